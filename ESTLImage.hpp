@@ -0,0 +1,351 @@
+//
+// Position-independent container images - common file header, writer and read-only memory mapping.
+//
+
+#ifndef ESTL_IMAGE_HPP
+#define ESTL_IMAGE_HPP
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <typeinfo>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ESTL {
+    /** Image files
+    An image is a container's storage written with indices instead of pointers, so it can be mapped back read-only at
+    any address and used in place - no parsing, no re-inserting. The file starts with an ImageHeader that is checked
+    before any lookup: magic, format version, container kind, a hash of the element layout and types (so a file
+    written for <int, long> is never read as <long, int>, or by a build with another Hash / Compare), and the section
+    sizes against the file size.
+    Keys and values must be trivially copyable, and the hash function must be stable across runs - std::hash is for
+    integers, but not guaranteed for strings by every standard library.
+Shared memory
+    The same images can be published into a POSIX shared memory object instead of a file: one process builds its
+    containers and publishes them, the other processes attach read-only and look up in place with zero copies and no
+    locks - a published image is never modified. The header is written last, so a process attaching while the image
+    is still being written fails validation instead of reading a partial image. Publishing under an existing name
+    replaces the object; processes attached to the old image keep their mapping.
+     * */
+
+    enum class ImageKind : std::uint32_t { UnorderedMap = 1, OrderedMap = 2, Vector = 3, List = 4 };
+
+    // Name of a POSIX shared memory object, e.g. "/estl-tables" - selects shared memory over a file path
+    struct SharedMemoryName {
+        std::string name;
+    };
+
+    struct ImageHeader {
+        static constexpr std::uint32_t CurrentVersion = 1;
+        static constexpr std::size_t SectionAlignment = 64;
+
+        char magic[8];
+        std::uint32_t version;
+        ImageKind kind;
+        std::uint64_t layoutHash;
+        std::uint64_t size;         // Elements stored
+        std::uint64_t capacity;     // Primary slots (hash buckets, or sorted entries)
+        std::uint64_t overflowCount;// Chained slots after the primary ones
+        std::uint64_t payloadBytes; // Bytes following the header
+        std::uint64_t reserved;
+    };
+    static_assert(sizeof(ImageHeader) == ImageHeader::SectionAlignment, "Image header must fill one section");
+
+    namespace image {
+        constexpr char Magic[8] = {'E', 'S', 'T', 'L', 'I', 'M', 'G', '\0'};
+
+        // FNV-1a over raw bytes - the layout hash is computed at run time from type names and sizes
+        inline std::uint64_t fnv1a(const void *data, std::size_t length, std::uint64_t hash = 14695981039346656037ull) {
+            const auto *bytes = static_cast<const unsigned char *>(data);
+            for (std::size_t i = 0; i < length; ++i) {
+                hash = (hash ^ bytes[i]) * 1099511628211ull;
+            }
+            return hash;
+        }
+
+        inline std::uint64_t hashValue(std::uint64_t hash, std::uint64_t value) {
+            return fnv1a(&value, sizeof(value), hash);
+        }
+
+        inline std::uint64_t hashType(std::uint64_t hash, const std::type_info &type) {
+            const char *name = type.name();
+            return fnv1a(name, std::strlen(name), hash);
+        }
+
+        inline std::size_t alignSection(std::size_t bytes) {
+            return (bytes + ImageHeader::SectionAlignment - 1) / ImageHeader::SectionAlignment *
+                   ImageHeader::SectionAlignment;
+        }
+
+        inline std::runtime_error ioError(const std::string &what, const std::string &path) {
+            return std::runtime_error(what + " '" + path + "': " + std::strerror(errno));
+        }
+
+        /**
+         * @brief Writes an image to a temporary file and renames it over path once complete.
+         *
+         * Readers mapping path see either the previous image or the new one, never a partial file.
+         */
+        class ImageWriter {
+            std::string m_path;
+            std::string m_tempPath;
+            std::FILE *m_file;
+
+        public:
+            explicit ImageWriter(const std::string &path)
+                : m_path(path)
+                , m_tempPath(path + ".tmp") {
+                m_file = std::fopen(m_tempPath.c_str(), "wb");
+                if (! m_file) {
+                    throw ioError("Cannot create image", m_tempPath);
+                }
+            }
+
+            ImageWriter(const ImageWriter &) = delete;
+            ImageWriter &operator=(const ImageWriter &) = delete;
+
+            ~ImageWriter() {
+                if (m_file) {
+                    std::fclose(m_file);
+                    std::remove(m_tempPath.c_str());
+                }
+            }
+
+            void write(const void *data, std::size_t bytes) {
+                if (bytes && std::fwrite(data, 1, bytes, m_file) != bytes) {
+                    throw ioError("Cannot write image", m_tempPath);
+                }
+            }
+
+            // Zero bytes up to the next section boundary
+            void pad(std::size_t written) {
+                static const char zeros[ImageHeader::SectionAlignment] = {};
+                write(zeros, alignSection(written) - written);
+            }
+
+            void commit() {
+                bool ok = std::fflush(m_file) == 0 && fsync(fileno(m_file)) == 0;
+                ok = std::fclose(m_file) == 0 && ok;
+                m_file = nullptr;
+                if (! ok || std::rename(m_tempPath.c_str(), m_path.c_str()) != 0) {
+                    std::remove(m_tempPath.c_str());
+                    throw ioError("Cannot commit image", m_path);
+                }
+            }
+        };
+
+        /**
+         * @brief Writes an image into a POSIX shared memory object.
+         *
+         * The object is sized from the header, the first write. The payload is written in place and the header is
+         * copied in last by commit().
+         */
+        class SharedMemoryWriter {
+            std::string m_name;
+            unsigned char *m_data = nullptr;
+            std::size_t m_length = 0;
+            std::size_t m_offset = 0;
+            ImageHeader m_header{};
+            bool m_committed = false;
+
+        public:
+            explicit SharedMemoryWriter(const SharedMemoryName &segment)
+                : m_name(segment.name) {}
+
+            SharedMemoryWriter(const SharedMemoryWriter &) = delete;
+            SharedMemoryWriter &operator=(const SharedMemoryWriter &) = delete;
+
+            ~SharedMemoryWriter() {
+                if (m_data) {
+                    munmap(m_data, m_length);
+                }
+                if (m_data && ! m_committed) {
+                    shm_unlink(m_name.c_str());
+                }
+            }
+
+            void write(const void *data, std::size_t bytes) {
+                if (! m_data) {
+                    if (bytes != sizeof(ImageHeader)) {
+                        throw std::logic_error("An image starts with its header");
+                    }
+                    std::memcpy(&m_header, data, sizeof(m_header));
+                    create(sizeof(ImageHeader) + m_header.payloadBytes);
+                    m_offset = sizeof(ImageHeader);
+                    return;
+                }
+                if (m_offset + bytes > m_length) {
+                    throw std::out_of_range("Image payload exceeds its header");
+                }
+                if (bytes) {
+                    std::memcpy(m_data + m_offset, data, bytes);
+                }
+                m_offset += bytes;
+            }
+
+            void pad(std::size_t written) { m_offset += alignSection(written) - written; }
+
+            void commit() {
+                if (! m_data || m_offset != m_length) {
+                    throw std::logic_error("Image payload does not match its header");
+                }
+                std::atomic_thread_fence(std::memory_order_release);
+                std::memcpy(m_data, &m_header, sizeof(m_header));
+                m_committed = true;
+            }
+
+        private:
+            void create(std::size_t length) {
+                shm_unlink(m_name.c_str());// replace a previous image - attached processes keep theirs
+                int fd = shm_open(m_name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+                if (fd < 0) {
+                    throw ioError("Cannot create shared memory", m_name);
+                }
+                if (ftruncate(fd, static_cast<off_t>(length)) != 0) {
+                    close(fd);
+                    shm_unlink(m_name.c_str());
+                    throw ioError("Cannot size shared memory", m_name);
+                }
+                void *mapped = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                close(fd);
+                if (mapped == MAP_FAILED) {
+                    shm_unlink(m_name.c_str());
+                    throw ioError("Cannot map shared memory", m_name);
+                }
+                m_data = static_cast<unsigned char *>(mapped);
+                m_length = length;
+            }
+        };
+    }// namespace image
+
+    /**
+     * @brief Read-only memory mapping of an image file, with its header validated.
+     *
+     * Pages are loaded lazily by the OS; populate = true pre-faults the whole file at map time instead.
+     */
+    class MappedImage {
+        const unsigned char *m_data = nullptr;
+        std::size_t m_length = 0;
+
+        void unmap() {
+            if (m_data) {
+                munmap(const_cast<unsigned char *>(m_data), m_length);
+            }
+            m_data = nullptr;
+            m_length = 0;
+        }
+
+    public:
+        MappedImage() = default;
+
+        /**
+         * @param path Image file.
+         * @param kind Expected container kind.
+         * @param layoutHash Expected layout hash of the element types.
+         * @throws std::runtime_error if the file cannot be mapped or its header does not match.
+         */
+        MappedImage(const std::string &path, ImageKind kind, std::uint64_t layoutHash, bool populate = false) {
+            int fd = open(path.c_str(), O_RDONLY);
+            if (fd < 0) {
+                throw image::ioError("Cannot open image", path);
+            }
+            map(fd, path, kind, layoutHash, populate);
+        }
+
+        // Attaches to an image published in shared memory
+        MappedImage(const SharedMemoryName &segment, ImageKind kind, std::uint64_t layoutHash, bool populate = false) {
+            int fd = shm_open(segment.name.c_str(), O_RDONLY, 0);
+            if (fd < 0) {
+                throw image::ioError("Cannot open shared memory", segment.name);
+            }
+            map(fd, segment.name, kind, layoutHash, populate);
+        }
+
+        MappedImage(const MappedImage &) = delete;
+        MappedImage &operator=(const MappedImage &) = delete;
+
+        MappedImage(MappedImage &&other) noexcept
+            : m_data(other.m_data)
+            , m_length(other.m_length) {
+            other.m_data = nullptr;
+            other.m_length = 0;
+        }
+
+        MappedImage &operator=(MappedImage &&other) noexcept {
+            if (this != &other) {
+                unmap();
+                std::swap(m_data, other.m_data);
+                std::swap(m_length, other.m_length);
+            }
+            return *this;
+        }
+
+        ~MappedImage() { unmap(); }
+
+        const ImageHeader &header() const { return *reinterpret_cast<const ImageHeader *>(m_data); }
+
+        // Section starting offset bytes after the header
+        template<typename T>
+        const T *section(std::size_t offset) const {
+            return reinterpret_cast<const T *>(m_data + sizeof(ImageHeader) + offset);
+        }
+
+        std::size_t bytes() const { return m_length; }
+
+    private:
+        // Maps and validates an open descriptor - closes it
+        void map(int fd, const std::string &path, ImageKind kind, std::uint64_t layoutHash, bool populate) {
+            struct stat info {};
+            if (fstat(fd, &info) != 0) {
+                close(fd);
+                throw image::ioError("Cannot stat image", path);
+            }
+            m_length = static_cast<std::size_t>(info.st_size);
+            if (m_length < sizeof(ImageHeader)) {
+                close(fd);
+                throw std::runtime_error("Image '" + path + "' is too small for its header");
+            }
+            void *mapped = mmap(nullptr, m_length, PROT_READ, MAP_PRIVATE | (populate ? MAP_POPULATE : 0), fd, 0);
+            close(fd);
+            if (mapped == MAP_FAILED) {
+                m_length = 0;
+                throw image::ioError("Cannot map image", path);
+            }
+            m_data = static_cast<const unsigned char *>(mapped);
+
+            const ImageHeader &head = header();
+            const char *problem = nullptr;
+            if (std::memcmp(head.magic, image::Magic, sizeof(image::Magic)) != 0) {
+                problem = "is not an ESTL image";
+            } else if (head.version != ImageHeader::CurrentVersion) {
+                problem = "has an unsupported format version";
+            } else if (head.kind != kind) {
+                problem = "holds another container kind";
+            } else if (head.layoutHash != layoutHash) {
+                problem = "was written for other key / value / hash types";
+            } else if (head.payloadBytes != m_length - sizeof(ImageHeader)) {
+                problem = "is truncated or has trailing data";
+            }
+            if (problem) {
+                unmap();
+                throw std::runtime_error("Image '" + path + "' " + problem);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);// pairs with the header written last on publish
+        }
+    };
+
+    // Removes an image published in shared memory - attached processes keep their mapping
+    inline void removeSharedImage(const SharedMemoryName &segment) { shm_unlink(segment.name.c_str()); }
+}// namespace ESTL
+
+#endif//ESTL_IMAGE_HPP
@@ -0,0 +1,335 @@
+//
+// Memory resources for the one-time storage allocation of RT containers.
+//
+
+#ifndef ESTL_MEMORY_HPP
+#define ESTL_MEMORY_HPP
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifndef ENABLE_THREAD_SAFETY
+#define ENABLE_THREAD_SAFETY true
+#endif
+
+namespace ESTL {
+    /** Memory resources
+    RT containers allocate their storage once, at construction, from a MemoryResource passed as the last constructor
+    argument - by default the heap. A resource hands out raw bytes; the container constructs and destroys its
+    elements. Copies of a container allocate from the source's resource, moves take the storage and the resource with
+    them. The resource must outlive every container using it.
+    - HeapResource: operator new, the default.
+    - ArenaResource: bump allocation from one block, deallocate is a no-op and reset() releases everything at once -
+      destroy the containers first, reset() does not run element destructors.
+    - HugePageResource: 2 MB aligned anonymous mappings advised as transparent hugepages, to cut TLB misses on large
+      tables. Without THP support the mapping stays on regular pages.
+    - NumaResource: anonymous mappings bound to a NUMA node before first touch. Where the kernel has no NUMA support
+      or the node does not exist, the memory is left to the default local policy.
+    Containers only take their element storage from the resource - side tables of the B+ and persistent tree engines
+    stay on the heap.
+     * */
+    class MemoryResource {
+    public:
+        virtual ~MemoryResource() = default;
+
+        // Throws std::bad_alloc when no memory is available
+        virtual void *allocate(std::size_t bytes, std::size_t alignment) = 0;
+        virtual void deallocate(void *pointer, std::size_t bytes, std::size_t alignment) = 0;
+    };
+
+    class HeapResource : public MemoryResource {
+    public:
+        void *allocate(std::size_t bytes, std::size_t alignment) override {
+            if (alignment <= alignof(std::max_align_t)) {
+                return ::operator new(bytes);
+            }
+            void *pointer = nullptr;
+            if (posix_memalign(&pointer, alignment, bytes ? bytes : 1) != 0) {
+                throw std::bad_alloc();
+            }
+            return pointer;
+        }
+
+        void deallocate(void *pointer, std::size_t, std::size_t alignment) override {
+            if (alignment <= alignof(std::max_align_t)) {
+                ::operator delete(pointer);
+            } else {
+                std::free(pointer);
+            }
+        }
+    };
+
+    inline MemoryResource *defaultResource() {
+        static HeapResource heap;
+        return &heap;
+    }
+
+    /**
+     * @brief Bump allocator over one block of memory.
+     *
+     * Allocation is a pointer increment, deallocation does nothing and reset() makes the whole block available again.
+     */
+    class ArenaResource : public MemoryResource {
+        unsigned char *m_begin;
+        std::size_t m_capacity;
+        std::size_t m_used = 0;
+        MemoryResource *m_upstream;// Owner of the block, nullptr for a caller provided buffer
+#if ENABLE_THREAD_SAFETY
+        std::mutex m_mutex;
+#endif
+
+    public:
+        // Takes a block of capacity bytes from upstream
+        explicit ArenaResource(std::size_t capacity, MemoryResource *upstream = defaultResource())
+            : m_begin(static_cast<unsigned char *>(upstream->allocate(capacity, alignof(std::max_align_t))))
+            , m_capacity(capacity)
+            , m_upstream(upstream) {}
+
+        // Allocates from a caller provided buffer
+        ArenaResource(void *buffer, std::size_t capacity)
+            : m_begin(static_cast<unsigned char *>(buffer))
+            , m_capacity(capacity)
+            , m_upstream(nullptr) {}
+
+        ArenaResource(const ArenaResource &) = delete;
+        ArenaResource &operator=(const ArenaResource &) = delete;
+
+        ~ArenaResource() override {
+            if (m_upstream) {
+                m_upstream->deallocate(m_begin, m_capacity, alignof(std::max_align_t));
+            }
+        }
+
+        void *allocate(std::size_t bytes, std::size_t alignment) override {
+#if ENABLE_THREAD_SAFETY
+            std::lock_guard<std::mutex> lock(m_mutex);
+#endif
+            std::uintptr_t current = reinterpret_cast<std::uintptr_t>(m_begin) + m_used;
+            std::size_t padding = (alignment - current % alignment) % alignment;
+            if (padding > m_capacity - m_used || bytes > m_capacity - m_used - padding) {
+                throw std::bad_alloc();
+            }
+            m_used += padding + bytes;
+            return reinterpret_cast<void *>(current + padding);
+        }
+
+        void deallocate(void *, std::size_t, std::size_t) override {}
+
+        // Releases every allocation at once
+        void reset() {
+#if ENABLE_THREAD_SAFETY
+            std::lock_guard<std::mutex> lock(m_mutex);
+#endif
+            m_used = 0;
+        }
+
+        std::size_t used() const { return m_used; }
+        std::size_t capacity() const { return m_capacity; }
+    };
+
+    namespace memory {
+        constexpr std::size_t HugePageSize = std::size_t(2) << 20;
+
+        inline std::size_t pageSize() {
+            static const std::size_t size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+            return size;
+        }
+
+        inline std::size_t roundUp(std::size_t bytes, std::size_t granularity) {
+            return (bytes + granularity - 1) / granularity * granularity;
+        }
+
+        // Anonymous mapping of bytes aligned to alignment - trims the over-allocated ends
+        inline void *mapAligned(std::size_t bytes, std::size_t alignment) {
+            std::size_t length = bytes + alignment;
+            void *mapped = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (mapped == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+            auto begin = reinterpret_cast<std::uintptr_t>(mapped);
+            std::uintptr_t aligned = roundUp(begin, alignment);
+            if (aligned > begin) {
+                munmap(mapped, aligned - begin);
+            }
+            std::uintptr_t end = begin + length;
+            if (end > aligned + bytes) {
+                munmap(reinterpret_cast<void *>(aligned + bytes), end - aligned - bytes);
+            }
+            return reinterpret_cast<void *>(aligned);
+        }
+
+        // Constructs count elements in storage from resource, default-initialized like new T[count]
+        template<typename T>
+        T *createArray(MemoryResource *resource, std::size_t count) {
+            T *data = static_cast<T *>(resource->allocate(count * sizeof(T), alignof(T)));
+            std::size_t constructed = 0;
+            try {
+                for (; constructed < count; ++constructed) {
+                    new (data + constructed) T;
+                }
+            } catch (...) {
+                while (constructed) {
+                    data[--constructed].~T();
+                }
+                resource->deallocate(data, count * sizeof(T), alignof(T));
+                throw;
+            }
+            return data;
+        }
+
+        template<typename T>
+        void destroyArray(MemoryResource *resource, T *data, std::size_t count) {
+            if (! data) {
+                return;
+            }
+            for (std::size_t i = 0; i < count; ++i) {
+                data[i].~T();
+            }
+            resource->deallocate(data, count * sizeof(T), alignof(T));
+        }
+    }// namespace memory
+
+    /**
+     * @brief Storage on 2 MB transparent hugepages.
+     *
+     * Every allocation is its own mapping, rounded up to whole hugepages - meant for a few large tables, not for
+     * many small containers.
+     */
+    class HugePageResource : public MemoryResource {
+    public:
+        void *allocate(std::size_t bytes, std::size_t alignment) override {
+            if (alignment > memory::HugePageSize) {
+                throw std::bad_alloc();
+            }
+            std::size_t length = memory::roundUp(bytes ? bytes : 1, memory::HugePageSize);
+            void *pointer = memory::mapAligned(length, memory::HugePageSize);
+#ifdef MADV_HUGEPAGE
+            madvise(pointer, length, MADV_HUGEPAGE);// a hint - regular pages without THP
+#endif
+            return pointer;
+        }
+
+        void deallocate(void *pointer, std::size_t bytes, std::size_t) override {
+            munmap(pointer, memory::roundUp(bytes ? bytes : 1, memory::HugePageSize));
+        }
+    };
+
+    // Placement of the NUMA container wrappers - see NumaUnorderedMap
+    enum class NumaPlacement { Partitioned, Replicated };
+
+    namespace numa {
+        // Number of NUMA node ids in use (highest online node + 1), 1 without NUMA support
+        inline int nodeCount() {
+            static const int count = [] {
+                std::FILE *file = std::fopen("/sys/devices/system/node/online", "r");
+                if (! file) {
+                    return 1;
+                }
+                int highest = 0;
+                int first = 0;
+                int last = 0;
+                char separator = 0;
+                while (std::fscanf(file, "%d", &first) == 1) {// "0-3,8-11"
+                    last = first;
+                    separator = static_cast<char>(std::fgetc(file));
+                    if (separator == '-' && std::fscanf(file, "%d", &last) == 1) {
+                        separator = static_cast<char>(std::fgetc(file));
+                    }
+                    highest = last > highest ? last : highest;
+                    if (separator != ',') {
+                        break;
+                    }
+                }
+                std::fclose(file);
+                return highest + 1;
+            }();
+            return count;
+        }
+
+        // Node of the CPU the calling thread runs on, 0 when unknown
+        inline int currentNode() {
+#ifdef SYS_getcpu
+            unsigned cpu = 0;
+            unsigned node = 0;
+            if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+                return static_cast<int>(node);
+            }
+#endif
+            return 0;
+        }
+    }// namespace numa
+
+    /**
+     * @brief Storage bound to one NUMA node.
+     *
+     * The mapping is bound with mbind before it is touched, so its pages are placed on the node whichever thread
+     * touches them first. Pages are placed with MPOL_PREFERRED: when the node runs out of memory they come from
+     * another node instead of failing.
+     */
+    class NumaResource : public MemoryResource {
+        int m_node;
+        bool m_hugePages;
+
+    public:
+        explicit NumaResource(int node, bool hugePages = false)
+            : m_node(node)
+            , m_hugePages(hugePages) {
+            if (node < 0) {
+                throw std::invalid_argument("NUMA node must not be negative");
+            }
+        }
+
+        void *allocate(std::size_t bytes, std::size_t alignment) override {
+            std::size_t granularity = m_hugePages ? memory::HugePageSize : memory::pageSize();
+            if (alignment > granularity) {
+                throw std::bad_alloc();
+            }
+            std::size_t length = memory::roundUp(bytes ? bytes : 1, granularity);
+            void *pointer = memory::mapAligned(length, granularity);
+#ifdef MADV_HUGEPAGE
+            if (m_hugePages) {
+                madvise(pointer, length, MADV_HUGEPAGE);
+            }
+#endif
+            bind(pointer, length);
+            return pointer;
+        }
+
+        void deallocate(void *pointer, std::size_t bytes, std::size_t) override {
+            std::size_t granularity = m_hugePages ? memory::HugePageSize : memory::pageSize();
+            munmap(pointer, memory::roundUp(bytes ? bytes : 1, granularity));
+        }
+
+        int node() const { return m_node; }
+
+    private:
+        void bind(void *pointer, std::size_t length) const {
+#ifdef SYS_mbind
+            constexpr int PreferredPolicy = 1;// MPOL_PREFERRED - <numaif.h> is not always installed
+            constexpr std::size_t MaskBits = 1024;
+            unsigned long mask[MaskBits / (8 * sizeof(unsigned long))] = {};
+            if (static_cast<std::size_t>(m_node) >= MaskBits) {
+                return;
+            }
+            mask[m_node / (8 * sizeof(unsigned long))] = 1ul << (m_node % (8 * sizeof(unsigned long)));
+            // Fails without kernel NUMA support or for a missing node - the default policy then applies
+            syscall(SYS_mbind, pointer, length, PreferredPolicy, mask, MaskBits + 1, 0);
+#else
+            (void) pointer;
+            (void) length;
+#endif
+        }
+    };
+}// namespace ESTL
+
+#endif//ESTL_MEMORY_HPP
@@ -0,0 +1,229 @@
+//
+// Opt-in statistics of the fixed containers: occupancy, chain lengths, pool pressure, tree shape, lock waits.
+//
+
+#ifndef ESTL_METRICS_HPP
+#define ESTL_METRICS_HPP
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#ifndef ENABLE_THREAD_SAFETY
+#define ENABLE_THREAD_SAFETY true
+#endif
+
+#ifndef ESTL_ENABLE_METRICS
+#define ESTL_ENABLE_METRICS false
+#endif
+
+// Statement compiled only when metrics are enabled - the containers' counter updates
+#if ESTL_ENABLE_METRICS
+#define ESTL_METRIC(statement) statement
+#else
+#define ESTL_METRIC(statement)
+#endif
+
+namespace ESTL {
+    /** Container metrics
+    Every container has a metrics() method returning a ContainerMetrics snapshot, taken under the container's lock.
+    The structural fields (size, load factor, chain lengths, pool use, tree height) are computed on demand by walking
+    the container, so they cost nothing until metrics() is called - chain lengths and tree height are O(capacity).
+    The counters (pool high-water mark, rotations, rebalances, lock waits) are updated on every operation, so they
+    are compiled in only when ESTL_ENABLE_METRICS is true (CMake option ESTL_ENABLE_METRICS). Without it they read
+    zero, countersEnabled is false and the containers keep their plain std::mutex and layout.
+    The flag must be the same in every translation unit of a program.
+     * */
+
+    // Lock wait times - bucket i counts the waits shorter than upperBoundNs(i), and not shorter than bucket i - 1's
+    struct LockWaitHistogram {
+        static constexpr std::size_t Buckets = 16;
+        static constexpr unsigned FirstBucketShift = 9;// First bucket: waits below 512 ns
+
+        std::uint64_t acquisitions = 0;// Every lock taken
+        std::uint64_t contended = 0;   // Locks that had to wait for another thread
+        std::uint64_t totalWaitNs = 0;
+        std::uint64_t maxWaitNs = 0;
+        std::uint64_t buckets[Buckets] = {};// Contended locks only
+
+        // The last bucket has no upper bound
+        static std::uint64_t upperBoundNs(std::size_t bucket) {
+            return bucket + 1 < Buckets ? std::uint64_t(1) << (bucket + FirstBucketShift) : UINT64_MAX;
+        }
+
+        void record(std::uint64_t waitNs) {
+            ++contended;
+            totalWaitNs += waitNs;
+            maxWaitNs = waitNs > maxWaitNs ? waitNs : maxWaitNs;
+            std::size_t bucket = 0;
+            while (bucket + 1 < Buckets && waitNs >= upperBoundNs(bucket)) {
+                ++bucket;
+            }
+            ++buckets[bucket];
+        }
+    };
+
+    struct ContainerMetrics {
+        bool countersEnabled = ESTL_ENABLE_METRICS;// False: the counters below are zero
+
+        std::size_t size = 0;
+        std::size_t capacity = 0;// Elements, or primary buckets of an unordered map
+        double loadFactor = 0;   // size / capacity
+
+        // Unordered maps - entries per occupied primary bucket, the primary included
+        std::size_t maxChainLength = 0;
+        double averageChainLength = 0;
+
+        // Free pool: chained buckets, tree nodes, list nodes; the element array of a vector
+        std::size_t poolCapacity = 0;
+        std::size_t poolInUse = 0;
+        std::size_t poolHighWater = 0;// Counter - the most ever in use at once
+
+        // Ordered maps - levels from the root to the deepest node, or B+ pages from the root to the leaves
+        std::size_t treeHeight = 0;
+
+        // Counters - ordered maps
+        std::uint64_t rotations = 0; // Binary tree rotations, path-copied ones included
+        std::uint64_t rebalances = 0;// Red-black fix-ups, AVL rebalanced nodes, B+ page splits and merges
+
+        // Counter - waits on the container's mutex
+        LockWaitHistogram lockWait;
+    };
+
+    /**
+     * @brief Hash distribution and sizing report of an unordered map - see FixedUnorderedMap::diagnostics().
+     *
+     * chiSquared compares the entries per primary bucket with a uniform spread of size entries over capacity
+     * buckets. A good hash gives a chiSquaredRatio (chiSquared / degrees of freedom) close to 1; clustering hashes,
+     * e.g. identity hashes of strided keys, score well above it.
+     */
+    struct HashDiagnostics {
+        std::size_t size = 0;
+        std::size_t capacity = 0;// Primary buckets
+        std::size_t poolCapacity = 0;
+
+        // chainLengths[i]: primary buckets holding i entries - [0] counts the empty ones
+        std::vector<std::size_t> chainLengths;
+        std::size_t primaryInUse = 0;// Occupied primary buckets
+        std::size_t poolInUse = 0;   // Chained buckets taken from the pool
+
+        double chiSquared = 0;
+        std::size_t degreesOfFreedom = 0;// capacity - 1
+        double chiSquaredRatio = 0;      // chiSquared / degreesOfFreedom, ~1 for a uniform hash
+
+        // Sizes holding size entries at targetLoad
+        double targetLoad = 0;
+        std::size_t recommendedCapacity = 0;
+        std::size_t recommendedPoolSize = 0;
+    };
+
+    namespace metrics {
+        /**
+         * Fills the chi-squared and recommendation fields of a report whose size, capacity and chainLengths are set.
+         *
+         * The recommended pool holds the chained entries expected when size keys hash uniformly into the recommended
+         * capacity - size minus the expected occupied primaries - plus three standard deviations, scaled up by the
+         * measured chiSquaredRatio when the hash spreads worse than uniform - never more than size.
+         */
+        inline void analyzeDistribution(HashDiagnostics &report, double targetLoad) {
+            if (! (targetLoad > 0)) {
+                throw std::invalid_argument("Target load must be positive");
+            }
+            report.targetLoad = targetLoad;
+            if (report.capacity > 1) {
+                const double expected = double(report.size) / report.capacity;
+                double sum = 0;
+                for (std::size_t length = 0; length < report.chainLengths.size(); ++length) {
+                    const double deviation = length - expected;
+                    sum += report.chainLengths[length] * deviation * deviation;
+                }
+                report.chiSquared = expected > 0 ? sum / expected : 0;
+                report.degreesOfFreedom = report.capacity - 1;
+                report.chiSquaredRatio = report.chiSquared / report.degreesOfFreedom;
+            }
+
+            const double keys = double(report.size);
+            const double capacity = std::ceil(keys / targetLoad);
+            report.recommendedCapacity = capacity < 1 ? 1 : static_cast<std::size_t>(capacity);
+            const double buckets = double(report.recommendedCapacity);
+            const double occupied = buckets * (1 - std::pow(1 - 1 / buckets, keys));
+            const double overflow = keys - occupied;
+            const double skew = report.chiSquaredRatio > 1 ? report.chiSquaredRatio : 1;
+            const double pool = std::min(std::ceil((overflow + 3 * std::sqrt(overflow)) * skew), keys);
+            report.recommendedPoolSize = pool < 1 ? 1 : static_cast<std::size_t>(pool);
+        }
+
+        // Counters kept by a container when metrics are enabled
+        struct Counters {
+            std::size_t poolInUse = 0;
+            std::size_t poolHighWater = 0;
+            std::uint64_t rotations = 0;
+            std::uint64_t rebalances = 0;
+
+            void acquire() {
+                ++poolInUse;
+                poolHighWater = poolInUse > poolHighWater ? poolInUse : poolHighWater;
+            }
+
+            void release() { --poolInUse; }
+
+            // For containers whose pool use is their size
+            void level(std::size_t inUse) {
+                poolInUse = inUse;
+                poolHighWater = inUse > poolHighWater ? inUse : poolHighWater;
+            }
+        };
+
+        /**
+         * @brief std::mutex that records how long lock() waited.
+         *
+         * An uncontended lock is one try_lock; only a failed try_lock reads the clock. The histogram is updated while
+         * the mutex is held, so it needs no atomics - read it under the lock.
+         */
+        class TimedMutex {
+            std::mutex m_mutex;
+            LockWaitHistogram m_histogram;
+
+        public:
+            void lock() {
+                if (m_mutex.try_lock()) {
+                    ++m_histogram.acquisitions;
+                    return;
+                }
+                auto start = std::chrono::steady_clock::now();
+                m_mutex.lock();
+                auto waited = std::chrono::steady_clock::now() - start;
+                ++m_histogram.acquisitions;
+                m_histogram.record(static_cast<std::uint64_t>(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(waited).count()));
+            }
+
+            bool try_lock() {
+                if (! m_mutex.try_lock()) {
+                    return false;
+                }
+                ++m_histogram.acquisitions;
+                return true;
+            }
+
+            void unlock() { m_mutex.unlock(); }
+
+            const LockWaitHistogram &histogram() const { return m_histogram; }
+        };
+    }// namespace metrics
+
+    // Mutex of the containers - timed when metrics are enabled
+#if ESTL_ENABLE_METRICS
+    using ContainerMutex = metrics::TimedMutex;
+#else
+    using ContainerMutex = std::mutex;
+#endif
+}// namespace ESTL
+
+#endif//ESTL_METRICS_HPP
@@ -0,0 +1,331 @@
+//
+// Parallel algorithms over FixedVector, run on an ESTL ThreadPool.
+//
+
+#ifndef ESTL_PARALLEL_HPP
+#define ESTL_PARALLEL_HPP
+#pragma once
+
+#include "ESTLThreadPool.hpp"
+#include "FixedVector.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace ESTL {
+    namespace parallel {
+        /** Parallel algorithms
+        Each algorithm splits the vector's [0, size()) into pieces that run on the pool's workers and the calling
+        thread, and returns when the whole range is done. The elements are accessed directly - the vector's lock is
+        not taken, so the vector must not be resized while an algorithm runs. Exceptions thrown by the callable are
+        rethrown to the caller; the vector's contents are then unspecified.
+        Grain: the smallest piece worth a task. 0 picks it with grainFor() - about kPiecesPerThread pieces per thread
+        so stealing can even out uneven pieces, but never below kMinGrain elements, where the split costs more than
+        it saves; a range of at most one grain runs serially on the caller. Pass a smaller grain when the callable is
+        expensive per element, a larger one when it is trivial.
+        Output vectors - transform and the scans - may be the input vector itself; their size is set to the input's,
+        which must fit their capacity (std::out_of_range otherwise).
+        sort is a sample sort: a sorted sample picks bucket splitters, the elements are counted and scattered into
+        their buckets in parallel, then each bucket is sorted on its own task. It needs size() elements of scratch,
+        allocated for the call, and falls back to std::sort below kSerialSort elements or without workers. Like
+        std::sort it is not stable; partition is.
+         * */
+        constexpr std::size_t kMinGrain = 2048;
+        constexpr std::size_t kPiecesPerThread = 4;
+        constexpr std::size_t kSerialSort = std::size_t(1) << 16;
+        constexpr std::size_t kMaxPieces = ThreadPool::kTaskSlots;
+
+        // The vector internals the algorithms work on
+        struct VectorAccess {
+            template<typename T>
+            static T *data(FixedVector<T> &vector) { return vector.m_data; }
+
+            template<typename T>
+            static const T *data(const FixedVector<T> &vector) { return vector.m_data; }
+
+            template<typename T>
+            static void checkCapacity(FixedVector<T> &vector, std::size_t size) {
+                if (size > vector.m_capacity) {
+                    throw std::out_of_range("FixedVector overflow");
+                }
+            }
+
+            template<typename T>
+            static void setSize(FixedVector<T> &vector, std::size_t size) { vector.m_size = size; }
+        };
+
+        // Grain for count elements on pool when the caller passed 0
+        inline std::size_t grainFor(std::size_t count, const ThreadPool &pool, std::size_t grain = 0) {
+            if (grain) {
+                return grain;
+            }
+            const std::size_t pieces = kPiecesPerThread * pool.concurrency();
+            return std::max(kMinGrain, (count + pieces - 1) / pieces);
+        }
+
+        namespace detail {
+            // A fixed cut of [0, total) into at most kMaxPieces pieces of about grain elements - for the algorithms
+            // that keep one partial result per piece
+            struct Pieces {
+                std::size_t total;
+                std::size_t size;
+                std::size_t count;
+
+                Pieces(std::size_t total, std::size_t grain)
+                    : total(total)
+                    , size(0)
+                    , count(0) {
+                    if (total) {
+                        const std::size_t wanted = std::min(kMaxPieces, (total + grain - 1) / grain);
+                        size = (total + wanted - 1) / wanted;
+                        count = (total + size - 1) / size;
+                    }
+                }
+
+                std::size_t begin(std::size_t piece) const { return piece * size; }
+                std::size_t end(std::size_t piece) const { return std::min(total, begin(piece) + size); }
+            };
+
+            // Calls f(piece, begin, end) for every piece, in parallel
+            template<typename F>
+            void forEachPiece(ThreadPool &pool, const Pieces &pieces, F f) {
+                pool.parallelFor(0, pieces.count, 1, [&pieces, &f](std::size_t first, std::size_t last) {
+                    for (std::size_t piece = first; piece < last; ++piece) {
+                        f(piece, pieces.begin(piece), pieces.end(piece));
+                    }
+                });
+            }
+
+            // op folded over each piece, left to right
+            template<typename T, typename BinaryOp>
+            std::vector<T> pieceTotals(ThreadPool &pool, const Pieces &pieces, const T *data, BinaryOp &op) {
+                std::vector<T> totals(pieces.count);
+                forEachPiece(pool, pieces, [&](std::size_t piece, std::size_t begin, std::size_t end) {
+                    T total = data[begin];
+                    for (std::size_t i = begin + 1; i < end; ++i) {
+                        total = op(total, data[i]);
+                    }
+                    totals[piece] = std::move(total);
+                });
+                return totals;
+            }
+        }// namespace detail
+
+        // Calls f(element) for every element, in no particular order
+        template<typename T, typename F>
+        void for_each(FixedVector<T> &vector, F f, ThreadPool &pool = ThreadPool::shared(), std::size_t grain = 0) {
+            T *data = VectorAccess::data(vector);
+            const std::size_t count = vector.size();
+            pool.parallelFor(0, count, grainFor(count, pool, grain), [data, &f](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; ++i) {
+                    f(data[i]);
+                }
+            });
+        }
+
+        // out[i] = f(in[i]) for every element of in
+        template<typename T, typename U, typename F>
+        void transform(const FixedVector<T> &in, FixedVector<U> &out, F f, ThreadPool &pool = ThreadPool::shared(),
+                       std::size_t grain = 0) {
+            const std::size_t count = in.size();
+            VectorAccess::checkCapacity(out, count);
+            const T *source = VectorAccess::data(in);
+            U *target = VectorAccess::data(out);
+            pool.parallelFor(0, count, grainFor(count, pool, grain),
+                             [source, target, &f](std::size_t begin, std::size_t end) {
+                                 for (std::size_t i = begin; i < end; ++i) {
+                                     target[i] = f(source[i]);
+                                 }
+                             });
+            VectorAccess::setSize(out, count);
+        }
+
+        // init op e0 op e1 op ... - op must be associative, it need not be commutative
+        template<typename T, typename BinaryOp = std::plus<T>>
+        T reduce(const FixedVector<T> &vector, T init, BinaryOp op = BinaryOp(),
+                 ThreadPool &pool = ThreadPool::shared(), std::size_t grain = 0) {
+            const std::size_t count = vector.size();
+            const detail::Pieces pieces(count, grainFor(count, pool, grain));
+            for (T &total: detail::pieceTotals(pool, pieces, VectorAccess::data(vector), op)) {
+                init = op(init, total);
+            }
+            return init;
+        }
+
+        // out[i] = in[0] op ... op in[i] - op must be associative
+        template<typename T, typename BinaryOp = std::plus<T>>
+        void inclusive_scan(const FixedVector<T> &in, FixedVector<T> &out, BinaryOp op = BinaryOp(),
+                            ThreadPool &pool = ThreadPool::shared(), std::size_t grain = 0) {
+            const std::size_t count = in.size();
+            VectorAccess::checkCapacity(out, count);
+            const T *source = VectorAccess::data(in);
+            T *target = VectorAccess::data(out);
+            const detail::Pieces pieces(count, grainFor(count, pool, grain));
+            // Two passes: the total of every piece, then each piece scanned from the total of the pieces before it
+            std::vector<T> carry = detail::pieceTotals(pool, pieces, source, op);
+            for (std::size_t piece = 1; piece < pieces.count; ++piece) {
+                carry[piece] = op(carry[piece - 1], carry[piece]);
+            }
+            detail::forEachPiece(pool, pieces, [&](std::size_t piece, std::size_t begin, std::size_t end) {
+                T running = piece ? op(carry[piece - 1], source[begin]) : source[begin];
+                target[begin] = running;
+                for (std::size_t i = begin + 1; i < end; ++i) {
+                    running = op(running, source[i]);// source[i] is read before target[i] is written
+                    target[i] = running;
+                }
+            });
+            VectorAccess::setSize(out, count);
+        }
+
+        // out[i] = init op in[0] op ... op in[i - 1] - op must be associative
+        template<typename T, typename BinaryOp = std::plus<T>>
+        void exclusive_scan(const FixedVector<T> &in, FixedVector<T> &out, T init, BinaryOp op = BinaryOp(),
+                            ThreadPool &pool = ThreadPool::shared(), std::size_t grain = 0) {
+            const std::size_t count = in.size();
+            VectorAccess::checkCapacity(out, count);
+            const T *source = VectorAccess::data(in);
+            T *target = VectorAccess::data(out);
+            const detail::Pieces pieces(count, grainFor(count, pool, grain));
+            std::vector<T> carry = detail::pieceTotals(pool, pieces, source, op);
+            T running = std::move(init);
+            for (std::size_t piece = 0; piece < pieces.count; ++piece) {
+                T total = std::move(carry[piece]);
+                carry[piece] = running;
+                running = op(running, total);
+            }
+            detail::forEachPiece(pool, pieces, [&](std::size_t piece, std::size_t begin, std::size_t end) {
+                T prefix = carry[piece];
+                for (std::size_t i = begin; i < end; ++i) {
+                    T next = op(prefix, source[i]);// Read before the write - out may be in
+                    target[i] = std::move(prefix);
+                    prefix = std::move(next);
+                }
+            });
+            VectorAccess::setSize(out, count);
+        }
+
+        /**
+         * Moves the elements satisfying pred before the others, keeping the order within both groups, and returns
+         * the first element of the second group. Needs size() elements of scratch, allocated for the call.
+         */
+        template<typename T, typename Predicate>
+        T *partition(FixedVector<T> &vector, Predicate pred, ThreadPool &pool = ThreadPool::shared(),
+                     std::size_t grain = 0) {
+            T *data = VectorAccess::data(vector);
+            const std::size_t count = vector.size();
+            const detail::Pieces pieces(count, grainFor(count, pool, grain));
+            if (pieces.count <= 1) {
+                return std::stable_partition(data, data + count, pred);
+            }
+            std::unique_ptr<bool[]> selected(new bool[count]);
+            std::vector<std::size_t> front(pieces.count);
+            detail::forEachPiece(pool, pieces, [&](std::size_t piece, std::size_t begin, std::size_t end) {
+                std::size_t taken = 0;
+                for (std::size_t i = begin; i < end; ++i) {
+                    selected[i] = static_cast<bool>(pred(data[i]));
+                    taken += selected[i];
+                }
+                front[piece] = taken;
+            });
+            // Where each piece's selected and other elements start in the result
+            std::vector<std::size_t> back(pieces.count);
+            std::size_t frontTotal = 0;
+            for (std::size_t piece = 0; piece < pieces.count; ++piece) {
+                const std::size_t taken = front[piece];
+                front[piece] = frontTotal;
+                frontTotal += taken;
+            }
+            for (std::size_t piece = 0; piece < pieces.count; ++piece) {
+                back[piece] = frontTotal + pieces.begin(piece) - front[piece];
+            }
+            std::unique_ptr<T[]> scratch(new T[count]);
+            detail::forEachPiece(pool, pieces, [&](std::size_t piece, std::size_t begin, std::size_t end) {
+                std::size_t toFront = front[piece];
+                std::size_t toBack = back[piece];
+                for (std::size_t i = begin; i < end; ++i) {
+                    scratch[selected[i] ? toFront++ : toBack++] = std::move(data[i]);
+                }
+            });
+            detail::forEachPiece(pool, pieces, [&](std::size_t, std::size_t begin, std::size_t end) {
+                std::move(scratch.get() + begin, scratch.get() + end, data + begin);
+            });
+            return data + frontTotal;
+        }
+
+        // Sorts the vector with comp, a strict weak ordering - see the sample sort notes above
+        template<typename T, typename Compare = std::less<T>>
+        void sort(FixedVector<T> &vector, Compare comp = Compare(), ThreadPool &pool = ThreadPool::shared()) {
+            constexpr std::size_t kOversample = 32;
+            constexpr std::size_t kMaxBuckets = 256;// Bucket numbers fit a byte
+            T *data = VectorAccess::data(vector);
+            const std::size_t count = vector.size();
+            const std::size_t buckets = std::min(kMaxBuckets, kPiecesPerThread * pool.concurrency());
+            if (pool.workerCount() == 0 || count < kSerialSort) {
+                std::sort(data, data + count, comp);
+                return;
+            }
+
+            // Splitters from a regular sample of the input
+            std::vector<T> sample;
+            sample.reserve(buckets * kOversample);
+            for (std::size_t i = 0; i < buckets * kOversample; ++i) {
+                sample.push_back(data[i * (count / (buckets * kOversample))]);
+            }
+            std::sort(sample.begin(), sample.end(), comp);
+            std::vector<T> splitters;
+            for (std::size_t bucket = 1; bucket < buckets; ++bucket) {
+                splitters.push_back(sample[bucket * kOversample]);
+            }
+
+            // Bucket of every element, counted per piece
+            const detail::Pieces pieces(count, grainFor(count, pool));
+            std::unique_ptr<std::uint8_t[]> bucketOf(new std::uint8_t[count]);
+            std::vector<std::size_t> offsets(pieces.count * buckets, 0);
+            detail::forEachPiece(pool, pieces, [&](std::size_t piece, std::size_t begin, std::size_t end) {
+                std::size_t *pieceCounts = &offsets[piece * buckets];
+                for (std::size_t i = begin; i < end; ++i) {
+                    const std::size_t bucket =
+                            std::upper_bound(splitters.begin(), splitters.end(), data[i], comp) - splitters.begin();
+                    bucketOf[i] = static_cast<std::uint8_t>(bucket);
+                    ++pieceCounts[bucket];
+                }
+            });
+
+            // Buckets laid out one after the other, each filled by the pieces in order
+            std::vector<std::size_t> bucketStart(buckets + 1);
+            std::size_t offset = 0;
+            for (std::size_t bucket = 0; bucket < buckets; ++bucket) {
+                bucketStart[bucket] = offset;
+                for (std::size_t piece = 0; piece < pieces.count; ++piece) {
+                    const std::size_t counted = offsets[piece * buckets + bucket];
+                    offsets[piece * buckets + bucket] = offset;
+                    offset += counted;
+                }
+            }
+            bucketStart[buckets] = count;
+
+            std::unique_ptr<T[]> scratch(new T[count]);
+            detail::forEachPiece(pool, pieces, [&](std::size_t piece, std::size_t begin, std::size_t end) {
+                std::size_t *next = &offsets[piece * buckets];
+                for (std::size_t i = begin; i < end; ++i) {
+                    scratch[next[bucketOf[i]]++] = std::move(data[i]);
+                }
+            });
+            pool.parallelFor(0, buckets, 1, [&](std::size_t first, std::size_t last) {
+                for (std::size_t bucket = first; bucket < last; ++bucket) {
+                    T *begin = scratch.get() + bucketStart[bucket];
+                    T *end = scratch.get() + bucketStart[bucket + 1];
+                    std::sort(begin, end, comp);
+                    std::move(begin, end, data + bucketStart[bucket]);
+                }
+            });
+        }
+    }// namespace parallel
+}// namespace ESTL
+
+#endif//ESTL_PARALLEL_HPP
@@ -0,0 +1,546 @@
+//
+// Binary serialization of ESTL containers - streaming writers and readers over a fixed buffer.
+//
+
+#ifndef ESTL_SERIALIZATION_HPP
+#define ESTL_SERIALIZATION_HPP
+#pragma once
+
+#include "ESTLMetrics.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+
+#ifndef ENABLE_THREAD_SAFETY
+#define ENABLE_THREAD_SAFETY true
+#endif
+
+namespace ESTL {
+    /** Binary serialization
+    serialize(writer, container) writes one record: a 16 byte RecordHeader (container kind, format version, element
+    size, element count) followed by the elements. Trivially copyable elements are copied as raw bytes - a FixedVector
+    is written and read with a single copy of its storage - other elements (strings, nested containers) are written as
+    their own records. FixedString is length prefixed. Maps are written as key, value pairs; FixedMap in key order.
+    The format is the in-memory representation, so it is only portable between builds with the same element layouts
+    and byte order.
+
+    BinaryWriter and BinaryReader stream through a caller provided buffer: small writes are gathered in the buffer,
+    writes at least as large as the buffer go straight to the stream, so checkpointing large containers costs one copy
+    into the stream. Without a stream they work on the buffer alone, for sending containers over a transport.
+
+    deserialize(reader, container) replaces the container's contents. A record with more elements than the container
+    holds throws std::out_of_range before the container is changed; malformed or truncated input throws
+    std::runtime_error and may leave the container partially filled. Unordered maps and sets are checked against their
+    slots plus bucket pool, but whether the keys fit depends on how they chain, known only while reading: a record
+    whose keys chain beyond the bucket pool throws std::out_of_range partway through, with the container cleared and
+    holding the entries read so far.
+
+    Trivially copyable elements, keys and values are read into raw storage and need no default constructor. Elements
+    written as nested records are read into an existing object, so those types must be default-constructible.
+     * */
+
+    template<typename T>
+    class FixedVector;
+    template<typename T>
+    class FixedList;
+    template<typename K, typename V, typename H>
+    class FixedUnorderedMap;
+    template<typename K, typename H>
+    class FixedUnorderedSet;
+    template<typename K, typename V, typename C>
+    class FixedMap;
+    template<typename D>
+    class FixedStringBase;
+
+    enum class RecordKind : std::uint16_t {
+        String = 1,
+        Vector = 2,
+        List = 3,
+        UnorderedMap = 4,
+        UnorderedSet = 5,
+        OrderedMap = 6
+    };
+
+    struct RecordHeader {
+        static constexpr std::uint16_t CurrentVersion = 1;
+
+        RecordKind kind;
+        std::uint16_t version;
+        std::uint32_t elementBytes;// Raw bytes per element, 0 for elements written as nested records
+        std::uint64_t count;
+    };
+    static_assert(sizeof(RecordHeader) == 16, "Record header must be 16 bytes");
+
+    /**
+     * @brief Buffered binary output to a std::ostream, or into a fixed buffer alone.
+     *
+     * The buffer is owned by the caller and must outlive the writer. The destructor flushes but swallows errors -
+     * call flush() to see them.
+     */
+    class BinaryWriter {
+        char *m_buffer;
+        std::size_t m_capacity;
+        std::size_t m_used = 0;
+        std::ostream *m_out;
+        std::uint64_t m_flushed = 0;
+
+    public:
+        BinaryWriter(std::ostream &out, char *buffer, std::size_t capacity)
+            : m_buffer(buffer)
+            , m_capacity(capacity)
+            , m_out(&out) {
+            if (capacity == 0) {
+                throw std::invalid_argument("BinaryWriter needs a buffer");
+            }
+        }
+
+        // Writes into buffer only - throws std::out_of_range once it is full
+        BinaryWriter(char *buffer, std::size_t capacity)
+            : m_buffer(buffer)
+            , m_capacity(capacity)
+            , m_out(nullptr) {}
+
+        BinaryWriter(const BinaryWriter &) = delete;
+        BinaryWriter &operator=(const BinaryWriter &) = delete;
+
+        ~BinaryWriter() {
+            try {
+                drain();
+            } catch (...) {
+            }
+        }
+
+        void write(const void *data, std::size_t bytes) {
+            if (bytes <= m_capacity - m_used) {
+                if (bytes) {
+                    std::memcpy(m_buffer + m_used, data, bytes);
+                    m_used += bytes;
+                }
+                return;
+            }
+            if (! m_out) {
+                throw std::out_of_range("Serialization buffer is full");
+            }
+            drain();
+            if (bytes >= m_capacity) {// Large blocks bypass the buffer
+                put(data, bytes);
+                m_flushed += bytes;
+            } else {
+                std::memcpy(m_buffer, data, bytes);
+                m_used = bytes;
+            }
+        }
+
+        template<typename T>
+        void writeValue(const T &value) {
+            static_assert(std::is_trivially_copyable<T>::value, "writeValue needs a trivially copyable type");
+            write(&value, sizeof(T));
+        }
+
+        // Hands the buffered bytes to the stream and flushes it
+        void flush() {
+            drain();
+            if (m_out && ! m_out->flush()) {
+                throw std::runtime_error("Cannot flush serialization stream");
+            }
+        }
+
+        // Total bytes written, buffered or not
+        std::uint64_t bytesWritten() const { return m_flushed + m_used; }
+
+        // Bytes held in the buffer - the whole output for a writer without a stream
+        const char *data() const { return m_buffer; }
+        std::size_t size() const { return m_used; }
+
+    private:
+        void put(const void *data, std::size_t bytes) {
+            if (! m_out->write(static_cast<const char *>(data), static_cast<std::streamsize>(bytes))) {
+                throw std::runtime_error("Cannot write serialization stream");
+            }
+        }
+
+        void drain() {
+            if (m_out && m_used) {
+                put(m_buffer, m_used);
+                m_flushed += m_used;
+                m_used = 0;
+            }
+        }
+    };
+
+    /**
+     * @brief Buffered binary input from a std::istream, or from a block of memory.
+     *
+     * Reads past the end of the input throw std::runtime_error.
+     */
+    class BinaryReader {
+        char *m_buffer;
+        std::size_t m_capacity;
+        const char *m_current;
+        const char *m_end;
+        std::istream *m_in;
+
+    public:
+        BinaryReader(std::istream &in, char *buffer, std::size_t capacity)
+            : m_buffer(buffer)
+            , m_capacity(capacity)
+            , m_current(buffer)
+            , m_end(buffer)
+            , m_in(&in) {
+            if (capacity == 0) {
+                throw std::invalid_argument("BinaryReader needs a buffer");
+            }
+        }
+
+        // Reads the bytes written by a BinaryWriter without a stream
+        BinaryReader(const void *data, std::size_t bytes)
+            : m_buffer(nullptr)
+            , m_capacity(0)
+            , m_current(static_cast<const char *>(data))
+            , m_end(m_current + bytes)
+            , m_in(nullptr) {}
+
+        BinaryReader(const BinaryReader &) = delete;
+        BinaryReader &operator=(const BinaryReader &) = delete;
+
+        void read(void *data, std::size_t bytes) {
+            auto *out = static_cast<char *>(data);
+            std::size_t buffered = static_cast<std::size_t>(m_end - m_current);
+            if (bytes <= buffered) {
+                if (bytes) {
+                    std::memcpy(out, m_current, bytes);
+                    m_current += bytes;
+                }
+                return;
+            }
+            if (buffered) {
+                std::memcpy(out, m_current, buffered);
+                m_current = m_end;
+                out += buffered;
+                bytes -= buffered;
+            }
+            if (! m_in) {
+                throw std::runtime_error("Unexpected end of serialized data");
+            }
+            if (bytes >= m_capacity) {// Large blocks bypass the buffer
+                if (! m_in->read(out, static_cast<std::streamsize>(bytes))) {
+                    throw std::runtime_error("Unexpected end of serialized data");
+                }
+                return;
+            }
+            while (bytes) {
+                m_in->read(m_buffer, static_cast<std::streamsize>(m_capacity));
+                std::size_t got = static_cast<std::size_t>(m_in->gcount());
+                if (got == 0) {
+                    throw std::runtime_error("Unexpected end of serialized data");
+                }
+                std::size_t used = got < bytes ? got : bytes;
+                std::memcpy(out, m_buffer, used);
+                out += used;
+                bytes -= used;
+                m_current = m_buffer + used;
+                m_end = m_buffer + got;
+            }
+        }
+
+        template<typename T>
+        void readValue(T &value) {
+            static_assert(std::is_trivially_copyable<T>::value, "readValue needs a trivially copyable type");
+            read(&value, sizeof(T));
+        }
+    };
+
+    template<typename Container>
+    void serialize(BinaryWriter &writer, const Container &container);
+    template<typename Container>
+    void deserialize(BinaryReader &reader, Container &container);
+
+    namespace serial {
+        template<typename T>
+        using IsRaw = std::is_trivially_copyable<T>;
+
+        template<typename T>
+        constexpr std::uint32_t elementBytes() {
+            return IsRaw<T>::value ? static_cast<std::uint32_t>(sizeof(T)) : 0;
+        }
+
+        template<typename K, typename V>
+        constexpr std::uint32_t pairBytes() {
+            return IsRaw<K>::value && IsRaw<V>::value ? static_cast<std::uint32_t>(sizeof(K) + sizeof(V)) : 0;
+        }
+
+        template<typename T>
+        void writeElement(BinaryWriter &writer, const T &value, std::true_type) {
+            writer.write(&value, sizeof(T));
+        }
+
+        template<typename T>
+        void writeElement(BinaryWriter &writer, const T &value, std::false_type) {
+            serialize(writer, value);
+        }
+
+        template<typename T>
+        void writeElement(BinaryWriter &writer, const T &value) {
+            writeElement(writer, value, IsRaw<T>());
+        }
+
+        template<typename T>
+        void readElement(BinaryReader &reader, T &value, std::true_type) {
+            reader.read(&value, sizeof(T));
+        }
+
+        template<typename T>
+        void readElement(BinaryReader &reader, T &value, std::false_type) {
+            deserialize(reader, value);
+        }
+
+        template<typename T>
+        void readElement(BinaryReader &reader, T &value) {
+            readElement(reader, value, IsRaw<T>());
+        }
+
+        // One element read from a record, before it is inserted into a list or map. Raw elements are read into
+        // uninitialized storage; nested records are read into a default-constructed element
+        template<typename T, bool Raw = IsRaw<T>::value>
+        class ReadSlot {
+            union {
+                T m_value;
+            };
+
+        public:
+            ReadSlot() {}
+
+            T &read(BinaryReader &reader) {
+                reader.read(&m_value, sizeof(T));
+                return m_value;
+            }
+        };
+
+        template<typename T>
+        class ReadSlot<T, false> {
+            T m_value{};
+
+        public:
+            T &read(BinaryReader &reader) {
+                deserialize(reader, m_value);
+                return m_value;
+            }
+        };
+
+        inline void writeHeader(BinaryWriter &writer, RecordKind kind, std::uint32_t elementBytes,
+                                std::uint64_t count) {
+            RecordHeader header{kind, RecordHeader::CurrentVersion, elementBytes, count};
+            writer.writeValue(header);
+        }
+
+        // Reads and checks a record header - returns its element count
+        inline std::uint64_t readHeader(BinaryReader &reader, RecordKind kind, std::uint32_t elementBytes,
+                                        std::size_t capacity) {
+            RecordHeader header{};
+            reader.readValue(header);
+            if (header.kind != kind || header.version != RecordHeader::CurrentVersion) {
+                throw std::runtime_error("Serialized record is not of the expected container kind or version");
+            }
+            if (header.elementBytes != elementBytes) {
+                throw std::runtime_error("Serialized element layout does not match");
+            }
+            if (header.count > capacity) {
+                throw std::out_of_range("Serialized data exceeds container capacity");
+            }
+            return header.count;
+        }
+    }// namespace serial
+
+    // Container access for serialize / deserialize
+    class Serialization {
+    public:
+        template<typename T>
+        static void write(BinaryWriter &writer, const FixedVector<T> &vector) {
+#if (ENABLE_THREAD_SAFETY)
+            std::lock_guard<ContainerMutex> lock(vector.m_mutex);
+#endif
+            serial::writeHeader(writer, RecordKind::Vector, serial::elementBytes<T>(), vector.m_size);
+            writeArray(writer, vector.m_data, vector.m_size, serial::IsRaw<T>());
+        }
+
+        template<typename T>
+        static void read(BinaryReader &reader, FixedVector<T> &vector) {
+#if (ENABLE_THREAD_SAFETY)
+            std::lock_guard<ContainerMutex> lock(vector.m_mutex);
+#endif
+            auto count = serial::readHeader(reader, RecordKind::Vector, serial::elementBytes<T>(), vector.m_capacity);
+            vector.m_size = 0;
+            readArray(reader, vector.m_data, count, serial::IsRaw<T>());
+            vector.m_size = count;
+        }
+
+        template<typename T>
+        static void write(BinaryWriter &writer, const FixedList<T> &list) {
+#if ENABLE_THREAD_SAFETY
+            std::lock_guard<ContainerMutex> lock(list.m_mutex);
+#endif
+            serial::writeHeader(writer, RecordKind::List, serial::elementBytes<T>(), list.m_size);
+            for (const auto *node = list.m_head; node; node = node->next) {
+                serial::writeElement(writer, node->data);
+            }
+        }
+
+        template<typename T>
+        static void read(BinaryReader &reader, FixedList<T> &list) {
+            auto count = serial::readHeader(reader, RecordKind::List, serial::elementBytes<T>(), list.capacity());
+            list.clear();
+            serial::ReadSlot<T> value;
+            for (std::uint64_t i = 0; i < count; ++i) {
+                list.push_back(value.read(reader));
+            }
+        }
+
+        template<typename K, typename V, typename H>
+        static void write(BinaryWriter &writer, const FixedUnorderedMap<K, V, H> &map) {
+#if (ENABLE_THREAD_SAFETY)
+            std::lock_guard<ContainerMutex> lock(map.m_mutex);
+#endif
+            serial::writeHeader(writer, RecordKind::UnorderedMap, serial::pairBytes<K, V>(), map.m_size);
+            forEachBucket(map, [&writer](const K &key, const V &value) {
+                serial::writeElement(writer, key);
+                serial::writeElement(writer, value);
+            });
+        }
+
+        template<typename K, typename V, typename H>
+        static void read(BinaryReader &reader, FixedUnorderedMap<K, V, H> &map) {
+            auto count = serial::readHeader(reader, RecordKind::UnorderedMap, serial::pairBytes<K, V>(),
+                                            map.m_mapCapacity + map.m_bucketPoolCapacity);
+            map.clear();
+            serial::ReadSlot<K> key;
+            serial::ReadSlot<V> value;
+            for (std::uint64_t i = 0; i < count; ++i) {
+                const K &readKey = key.read(reader);
+                if (! map.insert(readKey, value.read(reader))) {
+                    throw std::runtime_error("Serialized map repeats a key");
+                }
+            }
+        }
+
+        template<typename K, typename H>
+        static void write(BinaryWriter &writer, const FixedUnorderedSet<K, H> &set) {
+            const auto &map = *set.m_map;
+#if (ENABLE_THREAD_SAFETY)
+            std::lock_guard<ContainerMutex> lock(map.m_mutex);
+#endif
+            serial::writeHeader(writer, RecordKind::UnorderedSet, serial::elementBytes<K>(), map.m_size);
+            forEachBucket(map, [&writer](const K &key, bool) { serial::writeElement(writer, key); });
+        }
+
+        template<typename K, typename H>
+        static void read(BinaryReader &reader, FixedUnorderedSet<K, H> &set) {
+            auto &map = *set.m_map;
+            auto count = serial::readHeader(reader, RecordKind::UnorderedSet, serial::elementBytes<K>(),
+                                            map.m_mapCapacity + map.m_bucketPoolCapacity);
+            map.clear();
+            serial::ReadSlot<K> key;
+            for (std::uint64_t i = 0; i < count; ++i) {
+                if (! map.insert(key.read(reader), true)) {
+                    throw std::runtime_error("Serialized set repeats a key");
+                }
+            }
+        }
+
+        template<typename K, typename V, typename C>
+        static void write(BinaryWriter &writer, const FixedMap<K, V, C> &map) {
+#if ENABLE_THREAD_SAFETY
+            std::lock_guard<ContainerMutex> lock(map.m_mutex);
+#endif
+            auto &tree = *map.m_tree;
+            serial::writeHeader(writer, RecordKind::OrderedMap, serial::pairBytes<K, V>(), tree.size());
+            for (auto *node = tree.minimum(); node; node = tree.next(node)) {
+                serial::writeElement(writer, node->key);
+                serial::writeElement(writer, node->value);
+            }
+        }
+
+        template<typename K, typename V, typename C>
+        static void read(BinaryReader &reader, FixedMap<K, V, C> &map) {
+            auto count = serial::readHeader(reader, RecordKind::OrderedMap, serial::pairBytes<K, V>(), map.capacity());
+            map.clear();
+            serial::ReadSlot<K> key;
+            serial::ReadSlot<V> value;
+            for (std::uint64_t i = 0; i < count; ++i) {
+                const K &readKey = key.read(reader);
+                if (! map.insert(readKey, value.read(reader))) {
+                    throw std::runtime_error("Serialized map repeats a key");
+                }
+            }
+        }
+
+        template<typename D>
+        static void write(BinaryWriter &writer, const FixedStringBase<D> &string) {
+            serial::writeHeader(writer, RecordKind::String, 1, string.m_size);
+            writer.write(string.m_data, string.m_size);
+        }
+
+        template<typename D>
+        static void read(BinaryReader &reader, FixedStringBase<D> &string) {
+            auto count = serial::readHeader(reader, RecordKind::String, 1, string.m_capacity);
+            reader.read(string.m_data, count);
+            string.m_data[count] = '\0';
+            string.m_size = count;
+        }
+
+    private:
+        template<typename T>
+        static void writeArray(BinaryWriter &writer, const T *data, std::size_t count, std::true_type) {
+            writer.write(data, count * sizeof(T));
+        }
+
+        template<typename T>
+        static void writeArray(BinaryWriter &writer, const T *data, std::size_t count, std::false_type) {
+            for (std::size_t i = 0; i < count; ++i) {
+                serial::writeElement(writer, data[i]);
+            }
+        }
+
+        template<typename T>
+        static void readArray(BinaryReader &reader, T *data, std::size_t count, std::true_type) {
+            reader.read(data, count * sizeof(T));
+        }
+
+        template<typename T>
+        static void readArray(BinaryReader &reader, T *data, std::size_t count, std::false_type) {
+            for (std::size_t i = 0; i < count; ++i) {
+                serial::readElement(reader, data[i]);
+            }
+        }
+
+        // Visits the occupied buckets, primary and chained
+        template<typename Map, typename Visitor>
+        static void forEachBucket(const Map &map, Visitor visit) {
+            for (std::size_t i = map.nextOccupied(0); i < map.m_mapCapacity; i = map.nextOccupied(i + 1)) {
+                for (const auto *bucket = &map.m_buckets[i]; bucket; bucket = bucket->next) {
+                    if (bucket->occupied) {
+                        visit(bucket->key, bucket->value);
+                    }
+                }
+            }
+        }
+    };
+
+    // Writes container as one record - see Binary serialization above
+    template<typename Container>
+    void serialize(BinaryWriter &writer, const Container &container) {
+        Serialization::write(writer, container);
+    }
+
+    // Replaces container's contents with the next record
+    template<typename Container>
+    void deserialize(BinaryReader &reader, Container &container) {
+        Serialization::read(reader, container);
+    }
+}// namespace ESTL
+
+#endif//ESTL_SERIALIZATION_HPP
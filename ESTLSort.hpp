@@ -0,0 +1,294 @@
+//
+// Non-comparison sorts for FixedVector - LSD radix sort for large vectors, sorting networks for small ones.
+//
+
+#ifndef ESTL_SORT_HPP
+#define ESTL_SORT_HPP
+#pragma once
+
+#include "FixedVector.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace ESTL {
+    namespace sorting {
+        /** Sorting
+        sort() picks the algorithm from the element type and the size, for ascending order of an arithmetic type:
+        - at least kRadixMin elements: radix_sort, linear in the size instead of comparison-bound.
+        - at most kNetworkSortMax elements: network_sort, a fixed branch-free compare-exchange sequence.
+        - anything else, and every other element type, std::sort.
+        radix_sort is an LSD radix sort on byte digits, stable, and sorts records by a key taken with a key extractor -
+        an unsigned, signed or floating-point value. It counts all digits in one pass, then moves the elements
+        between the vector and a scratch buffer once per digit, skipping the digits every key shares. The scratch
+        buffer is the caller's - a FixedVector whose capacity fits the elements, contents overwritten - or one
+        allocated for the call.
+        network_sort runs a bitonic network over the next power of two of lanes, the spare lanes padded with the
+        largest value - infinity for floating point. The stages are generated at compile time per lane count, and
+        each is a min and a max over contiguous runs of lanes, which the compiler lowers to SIMD min/max
+        instructions where the target has them. It does not branch on the data, so it costs the same for any input.
+        It holds up to kNetworkMax elements, but beats std::sort only on the smallest sizes - past those the stages
+        with short runs spill lanes to memory - so sort() stops using it at kNetworkSortMax.
+         * */
+        constexpr std::size_t kRadixMin = 2048;
+        constexpr std::size_t kNetworkMax = 64;
+        constexpr std::size_t kNetworkSortMax = 8;
+
+        // Key extractor for vectors of keys
+        struct IdentityKey {
+            template<typename T>
+            const T &operator()(const T &value) const { return value; }
+        };
+
+        namespace detail {
+            // Unsigned image of a key that orders like the key
+            template<typename Key, typename = void>
+            struct RadixBits;
+
+            template<typename Key>
+            struct RadixBits<Key, typename std::enable_if<std::is_integral<Key>::value>::type> {
+                static_assert(! std::is_same<Key, bool>::value, "radix_sort needs a numeric key");
+                using Type = typename std::make_unsigned<Key>::type;
+                static constexpr Type kFlip = std::is_signed<Key>::value ? Type(Type(1) << (8 * sizeof(Type) - 1)) : 0;
+
+                static Type of(Key key) { return static_cast<Type>(key) ^ kFlip; }
+            };
+
+            template<typename Key>
+            struct RadixBits<Key, typename std::enable_if<std::is_floating_point<Key>::value>::type> {
+                static_assert(sizeof(Key) == 4 || sizeof(Key) == 8, "radix_sort needs IEEE float or double keys");
+                using Type = typename std::conditional<sizeof(Key) == 4, std::uint32_t, std::uint64_t>::type;
+                static constexpr Type kSign = Type(1) << (8 * sizeof(Type) - 1);
+
+                // Negative values count down, so all their bits flip; positive ones go above them
+                static Type of(Key key) {
+                    Type bits;
+                    std::memcpy(&bits, &key, sizeof(bits));
+                    return bits & kSign ? ~bits : bits | kSign;
+                }
+            };
+
+            template<typename T, typename KeyOf>
+            using KeyType = typename std::decay<decltype(std::declval<KeyOf &>()(std::declval<const T &>()))>::type;
+
+            template<typename T, typename KeyOf>
+            void radixSort(T *data, std::size_t count, T *scratch, KeyOf &keyOf) {
+                using Bits = RadixBits<KeyType<T, KeyOf>>;
+                constexpr std::size_t kDigits = sizeof(typename Bits::Type);
+                if (count < 2) {
+                    return;
+                }
+                std::array<std::array<std::size_t, 256>, kDigits> counts{};
+                for (std::size_t i = 0; i < count; ++i) {
+                    const auto bits = Bits::of(keyOf(data[i]));
+                    for (std::size_t digit = 0; digit < kDigits; ++digit) {
+                        ++counts[digit][(bits >> (8 * digit)) & 0xff];
+                    }
+                }
+                T *from = data;
+                T *to = scratch;
+                for (std::size_t digit = 0; digit < kDigits; ++digit) {
+                    std::array<std::size_t, 256> &offsets = counts[digit];
+                    const std::size_t shift = 8 * digit;
+                    if (offsets[(Bits::of(keyOf(from[0])) >> shift) & 0xff] == count) {
+                        continue;// Every key has this digit
+                    }
+                    std::size_t offset = 0;
+                    for (std::size_t &bucket: offsets) {
+                        const std::size_t counted = bucket;
+                        bucket = offset;
+                        offset += counted;
+                    }
+                    for (std::size_t i = 0; i < count; ++i) {
+                        to[offsets[(Bits::of(keyOf(from[i])) >> shift) & 0xff]++] = std::move(from[i]);
+                    }
+                    std::swap(from, to);
+                }
+                if (from != data) {
+                    std::move(from, from + count, data);
+                }
+            }
+
+            // Compare-exchange of lane t with lane t + J for t < J - one min and one max over J contiguous lanes
+            template<typename T, std::size_t J, bool Ascending>
+            void compareExchange(T *low) {
+                T *high = low + J;
+                for (std::size_t t = 0; t < J; ++t) {
+                    const T a = low[t];
+                    const T b = high[t];
+                    low[t] = Ascending ? std::min(a, b) : std::max(a, b);
+                    high[t] = Ascending ? std::max(a, b) : std::min(a, b);
+                }
+            }
+
+            // Compare-exchanges every J-block pair in [begin, end), all in one direction
+            template<typename T, std::size_t J, bool Ascending>
+            void compareExchangeRun(T *begin, T *end) {
+                for (T *block = begin; block < end; block += 2 * J) {
+                    compareExchange<T, J, Ascending>(block);
+                }
+            }
+
+            // One bitonic stage: ascending in the runs of K lanes at even multiples of K, descending in the others.
+            // Direction is a template argument, so every run is straight min/max code the compiler can vectorize
+            template<typename T, std::size_t Lanes, std::size_t K, std::size_t J>
+            struct BitonicStage {
+                static void apply(T *lanes) {
+                    if (K == Lanes) {
+                        compareExchangeRun<T, J, true>(lanes, lanes + Lanes);
+                        return;
+                    }
+                    for (T *run = lanes; run < lanes + Lanes; run += 2 * K) {
+                        compareExchangeRun<T, J, true>(run, run + K);
+                        compareExchangeRun<T, J, false>(run + K, run + 2 * K);
+                    }
+                }
+            };
+
+            // The stages of one merge, J halving down to 1
+            template<typename T, std::size_t Lanes, std::size_t K, std::size_t J = K / 2>
+            struct BitonicMerge {
+                static void apply(T *lanes) {
+                    BitonicStage<T, Lanes, K, J>::apply(lanes);
+                    BitonicMerge<T, Lanes, K, J / 2>::apply(lanes);
+                }
+            };
+
+            template<typename T, std::size_t Lanes, std::size_t K>
+            struct BitonicMerge<T, Lanes, K, 0> {
+                static void apply(T *) {}
+            };
+
+            // Merges runs of K / 2 lanes into runs of K, up to one run of all lanes
+            template<typename T, std::size_t Lanes, std::size_t K = 2, bool Done = (K > Lanes)>
+            struct BitonicNetwork {
+                static void apply(T *lanes) {
+                    BitonicMerge<T, Lanes, K>::apply(lanes);
+                    BitonicNetwork<T, Lanes, 2 * K>::apply(lanes);
+                }
+            };
+
+            template<typename T, std::size_t Lanes, std::size_t K>
+            struct BitonicNetwork<T, Lanes, K, true> {
+                static void apply(T *) {}
+            };
+
+            // Largest value of T, so the spare lanes sort after every element - infinity for floating point, where
+            // max() would sort before an infinite element and replace it
+            template<typename T>
+            constexpr T padding() {
+                return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity()
+                                                            : std::numeric_limits<T>::max();
+            }
+
+            template<std::size_t Lanes, typename T>
+            void networkSort(T *data, std::size_t count) {
+                T lanes[Lanes];
+                std::copy(data, data + count, lanes);
+                std::fill(lanes + count, lanes + Lanes, padding<T>());
+                BitonicNetwork<T, Lanes>::apply(lanes);
+                std::copy(lanes, lanes + count, data);
+            }
+        }// namespace detail
+
+        // Stable ascending sort by keyOf(element) with a scratch buffer allocated for the call
+        template<typename T, typename KeyOf = IdentityKey,
+                 typename = typename std::enable_if<! std::is_base_of<FixedVector<T>, KeyOf>::value>::type>
+        void radix_sort(FixedVector<T> &vector, KeyOf keyOf = KeyOf()) {
+            const std::size_t count = vector.size();
+            if (count < 2) {
+                return;
+            }
+            std::unique_ptr<T[]> scratch(new T[count]);
+            detail::radixSort(vector.begin(), count, scratch.get(), keyOf);
+        }
+
+        // Same, with the caller's scratch - its capacity must fit the elements, its contents are overwritten
+        template<typename T, typename KeyOf = IdentityKey>
+        void radix_sort(FixedVector<T> &vector, FixedVector<T> &scratch, KeyOf keyOf = KeyOf()) {
+            if (&scratch == &vector) {
+                throw std::invalid_argument("Radix sort scratch must be another vector");
+            }
+            if (scratch.capacity() < vector.size()) {
+                throw std::out_of_range("Radix sort scratch too small");
+            }
+            scratch.clear();
+            detail::radixSort(vector.begin(), vector.size(), scratch.begin(), keyOf);
+        }
+
+        // Ascending sort of at most kNetworkMax arithmetic elements
+        template<typename T>
+        void network_sort(FixedVector<T> &vector) {
+            static_assert(std::is_arithmetic<T>::value, "network_sort needs an arithmetic element type");
+            const std::size_t count = vector.size();
+            T *data = vector.begin();
+            if (count <= 1) {
+                return;
+            } else if (count <= 2) {
+                detail::networkSort<2>(data, count);
+            } else if (count <= 4) {
+                detail::networkSort<4>(data, count);
+            } else if (count <= 8) {
+                detail::networkSort<8>(data, count);
+            } else if (count <= 16) {
+                detail::networkSort<16>(data, count);
+            } else if (count <= 32) {
+                detail::networkSort<32>(data, count);
+            } else if (count <= kNetworkMax) {
+                detail::networkSort<kNetworkMax>(data, count);
+            } else {
+                throw std::out_of_range("Sorting network holds at most 64 elements");
+            }
+        }
+
+        namespace detail {
+            template<typename T>
+            void dispatchSort(FixedVector<T> &vector, FixedVector<T> *scratch, std::true_type) {
+                const std::size_t count = vector.size();
+                if (count >= kRadixMin) {
+                    if (scratch) {
+                        radix_sort(vector, *scratch);
+                    } else {
+                        radix_sort(vector);
+                    }
+                } else if (count <= kNetworkSortMax) {
+                    network_sort(vector);
+                } else {
+                    std::sort(vector.begin(), vector.end());
+                }
+            }
+
+            template<typename T>
+            void dispatchSort(FixedVector<T> &vector, FixedVector<T> *, std::false_type) {
+                std::sort(vector.begin(), vector.end());
+            }
+
+            // Keys RadixBits maps - long double and bool are left to std::sort
+            template<typename T>
+            using Radixable =
+                    std::integral_constant<bool, (std::is_integral<T>::value && ! std::is_same<T, bool>::value) ||
+                                                         (std::is_floating_point<T>::value && sizeof(T) <= 8)>;
+        }// namespace detail
+
+        // Ascending sort, by radix sort, sorting network or std::sort - see above
+        template<typename T>
+        void sort(FixedVector<T> &vector) {
+            detail::dispatchSort(vector, static_cast<FixedVector<T> *>(nullptr), detail::Radixable<T>());
+        }
+
+        // Same, with the caller's scratch for a radix sort
+        template<typename T>
+        void sort(FixedVector<T> &vector, FixedVector<T> &scratch) {
+            detail::dispatchSort(vector, &scratch, detail::Radixable<T>());
+        }
+    }// namespace sorting
+}// namespace ESTL
+
+#endif//ESTL_SORT_HPP
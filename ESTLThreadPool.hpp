@@ -0,0 +1,404 @@
+//
+// Work-stealing thread pool for the parallel algorithms and bulk builds - fixed storage, no allocation per task.
+//
+
+#ifndef ESTL_THREADPOOL_HPP
+#define ESTL_THREADPOOL_HPP
+#pragma once
+
+#include "FixedDeque.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace ESTL {
+    /** Work stealing
+    Every worker owns a WorkStealingDeque of tasks: it pushes and pops at the bottom, LIFO, so it keeps working on the
+    data it just split; idle workers steal from the top, FIFO, which takes the oldest - largest - pieces. Owner pushes
+    and pops touch no shared cache line unless the deque is nearly empty, steals take one CAS.
+    The deques are bounded (Chase-Lev without the growable array): a push onto a full deque fails and the task runs
+    inline instead, which only coarsens the split. Tasks live in storage of the job that spawns them - parallelFor
+    keeps a fixed array of task slots in its own frame - so the pool allocates nothing after construction.
+    The calling thread takes part: parallelFor runs the first piece itself and then helps by stealing until the job is
+    done, so a pool of N workers runs N + 1 threads and a pool of 0 workers runs everything on the caller. A task may
+    start a nested parallelFor; its worker keeps running tasks while it waits, so nesting does not deadlock.
+     * */
+    template<typename T, std::size_t Capacity>
+    class WorkStealingDeque {
+        static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "WorkStealingDeque capacity is a power of 2");
+        static_assert(std::is_trivially_copyable<T>::value, "WorkStealingDeque holds trivially copyable items");
+
+        static constexpr std::size_t kCacheLine = 64;
+        static constexpr std::int64_t kMask = static_cast<std::int64_t>(Capacity) - 1;
+
+        // top is written by thieves, bottom by the owner - kept on separate cache lines
+        std::atomic<std::int64_t> m_top;
+        char m_topPad[kCacheLine - sizeof(std::atomic<std::int64_t>)];
+        std::atomic<std::int64_t> m_bottom;
+        char m_bottomPad[kCacheLine - sizeof(std::atomic<std::int64_t>)];
+        std::array<std::atomic<T>, Capacity> m_items;
+
+    public:
+        WorkStealingDeque()
+            : m_top(0)
+            , m_bottom(0) {}
+
+        WorkStealingDeque(const WorkStealingDeque &) = delete;
+        WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+
+        // Owner only - false when the deque is full
+        bool push(T item) {
+            const std::int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+            const std::int64_t top = m_top.load(std::memory_order_acquire);
+            if (bottom - top >= static_cast<std::int64_t>(Capacity)) {
+                return false;
+            }
+            m_items[bottom & kMask].store(item, std::memory_order_relaxed);
+            // Publishes the item, and whatever it points to, to the thieves' acquire load of bottom
+            m_bottom.store(bottom + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Owner only - the most recently pushed item, false when empty or a thief took the last one
+        bool pop(T &item) {
+            const std::int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+            m_bottom.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            std::int64_t top = m_top.load(std::memory_order_relaxed);
+            if (top > bottom) {
+                m_bottom.store(bottom + 1, std::memory_order_relaxed);
+                return false;
+            }
+            item = m_items[bottom & kMask].load(std::memory_order_relaxed);
+            if (top < bottom) {
+                return true;
+            }
+            // Last item - race the thieves for it
+            const bool won = m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                                           std::memory_order_relaxed);
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return won;
+        }
+
+        // Any thread - the oldest item, false when empty or another thread got it first
+        bool steal(T &item) {
+            std::int64_t top = m_top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const std::int64_t bottom = m_bottom.load(std::memory_order_acquire);
+            if (top >= bottom) {
+                return false;
+            }
+            item = m_items[top & kMask].load(std::memory_order_relaxed);
+            return m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        }
+
+        // Snapshot, exact only when no other thread is using the deque
+        std::size_t size() const {
+            const std::int64_t count = m_bottom.load(std::memory_order_relaxed) - m_top.load(std::memory_order_relaxed);
+            return count > 0 ? static_cast<std::size_t>(count) : 0;
+        }
+
+        bool empty() const { return size() == 0; }
+        static constexpr std::size_t capacity() { return Capacity; }
+    };
+
+    class ThreadPool {
+    public:
+        // A unit of work. Its storage belongs to whoever spawns it and must outlive the run - the pool never copies,
+        // allocates or frees a task.
+        struct Task {
+            virtual void run() = 0;
+
+        protected:
+            ~Task() = default;
+        };
+
+        static constexpr std::size_t kDequeCapacity = 1024;
+        static constexpr std::size_t kInjectCapacity = 256;
+        static constexpr std::size_t kTaskSlots = 256;// Pieces one parallelFor can split into
+
+    private:
+        struct Worker {
+            ThreadPool *pool;
+            std::size_t index;
+            WorkStealingDeque<Task *, kDequeCapacity> deque;
+            std::thread thread;
+        };
+
+        std::vector<std::unique_ptr<Worker>> m_workers;
+        // Tasks spawned by threads outside the pool
+        CTDeque<Task *, kInjectCapacity> m_injected;
+        std::atomic<std::size_t> m_injectedCount;
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::atomic<unsigned> m_sleepers;
+        std::atomic<bool> m_stop;
+
+        // The worker running on this thread, nullptr outside every pool
+        static Worker *&currentWorker() {
+            static thread_local Worker *worker = nullptr;
+            return worker;
+        }
+
+        Worker *ownWorker() const {
+            Worker *worker = currentWorker();
+            return worker && worker->pool == this ? worker : nullptr;
+        }
+
+        bool takeInjected(Task *&task) {
+            if (m_injectedCount.load(std::memory_order_acquire) == 0) {
+                return false;
+            }
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_injected.empty()) {
+                return false;
+            }
+            task = m_injected.front();
+            m_injected.pop_front();
+            m_injectedCount.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        // Own deque first, then the injected tasks, then the other workers' deques
+        bool findTask(Worker *self, Task *&task) {
+            if (self && self->deque.pop(task)) {
+                return true;
+            }
+            if (takeInjected(task)) {
+                return true;
+            }
+            const std::size_t count = m_workers.size();
+            const std::size_t start = self ? self->index + 1 : 0;
+            for (std::size_t i = 0; i < count; ++i) {
+                Worker &victim = *m_workers[(start + i) % count];
+                if (&victim != self && victim.deque.steal(task)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool workVisible() const {
+            if (m_injectedCount.load(std::memory_order_relaxed)) {
+                return true;
+            }
+            for (const auto &worker: m_workers) {
+                if (! worker->deque.empty()) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void workerLoop(Worker *self) {
+            currentWorker() = self;
+            unsigned idleRounds = 0;
+            while (! m_stop.load(std::memory_order_acquire)) {
+                Task *task;
+                if (findTask(self, task)) {
+                    task->run();
+                    idleRounds = 0;
+                    continue;
+                }
+                if (++idleRounds < 64) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                // The timeout bounds the wait when a push races the sleeper count
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_sleepers.fetch_add(1);
+                if (! m_stop.load() && ! workVisible()) {
+                    m_wake.wait_for(lock, std::chrono::milliseconds(2));
+                }
+                m_sleepers.fetch_sub(1);
+                idleRounds = 0;
+            }
+            currentWorker() = nullptr;
+        }
+
+        template<typename Body>
+        struct ForJob;
+
+        // One piece of a parallelFor range - splits off halves until it is one grain, then runs the body
+        template<typename Body>
+        struct RangeTask : Task {
+            ForJob<Body> *job;
+            std::size_t begin;
+            std::size_t end;
+
+            void run() override { job->execute(begin, end); }
+        };
+
+        template<typename Body>
+        struct ForJob {
+            ThreadPool *pool;
+            Body *body;
+            std::size_t grain;
+            std::array<RangeTask<Body>, kTaskSlots> slots;
+            std::atomic<std::size_t> nextSlot;
+            std::atomic<std::size_t> pending;// Pieces not finished yet, the caller's included
+            std::atomic<bool> failed;
+            std::exception_ptr error;// Written by the first piece that throws
+
+            void execute(std::size_t begin, std::size_t end) {
+                try {
+                    while (end - begin > grain && ! failed.load(std::memory_order_relaxed)) {
+                        const std::size_t slot = nextSlot.fetch_add(1, std::memory_order_relaxed);
+                        if (slot >= kTaskSlots) {
+                            break;
+                        }
+                        const std::size_t middle = begin + (end - begin) / 2;
+                        RangeTask<Body> &half = slots[slot];
+                        half.job = this;
+                        half.begin = middle;
+                        half.end = end;
+                        pending.fetch_add(1, std::memory_order_relaxed);
+                        pool->spawn(&half);
+                        end = middle;
+                    }
+                    if (! failed.load(std::memory_order_relaxed)) {
+                        (*body)(begin, end);
+                    }
+                } catch (...) {
+                    if (! failed.exchange(true)) {
+                        error = std::current_exception();
+                    }
+                }
+                pending.fetch_sub(1, std::memory_order_release);
+            }
+        };
+
+    public:
+        // Workers besides the calling thread - one per further hardware thread
+        static unsigned defaultWorkers() {
+            const unsigned threads = std::thread::hardware_concurrency();
+            return threads > 1 ? threads - 1 : 0;
+        }
+
+        explicit ThreadPool(unsigned workers = defaultWorkers())
+            : m_injectedCount(0)
+            , m_sleepers(0)
+            , m_stop(false) {
+            for (unsigned i = 0; i < workers; ++i) {
+                m_workers.emplace_back(new Worker());
+                m_workers.back()->pool = this;
+                m_workers.back()->index = i;
+            }
+            for (auto &worker: m_workers) {
+                Worker *self = worker.get();
+                worker->thread = std::thread([this, self] { workerLoop(self); });
+            }
+        }
+
+        // Waits for the workers - no job may be running
+        ~ThreadPool() {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop.store(true, std::memory_order_release);
+            }
+            m_wake.notify_all();
+            for (auto &worker: m_workers) {
+                worker->thread.join();
+            }
+        }
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        // The process-wide pool the parallel algorithms use by default, started on first use
+        static ThreadPool &shared() {
+            static ThreadPool pool;
+            return pool;
+        }
+
+        unsigned workerCount() const { return static_cast<unsigned>(m_workers.size()); }
+
+        // Threads a job runs on - the workers and the caller
+        unsigned concurrency() const { return workerCount() + 1; }
+
+        /**
+         * Queues task for any thread of the pool. From a worker it goes onto the worker's own deque; from another
+         * thread onto the shared injection queue. When that queue is full the task runs inline, on the caller.
+         */
+        void spawn(Task *task) {
+            Worker *self = ownWorker();
+            if (self) {
+                if (! self->deque.push(task)) {
+                    task->run();
+                    return;
+                }
+            } else {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                if (m_injected.full() || m_workers.empty()) {
+                    lock.unlock();
+                    task->run();
+                    return;
+                }
+                m_injected.push_back(task);
+                m_injectedCount.fetch_add(1, std::memory_order_release);
+            }
+            if (m_sleepers.load()) {
+                m_wake.notify_one();
+            }
+        }
+
+        // Runs queued tasks on the calling thread until done() holds
+        template<typename Done>
+        void helpUntil(Done done) {
+            Worker *self = ownWorker();
+            while (! done()) {
+                Task *task;
+                if (findTask(self, task)) {
+                    task->run();
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        /**
+         * Calls body(pieceBegin, pieceEnd) over disjoint pieces covering [begin, end), in parallel, and returns once
+         * all of them ran. The first exception thrown by body is rethrown here, after the other pieces finished;
+         * pieces not started by then are skipped.
+         * @param grain Largest piece that is not split further, 0 to cut the range into about 8 pieces per thread.
+         */
+        template<typename Body>
+        void parallelFor(std::size_t begin, std::size_t end, std::size_t grain, Body body) {
+            if (begin >= end) {
+                return;
+            }
+            const std::size_t count = end - begin;
+            if (grain == 0) {
+                grain = std::max<std::size_t>(1, count / (8 * concurrency()));
+            }
+            if (m_workers.empty() || count <= grain) {
+                body(begin, end);
+                return;
+            }
+            ForJob<Body> job;
+            job.pool = this;
+            job.body = &body;
+            job.grain = grain;
+            job.nextSlot.store(0, std::memory_order_relaxed);
+            job.pending.store(1, std::memory_order_relaxed);
+            job.failed.store(false, std::memory_order_relaxed);
+            job.execute(begin, end);
+            helpUntil([&job] { return job.pending.load(std::memory_order_acquire) == 0; });
+            if (job.error) {
+                std::rethrow_exception(job.error);
+            }
+        }
+    };
+}// namespace ESTL
+
+#endif//ESTL_THREADPOOL_HPP
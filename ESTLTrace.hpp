@@ -0,0 +1,371 @@
+//
+// Operation tracing of the fixed containers - per-thread event rings and Chrome trace / perf script dumpers.
+//
+
+#ifndef ESTL_TRACE_HPP
+#define ESTL_TRACE_HPP
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#ifndef ESTL_ENABLE_TRACING
+#define ESTL_ENABLE_TRACING false
+#endif
+
+// The rings, clocks and dumpers are only compiled with tracing - without it this header pulls in no platform headers
+#if ESTL_ENABLE_TRACING
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#endif
+
+// Events kept per thread - the oldest are overwritten, must be a power of two
+#ifndef ESTL_TRACE_RING_EVENTS
+#define ESTL_TRACE_RING_EVENTS 16384
+#endif
+
+// Rings of exited threads kept for the dumpers - past this many, a new thread reuses the oldest one
+#ifndef ESTL_TRACE_RETIRED_RINGS
+#define ESTL_TRACE_RETIRED_RINGS 64
+#endif
+
+// Statement compiled only when tracing is enabled - the containers' trace spans
+#if ESTL_ENABLE_TRACING
+#define ESTL_TRACE(statement) statement
+#else
+#define ESTL_TRACE(statement)
+#endif
+
+namespace ESTL {
+    /** Tracing
+    With ESTL_ENABLE_TRACING true (CMake option ESTL_ENABLE_TRACING) the containers time their mutating and lookup
+    operations and hand one TraceEvent per call to the hook policy ESTL_TRACE_HOOK. Without it the spans are not
+    compiled at all. The default hook, trace::RingBufferHook, appends to a ring owned by the calling thread - no lock
+    and no shared cache line on the hot path; the ring is registered once, on the thread's first event.
+    To route events elsewhere define ESTL_TRACE_HOOK, before including any ESTL header, as a type with a static
+    record(const ESTL::TraceEvent &) member.
+    Durations are in cycles (rdtsc on x86, nanoseconds elsewhere) and cover the operation under the container lock -
+    lock waits are reported by metrics(). size is the container size when the operation started; probes counts the
+    buckets an unordered map operation visited.
+    writeChromeTrace() and writePerfScript() dump the rings of every thread that traced, threads that have exited
+    included. Dump while the traced threads are quiet: events overwritten during the dump are dropped, but one
+    being written at that moment may be torn.
+    A ring is retired when its thread exits. clear() frees the retired rings, and at most ESTL_TRACE_RETIRED_RINGS of
+    them are kept in between - a thread registering past that reuses the oldest, dropping its events - so a process
+    that keeps starting threads holds rings for its live threads plus that many.
+     * */
+    enum class TraceKind : std::uint8_t { Vector, List, UnorderedMap, OrderedMap };
+
+    enum class TraceOp : std::uint8_t {
+        Insert,
+        InsertOrAssign,
+        Find,
+        Erase,
+        Clear,
+        PushBack,
+        PushFront,
+        PopBack,
+        PopFront
+    };
+
+    struct TraceEvent {
+        std::uint64_t startCycles;
+        std::uint64_t durationCycles;
+        const void *container;
+        std::uint64_t size;
+        std::uint32_t probes;
+        std::uint32_t thread;// Kernel thread id, filled in by the dumpers
+        TraceKind kind;
+        TraceOp op;
+    };
+}// namespace ESTL
+
+#if ESTL_ENABLE_TRACING
+namespace ESTL {
+    namespace trace {
+        inline const char *name(TraceKind kind) {
+            static const char *const names[] = {"FixedVector", "FixedList", "FixedUnorderedMap", "FixedMap"};
+            return names[static_cast<std::size_t>(kind)];
+        }
+
+        inline const char *name(TraceOp op) {
+            static const char *const names[] = {"insert", "insert_or_assign", "find", "erase", "clear",
+                                                "push_back", "push_front", "pop_back", "pop_front"};
+            return names[static_cast<std::size_t>(op)];
+        }
+
+        inline std::uint64_t cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+            return __rdtsc();
+#else
+            return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+        }
+
+        // Kernel thread id on Linux, a hash of the thread id elsewhere
+        inline std::uint32_t threadId() {
+#if defined(__linux__)
+            return static_cast<std::uint32_t>(syscall(SYS_gettid));
+#else
+            return static_cast<std::uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id()));
+#endif
+        }
+
+        // Single-writer ring of the events of one thread
+        class ThreadRing {
+            static_assert((ESTL_TRACE_RING_EVENTS & (ESTL_TRACE_RING_EVENTS - 1)) == 0,
+                          "ESTL_TRACE_RING_EVENTS must be a power of two");
+
+        public:
+            static constexpr std::size_t Capacity = ESTL_TRACE_RING_EVENTS;
+
+            explicit ThreadRing(std::uint32_t thread) : m_thread(thread) {}
+
+            // Hands a retired ring to a new thread, dropping the old thread's events
+            void reuse(std::uint32_t thread) {
+                m_thread = thread;
+                m_written.store(0, std::memory_order_relaxed);
+                m_retired.store(false, std::memory_order_relaxed);
+            }
+
+            // Called by the owning thread on exit - its events stay until the ring is freed or reused
+            void retire() { m_retired.store(true, std::memory_order_release); }
+            bool retired() const { return m_retired.load(std::memory_order_acquire); }
+
+            void push(const TraceEvent &event) {
+                std::uint64_t index = m_written.load(std::memory_order_relaxed);
+                m_events[index & (Capacity - 1)] = event;
+                m_written.store(index + 1, std::memory_order_release);
+            }
+
+            // Appends the events still in the ring, oldest first
+            void copyTo(std::vector<TraceEvent> &events) const {
+                std::uint64_t end = m_written.load(std::memory_order_acquire);
+                std::uint64_t begin = end > Capacity ? end - Capacity : 0;
+                std::size_t first = events.size();
+                for (std::uint64_t i = begin; i < end; ++i) {
+                    events.push_back(m_events[i & (Capacity - 1)]);
+                    events.back().thread = m_thread;
+                }
+                // Drop what the owner overwrote while we copied
+                std::uint64_t now = m_written.load(std::memory_order_acquire);
+                std::uint64_t valid = now > Capacity ? now - Capacity : 0;
+                if (valid > begin) {
+                    std::size_t stale = static_cast<std::size_t>(std::min(valid - begin, end - begin));
+                    events.erase(events.begin() + first, events.begin() + first + stale);
+                }
+            }
+
+            void clear() { m_written.store(0, std::memory_order_release); }
+
+        private:
+            std::uint32_t m_thread;
+            std::atomic<std::uint64_t> m_written{0};
+            std::atomic<bool> m_retired{false};
+            TraceEvent m_events[Capacity];
+        };
+
+        // Rings of every thread that traced, and the clock pair that converts cycles to time
+        class Registry {
+            std::mutex m_mutex;
+            std::vector<std::unique_ptr<ThreadRing>> m_rings;
+            std::uint64_t m_startCycles;
+            std::chrono::steady_clock::time_point m_startTime;
+
+        public:
+            Registry()
+                : m_startCycles(cycles())
+                , m_startTime(std::chrono::steady_clock::now()) {}
+
+            static Registry &instance() {
+                static Registry registry;
+                return registry;
+            }
+
+            ThreadRing *add(std::uint32_t thread) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                ThreadRing *oldestRetired = nullptr;
+                std::size_t retired = 0;
+                for (const auto &ring: m_rings) {
+                    if (ring->retired()) {
+                        oldestRetired = oldestRetired ? oldestRetired : ring.get();
+                        ++retired;
+                    }
+                }
+                if (retired >= ESTL_TRACE_RETIRED_RINGS && oldestRetired) {
+                    oldestRetired->reuse(thread);
+                    return oldestRetired;
+                }
+                m_rings.emplace_back(new ThreadRing(thread));
+                return m_rings.back().get();
+            }
+
+            // Every retained event ordered by start time
+            std::vector<TraceEvent> collect() {
+                std::vector<TraceEvent> events;
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    for (const auto &ring: m_rings) {
+                        ring->copyTo(events);
+                    }
+                }
+                std::sort(events.begin(), events.end(), [](const TraceEvent &a, const TraceEvent &b) {
+                    return a.startCycles < b.startCycles;
+                });
+                return events;
+            }
+
+            // Drops every event and frees the rings of exited threads
+            void clear() {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_rings.erase(std::remove_if(m_rings.begin(), m_rings.end(),
+                                             [](const std::unique_ptr<ThreadRing> &ring) { return ring->retired(); }),
+                              m_rings.end());
+                for (const auto &ring: m_rings) {
+                    ring->clear();
+                }
+            }
+
+            // Rings held, of live and exited threads
+            std::size_t rings() {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                return m_rings.size();
+            }
+
+            // Cycles from the registry's creation - negative for an event that began just before it
+            std::int64_t sinceStart(std::uint64_t cycles) const {
+                return static_cast<std::int64_t>(cycles - m_startCycles);
+            }
+
+            // Measured over the time since the registry was created - dump a while after the first event
+            double cyclesPerNanosecond() const {
+                double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() -
+                                                                          m_startTime).count();
+                double ratio = elapsed > 0 ? double(cycles() - m_startCycles) / elapsed : 1;
+                return ratio > 0 ? ratio : 1;
+            }
+        };
+
+        // Registers the thread's ring on its first event and retires it when the thread exits
+        class RingOwner {
+            ThreadRing *m_ring;
+
+        public:
+            RingOwner()
+                : m_ring(Registry::instance().add(threadId())) {}
+
+            RingOwner(const RingOwner &) = delete;
+            RingOwner &operator=(const RingOwner &) = delete;
+
+            ~RingOwner() { m_ring->retire(); }
+
+            ThreadRing &ring() const { return *m_ring; }
+        };
+
+        inline ThreadRing &localRing() {
+            thread_local RingOwner owner;
+            return owner.ring();
+        }
+
+        // Default hook policy - the calling thread's ring
+        struct RingBufferHook {
+            static void record(const TraceEvent &event) { localRing().push(event); }
+        };
+    }// namespace trace
+}// namespace ESTL
+
+#ifndef ESTL_TRACE_HOOK
+#define ESTL_TRACE_HOOK ESTL::trace::RingBufferHook
+#endif
+
+namespace ESTL {
+    namespace trace {
+        // Times one container operation and records it through the hook when it goes out of scope
+        class Span {
+            TraceEvent m_event;
+
+        public:
+            std::uint32_t probes = 0;
+
+            Span(TraceKind kind, TraceOp op, const void *container, std::size_t size) {
+                m_event.container = container;
+                m_event.size = size;
+                m_event.thread = 0;
+                m_event.kind = kind;
+                m_event.op = op;
+                m_event.startCycles = cycles();
+            }
+
+            Span(const Span &) = delete;
+            Span &operator=(const Span &) = delete;
+
+            ~Span() {
+                m_event.durationCycles = cycles() - m_event.startCycles;
+                m_event.probes = probes;
+                ESTL_TRACE_HOOK::record(m_event);
+            }
+        };
+
+        // Drops every recorded event and frees the rings of exited threads
+        inline void clear() { Registry::instance().clear(); }
+
+        // Retained events of all threads, ordered by start time
+        inline std::vector<TraceEvent> collect() { return Registry::instance().collect(); }
+
+        // Chrome trace event format (chrome://tracing, Perfetto) - one complete event per operation
+        inline void writeChromeTrace(std::ostream &out) {
+            Registry &registry = Registry::instance();
+            const double perNs = registry.cyclesPerNanosecond();
+            const int pid = static_cast<int>(getpid());
+            out << "{\"traceEvents\":[";
+            bool first = true;
+            for (const TraceEvent &event: registry.collect()) {
+                double start = double(registry.sinceStart(event.startCycles)) / perNs / 1000.0;
+                double duration = double(event.durationCycles) / perNs / 1000.0;
+                out << (first ? "\n" : ",\n") << "{\"name\":\"" << name(event.op) << "\",\"cat\":\""
+                    << name(event.kind) << "\",\"ph\":\"X\",\"ts\":" << start << ",\"dur\":" << duration
+                    << ",\"pid\":" << pid << ",\"tid\":" << event.thread << ",\"args\":{\"container\":\""
+                    << event.container << "\",\"size\":" << event.size << ",\"probes\":" << event.probes
+                    << ",\"cycles\":" << event.durationCycles << "}}";
+                first = false;
+            }
+            out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+        }
+
+        // perf script text layout, for tools that consume `perf script` output
+        inline void writePerfScript(std::ostream &out) {
+            Registry &registry = Registry::instance();
+            const double perNs = registry.cyclesPerNanosecond();
+            const auto flags = out.flags();
+            const auto precision = out.precision();
+            out.setf(std::ios::fixed);
+            out.precision(9);
+            for (const TraceEvent &event: registry.collect()) {
+                double seconds = double(registry.sinceStart(event.startCycles)) / perNs / 1e9;
+                out << "estl " << event.thread << " [000] " << seconds << ": estl:" << name(event.op) << ": "
+                    << name(event.kind) << " container=" << event.container << " size=" << event.size
+                    << " probes=" << event.probes << " cycles=" << event.durationCycles << '\n';
+            }
+            out.flags(flags);
+            out.precision(precision);
+        }
+    }// namespace trace
+}// namespace ESTL
+#endif
+
+#endif//ESTL_TRACE_HPP
@@ -5,6 +5,9 @@
 #ifndef ESTLUTILS_HPP
 #define ESTLUTILS_HPP
 
+#include <new>
+#include <utility>
+
 #define WARN_IF(condition, message) \
 do { \
 if (condition) { \
@@ -12,4 +15,50 @@ __attribute__((warning(message))) int dummy; \
 } \
 } while (0)
 
+/** Constexpr build mode
+With ESTL_CONSTEXPR_CONTAINERS defined true in a C++20 build, CTVector, CTList and the unordered CTMap are literal
+types: they can be constructed, filled and queried in constant expressions, and a constexpr container is emitted
+fully built into the binary - no startup initialization. Keys of a constexpr CTMap need a constexpr hash, std::hash
+is not one - see ConstexprHash.
+A constexpr container is immutable, so the mode compiles without the container locks, metrics counters and trace
+spans, none of which can run in a constant expression - define ENABLE_THREAD_SAFETY as 0. The containers point
+into their own storage, so a constexpr container must have static storage duration: a namespace-scope or static
+constexpr variable. Without the mode ESTL_CONSTEXPR expands to nothing and the containers are unchanged. The
+ConstexprTests target builds tests/constexpr in this mode.
+ * */
+#ifndef ESTL_CONSTEXPR_CONTAINERS
+#define ESTL_CONSTEXPR_CONTAINERS false
+#endif
+
+#if ESTL_CONSTEXPR_CONTAINERS
+#if __cplusplus < 202002L
+#error "ESTL_CONSTEXPR_CONTAINERS needs C++20"
+#endif
+#if ! defined(ENABLE_THREAD_SAFETY) || ENABLE_THREAD_SAFETY || ESTL_ENABLE_METRICS || ESTL_ENABLE_TRACING
+#error "ESTL_CONSTEXPR_CONTAINERS needs ENABLE_THREAD_SAFETY defined as 0, and metrics and tracing off"
+#endif
+#include <memory>
+#define ESTL_CONSTEXPR constexpr
+#else
+#define ESTL_CONSTEXPR
+#endif
+
+namespace ESTL {
+    // Constructor tag of the container bases: the storage is an array member of the derived CT container, not
+    // constructed yet when the base is - the derived constructor initializes it
+    struct InlineStorage {};
+
+    namespace detail {
+        // Placement construction - std::construct_at in the constexpr mode, the form constant evaluation accepts
+        template<typename T, typename... Args>
+        ESTL_CONSTEXPR void constructAt(T *location, Args &&...args) {
+#if ESTL_CONSTEXPR_CONTAINERS
+            std::construct_at(location, std::forward<Args>(args)...);
+#else
+            ::new (static_cast<void *>(location)) T(std::forward<Args>(args)...);
+#endif
+        }
+    }// namespace detail
+}// namespace ESTL
+
 #endif //ESTLUTILS_HPP
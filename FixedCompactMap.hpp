@@ -0,0 +1,507 @@
+//
+// Insertion-ordered hash map - dense entry array plus a small-integer index table.
+//
+
+#ifndef ESTL_FIXEDCOMPACTMAP_HPP
+#define ESTL_FIXEDCOMPACTMAP_HPP
+#pragma once
+
+#include "ESTLMemory.hpp"
+#include "ESTLMetrics.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#ifndef ENABLE_THREAD_SAFETY
+#define ENABLE_THREAD_SAFETY true
+#endif
+
+namespace ESTL {
+    /**
+     * @brief Key and value of a compact map entry, in raw storage.
+     *
+     * Constructed when the entry is appended and destroyed when it is erased or cleared, so tombstones and unused
+     * entries hold no objects and neither Key nor Value has to be default-constructible.
+     */
+    template<typename Key, typename Value>
+    struct CompactMapEntry {
+        union {
+            Key key;
+        };
+        union {
+            Value value;
+        };
+
+        CompactMapEntry() {}
+        ~CompactMapEntry() {}
+
+        template<typename K, typename V>
+        void construct(K &&newKey, V &&newValue) {
+            new (&key) Key(std::forward<K>(newKey));
+            try {
+                new (&value) Value(std::forward<V>(newValue));
+            } catch (...) {
+                key.~Key();
+                throw;
+            }
+        }
+
+        void destroy() {
+            key.~Key();
+            value.~Value();
+        }
+    };
+
+    /** Compact map layout
+    Entries live in one array in insertion order; a separate table of slots, a power of two at least twice the
+    capacity, maps hashes to entry positions with linear probing. A slot holds entry index + 1 (0: empty), so with
+    the 16-bit index of small CTCompactMaps a slot costs 2 bytes:
+        slots    [ 0 | 3 | 0 | 1 | 2 | 0 | 0 | 0 ]      probe from hash, compare entries[slot - 1].key
+        entries  [ a:1 | b:2 | c:3 | ---- ]           insertion order, iterated like an array
+        live     1 1 1 0                              one bit per entry
+    Compared with FixedUnorderedMap, which keeps capacity + pool Buckets of Key, Value, a flag and a next pointer,
+    an entry here is just Key and Value, plus 1 bit and 4 to 8 bytes of slots (2 to 4 with 16-bit indices).
+    erase() leaves a tombstone (a cleared live bit) so the order of the other entries holds, and removes the slot with
+    backward-shift deletion, so probe sequences never grow with churn. When an insert finds the entry array used up
+    and tombstones in it, the live entries are compacted to the front in order and the slots rebuilt - O(capacity),
+    amortized over the erases that made the room. A map kept within a few entries of its capacity under churn
+    compacts often; size it with some headroom.
+    Keys are rehashed when slots move and on compaction, so Hash should be cheap. Its result is mixed before use, so
+    identity hashes of sequential or strided integers spread well.
+     * */
+    template<typename Key, typename Value, typename Hash = std::hash<Key>, typename Index = std::uint32_t>
+    class FixedCompactMap {
+        static_assert(std::is_unsigned<Index>::value, "Index must be an unsigned integer type");
+
+    protected:
+        using Entry = CompactMapEntry<Key, Value>;
+
+        static constexpr std::size_t slotCount(std::size_t capacity) {
+            std::size_t slots = 2;
+            while (slots < 2 * capacity) {
+                slots *= 2;
+            }
+            return slots;
+        }
+
+        static constexpr std::size_t liveWords(std::size_t capacity) { return (capacity + 63) / 64; }
+
+        Entry *m_entries;
+        Index *m_slots;
+        std::uint64_t *m_live;// Bit i: entry i is not erased
+        Hash m_hasher;
+        std::size_t m_capacity;
+        std::size_t m_slotMask;
+        unsigned m_shift;  // 64 - log2(slots), for the multiplicative mix
+        std::size_t m_size;// Live entries
+        std::size_t m_end; // Entries used, tombstones included
+#if (ENABLE_THREAD_SAFETY)
+        mutable ContainerMutex m_mutex;
+#endif
+
+        bool isLive(std::size_t entry) const { return (m_live[entry / 64] >> (entry % 64)) & 1; }
+
+        std::size_t home(const Key &key) const {
+            return static_cast<std::size_t>((static_cast<std::uint64_t>(m_hasher(key)) * 0x9e3779b97f4a7c15ULL) >>
+                                            m_shift);
+        }
+
+        // Slot holding key, or the empty slot that ends its probe sequence
+        std::size_t probe(const Key &key) const {
+            std::size_t slot = home(key);
+            while (m_slots[slot] && ! (m_entries[m_slots[slot] - 1].key == key)) {
+                slot = (slot + 1) & m_slotMask;
+            }
+            return slot;
+        }
+
+        // Backward-shift deletion - pulls later entries of the run into the hole so no probe sequence is broken
+        void removeSlot(std::size_t hole) {
+            for (std::size_t slot = (hole + 1) & m_slotMask; m_slots[slot]; slot = (slot + 1) & m_slotMask) {
+                std::size_t desired = home(m_entries[m_slots[slot] - 1].key);
+                // Movable when the hole lies between its home and its slot
+                if (((slot - desired) & m_slotMask) >= ((slot - hole) & m_slotMask)) {
+                    m_slots[hole] = m_slots[slot];
+                    hole = slot;
+                }
+            }
+            m_slots[hole] = 0;
+        }
+
+        // Moves the live entries to the front, in order, and rebuilds the slots - the entries they leave are raw
+        void compact() {
+            std::size_t to = 0;
+            for (std::size_t from = 0; from < m_end; ++from) {
+                if (isLive(from)) {
+                    if (to != from) {
+                        m_entries[to].construct(std::move(m_entries[from].key), std::move(m_entries[from].value));
+                        m_entries[from].destroy();
+                    }
+                    ++to;
+                }
+            }
+            m_end = to;
+            std::fill(m_live, m_live + liveWords(m_capacity), 0);
+            for (std::size_t entry = 0; entry < m_end; ++entry) {
+                m_live[entry / 64] |= std::uint64_t(1) << (entry % 64);
+            }
+            std::fill(m_slots, m_slots + m_slotMask + 1, Index(0));
+            for (std::size_t entry = 0; entry < m_end; ++entry) {
+                std::size_t slot = home(m_entries[entry].key);
+                while (m_slots[slot]) {
+                    slot = (slot + 1) & m_slotMask;
+                }
+                m_slots[slot] = static_cast<Index>(entry + 1);
+            }
+        }
+
+        // Entry of key, appended with value if missing - returns {entry, inserted}
+        template<typename V>
+        std::pair<std::size_t, bool> emplaceUnlocked(const Key &key, V &&value) {
+            std::size_t slot = probe(key);
+            if (m_slots[slot]) {
+                return {std::size_t(m_slots[slot] - 1), false};
+            }
+            if (m_end == m_capacity) {
+                if (m_size == m_capacity) {
+                    throw std::out_of_range("FixedCompactMap is full");
+                }
+                compact();
+                slot = probe(key);
+            }
+            const std::size_t entry = m_end;
+            m_entries[entry].construct(key, std::forward<V>(value));// A throwing constructor leaves the map as it was
+            ++m_end;
+            m_live[entry / 64] |= std::uint64_t(1) << (entry % 64);
+            m_slots[slot] = static_cast<Index>(entry + 1);
+            ++m_size;
+            return {entry, true};
+        }
+
+        // Destroys the live entries - for clear() and the owners of the storage, before it goes
+        void releaseEntries() {
+            if (! std::is_trivially_destructible<Key>::value || ! std::is_trivially_destructible<Value>::value) {
+                for (std::size_t entry = 0; entry < m_end; ++entry) {
+                    if (isLive(entry)) {
+                        m_entries[entry].destroy();
+                    }
+                }
+            }
+            resetStorage();
+        }
+
+        void resetStorage() {
+            std::fill(m_slots, m_slots + m_slotMask + 1, Index(0));
+            std::fill(m_live, m_live + liveWords(m_capacity), 0);
+            m_size = 0;
+            m_end = 0;
+        }
+
+    public:
+        FixedCompactMap(Entry *entries, Index *slots, std::uint64_t *live, std::size_t capacity)
+            : m_entries(entries)
+            , m_slots(slots)
+            , m_live(live)
+            , m_capacity(capacity)
+            , m_slotMask(slotCount(capacity) - 1)
+            , m_shift(64)
+            , m_size(0)
+            , m_end(0) {
+            if (capacity >= std::numeric_limits<Index>::max()) {
+                throw std::invalid_argument("FixedCompactMap capacity exceeds its index type");
+            }
+            for (std::size_t slots = m_slotMask + 1; slots > 1; slots /= 2) {
+                --m_shift;
+            }
+            resetStorage();
+        }
+
+        FixedCompactMap(const FixedCompactMap &) = delete;
+        FixedCompactMap &operator=(const FixedCompactMap &) = delete;
+
+        bool insert(const Key &key, const Value &value) {
+#if (ENABLE_THREAD_SAFETY)
+            std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
+            return emplaceUnlocked(key, value).second;
+        }
+
+        // An assigned key keeps its place in the order
+        bool insert_or_assign(const Key &key, const Value &value) {
+#if (ENABLE_THREAD_SAFETY)
+            std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
+            std::pair<std::size_t, bool> result = emplaceUnlocked(key, value);
+            if (! result.second) {
+                m_entries[result.first].value = value;
+            }
+            return result.second;
+        }
+
+        Value *find(const Key &key) const {
+#if (ENABLE_THREAD_SAFETY)
+            std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
+            std::size_t slot = probe(key);
+            return m_slots[slot] ? &m_entries[m_slots[slot] - 1].value : nullptr;
+        }
+
+        bool contains(const Key &key) const { return find(key) != nullptr; }
+
+        // Inserts a default Value at the end of the order if key is missing
+        Value &operator[](const Key &key) {
+#if (ENABLE_THREAD_SAFETY)
+            std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
+            std::size_t slot = probe(key);
+            if (m_slots[slot]) {
+                return m_entries[m_slots[slot] - 1].value;
+            }
+            return m_entries[emplaceUnlocked(key, Value()).first].value;
+        }
+
+        bool erase(const Key &key) {
+#if (ENABLE_THREAD_SAFETY)
+            std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
+            std::size_t slot = probe(key);
+            if (! m_slots[slot]) {
+                return false;
+            }
+            const std::size_t entry = m_slots[slot] - 1;
+            removeSlot(slot);
+            m_entries[entry].destroy();
+            m_live[entry / 64] &= ~(std::uint64_t(1) << (entry % 64));
+            --m_size;
+            // Tombstones at the end are simply given back
+            while (m_end && ! isLive(m_end - 1)) {
+                --m_end;
+            }
+            return true;
+        }
+
+        void clear() {
+#if (ENABLE_THREAD_SAFETY)
+            std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
+            releaseEntries();
+        }
+
+        // Compacts now instead of on a later insert - e.g. before a latency-sensitive phase
+        void shrink_to_fit() {
+#if (ENABLE_THREAD_SAFETY)
+            std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
+            if (m_end != m_size) {
+                compact();
+            }
+        }
+
+        std::size_t size() const {
+#if (ENABLE_THREAD_SAFETY)
+            std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
+            return m_size;
+        }
+
+        bool empty() const { return size() == 0; }
+
+        std::size_t capacity() const { return m_capacity; }
+
+        // The entry array is the pool - poolInUse counts tombstones not yet compacted away
+        ContainerMetrics metrics() const {
+#if (ENABLE_THREAD_SAFETY)
+            std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
+            ContainerMetrics result;
+            result.size = m_size;
+            result.capacity = m_capacity;
+            result.loadFactor = m_capacity ? double(m_size) / m_capacity : 0;
+            result.poolCapacity = m_capacity;
+            result.poolInUse = m_end;
+#if ESTL_ENABLE_METRICS && (ENABLE_THREAD_SAFETY)
+            result.lockWait = m_mutex.histogram();
+#endif
+            return result;
+        }
+
+        // Visits every entry in insertion order as visit(const Key &, Value &), under the lock
+        template<typename Visitor>
+        void forEach(Visitor visit) {
+#if (ENABLE_THREAD_SAFETY)
+            std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
+            for (std::size_t entry = 0; entry < m_end; ++entry) {
+                if (isLive(entry)) {
+                    visit(static_cast<const Key &>(m_entries[entry].key), m_entries[entry].value);
+                }
+            }
+        }
+
+        // Walks the entry array in insertion order, stepping over tombstones
+        class Iterator {
+            Entry *m_entries;
+            const std::uint64_t *m_live;
+            std::size_t m_index;
+            std::size_t m_end;
+
+            void skipErased() {
+                while (m_index < m_end && ! ((m_live[m_index / 64] >> (m_index % 64)) & 1)) {
+                    ++m_index;
+                }
+            }
+
+        public:
+            using value_type = std::pair<const Key &, Value &>;
+            using difference_type = std::ptrdiff_t;
+            using pointer = value_type *;
+            using reference = value_type &;
+            using iterator_category = std::forward_iterator_tag;
+
+            Iterator(Entry *entries, const std::uint64_t *live, std::size_t index, std::size_t end)
+                : m_entries(entries)
+                , m_live(live)
+                , m_index(index)
+                , m_end(end) {
+                skipErased();
+            }
+
+            Iterator &operator++() {
+                ++m_index;
+                skipErased();
+                return *this;
+            }
+
+            Iterator operator++(int) {
+                Iterator temp = *this;
+                ++(*this);
+                return temp;
+            }
+
+            std::pair<const Key &, Value &> operator*() const {
+                if (m_index >= m_end) {
+                    throw std::runtime_error("Dereferencing invalid iterator");
+                }
+                return {m_entries[m_index].key, m_entries[m_index].value};
+            }
+
+            bool operator==(const Iterator &other) const { return m_index == other.m_index; }
+            bool operator!=(const Iterator &other) const { return ! (*this == other); }
+        };
+
+        Iterator begin() { return Iterator(m_entries, m_live, 0, m_end); }
+        Iterator end() { return Iterator(m_entries, m_live, m_end, m_end); }
+    };
+
+    // Narrowest slot type indexing N entries
+    template<std::size_t N>
+    using CompactMapIndex = typename std::conditional<(N < 0xffff), std::uint16_t, std::uint32_t>::type;
+
+    // Compile-time compact map - 16-bit slots below 65535 entries
+    template<typename Key, typename Value, std::size_t N, typename Hash = std::hash<Key>>
+    class CTCompactMap : public FixedCompactMap<Key, Value, Hash, CompactMapIndex<N>> {
+        using Base = FixedCompactMap<Key, Value, Hash, CompactMapIndex<N>>;
+
+        std::array<typename Base::Entry, N> m_entryBuffer;
+        std::array<CompactMapIndex<N>, Base::slotCount(N)> m_slotBuffer;
+        std::array<std::uint64_t, Base::liveWords(N)> m_liveBuffer;
+
+    public:
+        CTCompactMap()
+            : Base(m_entryBuffer.data(), m_slotBuffer.data(), m_liveBuffer.data(), N) {
+            this->resetStorage();
+        }
+
+        ~CTCompactMap() { this->releaseEntries(); }
+
+        CTCompactMap(std::initializer_list<std::pair<const Key, Value>> initList)
+            : CTCompactMap() {
+            for (const auto &item: initList) {
+                this->insert(item.first, item.second);
+            }
+        }
+    };
+
+    /**
+     * @brief Entry, slot and live-bit arrays of a run-time compact map.
+     *
+     * A base of RTCompactMap ahead of the map itself, so the arrays are released when an allocation or the map's
+     * constructor throws, and only after the map has destroyed its entries.
+     */
+    template<typename Entry>
+    class CompactMapStorage {
+    protected:
+        MemoryResource *m_resource;
+        Entry *m_entryArray;
+        std::uint32_t *m_slotArray;
+        std::uint64_t *m_liveArray;
+        std::size_t m_entryCount;
+        std::size_t m_slotCount;
+        std::size_t m_liveCount;
+
+        CompactMapStorage(MemoryResource *resource, std::size_t entries, std::size_t slots, std::size_t liveWords)
+            : m_resource(resource)
+            , m_entryArray(nullptr)
+            , m_slotArray(nullptr)
+            , m_liveArray(nullptr)
+            , m_entryCount(entries)
+            , m_slotCount(slots)
+            , m_liveCount(liveWords) {
+            try {
+                m_entryArray = memory::createArray<Entry>(resource, entries);
+                m_slotArray = memory::createArray<std::uint32_t>(resource, slots);
+                m_liveArray = memory::createArray<std::uint64_t>(resource, liveWords);
+            } catch (...) {
+                release();
+                throw;
+            }
+        }
+
+        ~CompactMapStorage() { release(); }
+
+        CompactMapStorage(const CompactMapStorage &) = delete;
+        CompactMapStorage &operator=(const CompactMapStorage &) = delete;
+
+        void release() {
+            memory::destroyArray(m_resource, m_entryArray, m_entryCount);
+            memory::destroyArray(m_resource, m_slotArray, m_slotCount);
+            memory::destroyArray(m_resource, m_liveArray, m_liveCount);
+        }
+    };
+
+    // Run-time compact map - storage comes from a MemoryResource, the heap by default
+    template<typename Key, typename Value, typename Hash = std::hash<Key>>
+    class RTCompactMap : private CompactMapStorage<CompactMapEntry<Key, Value>>,
+                         public FixedCompactMap<Key, Value, Hash> {
+        using Storage = CompactMapStorage<CompactMapEntry<Key, Value>>;
+        using Base = FixedCompactMap<Key, Value, Hash>;
+
+    public:
+        explicit RTCompactMap(std::size_t capacity, MemoryResource *resource = defaultResource())
+            : Storage(resource, capacity, Base::slotCount(capacity), Base::liveWords(capacity))
+            , Base(Storage::m_entryArray, Storage::m_slotArray, Storage::m_liveArray, capacity) {}
+
+        RTCompactMap(std::initializer_list<std::pair<const Key, Value>> initList, std::size_t capacity = 0,
+                     MemoryResource *resource = defaultResource())
+            : RTCompactMap(capacity ? capacity : initList.size(), resource) {
+            for (const auto &item: initList) {
+                this->insert(item.first, item.second);
+            }
+        }
+
+        // The entries go first - the storage base releases the arrays after the map
+        ~RTCompactMap() { this->releaseEntries(); }
+
+        MemoryResource *resource() const { return Storage::m_resource; }
+    };
+}// namespace ESTL
+
+#endif//ESTL_FIXEDCOMPACTMAP_HPP
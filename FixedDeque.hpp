@@ -0,0 +1,466 @@
+//
+// Fixed-capacity double-ended queue - a circular buffer over one contiguous array.
+//
+#pragma once
+
+#include "ESTLMemory.hpp"
+#include "ESTLMetrics.hpp"
+#include "ESTLUtils.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#ifndef ENABLE_THREAD_SAFETY
+#define ENABLE_THREAD_SAFETY true
+#endif
+
+namespace ESTL {
+/** Deque layout
+The elements occupy size() consecutive slots of the array starting at the head, wrapping from the last slot to the
+first - push and pop at either end move the head or the tail, never the elements.
+    [ d e - - - - a b c ]     head at 6, size 5: a b c d e
+So the contents are at most two contiguous runs: segments() returns them in order, ready for writev() or a memcpy
+each, and freeSegments() returns the free slots after the back the same way, for readv(). Bytes read into the free
+segments become elements with commitBack(), elements written out are dropped with consumeFront().
+Like FixedVector, the array holds constructed T's: a popped slot keeps its value until it is reused.
+ * */
+
+// One contiguous run of a deque's array
+template <typename T> struct DequeSegment {
+  T *data;
+  std::size_t size;
+};
+
+// Base class for FixedDeque
+template <typename T> class FixedDeque {
+protected:
+  T *m_data;
+  std::size_t m_capacity;
+  std::size_t m_head;
+  std::size_t m_size;
+#if (ENABLE_THREAD_SAFETY)
+  mutable ContainerMutex m_mutex;
+#endif
+#if ESTL_ENABLE_METRICS
+  metrics::Counters m_counters;
+#endif
+
+  FixedDeque(T *data, std::size_t capacity)
+      : m_data(data), m_capacity(capacity), m_head(0), m_size(0) {}
+
+  // Array slot of the element at index - the wrap is a compare, not a division
+  std::size_t slot(std::size_t index) const {
+    const std::size_t position = m_head + index;
+    return position >= m_capacity ? position - m_capacity : position;
+  }
+
+  // Copies the elements in order to the start of data, which has room for all of them
+  void copyOut(T *data) const {
+    const std::size_t first = std::min(m_size, m_capacity - m_head);
+    std::copy(m_data + m_head, m_data + m_head + first, data);
+    std::copy(m_data, m_data + (m_size - first), data + first);
+  }
+
+  void moveOut(T *data) {
+    const std::size_t first = std::min(m_size, m_capacity - m_head);
+    std::move(m_data + m_head, m_data + m_head + first, data);
+    std::move(m_data, m_data + (m_size - first), data + first);
+  }
+
+public:
+  template <bool Const> class Iterator {
+    friend class FixedDeque;
+    using Deque = typename std::conditional<Const, const FixedDeque, FixedDeque>::type;
+
+    Deque *m_deque;
+    std::size_t m_index;
+
+    Iterator(Deque *deque, std::size_t index) : m_deque(deque), m_index(index) {}
+
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = typename std::conditional<Const, const T *, T *>::type;
+    using reference = typename std::conditional<Const, const T &, T &>::type;
+
+    Iterator() : m_deque(nullptr), m_index(0) {}
+
+    // iterator converts to const_iterator
+    template <bool OtherConst, typename = typename std::enable_if<Const && !OtherConst>::type>
+    Iterator(const Iterator<OtherConst> &other) : m_deque(other.m_deque), m_index(other.m_index) {}
+
+    reference operator*() const { return m_deque->m_data[m_deque->slot(m_index)]; }
+    pointer operator->() const { return &**this; }
+    reference operator[](difference_type offset) const { return *(*this + offset); }
+
+    Iterator &operator++() {
+      ++m_index;
+      return *this;
+    }
+    Iterator operator++(int) {
+      Iterator old = *this;
+      ++m_index;
+      return old;
+    }
+    Iterator &operator--() {
+      --m_index;
+      return *this;
+    }
+    Iterator operator--(int) {
+      Iterator old = *this;
+      --m_index;
+      return old;
+    }
+    Iterator &operator+=(difference_type offset) {
+      m_index += offset;
+      return *this;
+    }
+    Iterator &operator-=(difference_type offset) {
+      m_index -= offset;
+      return *this;
+    }
+    Iterator operator+(difference_type offset) const { return Iterator(m_deque, m_index + offset); }
+    Iterator operator-(difference_type offset) const { return Iterator(m_deque, m_index - offset); }
+    friend Iterator operator+(difference_type offset, const Iterator &it) { return it + offset; }
+    difference_type operator-(const Iterator &other) const {
+      return static_cast<difference_type>(m_index) - static_cast<difference_type>(other.m_index);
+    }
+
+    bool operator==(const Iterator &other) const { return m_index == other.m_index; }
+    bool operator!=(const Iterator &other) const { return m_index != other.m_index; }
+    bool operator<(const Iterator &other) const { return m_index < other.m_index; }
+    bool operator>(const Iterator &other) const { return m_index > other.m_index; }
+    bool operator<=(const Iterator &other) const { return m_index <= other.m_index; }
+    bool operator>=(const Iterator &other) const { return m_index >= other.m_index; }
+
+    template <bool> friend class Iterator;
+  };
+
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  FixedDeque(const FixedDeque &) = delete;
+  FixedDeque &operator=(const FixedDeque &) = delete;
+
+  // Push element to back - O(1)
+  void push_back(const T &value) { emplace_back(value); }
+  void push_back(T &&value) { emplace_back(std::move(value)); }
+
+  // Push element to front - O(1)
+  void push_front(const T &value) { emplace_front(value); }
+  void push_front(T &&value) { emplace_front(std::move(value)); }
+
+  template <typename... Args> void emplace_back(Args &&...args) {
+#if (ENABLE_THREAD_SAFETY)
+    std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
+    if (m_size >= m_capacity) {
+      throw std::out_of_range("FixedDeque overflow");
+    }
+    m_data[slot(m_size)] = T(std::forward<Args>(args)...);
+    ++m_size;
+    ESTL_METRIC(m_counters.level(m_size));
+  }
+
+  template <typename... Args> void emplace_front(Args &&...args) {
+#if (ENABLE_THREAD_SAFETY)
+    std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
+    if (m_size >= m_capacity) {
+      throw std::out_of_range("FixedDeque overflow");
+    }
+    const std::size_t head = m_head ? m_head - 1 : m_capacity - 1;
+    m_data[head] = T(std::forward<Args>(args)...);
+    m_head = head;
+    ++m_size;
+    ESTL_METRIC(m_counters.level(m_size));
+  }
+
+  // Remove last element - O(1)
+  void pop_back() {
+#if (ENABLE_THREAD_SAFETY)
+    std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
+    if (m_size == 0) {
+      throw std::out_of_range("FixedDeque underflow");
+    }
+    --m_size;
+  }
+
+  // Remove first element - O(1)
+  void pop_front() {
+#if (ENABLE_THREAD_SAFETY)
+    std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
+    if (m_size == 0) {
+      throw std::out_of_range("FixedDeque underflow");
+    }
+    m_head = slot(1);
+    --m_size;
+  }
+
+  // Append range of elements at the back - O(N), all or nothing; the range is measured first
+  template <typename ForwardIt> void append_range(ForwardIt first, ForwardIt last) {
+#if (ENABLE_THREAD_SAFETY)
+    std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
+    const std::size_t count = static_cast<std::size_t>(std::distance(first, last));
+    if (count > m_capacity - m_size) {
+      throw std::out_of_range("FixedDeque overflow");
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+      m_data[slot(m_size + i)] = *first++;
+    }
+    m_size += count;
+    ESTL_METRIC(m_counters.level(m_size));
+  }
+
+  // Element access - O(1)
+  T &operator[](std::size_t index) { return at(index); }
+  const T &operator[](std::size_t index) const { return at(index); }
+
+  // Bounds-checked access - O(1)
+  T &at(std::size_t index) {
+    if (index >= m_size) {
+      throw std::out_of_range("Index out of bounds");
+    }
+    return m_data[slot(index)];
+  }
+
+  const T &at(std::size_t index) const {
+    if (index >= m_size) {
+      throw std::out_of_range("Index out of bounds");
+    }
+    return m_data[slot(index)];
+  }
+
+  // Access first and last element - O(1)
+  T &front() { return at(0); }
+  const T &front() const { return at(0); }
+  T &back() { return at(m_size - 1); }
+  const T &back() const { return at(m_size - 1); }
+
+  // Capacity methods - O(1)
+  std::size_t size() const { return m_size; }
+  std::size_t capacity() const { return m_capacity; }
+  bool empty() const { return m_size == 0; }
+  bool full() const { return m_size == m_capacity; }
+
+  void clear() {
+#if (ENABLE_THREAD_SAFETY)
+    std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
+    m_head = m_size = 0;
+  }
+
+  // The elements as at most two contiguous runs, front first - the second is empty unless the contents wrap
+  std::array<DequeSegment<T>, 2> segments() {
+#if (ENABLE_THREAD_SAFETY)
+    std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
+    const std::size_t first = std::min(m_size, m_capacity - m_head);
+    return {{{m_data + m_head, first}, {m_data, m_size - first}}};
+  }
+
+  std::array<DequeSegment<const T>, 2> segments() const {
+    auto runs = const_cast<FixedDeque *>(this)->segments();
+    return {{{runs[0].data, runs[0].size}, {runs[1].data, runs[1].size}}};
+  }
+
+  // The free slots after the back as at most two contiguous runs, in the order commitBack() appends them
+  std::array<DequeSegment<T>, 2> freeSegments() {
+#if (ENABLE_THREAD_SAFETY)
+    std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
+    const std::size_t free = m_capacity - m_size;
+    if (free == 0) {
+      return {{{m_data, 0}, {m_data, 0}}};
+    }
+    const std::size_t tail = slot(m_size);
+    const std::size_t first = std::min(free, m_capacity - tail);
+    return {{{m_data + tail, first}, {m_data, free - first}}};
+  }
+
+  // Makes the first count free slots, filled through freeSegments(), the new back elements - O(1)
+  void commitBack(std::size_t count) {
+#if (ENABLE_THREAD_SAFETY)
+    std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
+    if (count > m_capacity - m_size) {
+      throw std::out_of_range("FixedDeque overflow");
+    }
+    m_size += count;
+    ESTL_METRIC(m_counters.level(m_size));
+  }
+
+  // Drops the first count elements, e.g. once segments() has been written out - O(1)
+  void consumeFront(std::size_t count) {
+#if (ENABLE_THREAD_SAFETY)
+    std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
+    if (count > m_size) {
+      throw std::out_of_range("FixedDeque underflow");
+    }
+    m_head = m_size == count ? 0 : slot(count);
+    m_size -= count;
+  }
+
+  // Occupancy snapshot - the pool is the element array, see ContainerMetrics
+  ContainerMetrics metrics() const {
+#if (ENABLE_THREAD_SAFETY)
+    std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
+    ContainerMetrics result;
+    result.size = result.poolInUse = m_size;
+    result.capacity = result.poolCapacity = m_capacity;
+    result.loadFactor = m_capacity ? double(m_size) / m_capacity : 0;
+#if ESTL_ENABLE_METRICS
+    result.poolHighWater = m_counters.poolHighWater;
+#if (ENABLE_THREAD_SAFETY)
+    result.lockWait = m_mutex.histogram();
+#endif
+#endif
+    return result;
+  }
+
+  // Iterators - O(1), invalidated by push_front and pop_front
+  iterator begin() { return iterator(this, 0); }
+  iterator end() { return iterator(this, m_size); }
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, m_size); }
+};
+
+// Element array of a CTDeque - a base ahead of FixedDeque, so it exists before the deque is handed a pointer to it
+template <typename T, std::size_t N> struct DequeStorage {
+  std::array<T, N> m_storage;
+};
+
+// Compile-time fixed deque
+template <typename T, std::size_t N> class CTDeque : private DequeStorage<T, N>, public FixedDeque<T> {
+  using DequeStorage<T, N>::m_storage;
+
+public:
+  CTDeque() : FixedDeque<T>(m_storage.data(), N) {}
+
+  // Copies and moves touch the first size() elements only, which land unwrapped at the start of the array
+  CTDeque(const CTDeque &other) : FixedDeque<T>(m_storage.data(), N) {
+    other.copyOut(this->m_data);
+    this->m_size = other.m_size;
+  }
+
+  CTDeque &operator=(const CTDeque &other) {
+    if (this != &other) {
+      other.copyOut(this->m_data);
+      this->m_head = 0;
+      this->m_size = other.m_size;
+    }
+    return *this;
+  }
+
+  // other is left empty and usable
+  CTDeque(CTDeque &&other) : FixedDeque<T>(m_storage.data(), N) {
+    other.moveOut(this->m_data);
+    this->m_size = other.m_size;
+    other.m_head = other.m_size = 0;
+  }
+
+  CTDeque &operator=(CTDeque &&other) {
+    if (this != &other) {
+      other.moveOut(this->m_data);
+      this->m_head = 0;
+      this->m_size = other.m_size;
+      other.m_head = other.m_size = 0;
+    }
+    return *this;
+  }
+
+  CTDeque(std::initializer_list<T> init) : FixedDeque<T>(m_storage.data(), N) {
+    if (init.size() > N) {
+      throw std::out_of_range("Initializer list too large");
+    }
+    std::copy(init.begin(), init.end(), this->m_data);
+    this->m_size = init.size();
+  }
+};
+
+// Run-time fixed deque - storage comes from a MemoryResource, the heap by default
+template <typename T> class RTDeque : public FixedDeque<T> {
+  MemoryResource *m_resource;
+
+public:
+  explicit RTDeque(std::size_t capacity, MemoryResource *resource = defaultResource())
+      : FixedDeque<T>(memory::createArray<T>(resource, capacity), capacity), m_resource(resource) {}
+
+  ~RTDeque() { memory::destroyArray(m_resource, this->m_data, this->m_capacity); }
+
+  RTDeque(const RTDeque &other) : RTDeque(other.m_capacity, other.m_resource) {
+    other.copyOut(this->m_data);
+    this->m_size = other.m_size;
+  }
+
+  // Reuses the buffer when the capacities match
+  RTDeque &operator=(const RTDeque &other) {
+    if (this != &other && this->m_capacity != other.m_capacity) {
+      T *data = memory::createArray<T>(m_resource, other.m_capacity);
+      memory::destroyArray(m_resource, this->m_data, this->m_capacity);
+      this->m_data = data;
+      this->m_capacity = other.m_capacity;
+    }
+    if (this != &other) {
+      other.copyOut(this->m_data);
+      this->m_head = 0;
+      this->m_size = other.m_size;
+    }
+    return *this;
+  }
+
+  RTDeque(RTDeque &&other) noexcept
+      : FixedDeque<T>(other.m_data, other.m_capacity), m_resource(other.m_resource) {
+    this->m_head = other.m_head;
+    this->m_size = other.m_size;
+    other.m_data = nullptr;
+    other.m_capacity = other.m_head = other.m_size = 0;
+  }
+
+  RTDeque &operator=(RTDeque &&other) noexcept {
+    if (this != &other) {
+      memory::destroyArray(m_resource, this->m_data, this->m_capacity);
+      this->m_data = other.m_data;
+      this->m_capacity = other.m_capacity;
+      this->m_head = other.m_head;
+      this->m_size = other.m_size;
+      m_resource = other.m_resource;
+
+      other.m_data = nullptr;
+      other.m_capacity = other.m_head = other.m_size = 0;
+    }
+    return *this;
+  }
+
+  // Exchanges buffers - O(1)
+  void swap(RTDeque &other) {
+    if (this == &other) {
+      return;
+    }
+#if (ENABLE_THREAD_SAFETY)
+    std::lock(this->m_mutex, other.m_mutex);
+    std::lock_guard<ContainerMutex> lock(this->m_mutex, std::adopt_lock);
+    std::lock_guard<ContainerMutex> otherLock(other.m_mutex, std::adopt_lock);
+#endif
+    std::swap(this->m_data, other.m_data);
+    std::swap(this->m_capacity, other.m_capacity);
+    std::swap(this->m_head, other.m_head);
+    std::swap(this->m_size, other.m_size);
+    std::swap(m_resource, other.m_resource);
+  }
+
+  MemoryResource *resource() const { return m_resource; }
+};
+} // namespace ESTL
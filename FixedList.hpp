@@ -1,27 +1,53 @@
 #pragma once
 
+#include "ESTLMemory.hpp"
+#include "ESTLMetrics.hpp"
+#include "ESTLTrace.hpp"
+#include "ESTLUtils.hpp"
 #include <stdexcept>
 #include <iterator>
 #include <mutex>
 #include <algorithm>
 #include <array>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 #ifndef ENABLE_THREAD_SAFETY
 #define ENABLE_THREAD_SAFETY true
 #endif
 
 namespace ESTL {
-// Node structure for the list
+// Node structure for the list - data is raw storage, constructed while the node is linked into the list
 template<typename T>
 struct ListNode {
-  T data;
+  union {
+#if ESTL_CONSTEXPR_CONTAINERS
+    char vacant{}; // active while the node is free - a constant may not hold a union without one
+#endif
+    T data;
+  };
   ListNode *prev;
   ListNode *next;
+
+  ESTL_CONSTEXPR ListNode() {}
+  ESTL_CONSTEXPR ~ListNode() {}
+
+  template<typename... Args>
+  ESTL_CONSTEXPR void construct(Args &&... args) { detail::constructAt(&data, std::forward<Args>(args)...); }
+  ESTL_CONSTEXPR void destroy() {
+    data.~T();
+#if ESTL_CONSTEXPR_CONTAINERS
+    vacant = 0;
+#endif
+  }
 };
 
 // Iterator for FixedList
 template<typename T>
 class FixedListIterator {
+  using Node = ListNode<typename std::remove_const<T>::type>; // const_iterator walks the same nodes
+
 public:
   using iterator_category = std::bidirectional_iterator_tag;
   using value_type = T;
@@ -29,47 +55,55 @@ public:
   using pointer = T *;
   using reference = T &;
 
-  explicit FixedListIterator(ListNode<T> *node) : m_node(node) {
+  ESTL_CONSTEXPR explicit FixedListIterator(Node *node) : m_node(node) {
   }
 
-  reference operator*() const { return m_node->data; }
-  pointer operator->() { return &m_node->data; }
+  ESTL_CONSTEXPR reference operator*() const { return m_node->data; }
+  ESTL_CONSTEXPR pointer operator->() { return &m_node->data; }
 
-  FixedListIterator &operator++() {
+  ESTL_CONSTEXPR FixedListIterator &operator++() {
     m_node = m_node->next;
     return *this;
   }
 
-  FixedListIterator operator++(int) {
+  ESTL_CONSTEXPR FixedListIterator operator++(int) {
     FixedListIterator temp = *this;
     m_node = m_node->next;
     return temp;
   }
 
-  FixedListIterator &operator--() {
+  ESTL_CONSTEXPR FixedListIterator &operator--() {
     m_node = m_node->prev;
     return *this;
   }
 
-  FixedListIterator operator--(int) {
+  ESTL_CONSTEXPR FixedListIterator operator--(int) {
     FixedListIterator temp = *this;
     m_node = m_node->prev;
     return temp;
   }
 
-  bool operator==(const FixedListIterator &other) const { return m_node == other.m_node; }
-  bool operator!=(const FixedListIterator &other) const { return m_node != other.m_node; }
+  ESTL_CONSTEXPR bool operator==(const FixedListIterator &other) const { return m_node == other.m_node; }
+  ESTL_CONSTEXPR bool operator!=(const FixedListIterator &other) const { return m_node != other.m_node; }
 
 private:
-  ListNode<T> *m_node;
+  Node *m_node;
 
   // For access to m_node
   template<typename U>
   friend class FixedList;
 };
 
+template<typename U>
+class ListImage;
+class Serialization;
+
 template<typename T>
 class FixedList {
+  template<typename U>
+  friend class ListImage;
+  friend class Serialization;
+
 protected:
   ListNode<T> *m_storage; // Fixed-size array of nodes
   std::size_t m_capacity;
@@ -78,20 +112,42 @@ protected:
   ListNode<T> *m_tail;
   ListNode<T> *m_freeList; // Points to the first free node
 #if ENABLE_THREAD_SAFETY
-  mutable std::mutex m_mutex;
+  mutable ContainerMutex m_mutex;
+#endif
+#if ESTL_ENABLE_METRICS
+  metrics::Counters m_counters;
 #endif
 
 public:
   using iterator = FixedListIterator<T>;
   using const_iterator = FixedListIterator<const T>;
 
-  FixedList(ListNode<T> *buffer, std::size_t capacity) : m_storage(buffer), m_capacity(capacity), m_size(0),
-                                                         m_head(nullptr), m_tail(nullptr), m_freeList(nullptr) {
+  ESTL_CONSTEXPR FixedList(ListNode<T> *buffer, std::size_t capacity)
+      : FixedList(buffer, capacity, InlineStorage{}) {
     initFreeListPool();
   }
 
+protected:
+  // The derived class links the free list once its node array exists
+  ESTL_CONSTEXPR FixedList(ListNode<T> *buffer, std::size_t capacity, InlineStorage)
+      : m_storage(buffer), m_capacity(capacity), m_size(0), m_head(nullptr), m_tail(nullptr), m_freeList(nullptr) {}
+
+  // Takes other's nodes as they are - O(1), for RT lists whose node array can change hands. other is left without
+  // storage: it can only be destroyed or assigned to.
+  FixedList(FixedList &&other) noexcept : m_storage(other.m_storage), m_capacity(other.m_capacity),
+                                          m_size(other.m_size), m_head(other.m_head), m_tail(other.m_tail),
+                                          m_freeList(other.m_freeList) {
+    ESTL_METRIC(m_counters = other.m_counters);
+    other.m_storage = nullptr;
+    other.m_head = nullptr;
+    other.m_tail = nullptr;
+    other.m_freeList = nullptr;
+    other.m_size = other.m_capacity = 0;
+  }
+
+public:
   // Helper to initialize the free bucket pool
-  void initFreeListPool() {
+  ESTL_CONSTEXPR void initFreeListPool() {
     // Initialize free list with all nodes
     for (std::size_t i = 0; i < m_capacity - 1; ++i) {
       m_storage[i].next = &m_storage[i + 1]; // Link nodes in the free list
@@ -100,106 +156,145 @@ public:
     m_storage[m_capacity - 1].next = nullptr; // Last node's next is null
     m_storage[m_capacity - 1].prev = nullptr; // Initialize prev pointer
     m_freeList = &m_storage[0]; // First free node
+    ESTL_METRIC(m_counters.poolInUse = 0);
   }
 
   // Get a free node from the free list - O(1)
-  ListNode<T> *getFreeNode() {
+  ESTL_CONSTEXPR ListNode<T> *getFreeNode() {
     if (!m_freeList) {
       throw std::out_of_range("FixedList is full");
     }
 #if ENABLE_THREAD_SAFETY
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::lock_guard<ContainerMutex> lock(m_mutex);
 #endif
     ListNode<T> *node = m_freeList;
     m_freeList = m_freeList->next; // Move free list pointer forward
     node->next = nullptr;
     node->prev = nullptr;
+    ESTL_METRIC(m_counters.acquire());
     return node;
   }
 
-  // Return a node to the free list - O(1)
-  void returnNode(ListNode<T> *node) {
+  // Return a node to the free list, destroying its element - O(1)
+  ESTL_CONSTEXPR void returnNode(ListNode<T> *node) {
+    node->destroy();
+    releaseNode(node);
+  }
+
+  // Return a node whose element was never constructed
+  ESTL_CONSTEXPR void releaseNode(ListNode<T> *node) {
     node->next = m_freeList;
     node->prev = nullptr;
     m_freeList = node;
+    ESTL_METRIC(m_counters.release());
+  }
+
+  // Constructs the element of a node taken from the free list - the node goes back if construction throws
+  template<typename... Args>
+  ESTL_CONSTEXPR void constructIn(ListNode<T> *node, Args &&... args) {
+    try {
+      node->construct(std::forward<Args>(args)...);
+    } catch (...) {
+      releaseNode(node);
+      throw;
+    }
   }
 
   // Size operations
-  std::size_t size() const {
+  ESTL_CONSTEXPR std::size_t size() const {
 #if ENABLE_THREAD_SAFETY
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::lock_guard<ContainerMutex> lock(m_mutex);
 #endif
     return m_size;
   }
 
-  std::size_t capacity() const { return m_capacity; }
+  ESTL_CONSTEXPR std::size_t capacity() const { return m_capacity; }
 
-  bool empty() const {
+  ESTL_CONSTEXPR bool empty() const {
 #if ENABLE_THREAD_SAFETY
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::lock_guard<ContainerMutex> lock(m_mutex);
 #endif
     return m_size == 0;
   }
 
-  bool full() const {
+  ESTL_CONSTEXPR bool full() const {
 #if ENABLE_THREAD_SAFETY
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::lock_guard<ContainerMutex> lock(m_mutex);
 #endif
     return m_size == m_capacity;
   }
 
+  // Occupancy snapshot - the pool is the node array, see ContainerMetrics
+  ContainerMetrics metrics() const {
+#if ENABLE_THREAD_SAFETY
+    std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
+    ContainerMetrics result;
+    result.size = result.poolInUse = m_size;
+    result.capacity = result.poolCapacity = m_capacity;
+    result.loadFactor = m_capacity ? double(m_size) / m_capacity : 0;
+#if ESTL_ENABLE_METRICS
+    result.poolHighWater = m_counters.poolHighWater;
+#if ENABLE_THREAD_SAFETY
+    result.lockWait = m_mutex.histogram();
+#endif
+#endif
+    return result;
+  }
+
   // Element access
-  T &front() {
+  ESTL_CONSTEXPR T &front() {
     if (!m_head) {
       throw std::out_of_range("FixedList is empty");
     }
 #if ENABLE_THREAD_SAFETY
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::lock_guard<ContainerMutex> lock(m_mutex);
 #endif
     return m_head->data;
   }
 
-  const T &front() const {
+  ESTL_CONSTEXPR const T &front() const {
     if (!m_head) {
       throw std::out_of_range("FixedList is empty");
     }
 #if ENABLE_THREAD_SAFETY
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::lock_guard<ContainerMutex> lock(m_mutex);
 #endif
     return m_head->data;
   }
 
-  T &back() {
+  ESTL_CONSTEXPR T &back() {
     if (!m_tail) {
       throw std::out_of_range("FixedList is empty");
     }
 #if ENABLE_THREAD_SAFETY
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::lock_guard<ContainerMutex> lock(m_mutex);
 #endif
     return m_tail->data;
   }
 
-  const T &back() const {
+  ESTL_CONSTEXPR const T &back() const {
     if (!m_tail) {
       throw std::out_of_range("FixedList is empty");
     }
 #if ENABLE_THREAD_SAFETY
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::lock_guard<ContainerMutex> lock(m_mutex);
 #endif
     return m_tail->data;
   }
 
   // Push to back - O(1)
-  void push_back(const T &value) {
+  ESTL_CONSTEXPR void push_back(const T &value) {
     if (m_size >= m_capacity) {
       throw std::out_of_range("FixedList is full");
     }
 
     ListNode<T> *newNode = getFreeNode();
 #if ENABLE_THREAD_SAFETY
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::lock_guard<ContainerMutex> lock(m_mutex);
 #endif
-    newNode->data = value;
+    ESTL_TRACE(trace::Span span(TraceKind::List, TraceOp::PushBack, this, m_size));
+    constructIn(newNode, value);
     newNode->next = nullptr;
     newNode->prev = m_tail;
 
@@ -210,16 +305,17 @@ public:
   }
 
   // Push to front - O(1)
-  void push_front(const T &value) {
+  ESTL_CONSTEXPR void push_front(const T &value) {
     if (m_size >= m_capacity) {
       throw std::out_of_range("FixedList is full");
     }
 
     ListNode<T> *newNode = getFreeNode();
 #if ENABLE_THREAD_SAFETY
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::lock_guard<ContainerMutex> lock(m_mutex);
 #endif
-    newNode->data = value;
+    ESTL_TRACE(trace::Span span(TraceKind::List, TraceOp::PushFront, this, m_size));
+    constructIn(newNode, value);
     newNode->prev = nullptr;
     newNode->next = m_head;
 
@@ -234,7 +330,7 @@ public:
   }
 
   template<typename... Args>
-  iterator emplace(iterator pos, Args &&... args) {
+  ESTL_CONSTEXPR iterator emplace(iterator pos, Args &&... args) {
     if (m_size >= m_capacity) {
       throw std::out_of_range("FixedList is full");
     }
@@ -253,12 +349,12 @@ public:
     // Regular case: insert between two nodes
     ListNode<T> *newNode = getFreeNode();
 #if ENABLE_THREAD_SAFETY
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::lock_guard<ContainerMutex> lock(m_mutex);
 #endif
     ListNode<T> *nextNode = pos.m_node;
     ListNode<T> *prevNode = nextNode->prev;
 
-    newNode->data = T(std::forward<Args>(args)...);
+    constructIn(newNode, std::forward<Args>(args)...);
     newNode->next = nextNode;
     newNode->prev = prevNode;
 
@@ -270,16 +366,16 @@ public:
   }
 
   template<typename... Args>
-  void emplace_front(Args &&... args) {
+  ESTL_CONSTEXPR void emplace_front(Args &&... args) {
     if (m_size >= m_capacity) {
       throw std::out_of_range("FixedList is full");
     }
 
     ListNode<T> *newNode = getFreeNode();
 #if ENABLE_THREAD_SAFETY
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::lock_guard<ContainerMutex> lock(m_mutex);
 #endif
-    newNode->data = T(std::forward<Args>(args)...);
+    constructIn(newNode, std::forward<Args>(args)...);
     newNode->prev = nullptr;
     newNode->next = m_head;
 
@@ -294,16 +390,16 @@ public:
   }
 
   template<typename... Args>
-  void emplace_back(Args &&... args) {
+  ESTL_CONSTEXPR void emplace_back(Args &&... args) {
     if (m_size >= m_capacity) {
       throw std::out_of_range("FixedList is full");
     }
 
     ListNode<T> *newNode = getFreeNode();
 #if ENABLE_THREAD_SAFETY
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::lock_guard<ContainerMutex> lock(m_mutex);
 #endif
-    newNode->data = T(std::forward<Args>(args)...);
+    constructIn(newNode, std::forward<Args>(args)...);
     newNode->next = nullptr;
     newNode->prev = m_tail;
 
@@ -314,13 +410,14 @@ public:
   }
 
   // Pop from back - O(1)
-  void pop_back() {
+  ESTL_CONSTEXPR void pop_back() {
     if (!m_tail) {
       throw std::out_of_range("FixedList is empty");
     }
 #if ENABLE_THREAD_SAFETY
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::lock_guard<ContainerMutex> lock(m_mutex);
 #endif
+    ESTL_TRACE(trace::Span span(TraceKind::List, TraceOp::PopBack, this, m_size));
     ListNode<T> *node = m_tail;
     m_tail = m_tail->prev;
     if (m_tail) {
@@ -333,13 +430,14 @@ public:
   }
 
   // Pop from front - O(1)
-  void pop_front() {
+  ESTL_CONSTEXPR void pop_front() {
     if (!m_head) {
       throw std::out_of_range("FixedList is empty");
     }
 #if ENABLE_THREAD_SAFETY
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::lock_guard<ContainerMutex> lock(m_mutex);
 #endif
+    ESTL_TRACE(trace::Span span(TraceKind::List, TraceOp::PopFront, this, m_size));
     ListNode<T> *node = m_head;
     m_head = m_head->next;
     if (m_head) {
@@ -352,10 +450,11 @@ public:
   }
 
   // Clear the list
-  void clear() {
+  ESTL_CONSTEXPR void clear() {
 #if ENABLE_THREAD_SAFETY
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::lock_guard<ContainerMutex> lock(m_mutex);
 #endif
+    ESTL_TRACE(trace::Span span(TraceKind::List, TraceOp::Clear, this, m_size));
     while (m_head) {
       ListNode<T> *node = m_head;
       m_head = m_head->next;
@@ -366,41 +465,41 @@ public:
   }
 
   // Iterator methods
-  iterator begin() {
+  ESTL_CONSTEXPR iterator begin() {
 #if ENABLE_THREAD_SAFETY
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::lock_guard<ContainerMutex> lock(m_mutex);
 #endif
     return iterator(m_head);
   }
 
-  iterator end() {
+  ESTL_CONSTEXPR iterator end() {
     return iterator(nullptr);
   }
 
-  const_iterator begin() const {
+  ESTL_CONSTEXPR const_iterator begin() const {
 #if ENABLE_THREAD_SAFETY
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::lock_guard<ContainerMutex> lock(m_mutex);
 #endif
     return const_iterator(m_head);
   }
 
-  const_iterator end() const {
+  ESTL_CONSTEXPR const_iterator end() const {
     return const_iterator(nullptr);
   }
 
-  const_iterator cbegin() const {
+  ESTL_CONSTEXPR const_iterator cbegin() const {
 #if ENABLE_THREAD_SAFETY
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::lock_guard<ContainerMutex> lock(m_mutex);
 #endif
     return const_iterator(m_head);
   }
 
-  const_iterator cend() const {
+  ESTL_CONSTEXPR const_iterator cend() const {
     return const_iterator(nullptr);
   }
 
   // Insert element at position
-  iterator insert(iterator pos, const T &value) {
+  ESTL_CONSTEXPR iterator insert(iterator pos, const T &value) {
     if (m_size >= m_capacity) throw std::out_of_range("FixedList is full");
 
     // Special cases for empty list or insertion at beginning/end
@@ -417,12 +516,13 @@ public:
     // Regular case: insert between two nodes
     ListNode<T> *newNode = getFreeNode();
 #if ENABLE_THREAD_SAFETY
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::lock_guard<ContainerMutex> lock(m_mutex);
 #endif
+    ESTL_TRACE(trace::Span span(TraceKind::List, TraceOp::Insert, this, m_size));
     ListNode<T> *nextNode = pos.m_node;
     ListNode<T> *prevNode = nextNode->prev;
 
-    newNode->data = value;
+    constructIn(newNode, value);
     newNode->next = nextNode;
     newNode->prev = prevNode;
 
@@ -434,7 +534,7 @@ public:
   }
 
   // Erase element at position
-  iterator erase(iterator pos) {
+  ESTL_CONSTEXPR iterator erase(iterator pos) {
     if (pos == end()) {
       throw std::out_of_range("Cannot erase end iterator");
     }
@@ -453,8 +553,9 @@ public:
       return end();
     }
 #if ENABLE_THREAD_SAFETY
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::lock_guard<ContainerMutex> lock(m_mutex);
 #endif
+    ESTL_TRACE(trace::Span span(TraceKind::List, TraceOp::Erase, this, m_size));
     // Regular case: remove from middle
     ListNode<T> *prevNode = node->prev;
 
@@ -468,7 +569,7 @@ public:
   }
 
   // Merge another list into this list
-  void merge(FixedList &other) {
+  ESTL_CONSTEXPR void merge(FixedList &other) {
     if (this == &other) {
       return; // Avoid self-merge
     }
@@ -493,7 +594,7 @@ public:
   }
 
   // Splice elements from another list into this list at the specified position
-  void splice(iterator pos, FixedList &other) {
+  ESTL_CONSTEXPR void splice(iterator pos, FixedList &other) {
     if (this == &other) {
       return; // Avoid self-splice
     }
@@ -505,7 +606,7 @@ public:
   }
 
   // Remove all elements equal to the given value
-  void remove(const T &value) {
+  ESTL_CONSTEXPR void remove(const T &value) {
     for (auto it = begin(); it != end();) {
       if (*it == value) {
         it = erase(it);
@@ -517,7 +618,7 @@ public:
 
   // Remove all elements that satisfy the predicate
   template<typename Predicate>
-  void remove_if(Predicate pred) {
+  ESTL_CONSTEXPR void remove_if(Predicate pred) {
     for (auto it = begin(); it != end();) {
       if (pred(*it)) {
         it = erase(it);
@@ -528,7 +629,7 @@ public:
   }
 
   // Remove consecutive duplicate elements
-  void unique() {
+  ESTL_CONSTEXPR void unique() {
     if (empty()) {
       return;
     }
@@ -550,11 +651,13 @@ class CTList : public FixedList<T> {
   std::array<ListNode<T>, N> m_storage;
 
 public:
-  CTList() : FixedList<T>(m_storage.data(), N) {
+  ESTL_CONSTEXPR CTList() : FixedList<T>(m_storage.data(), N, InlineStorage{}) {
     this->initFreeListPool();
   }
 
-  CTList(std::initializer_list<T> init) : CTList() {
+  ESTL_CONSTEXPR ~CTList() { this->clear(); }
+
+  ESTL_CONSTEXPR CTList(std::initializer_list<T> init) : CTList() {
     if (init.size() > N) {
       throw std::out_of_range("Initializer list too large");
     }
@@ -564,15 +667,19 @@ public:
   }
 };
 
-// Run-time fixed list
+// Run-time fixed list - nodes come from a MemoryResource, the heap by default
 template<typename T>
 class RTList : public FixedList<T> {
+  MemoryResource *m_resource;
+
 public:
-  explicit RTList(std::size_t capacity) : FixedList<T>(new ListNode<T>[capacity], capacity) {
+  explicit RTList(std::size_t capacity, MemoryResource *resource = defaultResource())
+      : FixedList<T>(memory::createArray<ListNode<T>>(resource, capacity), capacity), m_resource(resource) {
     this->initFreeListPool();
   }
 
-  RTList(std::size_t capacity, std::initializer_list<T> init) : RTList(capacity) {
+  RTList(std::size_t capacity, std::initializer_list<T> init, MemoryResource *resource = defaultResource())
+      : RTList(capacity, resource) {
     if (init.size() > capacity) {
       throw std::out_of_range("Initializer list too large");
     }
@@ -582,7 +689,8 @@ public:
   }
 
   ~RTList() {
-    delete[] this->m_storage;
+    this->clear();
+    memory::destroyArray(m_resource, this->m_storage, this->m_capacity);
   }
 
   // Prevent copying to avoid double-delete issues
@@ -590,22 +698,18 @@ public:
 
   RTList &operator=(const RTList &) = delete;
 
-  // Allow moving
-  RTList(RTList &&other) noexcept : FixedList<T>(other.m_storage, other.capacity()) {
-    other.m_storage = nullptr;
-    other.m_head = nullptr;
-    other.m_tail = nullptr;
-    other.m_freeList = nullptr;
-    other.m_size = 0;
-  }
+  // Allow moving - the nodes change hands, nothing is relinked
+  RTList(RTList &&other) noexcept : FixedList<T>(std::move(other)), m_resource(other.m_resource) {}
 
   RTList &operator=(RTList &&other) noexcept {
     if (this != &other) {
-      delete[] this->m_storage;
+      this->clear();
+      memory::destroyArray(m_resource, this->m_storage, this->m_capacity);
       // Re-initialize the base class
       this->m_storage = other.m_storage;
-      this->m_capacity = other.capacity;
-      this->m_size = other.size;
+      this->m_capacity = other.m_capacity;
+      this->m_size = other.m_size;
+      m_resource = other.m_resource;
       this->m_head = other.m_head;
       this->m_tail = other.m_tail;
       this->m_freeList = other.m_freeList;
@@ -614,7 +718,7 @@ public:
       other.m_head = nullptr;
       other.m_tail = nullptr;
       other.m_freeList = nullptr;
-      other.m_size = 0;
+      other.m_size = other.m_capacity = 0;
     }
     return *this;
   }
@@ -0,0 +1,132 @@
+//
+// Memory-mapped images of FixedList - write once, map read-only in place.
+//
+#pragma once
+
+#include "ESTLImage.hpp"
+#include "FixedList.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace ESTL {
+    /**
+     * @brief Image layout of a FixedList.
+     *
+     * The list is written in sequence order as a contiguous array, so the links are implied by position and a reader
+     * walks it without chasing pointers.
+     */
+    template<typename T>
+    class ListImage {
+        static_assert(std::is_trivially_copyable<T>::value, "Images need trivially copyable elements");
+
+    public:
+        static std::uint64_t layoutHash() {
+            std::uint64_t hash = image::hashValue(image::fnv1a("list", 4), sizeof(T));
+            hash = image::hashValue(hash, alignof(T));
+            return image::hashType(hash, typeid(T));
+        }
+
+        /**
+         * @brief Writes the list's elements in order to an image file or shared memory writer.
+         *
+         * @throws std::runtime_error on I/O errors - an existing image is left untouched.
+         */
+        template<typename Writer>
+        static void write(const FixedList<T> &list, Writer &writer) {
+#if ENABLE_THREAD_SAFETY
+            std::lock_guard<ContainerMutex> lock(list.m_mutex);
+#endif
+            const std::size_t bytes = list.m_size * sizeof(T);
+            ImageHeader header{};
+            std::memcpy(header.magic, image::Magic, sizeof(header.magic));
+            header.version = ImageHeader::CurrentVersion;
+            header.kind = ImageKind::List;
+            header.layoutHash = layoutHash();
+            header.size = list.m_size;
+            header.capacity = list.m_size;
+            header.payloadBytes = image::alignSection(bytes);
+
+            writer.write(&header, sizeof(header));
+            for (const ListNode<T> *node = list.m_head; node; node = node->next) {
+                writer.write(&node->data, sizeof(T));
+            }
+            writer.pad(bytes);
+            writer.commit();
+        }
+    };
+
+    /**
+     * @brief Read-only FixedList backed by a memory-mapped image.
+     *
+     * Attaching costs one mmap and a header check; iteration walks the elements in list order, in place.
+     */
+    template<typename T>
+    class MappedList {
+        using Image = ListImage<T>;
+
+        MappedImage m_image;
+        const T *m_data;
+        std::size_t m_size;
+
+    public:
+        using const_iterator = const T *;
+
+        explicit MappedList(const std::string &path, bool populate = false)
+            : m_image(path, ImageKind::List, Image::layoutHash(), populate) {
+            attach(path);
+        }
+
+        // Attaches to an image published with saveImage(list, SharedMemoryName{...})
+        explicit MappedList(const SharedMemoryName &segment, bool populate = false)
+            : m_image(segment, ImageKind::List, Image::layoutHash(), populate) {
+            attach(segment.name);
+        }
+
+        const T &front() const {
+            if (m_size == 0) {
+                throw std::out_of_range("List is empty");
+            }
+            return m_data[0];
+        }
+
+        const T &back() const {
+            if (m_size == 0) {
+                throw std::out_of_range("List is empty");
+            }
+            return m_data[m_size - 1];
+        }
+
+        std::size_t size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+
+        const_iterator begin() const { return m_data; }
+        const_iterator end() const { return m_data + m_size; }
+
+    private:
+        void attach(const std::string &source) {
+            const ImageHeader &header = m_image.header();
+            m_size = header.size;
+            if (header.capacity != m_size || header.payloadBytes != image::alignSection(m_size * sizeof(T))) {
+                throw std::runtime_error("Image '" + source + "' has inconsistent section sizes");
+            }
+            m_data = m_image.section<T>(0);
+        }
+    };
+
+    // Writes list to path - see ListImage
+    template<typename T>
+    void saveImage(const FixedList<T> &list, const std::string &path) {
+        image::ImageWriter writer(path);
+        ListImage<T>::write(list, writer);
+    }
+
+    // Publishes list in shared memory for other processes to attach with MappedList
+    template<typename T>
+    void saveImage(const FixedList<T> &list, const SharedMemoryName &segment) {
+        image::SharedMemoryWriter writer(segment);
+        ListImage<T>::write(list, writer);
+    }
+}// namespace ESTL
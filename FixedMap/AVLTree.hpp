@@ -41,16 +41,16 @@ protected:
 
     Node *allocateNode() override {
         Node *node = BaseTree::allocateNode();
-        node->SpecialProps.height = 1;// Leaf node height
+        node->setHeight(1);// Leaf node height
         return node;
     }
 
     void deallocateNode(Node *node) override {
+        node->setHeight(0);// Before the node goes back - a shared pool may hand it out at once
         BaseTree::deallocateNode(node);
-        node->SpecialProps.height = 0;
     }
 
-    int getHeight(Node *node) const { return node && node->in_use ? node->SpecialProps.height : 0; }
+    int getHeight(Node *node) const { return node && node->inUse() ? node->height() : 0; }
 
     /**
      * Calculates the balance factor of a given AVL tree node.
@@ -66,8 +66,8 @@ protected:
     int balanceFactor(Node *node) const { return node ? getHeight(node->left) - getHeight(node->right) : 0; }
 
     void updateHeight(Node *node) {
-        if (node && node->in_use) {
-            node->SpecialProps.height = std::max(getHeight(node->left), getHeight(node->right)) + 1;
+        if (node && node->inUse()) {
+            node->setHeight(std::max(getHeight(node->left), getHeight(node->right)) + 1);
         }
     }
 
@@ -96,30 +96,118 @@ protected:
      */
     void balance(Node *node) {
         while (node) {
-            updateHeight(node);
-            int bf = balanceFactor(node);
+            node = rebalanceNode(node)->parent;
+        }
+    }
 
-            if (bf > 1) {                           // Left Sub-tree heavier
-                if (balanceFactor(node->left) < 0) {//Left-right case - means that right child is heavier
-                    rotateLeft(node->left);
-                }
-                rotateRight(node);
-            } else if (bf < -1) {                    // Right heavy
-                if (balanceFactor(node->right) > 0) {// Right-left case - means that left child is heavier
-                    rotateRight(node->right);
-                }
-                rotateLeft(node);
+    // Updates the height of a single node and rotates it if unbalanced - returns the root of its subtree
+    Node *rebalanceNode(Node *node) {
+        updateHeight(node);
+        int bf = balanceFactor(node);
+
+        ESTL_METRIC(BaseTree::m_counters.rebalances += bf > 1 || bf < -1);
+        if (bf > 1) {                           // Left Sub-tree heavier
+            if (balanceFactor(node->left) < 0) {//Left-right case - means that right child is heavier
+                rotateLeft(node->left);
+            }
+            rotateRight(node);
+            return node->parent;
+        }
+        if (bf < -1) {                           // Right heavy
+            if (balanceFactor(node->right) > 0) {// Right-left case - means that left child is heavier
+                rotateRight(node->right);
             }
-            node = node->parent;
+            rotateLeft(node);
+            return node->parent;
         }
+        return node;
     }
 
 public:
     AVLTree(Node *nodeBuffer, std::size_t capacity)
         : BaseTree(nodeBuffer, capacity) {}
 
+    explicit AVLTree(NodePool<Key, Value> *pool)
+        : BaseTree(pool) {}
+
+    bool canJoin() const override { return true; }
+
+    std::unique_ptr<BaseTree> makeWorker() const override {
+        return std::make_unique<AVLTree>(BaseTree::m_pool);
+    }
+
+    /**
+     * @brief Joins two detached AVL subtrees around a pivot - O(|h(left) - h(right)| + 1).
+     *
+     * The pivot is hung on the taller tree's inner spine at the first node no more than one level taller than the
+     * other tree, then the path back to the root is re-balanced.
+     */
+    Node *joinWithPivot(Node *left, Node *pivot, Node *right) override {
+        left = BaseTree::liveChild(left);
+        right = BaseTree::liveChild(right);
+        if (left) {
+            left->parent = nullptr;
+        }
+        if (right) {
+            right->parent = nullptr;
+        }
+        pivot->parent = nullptr;
+
+        const int leftHeight = getHeight(left);
+        const int rightHeight = getHeight(right);
+        const bool leftTaller = leftHeight > rightHeight + 1;
+        const bool rightTaller = rightHeight > leftHeight + 1;
+        if (! leftTaller && ! rightTaller) {
+            pivot->left = left;
+            pivot->right = right;
+            if (left) {
+                left->parent = pivot;
+            }
+            if (right) {
+                right->parent = pivot;
+            }
+            updateHeight(pivot);
+            return pivot;
+        }
+
+        Node *tall = leftTaller ? left : right;
+        Node *shorter = leftTaller ? right : left;
+        const int target = (leftTaller ? rightHeight : leftHeight) + 1;
+        Node *parent = nullptr;
+        Node *current = tall;
+        while (getHeight(current) > target) {
+            parent = current;
+            current = BaseTree::liveChild(leftTaller ? current->right : current->left);
+        }
+
+        pivot->parent = parent;
+        (leftTaller ? pivot->left : pivot->right) = current;
+        (leftTaller ? pivot->right : pivot->left) = shorter;
+        (leftTaller ? parent->right : parent->left) = pivot;
+        if (current) {
+            current->parent = pivot;
+        }
+        if (shorter) {
+            shorter->parent = pivot;
+        }
+
+        // Re-balance up the spine until a subtree keeps its height - the part above it is unaffected
+        BaseTree::m_root = tall;// rotations at the top move the root through m_root
+        for (Node *node = pivot; node;) {
+            const int before = getHeight(node);
+            Node *subtree = rebalanceNode(node);
+            if (subtree == node && node != pivot && getHeight(node) == before) {
+                break;
+            }
+            node = subtree->parent;
+        }
+        Node *joined = BaseTree::m_root;
+        joined->parent = nullptr;
+        return joined;
+    }
+
     bool insert(const Key &key, const Value &value) override {
-        if (BaseTree::m_size >= BaseTree::m_capacity) {
+        if (BaseTree::m_pool->available() == 0) {// size() would recount after a split or join
             return false;
         }
 #if ENABLE_THREAD_SAFETY
@@ -147,13 +235,13 @@ public:
 
         Node *parent = node->parent;
 
-        if (! node->left || ! node->left->in_use) {
+        if (! node->left || ! node->left->inUse()) {
             BaseTree::transplant(node, node->right);
-        } else if (! node->right || ! node->right->in_use) {
+        } else if (! node->right || ! node->right->inUse()) {
             BaseTree::transplant(node, node->left);
         } else {
             Node *successor = BaseTree::minimum(node->right);
-            parent = successor->parent;
+            parent = successor->parent == node ? successor : successor->parent;// node itself is going away
             Node *child = successor->right;
 
             if (successor->parent == node) {
@@ -0,0 +1,636 @@
+#ifndef ESTL_BPLUSTREE_HPP
+#define ESTL_BPLUSTREE_HPP
+#pragma once
+
+/** Simple Explanation of a B+ Tree
+A B+ Tree is a search tree where every node (here called a "page") holds many sorted keys instead of one. A binary
+tree touches one key per cache line on the way down; a B+ Tree with 8-32 keys per page touches a handful of pages,
+and each page can be searched with a few SIMD compares.
+Key Properties
+    1. Internal pages only hold separator keys and child pointers - they route the search.
+    2. Leaf pages hold the actual entries, sorted, and are linked to their neighbours (prev/next), so a sequential
+       scan walks leaves left to right without going back up the tree.
+    3. Every page except the root is at least half full, so the height stays O(log n) with a large base.
+How It Balances
+    Insertion: When a full page receives a key it splits in two, and a separator is pushed to the parent. A split of
+    the root grows the tree by one level.
+    Deletion: When a page drops below half full it borrows one key from a sibling, or merges with it and removes a
+    separator from the parent. A root left with a single child shrinks the tree by one level.
+Separators
+    In this implementation separator keys[i] is an upper bound of child i: every key in child i is <= keys[i] and
+    every key in child i + 1 is > keys[i]. The child to descend into is therefore the number of separators less than
+    the key - a single "count less" primitive serves both internal and leaf pages.
+Storage
+    Keys live inline in the pages. Values live in the TreeNode buffer supplied by FixedMap (one node per entry), so
+    pointers returned by find() stay valid across splits and merges. Pages are drawn from a pool preallocated once
+    from the map capacity.
+ * */
+
+#include "IBalancedTree.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Counts the keys of a sorted page that compare less than a probe key (generic keys - binary search)
+template<typename Key, typename Compare, typename Enable = void>
+struct BPlusKeySearch {
+    static std::size_t countLess(const Key *keys, std::size_t count, const Key &key, const Compare &comparator) {
+        return std::lower_bound(keys, keys + count, key, comparator) - keys;
+    }
+};
+
+// 32-bit integral keys ordered by std::less - branch-free SIMD compare of the whole page
+template<typename Key>
+struct BPlusKeySearch<Key, std::less<Key>,
+                      typename std::enable_if<std::is_integral<Key>::value && sizeof(Key) == 4>::type> {
+    static std::size_t countLess(const Key *keys, std::size_t count, const Key &key, const std::less<Key> &) {
+        std::size_t less = 0;
+        std::size_t i = 0;
+#if defined(__SSE2__)
+        // Unsigned keys are biased so that the signed compare orders them correctly
+        const std::int32_t bias = std::is_signed<Key>::value ? 0 : INT32_MIN;
+        const __m128i biasVec = _mm_set1_epi32(bias);
+        const __m128i probe = _mm_set1_epi32(static_cast<std::int32_t>(key) ^ bias);
+        for (; i + 4 <= count; i += 4) {
+            __m128i block = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(keys + i)), biasVec);
+            less += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(probe, block))));
+        }
+#endif
+        for (; i < count; ++i) {
+            less += keys[i] < key;
+        }
+        return less;
+    }
+};
+
+// 64-bit integral keys ordered by std::less - needs pcmpgtq (SSE4.2 / AVX2), scalar count otherwise
+template<typename Key>
+struct BPlusKeySearch<Key, std::less<Key>,
+                      typename std::enable_if<std::is_integral<Key>::value && sizeof(Key) == 8>::type> {
+    static std::size_t countLess(const Key *keys, std::size_t count, const Key &key, const std::less<Key> &) {
+        std::size_t less = 0;
+        std::size_t i = 0;
+#if defined(__AVX2__)
+        const std::int64_t bias = std::is_signed<Key>::value ? 0 : INT64_MIN;
+        const __m256i biasVec = _mm256_set1_epi64x(bias);
+        const __m256i probe = _mm256_set1_epi64x(static_cast<std::int64_t>(key) ^ bias);
+        for (; i + 4 <= count; i += 4) {
+            __m256i block = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + i)), biasVec);
+            less += __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(probe, block))));
+        }
+#elif defined(__SSE4_2__)
+        const std::int64_t bias = std::is_signed<Key>::value ? 0 : INT64_MIN;
+        const __m128i biasVec = _mm_set1_epi64x(bias);
+        const __m128i probe = _mm_set1_epi64x(static_cast<std::int64_t>(key) ^ bias);
+        for (; i + 2 <= count; i += 2) {
+            __m128i block = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(keys + i)), biasVec);
+            less += __builtin_popcount(_mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(probe, block))));
+        }
+#endif
+        for (; i < count; ++i) {
+            less += keys[i] < key;
+        }
+        return less;
+    }
+};
+
+// B+ Tree implementation
+template<typename Key, typename Value, typename Compare = std::less<Key>>
+class BPlusTree : public BalancedTree<Key, Value, Compare> {
+    using BaseTree = BalancedTree<Key, Value, Compare>;
+
+public:
+    // Keys per page - about four cache lines of keys, clamped to [8, 32]
+    static constexpr std::size_t Order = 256 / sizeof(Key) < 8 ? 8 : (256 / sizeof(Key) > 32 ? 32 : 256 / sizeof(Key));
+
+protected:
+    using Node = typename BaseTree::Node;
+
+    static constexpr std::size_t MinKeys = Order / 2;// Minimum keys in a non-root page
+    static constexpr std::size_t MaxDepth = 48;      // Internal levels - unreachable with MinKeys >= 4
+    static constexpr std::size_t ScanPrefetch = 4;   // Entries fetched ahead by next()
+
+    struct Page {
+        bool leaf = true;
+        std::size_t count = 0;
+        Key keys[Order];
+        union {
+            Page *children[Order + 1];// Internal page - child i holds keys <= keys[i]
+            Node *entries[Order];     // Leaf page - nodes holding the values for keys[i]
+        };
+        Page *prev = nullptr;// Leaf neighbours
+        Page *next = nullptr;// Leaf neighbours, also links the free page pool
+    };
+
+    Page *m_pages;
+    Page *m_freePages;
+    std::size_t m_pageCapacity;
+    Page *m_rootPage;
+    Page *m_firstLeaf;
+    Page *m_lastLeaf;
+
+    // Worst case page count - every leaf half full plus the internal levels above them
+    static std::size_t pagesFor(std::size_t capacity) {
+        std::size_t leaves = capacity / MinKeys + 2;
+        return leaves + leaves / MinKeys + MaxDepth;
+    }
+
+    void initFreePages() {
+        for (std::size_t i = 0; i < m_pageCapacity - 1; ++i) {
+            m_pages[i].next = &m_pages[i + 1];
+        }
+        m_pages[m_pageCapacity - 1].next = nullptr;
+        m_freePages = &m_pages[0];
+    }
+
+    Page *allocatePage(bool leaf) {
+        if (! m_freePages) {
+            throw std::out_of_range("No more free pages available");
+        }
+        Page *page = m_freePages;
+        m_freePages = m_freePages->next;
+        page->leaf = leaf;
+        page->count = 0;
+        page->prev = page->next = nullptr;
+        return page;
+    }
+
+    void deallocatePage(Page *page) {
+        page->next = m_freePages;
+        m_freePages = page;
+    }
+
+    std::size_t countLess(const Page *page, const Key &key) const {
+        return BPlusKeySearch<Key, Compare>::countLess(page->keys, page->count, key, BaseTree::m_comparator);
+    }
+
+    // Records the owning leaf in the nodes of entries [from, to)
+    void attach(Page *leaf, std::size_t from, std::size_t to) {
+        const int index = static_cast<int>(leaf - m_pages);
+        for (std::size_t i = from; i < to; ++i) {
+            leaf->entries[i]->setLeaf(index);
+        }
+    }
+
+    Page *leafOf(const Node *node) const { return &m_pages[node->leaf()]; }
+
+    // Walks from the root to the leaf that should hold key, recording internal pages and child slots
+    Page *descend(const Key &key, Page **path, std::size_t *slots, std::size_t &depth) const {
+        depth = 0;
+        Page *page = m_rootPage;
+        while (! page->leaf) {
+            std::size_t slot = countLess(page, key);
+            path[depth] = page;
+            slots[depth] = slot;
+            ++depth;
+            page = page->children[slot];
+        }
+        return page;
+    }
+
+    Node *lookup(const Key &key) const {
+        if (! m_rootPage) {
+            return nullptr;
+        }
+        Page *page = m_rootPage;
+        while (! page->leaf) {
+            page = page->children[countLess(page, key)];
+        }
+        std::size_t pos = countLess(page, key);
+        if (pos < page->count && ! BaseTree::m_comparator(key, page->keys[pos])) {
+            return page->entries[pos];
+        }
+        return nullptr;
+    }
+
+    /** @brief Splits a full leaf, moving its upper half to a new right neighbour.
+     *
+     *   [a b c d]  -->  [a b] <-> [c d]
+     *
+     * @param leaf The full leaf.
+     * @return The new right leaf.
+     */
+    Page *splitLeaf(Page *leaf) {
+        ESTL_METRIC(++BaseTree::m_counters.rebalances);
+        Page *right = allocatePage(true);
+        const std::size_t keep = Order / 2;
+        for (std::size_t i = keep; i < leaf->count; ++i) {
+            right->keys[i - keep] = std::move(leaf->keys[i]);
+            right->entries[i - keep] = leaf->entries[i];
+        }
+        right->count = leaf->count - keep;
+        leaf->count = keep;
+        attach(right, 0, right->count);
+
+        right->prev = leaf;
+        right->next = leaf->next;
+        if (leaf->next) {
+            leaf->next->prev = right;
+        } else {
+            m_lastLeaf = right;
+        }
+        leaf->next = right;
+        return right;
+    }
+
+    /** @brief Inserts separator/child pairs produced by a split into the ancestors, splitting full pages upwards.
+     *
+     * @param separator Upper bound of the left half of the split page.
+     * @param child The new right half.
+     */
+    void insertIntoParents(Key separator, Page *child, Page **path, std::size_t *slots, std::size_t depth) {
+        while (depth > 0) {
+            --depth;
+            Page *parent = path[depth];
+            const std::size_t slot = slots[depth];
+
+            if (parent->count < Order) {
+                for (std::size_t i = parent->count; i > slot; --i) {
+                    parent->keys[i] = std::move(parent->keys[i - 1]);
+                    parent->children[i + 1] = parent->children[i];
+                }
+                parent->keys[slot] = std::move(separator);
+                parent->children[slot + 1] = child;
+                ++parent->count;
+                return;
+            }
+
+            // Full internal page - lay out the Order + 1 keys, then promote the middle one
+            Key keys[Order + 1];
+            Page *children[Order + 2];
+            for (std::size_t i = 0, k = 0; i <= Order; ++i) {
+                keys[i] = i == slot ? std::move(separator) : std::move(parent->keys[k++]);
+            }
+            for (std::size_t i = 0, k = 0; i <= Order + 1; ++i) {
+                children[i] = i == slot + 1 ? child : parent->children[k++];
+            }
+
+            const std::size_t keep = (Order + 1) / 2;
+            Page *right = allocatePage(false);
+            ESTL_METRIC(++BaseTree::m_counters.rebalances);
+            for (std::size_t i = 0; i < keep; ++i) {
+                parent->keys[i] = std::move(keys[i]);
+                parent->children[i] = children[i];
+            }
+            parent->children[keep] = children[keep];
+            parent->count = keep;
+            for (std::size_t i = keep + 1; i <= Order; ++i) {
+                right->keys[i - keep - 1] = std::move(keys[i]);
+                right->children[i - keep - 1] = children[i];
+            }
+            right->children[Order - keep] = children[Order + 1];
+            right->count = Order - keep;
+
+            separator = std::move(keys[keep]);
+            child = right;
+        }
+
+        // The root itself was split - grow the tree by one level
+        Page *root = allocatePage(false);
+        root->keys[0] = std::move(separator);
+        root->children[0] = m_rootPage;
+        root->children[1] = child;
+        root->count = 1;
+        m_rootPage = root;
+    }
+
+    // Removes separator keys[index] and child index + 1 from an internal page
+    static void removeSeparator(Page *parent, std::size_t index) {
+        for (std::size_t i = index; i + 1 < parent->count; ++i) {
+            parent->keys[i] = std::move(parent->keys[i + 1]);
+            parent->children[i + 1] = parent->children[i + 2];
+        }
+        --parent->count;
+    }
+
+    // Appends right to left and releases right; separator keys[index] between them is dropped from the parent
+    void mergeLeaves(Page *left, Page *right, Page *parent, std::size_t index) {
+        ESTL_METRIC(++BaseTree::m_counters.rebalances);
+        for (std::size_t i = 0; i < right->count; ++i) {
+            left->keys[left->count + i] = std::move(right->keys[i]);
+            left->entries[left->count + i] = right->entries[i];
+        }
+        attach(left, left->count, left->count + right->count);
+        left->count += right->count;
+
+        left->next = right->next;
+        if (right->next) {
+            right->next->prev = left;
+        } else {
+            m_lastLeaf = left;
+        }
+        deallocatePage(right);
+        removeSeparator(parent, index);
+    }
+
+    // Appends right to left pulling down the separator keys[index] between them, and releases right
+    void mergeInner(Page *left, Page *right, Page *parent, std::size_t index) {
+        ESTL_METRIC(++BaseTree::m_counters.rebalances);
+        left->keys[left->count] = std::move(parent->keys[index]);
+        for (std::size_t i = 0; i < right->count; ++i) {
+            left->keys[left->count + 1 + i] = std::move(right->keys[i]);
+            left->children[left->count + 1 + i] = right->children[i];
+        }
+        left->children[left->count + 1 + right->count] = right->children[right->count];
+        left->count += 1 + right->count;
+        deallocatePage(right);
+        removeSeparator(parent, index);
+    }
+
+    /** @brief Restores the minimum occupancy of a leaf after an erase.
+     *
+     * Borrows an entry from a sibling that has spare entries, otherwise merges with a sibling and continues with
+     * the parent, which lost a separator.
+     */
+    void rebalanceLeaf(Page *leaf, Page **path, std::size_t *slots, std::size_t depth) {
+        if (depth == 0) {// Leaf is the root
+            if (leaf->count == 0) {
+                deallocatePage(leaf);
+                m_rootPage = m_firstLeaf = m_lastLeaf = nullptr;
+            }
+            return;
+        }
+        if (leaf->count >= MinKeys) {
+            return;
+        }
+
+        Page *parent = path[depth - 1];
+        const std::size_t slot = slots[depth - 1];
+        Page *left = slot > 0 ? parent->children[slot - 1] : nullptr;
+        Page *right = slot < parent->count ? parent->children[slot + 1] : nullptr;
+
+        if (left && left->count > MinKeys) {// Borrow the largest entry of the left sibling
+            for (std::size_t i = leaf->count; i > 0; --i) {
+                leaf->keys[i] = std::move(leaf->keys[i - 1]);
+                leaf->entries[i] = leaf->entries[i - 1];
+            }
+            --left->count;
+            leaf->keys[0] = std::move(left->keys[left->count]);
+            leaf->entries[0] = left->entries[left->count];
+            ++leaf->count;
+            attach(leaf, 0, 1);
+            parent->keys[slot - 1] = left->keys[left->count - 1];
+            return;
+        }
+        if (right && right->count > MinKeys) {// Borrow the smallest entry of the right sibling
+            leaf->keys[leaf->count] = std::move(right->keys[0]);
+            leaf->entries[leaf->count] = right->entries[0];
+            attach(leaf, leaf->count, leaf->count + 1);
+            ++leaf->count;
+            for (std::size_t i = 0; i + 1 < right->count; ++i) {
+                right->keys[i] = std::move(right->keys[i + 1]);
+                right->entries[i] = right->entries[i + 1];
+            }
+            --right->count;
+            parent->keys[slot] = leaf->keys[leaf->count - 1];
+            return;
+        }
+
+        if (left) {
+            mergeLeaves(left, leaf, parent, slot - 1);
+        } else {
+            mergeLeaves(leaf, right, parent, slot);
+        }
+        rebalanceInner(path, slots, depth - 1);
+    }
+
+    // Same as rebalanceLeaf for the internal page path[depth], walking up while merges propagate
+    void rebalanceInner(Page **path, std::size_t *slots, std::size_t depth) {
+        while (true) {
+            Page *page = path[depth];
+            if (depth == 0) {// Root with a single child - shrink the tree by one level
+                if (page->count == 0) {
+                    m_rootPage = page->children[0];
+                    deallocatePage(page);
+                }
+                return;
+            }
+            if (page->count >= MinKeys) {
+                return;
+            }
+
+            Page *parent = path[depth - 1];
+            const std::size_t slot = slots[depth - 1];
+            Page *left = slot > 0 ? parent->children[slot - 1] : nullptr;
+            Page *right = slot < parent->count ? parent->children[slot + 1] : nullptr;
+
+            if (left && left->count > MinKeys) {// Rotate right through the parent separator
+                page->children[page->count + 1] = page->children[page->count];
+                for (std::size_t i = page->count; i > 0; --i) {
+                    page->keys[i] = std::move(page->keys[i - 1]);
+                    page->children[i] = page->children[i - 1];
+                }
+                page->keys[0] = std::move(parent->keys[slot - 1]);
+                page->children[0] = left->children[left->count];
+                ++page->count;
+                --left->count;
+                parent->keys[slot - 1] = std::move(left->keys[left->count]);
+                return;
+            }
+            if (right && right->count > MinKeys) {// Rotate left through the parent separator
+                page->keys[page->count] = std::move(parent->keys[slot]);
+                page->children[page->count + 1] = right->children[0];
+                ++page->count;
+                parent->keys[slot] = std::move(right->keys[0]);
+                for (std::size_t i = 0; i + 1 < right->count; ++i) {
+                    right->keys[i] = std::move(right->keys[i + 1]);
+                    right->children[i] = right->children[i + 1];
+                }
+                right->children[right->count - 1] = right->children[right->count];
+                --right->count;
+                return;
+            }
+
+            if (left) {
+                mergeInner(left, page, parent, slot - 1);
+            } else {
+                mergeInner(page, right, parent, slot);
+            }
+            --depth;
+        }
+    }
+
+public:
+    BPlusTree(Node *nodeBuffer, std::size_t capacity)
+        : BaseTree(nodeBuffer, capacity)
+        , m_pages(new Page[pagesFor(capacity)])
+        , m_freePages(nullptr)
+        , m_pageCapacity(pagesFor(capacity))
+        , m_rootPage(nullptr)
+        , m_firstLeaf(nullptr)
+        , m_lastLeaf(nullptr) {
+        initFreePages();
+    }
+
+    ~BPlusTree() override { delete[] m_pages; }
+
+    bool insert(const Key &key, const Value &value) override {
+#if ENABLE_THREAD_SAFETY
+        std::lock_guard<std::mutex> lock(BaseTree::m_mutex);
+#endif
+        if (BaseTree::m_pool->available() == 0) {// Under the lock - concurrent inserts and erases change it
+            return false;
+        }
+        if (! m_rootPage) {
+            m_rootPage = m_firstLeaf = m_lastLeaf = allocatePage(true);
+        }
+
+        Page *path[MaxDepth];
+        std::size_t slots[MaxDepth];
+        std::size_t depth;
+        Page *leaf = descend(key, path, slots, depth);
+        std::size_t pos = countLess(leaf, key);
+        if (pos < leaf->count && ! BaseTree::m_comparator(key, leaf->keys[pos])) {
+            return false;// Duplicate key
+        }
+
+        Node *newNode = BaseTree::allocateNode();
+        BaseTree::constructEntry(newNode, key, value);
+
+        Page *right = nullptr;
+        if (leaf->count == Order) {
+            right = splitLeaf(leaf);
+            if (pos > leaf->count) {
+                pos -= leaf->count;
+                leaf = right;
+            }
+        }
+
+        for (std::size_t i = leaf->count; i > pos; --i) {
+            leaf->keys[i] = std::move(leaf->keys[i - 1]);
+            leaf->entries[i] = leaf->entries[i - 1];
+        }
+        leaf->keys[pos] = key;
+        leaf->entries[pos] = newNode;
+        ++leaf->count;
+        attach(leaf, pos, pos + 1);
+
+        if (right) {
+            // Separator is taken after the insert so that it bounds the left half including the new key
+            Page *left = right->prev;
+            insertIntoParents(left->keys[left->count - 1], right, path, slots, depth);
+        }
+        ++BaseTree::m_size;
+        return true;
+    }
+
+    bool erase(const Key &key) override {
+#if ENABLE_THREAD_SAFETY
+        std::lock_guard<std::mutex> lock(BaseTree::m_mutex);
+#endif
+        if (! m_rootPage) {
+            return false;
+        }
+
+        Page *path[MaxDepth];
+        std::size_t slots[MaxDepth];
+        std::size_t depth;
+        Page *leaf = descend(key, path, slots, depth);
+        std::size_t pos = countLess(leaf, key);
+        if (pos >= leaf->count || BaseTree::m_comparator(key, leaf->keys[pos])) {
+            return false;
+        }
+
+        Node *node = leaf->entries[pos];
+        for (std::size_t i = pos; i + 1 < leaf->count; ++i) {
+            leaf->keys[i] = std::move(leaf->keys[i + 1]);
+            leaf->entries[i] = leaf->entries[i + 1];
+        }
+        --leaf->count;
+        BaseTree::deallocateNode(node);
+        --BaseTree::m_size;
+
+        rebalanceLeaf(leaf, path, slots, depth);
+        return true;
+    }
+
+    void clear() override {
+        for (Page *leaf = m_firstLeaf; leaf; leaf = leaf->next) {
+            for (std::size_t i = 0; i < leaf->count; ++i) {
+                BaseTree::deallocateNode(leaf->entries[i]);
+            }
+        }
+        initFreePages();
+        m_rootPage = m_firstLeaf = m_lastLeaf = nullptr;
+        BaseTree::m_size = 0;
+    }
+
+    // Entries hang off the root page - the base m_root is never set
+    bool empty() const override { return ! m_rootPage; }
+
+    // Pages from the root to the leaves - every leaf is at the same depth
+    std::size_t height() const override {
+        std::size_t levels = 0;
+        for (const Page *page = m_rootPage; page; page = page->leaf ? nullptr : page->children[0]) {
+            ++levels;
+        }
+        return levels;
+    }
+
+    Node *findNode(const Key &key) const override {
+#if ENABLE_THREAD_SAFETY
+        std::lock_guard<std::mutex> lock(BaseTree::m_mutex);
+#endif
+        return lookup(key);
+    }
+
+    Node *lowerBound(const Key &key) const override {
+#if ENABLE_THREAD_SAFETY
+        std::lock_guard<std::mutex> lock(BaseTree::m_mutex);
+#endif
+        if (! m_rootPage) {
+            return nullptr;
+        }
+        Page *page = m_rootPage;
+        while (! page->leaf) {
+            page = page->children[countLess(page, key)];
+        }
+        std::size_t pos = countLess(page, key);
+        if (pos < page->count) {
+            return page->entries[pos];
+        }
+        return page->next ? page->next->entries[0] : nullptr;
+    }
+
+    Node *minimum() override { return m_firstLeaf ? m_firstLeaf->entries[0] : nullptr; }
+
+    // Successor in key order - the next slot of the same leaf, or the first slot of the linked next leaf
+    Node *next(Node *node) override {
+        if (! node || ! node->inUse()) {
+            return nullptr;
+        }
+        Page *leaf = leafOf(node);
+        std::size_t pos = countLess(leaf, node->key) + 1;
+        if (pos < leaf->count) {
+            // Entries sit in pool order, not key order - fetch a few ahead so a scan overlaps the misses
+            if (pos + ScanPrefetch < leaf->count) {
+                __builtin_prefetch(leaf->entries[pos + ScanPrefetch]);
+            } else if (leaf->next && pos + ScanPrefetch - leaf->count < leaf->next->count) {
+                __builtin_prefetch(leaf->next->entries[pos + ScanPrefetch - leaf->count]);
+            }
+            return leaf->entries[pos];
+        }
+        return leaf->next ? leaf->next->entries[0] : nullptr;
+    }
+
+    // Predecessor in key order; a null node (end) yields the maximum
+    Node *prev(Node *node) override {
+        if (! node || ! node->inUse()) {
+            return m_lastLeaf ? m_lastLeaf->entries[m_lastLeaf->count - 1] : nullptr;
+        }
+        Page *leaf = leafOf(node);
+        std::size_t pos = countLess(leaf, node->key);
+        if (pos > 0) {
+            return leaf->entries[pos - 1];
+        }
+        return leaf->prev ? leaf->prev->entries[leaf->prev->count - 1] : nullptr;
+    }
+};
+
+#endif//ESTL_BPLUSTREE_HPP
@@ -6,10 +6,12 @@
 #define ESTL_BALANCEDTREEFACTORY_HPP
 
 #include "AVLTree.hpp"
+#include "BPlusTree.hpp"
+#include "PersistentTree.hpp"
 #include "RedBlackTree.hpp"
 #include <memory>
 
-enum TreeType { RedBlack, AVL };
+enum TreeType { RedBlack, AVL, BPlus, Persistent };
 
 
 template<typename Key, typename Value, typename Compare = std::less<Key>>
@@ -23,9 +25,27 @@ public:
             case TreeType::AVL:
                 return std::move(
                         std::make_unique<AVLTree<Key, Value, Compare>>(buffer, capacity));
+            case TreeType::BPlus:
+                return std::move(
+                        std::make_unique<BPlusTree<Key, Value, Compare>>(buffer, capacity));
+            case TreeType::Persistent:
+                return std::move(
+                        std::make_unique<PersistentTree<Key, Value, Compare>>(buffer, capacity));
             default:
                 throw std::invalid_argument("Unknown tree type");
         }
     }
+
+    // Tree over a pool shared with other trees - only the engines that support split/join can share nodes
+    static std::unique_ptr<BalancedTree<Key, Value, Compare>> createTree(TreeType type, NodePool<Key, Value> *pool) {
+        switch (type) {
+            case TreeType::RedBlack:
+                return std::make_unique<RBTree<Key, Value, Compare>>(pool);
+            case TreeType::AVL:
+                return std::make_unique<AVLTree<Key, Value, Compare>>(pool);
+            default:
+                throw std::invalid_argument("Shared node pools require TreeType::RedBlack or TreeType::AVL");
+        }
+    }
 };
 #endif//ESTL_BALANCEDTREEFACTORY_HPP
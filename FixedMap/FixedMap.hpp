@@ -1,5 +1,7 @@
 #pragma once
 
+#include "../ESTLMemory.hpp"
+#include "../ESTLTrace.hpp"
 #include "BalancedTreeFactory.hpp"
 #include "IBalancedTree.hpp"
 #include <array>
@@ -7,23 +9,98 @@
 #include <memory>
 #include <mutex>
 #include <stdexcept>
+#include <typeinfo>
+#include <utility>
 
 #ifndef ENABLE_THREAD_SAFETY
 #define ENABLE_THREAD_SAFETY true
 #endif
 
 namespace ESTL {
+    template<typename K, typename V, typename C>
+    class MapImage;
+    class Serialization;
+
     // FixedMap class using BalancedTreeWP interface
     template<typename Key, typename Value, typename Compare = std::less<Key>>
     class FixedMap {
         using BalancedTreeWP = BalancedTree<Key, Value, Compare>;
+        template<typename K, typename V, typename C>
+        friend class MapImage;
+        friend class Serialization;
 
     protected:
         std::unique_ptr<BalancedTreeWP> m_tree;
         std::size_t m_capacity;
 #if ENABLE_THREAD_SAFETY
-        mutable std::mutex m_mutex;
+        mutable ContainerMutex m_mutex;
+#endif
+
+        // Nodes can be relinked between the maps only if they come from one pool and follow the same invariants
+        bool sharesNodesWith(const FixedMap &other) const {
+            return m_tree->pool() == other.m_tree->pool() && m_tree->canJoin() &&
+                   typeid(*m_tree) == typeid(*other.m_tree);
+        }
+
+        /**
+         * Set operation with other, which is left empty. Join-based divide and conquer when the maps share nodes,
+         * otherwise element-wise copies and erases.
+         */
+        void combine(FixedMap &other, SetOperation operation) {
+            if (&other == this) {
+                throw std::invalid_argument("Cannot combine a map with itself");
+            }
+#if ENABLE_THREAD_SAFETY
+            std::lock(m_mutex, other.m_mutex);
+            std::lock_guard<ContainerMutex> lock(m_mutex, std::adopt_lock);
+            std::lock_guard<ContainerMutex> otherLock(other.m_mutex, std::adopt_lock);
 #endif
+            if (sharesNodesWith(other)) {
+                m_tree->combineWith(*other.m_tree, operation);
+                return;
+            }
+
+            if (operation == SetOperation::Union) {
+                std::size_t added = 0;
+                for (auto *node = other.m_tree->minimum(); node; node = other.m_tree->next(node)) {
+                    added += m_tree->find(node->key) ? 0 : 1;
+                }
+                if (m_tree->size() + added > m_capacity) {
+                    throw std::out_of_range("Map is too small for the union");
+                }
+                for (auto *node = other.m_tree->minimum(); node; node = other.m_tree->next(node)) {
+                    m_tree->insert(node->key, node->value);
+                }
+            } else {
+                auto *node = m_tree->minimum();
+                while (node) {
+                    bool inOther = other.m_tree->find(node->key) != nullptr;
+                    bool drop = operation == SetOperation::Intersection ? ! inOther : inOther;
+                    auto *next = m_tree->next(node);
+                    if (drop) {
+                        // Erasing may move nodes (B+ pages), so re-seek the successor by key
+                        Key key = node->key;
+                        if (next) {
+                            Key nextKey = next->key;
+                            m_tree->erase(key);
+                            next = m_tree->lowerBound(nextKey);
+                        } else {
+                            m_tree->erase(key);
+                        }
+                    }
+                    node = next;
+                }
+            }
+            other.m_tree->clear();
+        }
+
+        // Takes other's tree as is - O(1), for RT maps whose node array can change hands. other is left without a
+        // tree: it can only be destroyed or assigned to.
+        FixedMap(FixedMap &&other) noexcept
+            : m_tree(std::move(other.m_tree))
+            , m_capacity(other.m_capacity) {
+            other.m_capacity = 0;
+        }
 
     public:
         FixedMap(TreeNode<Key, Value> *buffer, std::size_t capacity, TreeType treeType = TreeType::RedBlack)
@@ -40,26 +117,51 @@ namespace ESTL {
             }
         }
 
+        // Map drawing its nodes from a pool shared with other maps - split/join between them move nodes in O(log n)
+        FixedMap(NodePool<Key, Value> &pool, TreeType treeType = TreeType::RedBlack)
+            : m_capacity(pool.capacity()) {
+            m_tree = BalancedTreeFactory<Key, Value, Compare>::createTree(treeType, &pool);
+        }
+
         void initFreeNodes() { m_tree->initFreeNodes(); }
 
+        // Occupancy and shape snapshot - the tree height is O(size). The pool is the node pool, shared or not.
+        ContainerMetrics metrics() const {
+#if ENABLE_THREAD_SAFETY
+            std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
+            ContainerMetrics result;
+            result.size = m_tree->size();
+            result.capacity = m_capacity;
+            result.loadFactor = m_capacity ? double(result.size) / m_capacity : 0;
+            m_tree->collectMetrics(result);
+#if ESTL_ENABLE_METRICS && ENABLE_THREAD_SAFETY
+            result.lockWait = m_mutex.histogram();
+#endif
+            return result;
+        }
+
         bool insert(const Key &key, const Value &value) {
 #if ENABLE_THREAD_SAFETY
-            std::lock_guard<std::mutex> lock(m_mutex);
+            std::lock_guard<ContainerMutex> lock(m_mutex);
 #endif
+            ESTL_TRACE(trace::Span span(TraceKind::OrderedMap, TraceOp::Insert, this, m_tree->size()));
             return m_tree->insert(key, value);
         }
 
         bool erase(const Key &key) {
 #if ENABLE_THREAD_SAFETY
-            std::lock_guard<std::mutex> lock(m_mutex);
+            std::lock_guard<ContainerMutex> lock(m_mutex);
 #endif
+            ESTL_TRACE(trace::Span span(TraceKind::OrderedMap, TraceOp::Erase, this, m_tree->size()));
             return m_tree->erase(key);
         }
 
         Value *find(const Key &key) {
 #if ENABLE_THREAD_SAFETY
-            std::lock_guard<std::mutex> lock(m_mutex);
+            std::lock_guard<ContainerMutex> lock(m_mutex);
 #endif
+            ESTL_TRACE(trace::Span span(TraceKind::OrderedMap, TraceOp::Find, this, m_tree->size()));
             return m_tree->find(key);
         }
 
@@ -73,29 +175,25 @@ namespace ESTL {
 
         void clear() {
 #if ENABLE_THREAD_SAFETY
-            std::lock_guard<std::mutex> lock(m_mutex);
+            std::lock_guard<ContainerMutex> lock(m_mutex);
 #endif
+            ESTL_TRACE(trace::Span span(TraceKind::OrderedMap, TraceOp::Clear, this, m_tree->size()));
             m_tree->clear();
         }
 
         // Insert or assign a key-value pair
         bool insert_or_assign(const Key &key, const Value &value) {
         #if ENABLE_THREAD_SAFETY
-            std::lock_guard<std::mutex> lock(m_mutex);
+            std::lock_guard<ContainerMutex> lock(m_mutex);
         #endif
-            Value *found = m_tree->find(key);
-            if (found) {
-                *found = value;
-                return false;
-            } else {
-                return m_tree->insert(key, value);
-            }
+            ESTL_TRACE(trace::Span span(TraceKind::OrderedMap, TraceOp::InsertOrAssign, this, m_tree->size()));
+            return m_tree->insertOrAssign(key, value);
         }
 
         // Extract a key-value pair by key
         std::pair<Key, Value> extract(const Key &key) {
         #if ENABLE_THREAD_SAFETY
-            std::lock_guard<std::mutex> lock(m_mutex);
+            std::lock_guard<ContainerMutex> lock(m_mutex);
         #endif
             Value *found = m_tree->find(key);
             if (!found) {
@@ -109,29 +207,138 @@ namespace ESTL {
         // Merge another FixedMap into this one
         void merge(FixedMap &other) {
         #if ENABLE_THREAD_SAFETY
-            std::lock_guard<std::mutex> otherLock(other.m_mutex);
+            std::lock_guard<ContainerMutex> otherLock(other.m_mutex);
         #endif
             for (auto it = other.begin(); it != other.end(); ++it) {
                 this->insert(it->first, it->second);
             }
         }
 
+        /**
+         * @brief Bulk set operations - this map becomes this ∪ other, this ∩ other or this \ other.
+         *
+         * Keys present in both maps keep this map's value. other is left empty. When both maps share a node pool and
+         * a join-capable engine the operation is join-based divide and conquer in O(m log(n/m + 1)) work, with the
+         * independent halves spread over the hardware threads; otherwise elements are copied one by one.
+         *
+         * @throws std::invalid_argument if other is this map.
+         * @throws std::out_of_range if the union does not fit - neither map is modified.
+         */
+        void set_union(FixedMap &other) { combine(other, SetOperation::Union); }
+        void set_intersection(FixedMap &other) { combine(other, SetOperation::Intersection); }
+        void set_difference(FixedMap &other) { combine(other, SetOperation::Difference); }
+
+        // O(1), except the first call after an O(log n) split, which counts the elements in O(size)
         std::size_t size() const {
 #if ENABLE_THREAD_SAFETY
-            std::lock_guard<std::mutex> lock(m_mutex);
+            std::lock_guard<ContainerMutex> lock(m_mutex);
 #endif
             return m_tree->size();
         }
 
         bool empty() const {
 #if ENABLE_THREAD_SAFETY
-            std::lock_guard<std::mutex> lock(m_mutex);
+            std::lock_guard<ContainerMutex> lock(m_mutex);
 #endif
             return m_tree->empty();
         }
 
         std::size_t capacity() const { return m_capacity; }
 
+        /**
+         * @brief Moves every element with a key not less than key into the empty map right.
+         *
+         * O(log n) when both maps share a node pool and use the same join-capable engine, otherwise the elements are
+         * copied into right and erased here. The O(log n) split leaves both sizes to be recounted: the next call that
+         * reads the size - size(), a traced insert, erase or find, a set operation - walks the map once in O(size).
+         *
+         * @throws std::invalid_argument if right is this map or not empty.
+         * @throws std::out_of_range if right cannot hold the moved elements - neither map is modified.
+         */
+        void split(const Key &key, FixedMap &right) {
+            if (&right == this) {
+                throw std::invalid_argument("Cannot split a map into itself");
+            }
+#if ENABLE_THREAD_SAFETY
+            std::lock(m_mutex, right.m_mutex);
+            std::lock_guard<ContainerMutex> lock(m_mutex, std::adopt_lock);
+            std::lock_guard<ContainerMutex> rightLock(right.m_mutex, std::adopt_lock);
+#endif
+            if (! right.m_tree->empty()) {
+                throw std::invalid_argument("Split target must be empty");
+            }
+            if (sharesNodesWith(right)) {
+                m_tree->splitInto(key, *right.m_tree);
+                return;
+            }
+
+            std::size_t count = 0;
+            for (auto *node = m_tree->lowerBound(key); node; node = m_tree->next(node)) {
+                ++count;
+            }
+            if (count > right.m_capacity) {
+                throw std::out_of_range("Split target is too small");
+            }
+            for (auto *node = m_tree->lowerBound(key); node; node = m_tree->next(node)) {
+                right.m_tree->insert(node->key, node->value);
+            }
+            for (auto *node = right.m_tree->minimum(); node; node = right.m_tree->next(node)) {
+                m_tree->erase(node->key);
+            }
+        }
+
+        /**
+         * @brief Moves every element of right, whose keys must all be greater than this map's keys, into this map.
+         *
+         * O(log n) when both maps share a node pool and use the same join-capable engine, otherwise the elements are
+         * copied here and right is cleared. Joining a map that was split and not counted since defers its size to the
+         * next size() call, as split does.
+         *
+         * @throws std::invalid_argument if right is this map or its keys do not all follow this map's keys.
+         * @throws std::out_of_range if this map cannot hold the moved elements - neither map is modified.
+         */
+        void join(FixedMap &right) {
+            if (&right == this) {
+                throw std::invalid_argument("Cannot join a map with itself");
+            }
+#if ENABLE_THREAD_SAFETY
+            std::lock(m_mutex, right.m_mutex);
+            std::lock_guard<ContainerMutex> lock(m_mutex, std::adopt_lock);
+            std::lock_guard<ContainerMutex> rightLock(right.m_mutex, std::adopt_lock);
+#endif
+            auto *last = m_tree->prev(nullptr);
+            auto *first = right.m_tree->minimum();
+            if (! first) {
+                return;
+            }
+            if (last && ! Compare()(last->key, first->key)) {
+                throw std::invalid_argument("Joined keys must all be greater than the map's keys");
+            }
+            if (sharesNodesWith(right)) {
+                m_tree->joinFrom(*right.m_tree);
+                return;
+            }
+
+            if (m_tree->size() + right.m_tree->size() > m_capacity) {
+                throw std::out_of_range("Map is too small for the joined elements");
+            }
+            for (auto *node = first; node; node = right.m_tree->next(node)) {
+                m_tree->insert(node->key, node->value);
+            }
+            right.m_tree->clear();
+        }
+
+        using Snapshot = typename PersistentTree<Key, Value, Compare>::Snapshot;
+
+        // Lock-free, consistent read view of the map - requires TreeType::Persistent
+        Snapshot snapshot() {
+            auto *tree = dynamic_cast<PersistentTree<Key, Value, Compare> *>(m_tree.get());
+            if (! tree) {
+                throw std::logic_error("Snapshots require TreeType::Persistent");
+            }
+            return tree->snapshot();
+        }
+
         class Iterator {
             using Node = TreeNode<Key, Value>;
         private:
@@ -165,7 +372,7 @@ namespace ESTL {
             }
 
             std::pair<const Key, Value> operator*() const {
-                if (! m_current || ! m_current->in_use)
+                if (! m_current || ! m_current->inUse())
                     throw std::runtime_error("Dereferencing invalid iterator");
                 return {m_current->key, m_current->value};
             }
@@ -183,8 +390,45 @@ namespace ESTL {
 
         Iterator begin() { return Iterator(m_tree->minimum(), m_tree.get()); }
         Iterator end() { return Iterator(nullptr, m_tree.get()); }
+
+        // First element whose key is not less than key - start point for range scans
+        Iterator lower_bound(const Key &key) {
+#if ENABLE_THREAD_SAFETY
+            std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
+            return Iterator(m_tree->lowerBound(key), m_tree.get());
+        }
+    };
+
+
+    // Compile-time node pool shared by several maps
+    template<typename Key, typename Value, std::size_t N>
+    class CTNodePool : public NodePool<Key, Value> {
+        std::array<TreeNode<Key, Value>, N> m_buckets;
+
+    public:
+        CTNodePool() : NodePool<Key, Value>(m_buckets.data(), N, true) {
+            this->init();// the buffer is constructed after the base
+        }
+
+        ~CTNodePool() { this->destroyLive(); }
     };
 
+    // Run-time node pool shared by several maps
+    template<typename Key, typename Value>
+    class RTNodePool : public NodePool<Key, Value> {
+        MemoryResource *m_resource;
+
+    public:
+        explicit RTNodePool(std::size_t capacity, MemoryResource *resource = defaultResource())
+            : NodePool<Key, Value>(memory::createArray<TreeNode<Key, Value>>(resource, capacity), capacity, true)
+            , m_resource(resource) {}
+
+        ~RTNodePool() {
+            this->destroyLive();
+            memory::destroyArray(m_resource, this->nodes(), this->capacity());
+        }
+    };
 
     // Compile-time fixed unordered map
     template<typename Key, typename Value, std::size_t N, typename Compare = std::less<Key>>
@@ -198,6 +442,9 @@ namespace ESTL {
             this->initFreeNodes();
         }
 
+        // The tree destroys its entries - before m_buckets goes
+        ~CTMap() { this->m_tree.reset(); }
+
         CTMap(std::initializer_list<std::pair<const Key, Value>> initList, TreeType treeType = TreeType::RedBlack)
             : CTMap(treeType) {
             for (const auto &item: initList) {
@@ -210,21 +457,56 @@ namespace ESTL {
     template<typename Key, typename Value, typename Compare = std::less<Key>>
     class RTMap : public FixedMap<Key, Value, Compare> {
     TreeNode<Key, Value>* dynamicNodes;
+    MemoryResource *m_resource;
 
     public:
-        explicit RTMap(std::size_t capacity, TreeType treeType = TreeType::RedBlack) : FixedMap<Key, Value, Compare>(
-                      dynamicNodes = new TreeNode<Key, Value>[capacity], capacity, treeType) {
+        // Node storage comes from resource, the heap by default
+        explicit RTMap(std::size_t capacity, TreeType treeType = TreeType::RedBlack,
+                       MemoryResource *resource = defaultResource())
+            : FixedMap<Key, Value, Compare>(
+                      dynamicNodes = memory::createArray<TreeNode<Key, Value>>(resource, capacity), capacity, treeType)
+            , m_resource(resource) {
             this->initFreeNodes();
         }
 
         RTMap(std::initializer_list<std::pair<const Key, Value>> initList, std::size_t capacity = 0 ,
-              TreeType treeType = TreeType::RedBlack) : RTMap(capacity ? capacity : initList.size(), treeType) {
+              TreeType treeType = TreeType::RedBlack, MemoryResource *resource = defaultResource())
+            : RTMap(capacity ? capacity : initList.size(), treeType, resource) {
             for (const auto &item: initList) {
                 this->insert(item.first, item.second);
             }
         }
 
-        ~RTMap() { delete[] dynamicNodes; }
+        ~RTMap() {
+            this->m_tree.reset();// destroys the entries while the nodes exist
+            memory::destroyArray(m_resource, dynamicNodes, this->m_capacity);
+        }
+
+        RTMap(const RTMap &) = delete;
+        RTMap &operator=(const RTMap &) = delete;
+
+        // The tree and its nodes change hands, nothing is relinked
+        RTMap(RTMap &&other) noexcept
+            : FixedMap<Key, Value, Compare>(std::move(other))
+            , dynamicNodes(other.dynamicNodes)
+            , m_resource(other.m_resource) {
+            other.dynamicNodes = nullptr;
+        }
+
+        RTMap &operator=(RTMap &&other) noexcept {
+            if (this != &other) {
+                this->m_tree = std::move(other.m_tree);// the old tree destroys its entries first
+                memory::destroyArray(m_resource, dynamicNodes, this->m_capacity);
+                dynamicNodes = other.dynamicNodes;
+                this->m_capacity = other.m_capacity;
+                m_resource = other.m_resource;
+                other.dynamicNodes = nullptr;
+                other.m_capacity = 0;
+            }
+            return *this;
+        }
+
+        MemoryResource *resource() const { return m_resource; }
     };
 
 }// namespace ESTL
\ No newline at end of file
@@ -0,0 +1,219 @@
+//
+// Memory-mapped images of FixedMap - write once, map read-only at startup.
+//
+#pragma once
+
+#include "../ESTLImage.hpp"
+#include "FixedMap.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace ESTL {
+    /**
+     * @brief Image layout of a FixedMap.
+     *
+     * The tree is written as its in-order sequence of entries - a sorted array needs no links at all, and a binary
+     * search over it visits the same O(log n) keys as a descent of the tree.
+     */
+    template<typename Key, typename Value, typename Compare = std::less<Key>>
+    class MapImage {
+        static_assert(std::is_trivially_copyable<Key>::value && std::is_trivially_copyable<Value>::value,
+                      "Images need trivially copyable keys and values");
+
+    public:
+        struct Entry {
+            Key key;
+            Value value;
+        };
+
+        static std::uint64_t layoutHash() {
+            std::uint64_t hash = image::hashValue(image::fnv1a("ordered", 7), sizeof(Entry));
+            hash = image::hashValue(hash, offsetof(Entry, value));
+            hash = image::hashType(hash, typeid(Key));
+            hash = image::hashType(hash, typeid(Value));
+            return image::hashType(hash, typeid(Compare));
+        }
+
+        /**
+         * @brief Writes the map's entries in key order to an image file or shared memory writer.
+         *
+         * @throws std::runtime_error on I/O errors - an existing image is left untouched.
+         */
+        template<typename Writer>
+        static void write(const FixedMap<Key, Value, Compare> &map, Writer &writer) {
+#if ENABLE_THREAD_SAFETY
+            std::lock_guard<ContainerMutex> lock(map.m_mutex);
+#endif
+            auto &tree = *map.m_tree;
+            const std::size_t count = tree.size();
+            const std::size_t entryBytes = count * sizeof(Entry);
+            ImageHeader header{};
+            std::memcpy(header.magic, image::Magic, sizeof(header.magic));
+            header.version = ImageHeader::CurrentVersion;
+            header.kind = ImageKind::OrderedMap;
+            header.layoutHash = layoutHash();
+            header.size = count;
+            header.capacity = count;
+            header.payloadBytes = image::alignSection(entryBytes);
+
+            writer.write(&header, sizeof(header));
+            for (auto *node = tree.minimum(); node; node = tree.next(node)) {
+                Entry entry;
+                std::memset(&entry, 0, sizeof(entry));// padding is written as zeros
+                std::memcpy(&entry.key, &node->key, sizeof(Key));
+                std::memcpy(&entry.value, &node->value, sizeof(Value));
+                writer.write(&entry, sizeof(entry));
+            }
+            writer.pad(entryBytes);
+            writer.commit();
+        }
+    };
+
+    /**
+     * @brief Read-only FixedMap backed by a memory-mapped image.
+     *
+     * Opening costs one mmap and a header check, independent of the number of elements. Lookups are binary searches
+     * over the sorted entries; iteration is a linear walk in key order.
+     */
+    template<typename Key, typename Value, typename Compare = std::less<Key>>
+    class MappedMap {
+        using Image = MapImage<Key, Value, Compare>;
+        using Entry = typename Image::Entry;
+
+        MappedImage m_image;
+        const Entry *m_entries;
+        std::size_t m_size;
+        Compare m_comparator;
+
+    public:
+        explicit MappedMap(const std::string &path, bool populate = false)
+            : m_image(path, ImageKind::OrderedMap, Image::layoutHash(), populate) {
+            attach(path);
+        }
+
+        // Attaches to an image published with saveImage(map, SharedMemoryName{...})
+        explicit MappedMap(const SharedMemoryName &segment, bool populate = false)
+            : m_image(segment, ImageKind::OrderedMap, Image::layoutHash(), populate) {
+            attach(segment.name);
+        }
+
+        // Walks the sorted entry array - a proxy pair of references stands in for the element
+        class Iterator {
+            const Entry *m_entry;
+
+        public:
+            using value_type = std::pair<const Key &, const Value &>;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = value_type;
+            using iterator_category = std::random_access_iterator_tag;
+
+            Iterator()
+                : m_entry(nullptr) {}
+
+            explicit Iterator(const Entry *entry)
+                : m_entry(entry) {}
+
+            reference operator*() const { return {m_entry->key, m_entry->value}; }
+            reference operator[](difference_type offset) const { return *(*this + offset); }
+
+            Iterator &operator++() {
+                ++m_entry;
+                return *this;
+            }
+
+            Iterator operator++(int) {
+                Iterator temp = *this;
+                ++m_entry;
+                return temp;
+            }
+
+            Iterator &operator--() {
+                --m_entry;
+                return *this;
+            }
+
+            Iterator operator--(int) {
+                Iterator temp = *this;
+                --m_entry;
+                return temp;
+            }
+
+            Iterator &operator+=(difference_type offset) {
+                m_entry += offset;
+                return *this;
+            }
+
+            Iterator &operator-=(difference_type offset) {
+                m_entry -= offset;
+                return *this;
+            }
+
+            Iterator operator+(difference_type offset) const { return Iterator(m_entry + offset); }
+            Iterator operator-(difference_type offset) const { return Iterator(m_entry - offset); }
+            friend Iterator operator+(difference_type offset, const Iterator &it) { return it + offset; }
+            difference_type operator-(const Iterator &other) const { return m_entry - other.m_entry; }
+
+            bool operator==(const Iterator &other) const { return m_entry == other.m_entry; }
+            bool operator!=(const Iterator &other) const { return ! (*this == other); }
+            bool operator<(const Iterator &other) const { return m_entry < other.m_entry; }
+            bool operator>(const Iterator &other) const { return m_entry > other.m_entry; }
+            bool operator<=(const Iterator &other) const { return m_entry <= other.m_entry; }
+            bool operator>=(const Iterator &other) const { return m_entry >= other.m_entry; }
+        };
+
+        Iterator begin() const { return Iterator(m_entries); }
+        Iterator end() const { return Iterator(m_entries + m_size); }
+
+        // First entry whose key is not less than key
+        Iterator lower_bound(const Key &key) const {
+            return Iterator(std::lower_bound(m_entries, m_entries + m_size, key,
+                                             [this](const Entry &entry, const Key &probe) {
+                                                 return m_comparator(entry.key, probe);
+                                             }));
+        }
+
+        const Value *find(const Key &key) const {
+            auto it = lower_bound(key);
+            if (it == end() || m_comparator(key, (*it).first)) {
+                return nullptr;
+            }
+            return &(*it).second;
+        }
+
+        bool contains(const Key &key) const { return find(key) != nullptr; }
+
+        std::size_t size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+
+    private:
+        void attach(const std::string &source) {
+            const ImageHeader &header = m_image.header();
+            m_size = header.size;
+            if (header.capacity != m_size || header.payloadBytes != image::alignSection(m_size * sizeof(Entry))) {
+                throw std::runtime_error("Image '" + source + "' has inconsistent section sizes");
+            }
+            m_entries = m_image.section<Entry>(0);
+        }
+    };
+
+    // Writes map to path - see MapImage
+    template<typename Key, typename Value, typename Compare>
+    void saveImage(const FixedMap<Key, Value, Compare> &map, const std::string &path) {
+        image::ImageWriter writer(path);
+        MapImage<Key, Value, Compare>::write(map, writer);
+    }
+
+    // Publishes map in shared memory for other processes to attach with MappedMap
+    template<typename Key, typename Value, typename Compare>
+    void saveImage(const FixedMap<Key, Value, Compare> &map, const SharedMemoryName &segment) {
+        image::SharedMemoryWriter writer(segment);
+        MapImage<Key, Value, Compare>::write(map, writer);
+    }
+}// namespace ESTL
@@ -6,20 +6,128 @@
 #define ESTL_IBALANCEDTREE_HPP
 #pragma once
 
+#include "../ESTLMetrics.hpp"
+#include <cstdint>
 #include <functional>
+#include <future>
+#include <memory>
 #include <stdexcept>
+#include <thread>
 #include <utility>
 #include <mutex>
+#include <new>
+#include <type_traits>
 
 #ifndef ENABLE_THREAD_SAFETY
 #define ENABLE_THREAD_SAFETY true
 #endif
 
+#ifndef ESTL_COMPACT_TREE_NODE
+#define ESTL_COMPACT_TREE_NODE false
+#endif
+
+/**
+ * @brief Key and value of a tree node, in raw storage.
+ *
+ * Constructed when a tree takes the node from its pool and destroyed when it gives the node back, so free nodes hold
+ * no objects and neither Key nor Value has to be default-constructible.
+ */
 template<typename Key, typename Value>
-struct TreeNode {
-    Key key;
-    Value value;
-    bool in_use = false;
+struct NodeEntry {
+    union {
+        Key key;
+    };
+    union {
+        Value value;
+    };
+
+    NodeEntry() {}
+    ~NodeEntry() {}
+
+    void construct(const Key &newKey, const Value &newValue) {
+        new (&key) Key(newKey);
+        try {
+            new (&value) Value(newValue);
+        } catch (...) {
+            key.~Key();
+            throw;
+        }
+    }
+
+    void destroy() {
+        key.~Key();
+        value.~Value();
+    }
+};
+
+#if ESTL_COMPACT_TREE_NODE
+/**
+ * @brief Parent link that carries the node's metadata in its upper 16 bits.
+ *
+ * User-space addresses on x86-64 and AArch64 fit in 48 bits, leaving bit 63 for the in-use flag, bit 62 for the
+ * red-black color and bits 48-61 for the AVL height. Reads and writes through the link only touch the address part.
+ */
+template<typename NodeT>
+class TaggedParent {
+    static_assert(sizeof(void *) == 8, "ESTL_COMPACT_TREE_NODE requires 64-bit pointers");
+    static constexpr std::uint64_t AddressMask = (std::uint64_t(1) << 48) - 1;
+    static constexpr int FieldShift = 48;
+    static constexpr std::uint64_t FieldMask = (std::uint64_t(1) << 14) - 1;
+
+    std::uint64_t m_bits = 0;
+
+public:
+    static constexpr int InUseBit = 63;
+    static constexpr int RedBit = 62;
+
+    TaggedParent() = default;
+    TaggedParent(const TaggedParent &) = default;
+
+    // Assigning another link copies its address only - the metadata belongs to the node holding the link
+    TaggedParent &operator=(const TaggedParent &other) { return *this = static_cast<NodeT *>(other); }
+    TaggedParent &operator=(NodeT *node) {
+        m_bits = (m_bits & ~AddressMask) | (reinterpret_cast<std::uintptr_t>(node) & AddressMask);
+        return *this;
+    }
+
+    operator NodeT *() const { return reinterpret_cast<NodeT *>(static_cast<std::uintptr_t>(m_bits & AddressMask)); }
+    NodeT *operator->() const { return static_cast<NodeT *>(*this); }
+
+    bool flag(int bit) const { return (m_bits >> bit) & 1; }
+    void setFlag(int bit, bool value) {
+        m_bits = (m_bits & ~(std::uint64_t(1) << bit)) | (std::uint64_t(value) << bit);
+    }
+    int field() const { return static_cast<int>((m_bits >> FieldShift) & FieldMask); }
+    void setField(int value) {
+        m_bits = (m_bits & ~(FieldMask << FieldShift)) | ((static_cast<std::uint64_t>(value) & FieldMask) << FieldShift);
+    }
+};
+
+// Tree node with metadata packed into the parent link - three words of links and no flag word
+template<typename Key, typename Value>
+struct TreeNode : NodeEntry<Key, Value> {
+    using Parent = TaggedParent<TreeNode>;
+
+    union {
+        TreeNode *left = nullptr;
+        std::uintptr_t leafSlot;// For B+ tree - entries are not linked through left
+    };
+    TreeNode *right = nullptr;
+    Parent parent;
+
+    bool inUse() const { return parent.flag(Parent::InUseBit); }
+    void setInUse(bool used) { parent.setFlag(Parent::InUseBit, used); }
+    bool isRed() const { return parent.flag(Parent::RedBit); }
+    void setRed(bool red) { parent.setFlag(Parent::RedBit, red); }
+    int height() const { return parent.field(); }
+    void setHeight(int height) { parent.setField(height); }
+    int leaf() const { return static_cast<int>(leafSlot); }
+    void setLeaf(int leaf) { leafSlot = static_cast<std::uintptr_t>(leaf); }
+};
+#else
+// Links first, then the small fields together at the end so they share one padded word
+template<typename Key, typename Value>
+struct TreeNode : NodeEntry<Key, Value> {
     TreeNode *left = nullptr;
     TreeNode *right = nullptr;
     TreeNode *parent = nullptr;
@@ -27,8 +135,131 @@ struct TreeNode {
     union {
         bool red;  // For red-black tree
         int height;// For AVL tree
+        int leaf;  // For B+ tree - index of the owning leaf page
     } SpecialProps;
+    bool in_use = false;
+
+    bool inUse() const { return in_use; }
+    void setInUse(bool used) { in_use = used; }
+    bool isRed() const { return SpecialProps.red; }
+    void setRed(bool red) { SpecialProps.red = red; }
+    int height() const { return SpecialProps.height; }
+    void setHeight(int height) { SpecialProps.height = height; }
+    int leaf() const { return SpecialProps.leaf; }
+    void setLeaf(int leaf) { SpecialProps.leaf = leaf; }
 };
+#endif
+
+/**
+ * @brief Free list over a fixed buffer of tree nodes.
+ *
+ * Every tree owns a private pool by default. A pool constructed as shared can back several trees at once; trees of
+ * the same engine over one pool can then hand nodes to each other (split / join) without copying.
+ */
+template<typename Key, typename Value>
+class NodePool {
+    using Node = TreeNode<Key, Value>;
+
+    Node *m_nodes;
+    Node *m_freeNodes;
+    std::size_t m_capacity;
+    std::size_t m_available;
+    bool m_shared;
+#if ENABLE_THREAD_SAFETY
+    mutable std::mutex m_mutex;
+#endif
+#if ESTL_ENABLE_METRICS
+    std::size_t m_highWater = 0;// Most nodes ever allocated at once
+#endif
+
+public:
+    NodePool(Node *buffer, std::size_t capacity, bool shared = false)
+        : m_nodes(buffer)
+        , m_freeNodes(nullptr)
+        , m_capacity(capacity)
+        , m_available(0)
+        , m_shared(shared) {
+        init();
+    }
+
+    NodePool(const NodePool &) = delete;
+    NodePool &operator=(const NodePool &) = delete;
+
+    // Links every node of the buffer into the free list
+    void init() {
+        if (m_capacity == 0) {
+            return;
+        }
+        for (std::size_t i = 0; i < m_capacity - 1; ++i) {
+            m_nodes[i].right = &m_nodes[i + 1];
+        }
+        m_nodes[m_capacity - 1].right = nullptr;
+        m_freeNodes = &m_nodes[0];
+        m_available = m_capacity;
+        ESTL_METRIC(m_highWater = 0);
+    }
+
+    Node *allocate() {
+#if ENABLE_THREAD_SAFETY
+        std::unique_lock<std::mutex> lock(m_mutex, std::defer_lock);
+        if (m_shared) {
+            lock.lock();
+        }
+#endif
+        if (! m_freeNodes) {
+            throw std::out_of_range("No more free nodes available");
+        }
+        Node *node = m_freeNodes;
+        m_freeNodes = m_freeNodes->right;
+        --m_available;
+        ESTL_METRIC(m_highWater = m_capacity - m_available > m_highWater ? m_capacity - m_available : m_highWater);
+        return node;
+    }
+
+    void deallocate(Node *node) {
+#if ENABLE_THREAD_SAFETY
+        std::unique_lock<std::mutex> lock(m_mutex, std::defer_lock);
+        if (m_shared) {
+            lock.lock();
+        }
+#endif
+        node->right = m_freeNodes;
+        m_freeNodes = node;
+        ++m_available;
+    }
+
+    // Destroys the entries of the nodes still in use - for the owner of the buffer, before it goes
+    void destroyLive() {
+        if (std::is_trivially_destructible<Key>::value && std::is_trivially_destructible<Value>::value) {
+            return;
+        }
+        for (std::size_t i = 0; i < m_capacity; ++i) {
+            if (m_nodes[i].inUse()) {
+                m_nodes[i].destroy();
+                m_nodes[i].setInUse(false);
+            }
+        }
+    }
+
+    Node *nodes() const { return m_nodes; }
+    std::size_t capacity() const { return m_capacity; }
+    std::size_t available() const {
+#if ENABLE_THREAD_SAFETY
+        std::unique_lock<std::mutex> lock(m_mutex, std::defer_lock);
+        if (m_shared) {
+            lock.lock();
+        }
+#endif
+        return m_available;
+    }
+    bool shared() const { return m_shared; }
+#if ESTL_ENABLE_METRICS
+    std::size_t highWater() const { return m_highWater; }
+#endif
+};
+
+// Bulk set operations between two ordered trees
+enum class SetOperation { Union, Intersection, Difference };
 
 // Abstract Balanced Tree interface
 template<typename Key, typename Value, typename Compare = std::less<Key>>
@@ -38,16 +269,20 @@ protected:
 
     Node *m_root;
     Node *m_nodes;
-    Node *m_freeNodes;
-    std::size_t m_size;
+    NodePool<Key, Value> m_ownPool;
+    NodePool<Key, Value> *m_pool;// m_ownPool, or a pool shared with other trees
+    mutable std::size_t m_size;
+    mutable bool m_sizeKnown;// False after split/join moved an uncounted number of nodes
     std::size_t m_capacity;
     Compare m_comparator;
 #if ENABLE_THREAD_SAFETY
     mutable std::mutex m_mutex;
+#endif
+#if ESTL_ENABLE_METRICS
+    ESTL::metrics::Counters m_counters;// Rotations and rebalances
 #endif
     bool insert(const Key &key, const Value &value, Node *newNode) {
-        newNode->key = key;
-        newNode->value = value;
+        constructEntry(newNode, key, value);
         //in case this is the first node
         if (! m_root) {
             m_root = newNode;
@@ -77,44 +312,271 @@ protected:
         return true;
     };
 
+    static Node *liveChild(Node *child) { return child && child->inUse() ? child : nullptr; }
+
+    static std::size_t subtreeHeight(const Node *node) {
+        if (! node || ! node->inUse()) {
+            return 0;
+        }
+        std::size_t left = subtreeHeight(node->left);
+        std::size_t right = subtreeHeight(node->right);
+        return 1 + (left > right ? left : right);
+    }
+
+    std::size_t countNodes(const Node *node) const {
+        if (! node || ! node->inUse()) {
+            return 0;
+        }
+        return 1 + countNodes(node->left) + countNodes(node->right);
+    }
+
+    // Post-order release of a subtree back to the pool
+    void releaseSubtree(Node *node) {
+        if (! node || ! node->inUse()) {
+            return;
+        }
+        releaseSubtree(node->left);
+        releaseSubtree(node->right);
+        deallocateNode(node);
+    }
+
+    /**
+     * @brief Splits a detached subtree around key.
+     *
+     * Walks down the search path for key and re-joins the pieces hanging off it - the join costs telescope to
+     * O(log n) for red-black and AVL trees.
+     *
+     * @param node Root of the subtree to split.
+     * @param key Split key.
+     * @param right Receives the root of the nodes with keys > key.
+     * @param equal Receives the detached node with key itself, or nullptr.
+     * @return Root of the nodes with keys < key.
+     */
+    Node *splitSubtree(Node *node, const Key &key, Node *&right, Node *&equal) {
+        node = liveChild(node);
+        if (! node) {
+            right = nullptr;
+            return nullptr;
+        }
+        Node *left = liveChild(node->left);
+        Node *rightChild = liveChild(node->right);
+        if (left) {
+            left->parent = nullptr;
+        }
+        if (rightChild) {
+            rightChild->parent = nullptr;
+        }
+
+        if (m_comparator(node->key, key)) {// node goes to the left part
+            Node *lowerRight = splitSubtree(rightChild, key, right, equal);
+            return joinWithPivot(left, node, lowerRight);
+        }
+        if (m_comparator(key, node->key)) {// node goes to the right part
+            Node *upperLeft = nullptr;
+            Node *lower = splitSubtree(left, key, upperLeft, equal);
+            right = joinWithPivot(upperLeft, node, rightChild);
+            return lower;
+        }
+        node->left = node->right = node->parent = nullptr;
+        equal = node;
+        right = rightChild;
+        return left;
+    }
+
+    // Splits into keys < key (returned) and keys >= key (right)
+    Node *splitSubtree(Node *node, const Key &key, Node *&right) {
+        Node *equal = nullptr;
+        Node *lower = splitSubtree(node, key, right, equal);
+        if (equal) {
+            right = joinWithPivot(nullptr, equal, right);
+        }
+        return lower;
+    }
+
+    // Joins two detached subtrees without a pivot - the maximum of left is split off and used as the pivot
+    Node *joinSubtrees(Node *left, Node *right) {
+        left = liveChild(left);
+        right = liveChild(right);
+        if (! left) {
+            return right;
+        }
+        if (! right) {
+            return left;
+        }
+        Node *maximum = left;
+        while (liveChild(maximum->right)) {
+            maximum = maximum->right;
+        }
+        Node *pivot = nullptr;
+        Node *empty = nullptr;
+        Node *rest = splitSubtree(left, maximum->key, empty, pivot);
+        return joinWithPivot(rest, pivot, right);
+    }
+
+    // Engine of the same type over the same pool - parallel set operations give each task its own join workspace
+    virtual std::unique_ptr<BalancedTree> makeWorker() const {
+        throw std::logic_error("Join is not supported by this tree");
+    }
+
+    /**
+     * @brief Join-based set operation of two detached subtrees over one pool.
+     *
+     * Splits a around the root key of b and recurses on both halves - the halves are independent, so the left one
+     * runs on another thread while forkDepth allows. Nodes of b are either moved into the result or released; for
+     * keys present in both, the node of a is kept. O(m log(n/m + 1)) work for subtree sizes m <= n.
+     *
+     * @param matches Incremented once per key present in both subtrees - the result size follows from it.
+     */
+    Node *combineSubtrees(Node *a, Node *b, SetOperation operation, int forkDepth, std::size_t &matches) {
+        a = liveChild(a);
+        b = liveChild(b);
+        if (! b) {
+            if (operation == SetOperation::Intersection) {
+                releaseSubtree(a);
+                return nullptr;
+            }
+            return a;
+        }
+        if (! a) {
+            if (operation == SetOperation::Union) {
+                return b;
+            }
+            releaseSubtree(b);
+            return nullptr;
+        }
+
+        Node *bLeft = liveChild(b->left);
+        Node *bRight = liveChild(b->right);
+        if (bLeft) {
+            bLeft->parent = nullptr;
+        }
+        if (bRight) {
+            bRight->parent = nullptr;
+        }
+        b->left = b->right = b->parent = nullptr;
+        Node *aRight = nullptr;
+        Node *equal = nullptr;
+        Node *aLeft = splitSubtree(a, b->key, aRight, equal);
+        if (equal) {
+            ++matches;
+        }
+
+        Node *left;
+        Node *right;
+        if (forkDepth > 0) {
+            std::unique_ptr<BalancedTree> worker = makeWorker();
+            std::size_t leftMatches = 0;
+            auto leftTask = std::async(std::launch::async, [&] {
+                return worker->combineSubtrees(aLeft, bLeft, operation, forkDepth - 1, leftMatches);
+            });
+            right = combineSubtrees(aRight, bRight, operation, forkDepth - 1, matches);
+            left = leftTask.get();
+            matches += leftMatches;
+        } else {
+            left = combineSubtrees(aLeft, bLeft, operation, 0, matches);
+            right = combineSubtrees(aRight, bRight, operation, 0, matches);
+        }
+
+        Node *pivot = nullptr;
+        switch (operation) {
+            case SetOperation::Union:
+                pivot = equal ? equal : b;
+                break;
+            case SetOperation::Intersection:
+                pivot = equal;
+                break;
+            case SetOperation::Difference:
+                if (equal) {
+                    deallocateNode(equal);
+                }
+                break;
+        }
+        if (pivot != b) {
+            deallocateNode(b);
+        }
+        return pivot ? joinWithPivot(left, pivot, right) : joinSubtrees(left, right);
+    }
+
+    // Fork depth that keeps about one task per hardware thread busy
+    static int forkDepthForHardware() {
+#if ENABLE_THREAD_SAFETY
+        int depth = 0;
+        for (unsigned threads = std::thread::hardware_concurrency(); threads > 1; threads = (threads + 1) / 2) {
+            ++depth;
+        }
+        return depth;
+#else
+        return 0;// the pool is not locked, node releases must stay on one thread
+#endif
+    }
+
 public:
     BalancedTree(Node *nodeBuffer, std::size_t capacity)
         : m_nodes(nodeBuffer)
         , m_root(nullptr)
-        , m_freeNodes(nullptr)
+        , m_ownPool(nodeBuffer, capacity)
+        , m_pool(&m_ownPool)
         , m_size(0)
-        , m_capacity(capacity) {
-        initFreeNodes();
-    }
+        , m_sizeKnown(true)
+        , m_capacity(capacity) {}
+
+    explicit BalancedTree(NodePool<Key, Value> *pool)
+        : m_nodes(pool->nodes())
+        , m_root(nullptr)
+        , m_ownPool(nullptr, 0)
+        , m_pool(pool)
+        , m_size(0)
+        , m_sizeKnown(true)
+        , m_capacity(pool->capacity()) {}
 
+    // Resets a private pool - a shared pool belongs to its other trees as well and is left alone
     void initFreeNodes() {
-        for (std::size_t i = 0; i < m_capacity - 1; ++i) {
-            m_nodes[i].right = &m_nodes[i + 1];
+        if (m_pool == &m_ownPool) {
+            m_ownPool.init();
+        }
+    }
+    /**
+     * Destroys the entries of a private pool while its nodes still exist, so the tree must go before its node buffer.
+     * The whole pool is scanned, which also catches nodes held outside the tree (retired persistent versions). A
+     * shared pool destroys what is left in it when it goes itself.
+     */
+    virtual ~BalancedTree() {
+        if (m_pool == &m_ownPool) {
+            m_ownPool.destroyLive();
         }
-        m_nodes[m_capacity - 1].right = nullptr;
-        m_freeNodes = &m_nodes[0];
     }
-    virtual ~BalancedTree() = default;
+
+    const NodePool<Key, Value> *pool() const { return m_pool; }
 
     virtual bool insert(const Key &key, const Value &value) = 0;
     virtual bool erase(const Key &key) = 0;
 
+    // Hands out a node with a raw entry - constructEntry() fills it and marks it in use
     virtual Node *allocateNode() {
-        if (! m_freeNodes) {
-            throw std::out_of_range("No more free nodes available");
-        }
-        Node *node = m_freeNodes;
-        m_freeNodes = m_freeNodes->right;
+        Node *node = m_pool->allocate();
         node->right = node->left = node->parent = nullptr;
-        node->in_use = true;
         return node;
     }
 
+    // The node goes back to the pool if a copy throws
+    void constructEntry(Node *node, const Key &key, const Value &value) {
+        try {
+            node->construct(key, value);
+        } catch (...) {
+            deallocateNode(node);
+            throw;
+        }
+        node->setInUse(true);
+    }
+
+    // Destroys the entry of a node in use and returns the node to the pool
     virtual void deallocateNode(Node *node) {
-        node->in_use = false;
+        if (node->inUse()) {
+            node->destroy();
+        }
+        node->setInUse(false);
         node->left = node->parent = nullptr;
-        node->right = m_freeNodes;
-        m_freeNodes = node;
+        m_pool->deallocate(node);
     }
 
     virtual Value *find(const Key &key) {
@@ -122,17 +584,128 @@ public:
         return node ? &node->value : nullptr;
     }
 
-    virtual void clear() {
-        for (std::size_t i = 0; i < m_capacity; ++i) {
-            if (m_nodes[i].in_use)
-                deallocateNode(&m_nodes[i]);
+    // Inserts the key or overwrites the value of an existing one - returns true if inserted
+    virtual bool insertOrAssign(const Key &key, const Value &value) {
+        Value *found = find(key);
+        if (found) {
+            *found = value;
+            return false;
         }
+        return insert(key, value);
+    }
+
+    // Returns the tree's own nodes to the pool - O(size), other trees of a shared pool are untouched
+    virtual void clear() {
+        releaseSubtree(m_root);
         m_root = nullptr;
         m_size = 0;
+        m_sizeKnown = true;
+    }
+
+    std::size_t size() const {
+        if (! m_sizeKnown) {
+            m_size = countNodes(m_root);
+            m_sizeKnown = true;
+        }
+        return m_size;
+    }
+    virtual bool empty() const { return ! m_root; }
+
+    // Levels from the root to the deepest node - O(size)
+    virtual std::size_t height() const { return subtreeHeight(m_root); }
+
+    // Fills the pool, shape and counter fields of a metrics snapshot
+    void collectMetrics(ESTL::ContainerMetrics &metrics) const {
+        metrics.poolCapacity = m_pool->capacity();
+        metrics.poolInUse = m_pool->capacity() - m_pool->available();
+        metrics.treeHeight = height();
+#if ESTL_ENABLE_METRICS
+        metrics.poolHighWater = m_pool->highWater();
+        metrics.rotations = m_counters.rotations;
+        metrics.rebalances = m_counters.rebalances;
+#endif
+    }
+
+    // Join/split support - engines that can concatenate two subtrees around a pivot in O(log n) override these
+    virtual bool canJoin() const { return false; }
+
+    /**
+     * @brief Joins two detached subtrees around a pivot node.
+     *
+     * All keys of left must be less than pivot->key and all keys of right greater. The subtrees and the pivot must
+     * belong to this engine type. The result has no parent.
+     *
+     * @return Root of the joined subtree.
+     */
+    virtual Node *joinWithPivot(Node *, Node *, Node *) {
+        throw std::logic_error("Join is not supported by this tree");
+    }
+
+    /**
+     * @brief Moves every node with key >= key into the empty tree right - O(log n).
+     *
+     * Both trees must be the same engine over the same pool. Nodes carry no subtree sizes, so the split cannot tell
+     * how many nodes moved: both sizes are recounted on the next size() call, once, in O(size).
+     */
+    void splitInto(const Key &key, BalancedTree &right) {
+        Node *moved = nullptr;
+        Node *kept = splitSubtree(m_root, key, moved);
+        m_root = kept;
+        right.m_root = moved;
+        m_sizeKnown = right.m_sizeKnown = false;
+    }
+
+    /**
+     * @brief Moves every node of right, whose keys are all greater than this tree's keys, into this tree - O(log n).
+     *
+     * Both trees must be the same engine over the same pool. The size stays exact unless either tree was split and
+     * not counted since.
+     */
+    void joinFrom(BalancedTree &right) {
+        Node *joined = joinSubtrees(m_root, right.m_root);
+        m_root = joined;
+        m_size += right.m_size;
+        m_sizeKnown = m_sizeKnown && right.m_sizeKnown;
+        right.m_root = nullptr;
+        right.m_size = 0;
+        right.m_sizeKnown = true;
     }
 
-    std::size_t size() const { return m_size; }
-    bool empty() const { return m_size == 0; }
+    /**
+     * @brief Combines other into this tree - union, intersection or difference of the key sets.
+     *
+     * Both trees must be the same join-capable engine over the same pool. For keys present in both trees this
+     * tree's value is kept. other is left empty: its nodes are moved into this tree or released to the pool. The
+     * size of the result follows from both sizes and the number of shared keys, so it stays exact.
+     *
+     * @param forkDepth Levels of the recursion that fork a task, negative to size it to the hardware threads.
+     */
+    void combineWith(BalancedTree &other, SetOperation operation, int forkDepth = -1) {
+        if (forkDepth < 0) {
+            forkDepth = forkDepthForHardware();
+        }
+        if (! m_pool->shared()) {
+            forkDepth = 0;// a private pool is not locked
+        }
+        const std::size_t thisSize = size();
+        const std::size_t otherSize = other.size();
+        std::size_t matches = 0;
+        m_root = combineSubtrees(m_root, other.m_root, operation, forkDepth, matches);
+        switch (operation) {
+            case SetOperation::Union:
+                m_size = thisSize + otherSize - matches;
+                break;
+            case SetOperation::Intersection:
+                m_size = matches;
+                break;
+            case SetOperation::Difference:
+                m_size = thisSize - matches;
+                break;
+        }
+        other.m_root = nullptr;
+        other.m_size = 0;
+        other.m_sizeKnown = true;
+    }
 
     /** @brief Performs a left rotation on the given node.
      *
@@ -154,6 +727,7 @@ public:
       if (!node || !node->right){
         return;
       }
+        ESTL_METRIC(++m_counters.rotations);
         Node *rightChild = node->right;
         node->right = rightChild->left;
 
@@ -194,6 +768,7 @@ public:
       if (!node || !node->left){
         return;
       }
+        ESTL_METRIC(++m_counters.rotations);
         Node *leftChild = node->left;
         node->left = leftChild->right;
 
@@ -250,7 +825,7 @@ public:
       std::lock_guard<std::mutex> lock(m_mutex);
 #endif
         Node *current = m_root;
-        while (current && current->in_use) {
+        while (current && current->inUse()) {
             if (m_comparator(key, current->key)) {
                 current = current->left;
             } else if (m_comparator(current->key, key)) {
@@ -263,17 +838,40 @@ public:
     }
 
     virtual Node *minimum(Node *node) const {
-        if (! node || ! node->in_use) {
+        if (! node || ! node->inUse()) {
             return nullptr;
         }
-        while (node->left && node->left->in_use) {
+        while (node->left && node->left->inUse()) {
             node = node->left;
         }
         return node;
     }
 
     // For iteration
-    Node *minimum() { return minimum(m_root); }
+    virtual Node *minimum() { return minimum(m_root); }
+
+    /**
+     * @brief Finds the first node whose key is not less than the given key.
+     *
+     * @param key The key to search for.
+     * @return The lower bound node, or nullptr if all keys are less than key.
+     */
+    virtual Node *lowerBound(const Key &key) const {
+#if ENABLE_THREAD_SAFETY
+        std::lock_guard<std::mutex> lock(m_mutex);
+#endif
+        Node *current = m_root;
+        Node *candidate = nullptr;
+        while (current && current->inUse()) {
+            if (! m_comparator(current->key, key)) {// current->key >= key
+                candidate = current;
+                current = current->left;
+            } else {
+                current = current->right;
+            }
+        }
+        return candidate;
+    }
 
     /**
      * @brief Finds the successor of the given node in the Balanced Tree.
@@ -287,11 +885,11 @@ public:
      * @return The successor node, or nullptr if no successor exists.
      */
     virtual Node *next(Node *node) {
-        if (! node || ! node->in_use) {
+        if (! node || ! node->inUse()) {
             return nullptr;
         }
 
-        if (node->right && node->right->in_use) {
+        if (node->right && node->right->inUse()) {
             return minimum(node->right);
         }
 
@@ -315,16 +913,16 @@ public:
      * @return The predecessor node, or nullptr if no predecessor exists.
      */
     virtual Node *prev(Node *node) {
-        if (! node || ! node->in_use) {
+        if (! node || ! node->inUse()) {
             Node *current = m_root;
-            while (current && current->right && current->right->in_use) {
+            while (current && current->right && current->right->inUse()) {
                 current = current->right;
             }
             return current;
         }
-        if (node->left && node->left->in_use) {
+        if (node->left && node->left->inUse()) {
             Node *current = node->left;
-            while (current->right && current->right->in_use) {
+            while (current->right && current->right->inUse()) {
                 current = current->right;
             }
             return current;
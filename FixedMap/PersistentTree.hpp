@@ -0,0 +1,555 @@
+#ifndef ESTL_PERSISTENTTREE_HPP
+#define ESTL_PERSISTENTTREE_HPP
+#pragma once
+
+/** Simple Explanation of a Persistent (Path-Copying) Tree
+A persistent tree never modifies a node that readers may see. To change a key, the writer copies every node on the
+path from the root down to that key, changes the copies, and publishes the new root in one atomic store. Everything
+off the path is shared between the old and the new version, so a write costs O(log n) new nodes.
+    Old root  -->  A           New root  -->  A'
+                  / \                        / \
+                 B   C                      B   C'   (C' is a copy of C with the change applied)
+Snapshots
+    A reader pins the current version and keeps its root. That root and everything below it stays unchanged for as long
+    as the snapshot lives, while writers keep publishing new roots - so readers iterate without taking the lock.
+Reclamation
+    Nodes replaced by a write are retired with that write's version. A retired node goes back to the free list once no
+    pinned snapshot is older than the version that retired it. All nodes come from the same fixed pool, so the pool
+    must be sized with spare capacity: about 3 * height nodes per write plus whatever live snapshots keep alive.
+Balancing
+    The tree is an AVL tree (height kept in the node). Nodes have no parent pointers - a node may be shared
+    by several versions - so rebalancing happens on the way back up a recursive descent.
+Note
+    Values must only be changed through insert / insertOrAssign / erase. Writing through a pointer from find() would
+    modify a node that snapshots may be reading.
+ * */
+
+#include "IBalancedTree.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+
+// Persistent AVL Tree implementation
+template<typename Key, typename Value, typename Compare = std::less<Key>>
+class PersistentTree : public BalancedTree<Key, Value, Compare> {
+    using BaseTree = BalancedTree<Key, Value, Compare>;
+
+public:
+    static constexpr std::size_t MaxSnapshots = 64;// Concurrently pinned snapshots
+    static constexpr std::size_t MaxHeight = 96;   // AVL height bound for any 64-bit size
+
+protected:
+    using Node = typename BaseTree::Node;
+
+    struct Retired {
+        Node *node;
+        std::uint64_t version;// Version whose write replaced the node
+    };
+
+    std::atomic<Node *> m_published;              // Root of the latest version, read by snapshots
+    std::atomic<std::uint64_t> m_version;         // Latest published version
+    std::atomic<std::uint64_t> m_pins[MaxSnapshots];// Version pinned by each snapshot slot, 0 when free
+    std::uint64_t m_writeVersion;                 // Version being built by the current write
+    std::uint64_t *m_birth;                       // Version that allocated each node of the pool
+    Retired *m_retired;                           // Ring of retired nodes, ordered by version
+    std::size_t m_retiredHead;
+    std::size_t m_retiredCount;
+    std::size_t m_freeCount;
+
+    Node *allocateNode() override {
+        Node *node = BaseTree::allocateNode();
+        --m_freeCount;
+        m_birth[node - BaseTree::m_nodes] = m_writeVersion;
+        return node;
+    }
+
+    void deallocateNode(Node *node) override {
+        BaseTree::deallocateNode(node);
+        ++m_freeCount;
+    }
+
+    static int getHeight(const Node *node) { return node ? node->height() : 0; }
+
+    static int balanceFactor(const Node *node) { return getHeight(node->left) - getHeight(node->right); }
+
+    static void updateHeight(Node *node) {
+        node->setHeight(std::max(getHeight(node->left), getHeight(node->right)) + 1);
+    }
+
+    bool isFresh(const Node *node) const { return m_birth[node - BaseTree::m_nodes] == m_writeVersion; }
+
+    // Takes a node out of the current version - immediately if no reader could have seen it
+    void retire(Node *node) {
+        if (isFresh(node)) {
+            deallocateNode(node);
+            return;
+        }
+        const std::size_t capacity = BaseTree::m_capacity;
+        m_retired[(m_retiredHead + m_retiredCount) % capacity] = {node, m_writeVersion};
+        ++m_retiredCount;
+    }
+
+    // Returns a node the current write may modify - the node itself if it was created by this write, else a copy
+    Node *writable(Node *node) {
+        if (isFresh(node)) {
+            return node;
+        }
+        Node *copy = allocateNode();
+        BaseTree::constructEntry(copy, node->key, node->value);
+        copy->left = node->left;
+        copy->right = node->right;
+        copy->setHeight(node->height());
+        retire(node);
+        return copy;
+    }
+
+    Node *rotateLeftCopy(Node *node) {
+        ESTL_METRIC(++BaseTree::m_counters.rotations);
+        Node *rightChild = writable(node->right);
+        node->right = rightChild->left;
+        rightChild->left = node;
+        updateHeight(node);
+        updateHeight(rightChild);
+        return rightChild;
+    }
+
+    Node *rotateRightCopy(Node *node) {
+        ESTL_METRIC(++BaseTree::m_counters.rotations);
+        Node *leftChild = writable(node->left);
+        node->left = leftChild->right;
+        leftChild->right = node;
+        updateHeight(node);
+        updateHeight(leftChild);
+        return leftChild;
+    }
+
+    // Rebalances a writable node whose children changed, returns the new subtree root
+    Node *rebalance(Node *node) {
+        updateHeight(node);
+        int bf = balanceFactor(node);
+        ESTL_METRIC(BaseTree::m_counters.rebalances += bf > 1 || bf < -1);
+        if (bf > 1) {// Left Sub-tree heavier
+            if (balanceFactor(node->left) < 0) {
+                node->left = rotateLeftCopy(writable(node->left));
+            }
+            return rotateRightCopy(node);
+        }
+        if (bf < -1) {// Right Sub-tree heavier
+            if (balanceFactor(node->right) > 0) {
+                node->right = rotateRightCopy(writable(node->right));
+            }
+            return rotateLeftCopy(node);
+        }
+        return node;
+    }
+
+    // Path-copying insert, returns the new subtree root (the same node when nothing changed)
+    Node *insertAt(Node *node, const Key &key, const Value &value, bool assign, bool &inserted) {
+        if (! node) {
+            Node *newNode = allocateNode();
+            BaseTree::constructEntry(newNode, key, value);
+            newNode->setHeight(1);
+            inserted = true;
+            return newNode;
+        }
+        if (BaseTree::m_comparator(key, node->key)) {
+            Node *left = insertAt(node->left, key, value, assign, inserted);
+            if (left == node->left) {
+                return node;
+            }
+            Node *copy = writable(node);
+            copy->left = left;
+            return rebalance(copy);
+        }
+        if (BaseTree::m_comparator(node->key, key)) {
+            Node *right = insertAt(node->right, key, value, assign, inserted);
+            if (right == node->right) {
+                return node;
+            }
+            Node *copy = writable(node);
+            copy->right = right;
+            return rebalance(copy);
+        }
+        if (! assign) {
+            return node;// Duplicate key
+        }
+        Node *copy = writable(node);
+        copy->value = value;
+        return copy;
+    }
+
+    // Detaches the minimum of a subtree, returns the new subtree root
+    Node *removeMinimum(Node *node, Node *&minimum) {
+        if (! node->left) {
+            minimum = node;
+            return node->right;
+        }
+        Node *left = removeMinimum(node->left, minimum);
+        Node *copy = writable(node);
+        copy->left = left;
+        return rebalance(copy);
+    }
+
+    // Path-copying erase, returns the new subtree root
+    Node *eraseAt(Node *node, const Key &key, bool &erased) {
+        if (! node) {
+            return nullptr;
+        }
+        if (BaseTree::m_comparator(key, node->key)) {
+            Node *left = eraseAt(node->left, key, erased);
+            if (! erased) {
+                return node;
+            }
+            Node *copy = writable(node);
+            copy->left = left;
+            return rebalance(copy);
+        }
+        if (BaseTree::m_comparator(node->key, key)) {
+            Node *right = eraseAt(node->right, key, erased);
+            if (! erased) {
+                return node;
+            }
+            Node *copy = writable(node);
+            copy->right = right;
+            return rebalance(copy);
+        }
+
+        erased = true;
+        if (! node->left || ! node->right) {
+            Node *child = node->left ? node->left : node->right;
+            retire(node);
+            return child;
+        }
+        // Two children - the successor takes the place of the erased node
+        Node *successor = nullptr;
+        Node *right = removeMinimum(node->right, successor);
+        Node *copy = writable(node);
+        copy->key = successor->key;
+        copy->value = successor->value;
+        copy->right = right;
+        retire(successor);
+        return rebalance(copy);
+    }
+
+    // Retires every node of a version's tree
+    void retireAll(Node *node) {
+        if (! node) {
+            return;
+        }
+        retireAll(node->left);
+        retireAll(node->right);
+        retire(node);
+    }
+
+    // Returns retired nodes that no pinned snapshot can reach to the free list
+    void reclaim() {
+        std::uint64_t oldestPin = UINT64_MAX;
+        for (auto &pin: m_pins) {
+            std::uint64_t version = pin.load();
+            if (version != 0 && version < oldestPin) {
+                oldestPin = version;
+            }
+        }
+        const std::size_t capacity = BaseTree::m_capacity;
+        while (m_retiredCount > 0 && m_retired[m_retiredHead].version <= oldestPin) {
+            deallocateNode(m_retired[m_retiredHead].node);
+            m_retiredHead = (m_retiredHead + 1) % capacity;
+            --m_retiredCount;
+        }
+    }
+
+    // Starts a write - makes sure the pool can take a full path copy before touching anything
+    void beginWrite() {
+        reclaim();
+        if (m_freeCount < 3 * static_cast<std::size_t>(getHeight(BaseTree::m_root) + 1)) {
+            throw std::out_of_range("No more free nodes available");
+        }
+        m_writeVersion = m_version.load() + 1;
+    }
+
+    // Publishes the root built by the current write as the latest version
+    void publish(Node *root) {
+        BaseTree::m_root = root;
+        m_published.store(root);
+        m_version.store(m_writeVersion);
+        reclaim();
+    }
+
+    // Smallest node with key > key (strict) or >= key, searched from the writer's root
+    Node *successorOf(const Key &key, bool inclusive) const {
+        Node *current = BaseTree::m_root;
+        Node *candidate = nullptr;
+        while (current) {
+            bool goLeft = inclusive ? ! BaseTree::m_comparator(current->key, key)
+                                    : BaseTree::m_comparator(key, current->key);
+            if (goLeft) {
+                candidate = current;
+                current = current->left;
+            } else {
+                current = current->right;
+            }
+        }
+        return candidate;
+    }
+
+public:
+    /**
+     * @brief A pinned, read-only version of the tree.
+     *
+     * Lookups and iteration never take the tree lock and never see later writes. Releasing the snapshot (destructor)
+     * allows the nodes only it could reach to be reclaimed by the next write.
+     */
+    class Snapshot {
+        PersistentTree *m_tree;
+        std::size_t m_slot;
+        const Node *m_root;
+
+        friend class PersistentTree;
+
+        Snapshot(PersistentTree *tree, std::size_t slot, const Node *root)
+            : m_tree(tree)
+            , m_slot(slot)
+            , m_root(root) {}
+
+    public:
+        Snapshot(const Snapshot &) = delete;
+        Snapshot &operator=(const Snapshot &) = delete;
+
+        Snapshot(Snapshot &&other) noexcept
+            : m_tree(other.m_tree)
+            , m_slot(other.m_slot)
+            , m_root(other.m_root) {
+            other.m_tree = nullptr;
+        }
+
+        Snapshot &operator=(Snapshot &&other) noexcept {
+            if (this != &other) {
+                release();
+                m_tree = other.m_tree;
+                m_slot = other.m_slot;
+                m_root = other.m_root;
+                other.m_tree = nullptr;
+            }
+            return *this;
+        }
+
+        ~Snapshot() { release(); }
+
+        void release() {
+            if (m_tree) {
+                m_tree->m_pins[m_slot].store(0);
+                m_tree = nullptr;
+            }
+        }
+
+        bool empty() const { return m_root == nullptr; }
+
+        const Value *find(const Key &key) const {
+            const Compare &comparator = m_tree->m_comparator;
+            const Node *current = m_root;
+            while (current) {
+                if (comparator(key, current->key)) {
+                    current = current->left;
+                } else if (comparator(current->key, key)) {
+                    current = current->right;
+                } else {
+                    return &current->value;
+                }
+            }
+            return nullptr;
+        }
+
+        // In-order iterator over the pinned version, keeps the path to the current node on a fixed stack
+        class Iterator {
+            const Node *m_stack[MaxHeight];
+            std::size_t m_depth;
+
+            void pushLeft(const Node *node) {
+                while (node) {
+                    m_stack[m_depth++] = node;
+                    node = node->left;
+                }
+            }
+
+        public:
+            using value_type = std::pair<const Key &, const Value &>;
+            using difference_type = std::ptrdiff_t;
+            using iterator_category = std::forward_iterator_tag;
+
+            explicit Iterator(const Node *root)
+                : m_depth(0) {
+                pushLeft(root);
+            }
+
+            Iterator &operator++() {
+                const Node *node = m_stack[--m_depth];
+                pushLeft(node->right);
+                return *this;
+            }
+
+            std::pair<const Key &, const Value &> operator*() const {
+                if (m_depth == 0) {
+                    throw std::runtime_error("Dereferencing invalid iterator");
+                }
+                const Node *node = m_stack[m_depth - 1];
+                return {node->key, node->value};
+            }
+
+            bool operator==(const Iterator &other) const {
+                return m_depth == other.m_depth && (m_depth == 0 || m_stack[m_depth - 1] == other.m_stack[m_depth - 1]);
+            }
+            bool operator!=(const Iterator &other) const { return ! (*this == other); }
+        };
+
+        Iterator begin() const { return Iterator(m_root); }
+        Iterator end() const { return Iterator(nullptr); }
+    };
+
+    PersistentTree(Node *nodeBuffer, std::size_t capacity)
+        : BaseTree(nodeBuffer, capacity)
+        , m_published(nullptr)
+        , m_version(1)
+        , m_writeVersion(1)
+        , m_birth(new std::uint64_t[capacity]())
+        , m_retired(new Retired[capacity])
+        , m_retiredHead(0)
+        , m_retiredCount(0)
+        , m_freeCount(capacity) {
+        for (auto &pin: m_pins) {
+            pin.store(0);
+        }
+    }
+
+    ~PersistentTree() override {
+        delete[] m_birth;
+        delete[] m_retired;
+    }
+
+    bool insert(const Key &key, const Value &value) override {
+        if (BaseTree::m_size >= BaseTree::m_capacity) {
+            return false;
+        }
+#if ENABLE_THREAD_SAFETY
+        std::lock_guard<std::mutex> lock(BaseTree::m_mutex);
+#endif
+        beginWrite();
+        bool inserted = false;
+        Node *root = insertAt(BaseTree::m_root, key, value, false, inserted);
+        if (! inserted) {
+            return false;
+        }
+        publish(root);
+        ++BaseTree::m_size;
+        return true;
+    }
+
+    bool insertOrAssign(const Key &key, const Value &value) override {
+#if ENABLE_THREAD_SAFETY
+        std::lock_guard<std::mutex> lock(BaseTree::m_mutex);
+#endif
+        beginWrite();
+        bool inserted = false;
+        publish(insertAt(BaseTree::m_root, key, value, true, inserted));
+        if (inserted) {
+            ++BaseTree::m_size;
+        }
+        return inserted;
+    }
+
+    bool erase(const Key &key) override {
+#if ENABLE_THREAD_SAFETY
+        std::lock_guard<std::mutex> lock(BaseTree::m_mutex);
+#endif
+        Node *found = successorOf(key, true);
+        if (! found || BaseTree::m_comparator(key, found->key)) {// Missing key - no copy, so no free nodes needed
+            return false;
+        }
+        beginWrite();
+        bool erased = false;
+        Node *root = eraseAt(BaseTree::m_root, key, erased);
+        if (! erased) {
+            return false;
+        }
+        publish(root);
+        --BaseTree::m_size;
+        return true;
+    }
+
+    void clear() override {
+        m_writeVersion = m_version.load() + 1;
+        retireAll(BaseTree::m_root);
+        publish(nullptr);
+        BaseTree::m_size = 0;
+    }
+
+    /**
+     * @brief Pins the latest published version without taking the tree lock.
+     *
+     * @return A snapshot that keeps its version alive until released.
+     * @throws std::out_of_range if MaxSnapshots snapshots are already pinned.
+     */
+    Snapshot snapshot() {
+        for (std::size_t slot = 0; slot < MaxSnapshots; ++slot) {
+            std::uint64_t expected = 0;
+            // Pin before reading the root - the root read can only be as new or newer than the pinned version
+            if (m_pins[slot].compare_exchange_strong(expected, m_version.load())) {
+                return Snapshot(this, slot, m_published.load());
+            }
+        }
+        throw std::out_of_range("No more snapshot slots available");
+    }
+
+    Node *findNode(const Key &key) const override {
+#if ENABLE_THREAD_SAFETY
+        std::lock_guard<std::mutex> lock(BaseTree::m_mutex);
+#endif
+        Node *current = BaseTree::m_root;
+        while (current) {
+            if (BaseTree::m_comparator(key, current->key)) {
+                current = current->left;
+            } else if (BaseTree::m_comparator(current->key, key)) {
+                current = current->right;
+            } else {
+                return current;
+            }
+        }
+        return nullptr;
+    }
+
+    Node *lowerBound(const Key &key) const override {
+#if ENABLE_THREAD_SAFETY
+        std::lock_guard<std::mutex> lock(BaseTree::m_mutex);
+#endif
+        return successorOf(key, true);
+    }
+
+    Node *minimum() override {
+        Node *node = BaseTree::m_root;
+        while (node && node->left) {
+            node = node->left;
+        }
+        return node;
+    }
+
+    // Nodes are shared between versions and have no parent - the successor is searched from the root, O(log n)
+    Node *next(Node *node) override { return node ? successorOf(node->key, false) : nullptr; }
+
+    Node *prev(Node *node) override {
+        Node *current = BaseTree::m_root;
+        Node *candidate = nullptr;
+        while (current) {
+            if (! node || BaseTree::m_comparator(current->key, node->key)) {
+                candidate = current;
+                current = current->right;
+            } else {
+                current = current->left;
+            }
+        }
+        return candidate;
+    }
+};
+
+#endif//ESTL_PERSISTENTTREE_HPP
@@ -42,23 +42,23 @@ protected:
 
     Node *allocateNode() override {
         Node *node = BaseTree::allocateNode();
-        node->SpecialProps.red = true;
+        node->setRed(true);
         return node;
     }
 
     void deallocateNode(Node *node) override {
+        node->setRed(false);// Before the node goes back - a shared pool may hand it out at once
         BaseTree::deallocateNode(node);
-        node->SpecialProps.red = false;
     }
 
-    void rotateLeft(Node *node, Node* &parent) {
+    void rotateLeft(Node *&node, Node* &parent) {
       parent = node->parent;
       BaseTree::rotateLeft(parent);
       node = parent;
       parent = node->parent;
     }
 
-    void rotateRight(Node *node, Node* &parent) {
+    void rotateRight(Node *&node, Node* &parent) {
       parent = node->parent;
       BaseTree::rotateRight(parent);
       node = parent;
@@ -89,11 +89,12 @@ protected:
               return;
             }
 
-            auto parent = node->parent;
-            auto grandparent = node->parent->parent;
-            if (uncle && uncle->SpecialProps.red) {// Case 1: Red uncle and parent (2 reds in a row)
-                parent->SpecialProps.red = uncle->SpecialProps.red = false;// recolor parent & uncle as black
-                grandparent->SpecialProps.red = true;                      // recolor grandparent as red
+            Node *parent = node->parent;
+            Node *grandparent = node->parent->parent;
+            if (uncle && uncle->isRed()) {// Case 1: Red uncle and parent (2 reds in a row)
+                parent->setRed(false);// recolor parent & uncle as black
+                uncle->setRed(false);
+                grandparent->setRed(true);// recolor grandparent as red
                 node = grandparent;// node == grandparent, go back and make sure now that the changes left
                                    // the tree balanced
             } else {               // Case 2 or 3: Black uncle
@@ -115,15 +116,16 @@ protected:
                  *      / \         / \
                  *        Node    Node
                  * **/
-                parent->SpecialProps.red = false;// Case 3: Line
-                grandparent->SpecialProps.red = true;
+                parent->setRed(false);// Case 3: Line
+                grandparent->setRed(true);
                 //rotate the grandparent to fix the line
                 isParentLeft ? BaseTree::rotateRight(grandparent) : BaseTree::rotateLeft(grandparent);
             }
         };
 
         // Loop to fix the Red-Black Tree properties if the parent node is red
-        while (node != BaseTree::m_root && node->parent && node->parent->SpecialProps.red) {// Rule 2 violation: red parent
+        while (node != BaseTree::m_root && node->parent && node->parent->isRed()) {// Rule 2 violation: red parent
+          ESTL_METRIC(++BaseTree::m_counters.rebalances);
           if (node->parent->parent &&
               node->parent == node->parent->parent->left) {
             balanceHelper(node->parent->parent->right, true);
@@ -131,106 +133,156 @@ protected:
                 balanceHelper(node->parent->parent->left, false);
             }
         }
-        BaseTree::m_root->SpecialProps.red = false;// Ensure the root is always black
+        BaseTree::m_root->setRed(false);// Ensure the root is always black
     }
 
     /**
      * @brief Balances the Red-Black Tree after a node deletion.
      *
-     * This function ensures that the Red-Black Tree properties are maintained after a node is deleted.
-     * It uses a helper lambda function to handle the balancing cases and performs rotations and recoloring as needed.
+     * This function ensures that the Red-Black Tree properties are maintained after a black node is deleted. The
+     * position the node left carries an extra black, which is pushed up the tree by recoloring the sibling, or
+     * absorbed with rotations at a sibling that has a red child.
      *
-     * @param node The node that may cause a violation of the Red-Black Tree properties after deletion.
+     * @param node The node that took the deleted node's place - may be null, a missing leaf.
+     * @param parent Parent of that position, needed when node is null.
      */
-    void balanceAfterDeletion(Node *node) {
-      Node *sibling;
-      /** @brief Helper lambda function to balance the tree after deletion.
-         *
-         * This function handles the balancing cases when the sibling node is red or black.
-         * It performs rotations and recoloring to restore the Red-Black Tree properties.
-         *
-         * @param node The current node being checked.
-         * @param sibling The sibling node of the current node. Sibling is the other child of the parent, for example -
-         *            Parent
-         *           /     \
-         *          Node   Sibling
-         * @param isSiblingLeft A boolean indicating if the sibling node is a left child.
-       */
-      auto balanceHelper = [this, &node, &sibling](bool isSiblingLeft) {
-        if (!node || !node->parent) return;
-
-        // Case 1: Red sibling
-        if (sibling && sibling->SpecialProps.red) {
-          sibling->SpecialProps.red = false;
-          node->parent->SpecialProps.red = true;
-          isSiblingLeft ? BaseTree::rotateRight(node->parent) : BaseTree::rotateLeft(node->parent);
-          sibling = isSiblingLeft ? node->parent->left : node->parent->right;
+    void balanceAfterDeletion(Node *node, Node *parent) {
+        while (node != BaseTree::m_root && ! isRed(node) && parent) {
+            ESTL_METRIC(++BaseTree::m_counters.rebalances);
+            const bool isLeft = node == BaseTree::liveChild(parent->left);
+            Node *sibling = BaseTree::liveChild(isLeft ? parent->right : parent->left);
+            if (isRed(sibling)) {// Case 1: Red sibling - rotate it above the parent to get a black sibling
+                sibling->setRed(false);
+                parent->setRed(true);
+                isLeft ? BaseTree::rotateLeft(parent) : BaseTree::rotateRight(parent);
+                sibling = BaseTree::liveChild(isLeft ? parent->right : parent->left);
+            }
+            if (! sibling) {// Not reached in a valid tree - the sibling side holds the missing black
+                node = parent;
+                parent = node->parent;
+                continue;
+            }
+            Node *nearNephew = BaseTree::liveChild(isLeft ? sibling->left : sibling->right);
+            Node *farNephew = BaseTree::liveChild(isLeft ? sibling->right : sibling->left);
+            if (! isRed(nearNephew) && ! isRed(farNephew)) {// Case 2: Black sibling, both children black
+                sibling->setRed(true);
+                node = parent;
+                parent = node->parent;
+                continue;
+            }
+            if (! isRed(farNephew)) {// Case 3: Only the near nephew is red - rotate it into the sibling's place
+                nearNephew->setRed(false);
+                sibling->setRed(true);
+                isLeft ? BaseTree::rotateRight(sibling) : BaseTree::rotateLeft(sibling);
+                sibling = BaseTree::liveChild(isLeft ? parent->right : parent->left);
+                farNephew = BaseTree::liveChild(isLeft ? sibling->right : sibling->left);
+            }
+            // Case 4: Far nephew red - the rotation at the parent absorbs the extra black
+            sibling->setRed(parent->isRed());
+            parent->setRed(false);
+            farNephew->setRed(false);
+            isLeft ? BaseTree::rotateLeft(parent) : BaseTree::rotateRight(parent);
+            node = BaseTree::m_root;
+            parent = nullptr;
         }
+        if (node) {
+            node->setRed(false);
+        }
+    }
 
-        // If sibling is null, move up
-        if (!sibling) {
-          node = node->parent;
-          return;
+    static bool isRed(const Node *node) { return node && node->inUse() && node->isRed(); }
+
+    // Number of black nodes on the path down the given spine - equal on every path of a valid tree
+    static int blackHeight(Node *node, bool leftSpine) {
+        int height = 0;
+        for (node = BaseTree::liveChild(node); node; node = BaseTree::liveChild(leftSpine ? node->left : node->right)) {
+            height += node->isRed() ? 0 : 1;
         }
+        return height;
+    }
+
+public:
+    RBTree(Node *nodeBuffer, std::size_t capacity)
+        : BaseTree(nodeBuffer, capacity) {}
+
+    explicit RBTree(NodePool<Key, Value> *pool)
+        : BaseTree(pool) {}
 
-        Node *leftNephew = sibling->left;
-        Node *rightNephew = sibling->right;
+    bool canJoin() const override { return true; }
 
-        // Case 2: Black sibling, both children black
-        if ((!leftNephew || !leftNephew->SpecialProps.red) &&
-            (!rightNephew || !rightNephew->SpecialProps.red)) {
-          sibling->SpecialProps.red = true;
-          node = node->parent;
-          return;
+    std::unique_ptr<BaseTree> makeWorker() const override {
+        return std::make_unique<RBTree>(BaseTree::m_pool);
+    }
+
+    /**
+     * @brief Joins two detached red-black subtrees around a pivot - O(|bh(left) - bh(right)| + 1).
+     *
+     * The root with the larger black height is followed down its inner spine to a black node of the other tree's
+     * black height, the pivot is hung there as a red node and the usual insertion fix-up repairs a red-red pair.
+     */
+    Node *joinWithPivot(Node *left, Node *pivot, Node *right) override {
+        left = BaseTree::liveChild(left);
+        right = BaseTree::liveChild(right);
+        if (left) {
+            left->parent = nullptr;
+            left->setRed(false);
+        }
+        if (right) {
+            right->parent = nullptr;
+            right->setRed(false);
         }
+        pivot->parent = nullptr;
 
-        // Case 3/4: Black sibling, at least one red child
-        if (isSiblingLeft ? !leftNephew || !leftNephew->SpecialProps.red :
-                          !rightNephew || !rightNephew->SpecialProps.red) {
-          // Case 3: Left nephew black or null
-            if (isSiblingLeft ? rightNephew : leftNephew){
-              isSiblingLeft? rightNephew->SpecialProps.red :
-                            leftNephew->SpecialProps.red = false;
+        const int leftHeight = blackHeight(left, false);
+        const int rightHeight = blackHeight(right, true);
+        if (leftHeight == rightHeight) {
+            pivot->left = left;
+            pivot->right = right;
+            pivot->setRed(false);
+            if (left) {
+                left->parent = pivot;
+            }
+            if (right) {
+                right->parent = pivot;
             }
+            return pivot;
+        }
 
-            sibling->SpecialProps.red = true;
-            isSiblingLeft ? BaseTree::rotateLeft(sibling) :
-                          BaseTree::rotateRight(sibling);
-            sibling = isSiblingLeft ? node->parent->left : node->parent->right;
-            isSiblingLeft ? leftNephew = sibling->left : rightNephew = sibling->right;
-          }
-          // Case 4: Left nephew red
-          sibling->SpecialProps.red = node->parent->SpecialProps.red;
-          node->parent->SpecialProps.red = false;
-          if (isSiblingLeft ? leftNephew : rightNephew) {
-            isSiblingLeft ? leftNephew->SpecialProps.red :
-                          rightNephew->SpecialProps.red =  false;
-          }
-          isSiblingLeft ? BaseTree::rotateRight(node->parent) :
-                        BaseTree::rotateLeft(node->parent);
-          node = BaseTree::m_root;
-      };
+        // Walk down the taller tree's inner spine to a black node with the shorter tree's black height
+        const bool leftTaller = leftHeight > rightHeight;
+        Node *tall = leftTaller ? left : right;
+        Node *shorter = leftTaller ? right : left;
+        int height = leftTaller ? leftHeight : rightHeight;
+        const int target = leftTaller ? rightHeight : leftHeight;
+        Node *parent = nullptr;
+        Node *current = tall;
+        while (current && (isRed(current) || height > target)) {
+            height -= current->isRed() ? 0 : 1;
+            parent = current;
+            current = BaseTree::liveChild(leftTaller ? current->right : current->left);
+        }
 
-      while (node && node != BaseTree::m_root && !node->SpecialProps.red) {
-        if (!node->parent) break;
-        if (node == node->parent->left) {
-          sibling = node->parent->right;
-          balanceHelper(false);
-        } else {
-          sibling = node->parent->left;
-          balanceHelper(true);
+        pivot->setRed(true);
+        pivot->parent = parent;
+        (leftTaller ? pivot->left : pivot->right) = current;
+        (leftTaller ? pivot->right : pivot->left) = shorter;
+        (leftTaller ? parent->right : parent->left) = pivot;
+        if (current) {
+            current->parent = pivot;
+        }
+        if (shorter) {
+            shorter->parent = pivot;
         }
-      }
 
-      if (node) node->SpecialProps.red = false;
+        BaseTree::m_root = tall;// rotations at the top of the fix-up move the root through m_root
+        balanceAfterInsertion(pivot);
+        Node *joined = BaseTree::m_root;
+        joined->parent = nullptr;
+        return joined;
     }
 
-public:
-    RBTree(Node *nodeBuffer, std::size_t capacity)
-        : BaseTree(nodeBuffer, capacity) {}
-
     bool insert(const Key &key, const Value &value) override {
-        if (BaseTree::m_size >= BaseTree::m_capacity) {
+        if (BaseTree::m_pool->available() == 0) {// size() would recount after a split or join
             return false;
         }
 #if ENABLE_THREAD_SAFETY
@@ -255,7 +307,8 @@ public:
         std::lock_guard<std::mutex> lock(BaseTree::m_mutex);
 #endif
         Node *child;
-        bool originalColor = node->SpecialProps.red;
+        Node *childParent = node->parent;// Parent of the position the removed node leaves
+        bool originalColor = node->isRed();
 
         if (! node->left) {// Case left child is null - call to transplant for the right child (and subtree)
             child = node->right;
@@ -266,8 +319,9 @@ public:
         } else {// Case none of the children are null
             //find minimum in right subtree
             Node *successor = BaseTree::minimum(node->right);
-            originalColor = successor->SpecialProps.red;
+            originalColor = successor->isRed();
             child = successor->right;
+            childParent = successor->parent == node ? successor : successor->parent;
             if (successor->parent == node) {//successor is the right child of node
                 if (child) {
                     child->parent = successor;
@@ -281,12 +335,12 @@ public:
             BaseTree::transplant(node, successor);
             successor->left = node->left;
             successor->left->parent = successor;
-            successor->SpecialProps.red = node->SpecialProps.red;
+            successor->setRed(node->isRed());
         }
 
         deallocateNode(node);
-        if (! originalColor && child) {//only if black node deleted
-            balanceAfterDeletion(child);
+        if (! originalColor) {//only if black node deleted
+            balanceAfterDeletion(BaseTree::liveChild(child), childParent);
         }
         --BaseTree::m_size;
         return true;
@@ -0,0 +1,383 @@
+//
+// Generational slot map - stable handles to objects packed in a dense array.
+//
+
+#ifndef ESTL_FIXEDSLOTMAP_HPP
+#define ESTL_FIXEDSLOTMAP_HPP
+#pragma once
+
+#include "ESTLMemory.hpp"
+#include "ESTLMetrics.hpp"
+#include "ESTLUtils.hpp"
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+#ifndef ENABLE_THREAD_SAFETY
+#define ENABLE_THREAD_SAFETY true
+#endif
+
+namespace ESTL {
+    /** Slot map layout
+    insert() returns a SlotHandle {index, generation}: index names a slot of the sparse table, which points at the
+    value in the dense array, and the generation must match the slot's current one. Erasing a value bumps its slot's
+    generation, so every handle to it goes stale at once - find() returns nullptr, at() throws, erase() returns false -
+    with no side map of valid handles.
+        slots   [ 2/g1 | free/g4 | 0/g2 | 1/g1 ]        dense position (or next free slot) / generation
+        values  [ c | d | a | -- ]                      packed, iterated like an array
+        owners  [ 2 | 3 | 0 | -- ]                      slot of each value, to repoint the slot of a moved value
+    The values stay packed: erase moves the last value into the hole - O(1), but iteration order is not insertion
+    order. Freed slots are reused last-in first-out, so a churning pool keeps handing out the slots it touched last.
+    Values are constructed in place on insert and destroyed on erase; T needs no default constructor.
+    Generations are 32-bit and skip 0, so the default SlotHandle is never valid. A slot would have to be erased 2^32
+    times for an old handle to match again.
+     * */
+    struct SlotHandle {
+        std::uint32_t index = 0;
+        std::uint32_t generation = 0;// 0: the null handle
+
+        bool operator==(const SlotHandle &other) const {
+            return index == other.index && generation == other.generation;
+        }
+        bool operator!=(const SlotHandle &other) const { return ! (*this == other); }
+    };
+
+    template<typename T>
+    class FixedSlotMap {
+    protected:
+        static constexpr std::uint32_t kNoSlot = std::numeric_limits<std::uint32_t>::max();
+
+        // The value is raw storage, constructed while the cell is below size()
+        struct Cell {
+            union {
+                T value;
+            };
+
+            Cell() {}
+            ~Cell() {}
+        };
+
+        struct Slot {
+            std::uint32_t target;    // Dense position while in use, next free slot otherwise
+            std::uint32_t generation;// Bumped on erase
+        };
+
+        Cell *m_values;
+        std::uint32_t *m_owners;// Slot of each dense position
+        Slot *m_slots;
+        std::size_t m_capacity;
+        std::size_t m_size;
+        std::uint32_t m_freeHead;
+#if (ENABLE_THREAD_SAFETY)
+        mutable ContainerMutex m_mutex;
+#endif
+#if ESTL_ENABLE_METRICS
+        metrics::Counters m_counters;
+#endif
+
+        // The derived class links the slots once its arrays exist
+        FixedSlotMap(Cell *values, std::uint32_t *owners, Slot *slots, std::size_t capacity, InlineStorage)
+            : m_values(values)
+            , m_owners(owners)
+            , m_slots(slots)
+            , m_capacity(capacity)
+            , m_size(0)
+            , m_freeHead(kNoSlot) {
+            if (capacity >= kNoSlot) {
+                throw std::invalid_argument("FixedSlotMap capacity exceeds 32-bit slot indices");
+            }
+        }
+
+        // Takes other's arrays as they are - O(1), for RT slot maps. other is left without storage: it can only be
+        // destroyed or assigned to.
+        FixedSlotMap(FixedSlotMap &&other) noexcept
+            : m_values(other.m_values)
+            , m_owners(other.m_owners)
+            , m_slots(other.m_slots)
+            , m_capacity(other.m_capacity)
+            , m_size(other.m_size)
+            , m_freeHead(other.m_freeHead) {
+            ESTL_METRIC(m_counters = other.m_counters);
+            other.forgetStorage();
+        }
+
+        void forgetStorage() {
+            m_values = nullptr;
+            m_owners = nullptr;
+            m_slots = nullptr;
+            m_capacity = m_size = 0;
+            m_freeHead = kNoSlot;
+        }
+
+        // Every slot free, in index order, at generation 1
+        void initSlots() {
+            for (std::size_t i = 0; i < m_capacity; ++i) {
+                m_slots[i].target = i + 1 < m_capacity ? static_cast<std::uint32_t>(i + 1) : kNoSlot;
+                m_slots[i].generation = 1;
+            }
+            m_freeHead = m_capacity ? 0 : kNoSlot;
+            m_size = 0;
+            ESTL_METRIC(m_counters.poolInUse = 0);
+        }
+
+        static std::uint32_t nextGeneration(std::uint32_t generation) { return generation + 1 ? generation + 1 : 1; }
+
+        // Dense position of handle's value, or m_size when the handle is stale
+        std::size_t locate(SlotHandle handle) const {
+            if (handle.index >= m_capacity) {
+                return m_size;
+            }
+            const Slot &slot = m_slots[handle.index];
+            return slot.generation == handle.generation && slot.target < m_size && m_owners[slot.target] == handle.index
+                           ? slot.target
+                           : m_size;
+        }
+
+        // Destroys the value at position, fills the hole with the last value and frees the slot
+        void eraseAt(std::size_t position) {
+            const std::uint32_t index = m_owners[position];
+            const std::size_t last = m_size - 1;
+            m_values[position].value.~T();
+            if (position != last) {
+                detail::constructAt(&m_values[position].value, std::move(m_values[last].value));
+                m_values[last].value.~T();
+                m_owners[position] = m_owners[last];
+                m_slots[m_owners[position]].target = static_cast<std::uint32_t>(position);
+            }
+            --m_size;
+            Slot &slot = m_slots[index];
+            slot.generation = nextGeneration(slot.generation);
+            slot.target = m_freeHead;
+            m_freeHead = index;
+            ESTL_METRIC(m_counters.release());
+        }
+
+        // Destroys every value; all handles go stale
+        void releaseValues() {
+            while (m_size) {
+                const std::size_t last = m_size - 1;
+                Slot &slot = m_slots[m_owners[last]];
+                slot.generation = nextGeneration(slot.generation);
+                slot.target = m_freeHead;
+                m_freeHead = m_owners[last];
+                m_values[last].value.~T();
+                m_size = last;
+            }
+            ESTL_METRIC(m_counters.poolInUse = 0);
+        }
+
+    public:
+        using iterator = T *;
+        using const_iterator = const T *;
+
+        FixedSlotMap(const FixedSlotMap &) = delete;
+        FixedSlotMap &operator=(const FixedSlotMap &) = delete;
+
+        // Constructs a value in place and returns its handle - O(1). Throws std::out_of_range when full.
+        template<typename... Args>
+        SlotHandle emplace(Args &&...args) {
+#if (ENABLE_THREAD_SAFETY)
+            std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
+            if (m_freeHead == kNoSlot) {
+                throw std::out_of_range("FixedSlotMap is full");
+            }
+            // The slot is taken only once the value exists, so a throwing constructor leaves the map unchanged
+            detail::constructAt(&m_values[m_size].value, std::forward<Args>(args)...);
+            const std::uint32_t index = m_freeHead;
+            Slot &slot = m_slots[index];
+            m_freeHead = slot.target;
+            slot.target = static_cast<std::uint32_t>(m_size);
+            m_owners[m_size] = index;
+            ++m_size;
+            ESTL_METRIC(m_counters.acquire());
+            return SlotHandle{index, slot.generation};
+        }
+
+        SlotHandle insert(const T &value) { return emplace(value); }
+        SlotHandle insert(T &&value) { return emplace(std::move(value)); }
+
+        // Value of handle, nullptr when the handle is stale or null - O(1)
+        T *find(SlotHandle handle) {
+#if (ENABLE_THREAD_SAFETY)
+            std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
+            const std::size_t position = locate(handle);
+            return position < m_size ? &m_values[position].value : nullptr;
+        }
+
+        const T *find(SlotHandle handle) const { return const_cast<FixedSlotMap *>(this)->find(handle); }
+
+        bool contains(SlotHandle handle) const { return find(handle) != nullptr; }
+
+        // Bounds-checked access - throws std::out_of_range for a stale or null handle
+        T &at(SlotHandle handle) {
+            T *value = find(handle);
+            if (! value) {
+                throw std::out_of_range("Stale or invalid slot handle");
+            }
+            return *value;
+        }
+
+        const T &at(SlotHandle handle) const { return const_cast<FixedSlotMap *>(this)->at(handle); }
+
+        T &operator[](SlotHandle handle) { return at(handle); }
+        const T &operator[](SlotHandle handle) const { return at(handle); }
+
+        // Destroys the value and invalidates every handle to it - false when the handle is already stale. O(1).
+        bool erase(SlotHandle handle) {
+#if (ENABLE_THREAD_SAFETY)
+            std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
+            const std::size_t position = locate(handle);
+            if (position == m_size) {
+                return false;
+            }
+            eraseAt(position);
+            return true;
+        }
+
+        void clear() {
+#if (ENABLE_THREAD_SAFETY)
+            std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
+            releaseValues();
+        }
+
+        // Handle of the value at a dense position, e.g. while iterating
+        SlotHandle handleAt(std::size_t position) const {
+#if (ENABLE_THREAD_SAFETY)
+            std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
+            if (position >= m_size) {
+                throw std::out_of_range("Index out of bounds");
+            }
+            const std::uint32_t index = m_owners[position];
+            return SlotHandle{index, m_slots[index].generation};
+        }
+
+        std::size_t size() const {
+#if (ENABLE_THREAD_SAFETY)
+            std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
+            return m_size;
+        }
+
+        std::size_t capacity() const { return m_capacity; }
+        bool empty() const { return size() == 0; }
+        bool full() const { return size() == m_capacity; }
+
+        // The dense array is the pool
+        ContainerMetrics metrics() const {
+#if (ENABLE_THREAD_SAFETY)
+            std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
+            ContainerMetrics result;
+            result.size = result.poolInUse = m_size;
+            result.capacity = result.poolCapacity = m_capacity;
+            result.loadFactor = m_capacity ? double(m_size) / m_capacity : 0;
+#if ESTL_ENABLE_METRICS
+            result.poolHighWater = m_counters.poolHighWater;
+#if (ENABLE_THREAD_SAFETY)
+            result.lockWait = m_mutex.histogram();
+#endif
+#endif
+            return result;
+        }
+
+        // Visits every value with its handle as visit(SlotHandle, T &), under the lock. visit must not modify the map.
+        template<typename Visitor>
+        void forEach(Visitor visit) {
+#if (ENABLE_THREAD_SAFETY)
+            std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
+            for (std::size_t position = 0; position < m_size; ++position) {
+                const std::uint32_t index = m_owners[position];
+                visit(SlotHandle{index, m_slots[index].generation}, m_values[position].value);
+            }
+        }
+
+        // The dense values, unordered - erase moves the last value into the hole
+        iterator begin() { return &m_values[0].value; }
+        iterator end() { return &m_values[0].value + m_size; }
+        const_iterator begin() const { return &m_values[0].value; }
+        const_iterator end() const { return &m_values[0].value + m_size; }
+    };
+
+    // Compile-time slot map
+    template<typename T, std::size_t N>
+    class CTSlotMap : public FixedSlotMap<T> {
+        using Base = FixedSlotMap<T>;
+
+        std::array<typename Base::Cell, N> m_valueBuffer;
+        std::array<std::uint32_t, N> m_ownerBuffer;
+        std::array<typename Base::Slot, N> m_slotBuffer;
+
+    public:
+        CTSlotMap()
+            : Base(m_valueBuffer.data(), m_ownerBuffer.data(), m_slotBuffer.data(), N, InlineStorage{}) {
+            this->initSlots();
+        }
+
+        ~CTSlotMap() { this->releaseValues(); }
+    };
+
+    // Run-time slot map - storage comes from a MemoryResource, the heap by default
+    template<typename T>
+    class RTSlotMap : public FixedSlotMap<T> {
+        using Base = FixedSlotMap<T>;
+        using Cell = typename Base::Cell;
+        using Slot = typename Base::Slot;
+
+        MemoryResource *m_resource;
+
+        void releaseStorage() {
+            memory::destroyArray(m_resource, this->m_values, this->m_capacity);
+            memory::destroyArray(m_resource, this->m_owners, this->m_capacity);
+            memory::destroyArray(m_resource, this->m_slots, this->m_capacity);
+        }
+
+    public:
+        explicit RTSlotMap(std::size_t capacity, MemoryResource *resource = defaultResource())
+            : Base(memory::createArray<Cell>(resource, capacity),
+                   memory::createArray<std::uint32_t>(resource, capacity),
+                   memory::createArray<Slot>(resource, capacity), capacity, InlineStorage{})
+            , m_resource(resource) {
+            this->initSlots();
+        }
+
+        ~RTSlotMap() {
+            this->releaseValues();
+            releaseStorage();
+        }
+
+        // The arrays change hands - handles stay valid against the new owner
+        RTSlotMap(RTSlotMap &&other) noexcept
+            : Base(std::move(other))
+            , m_resource(other.m_resource) {}
+
+        RTSlotMap &operator=(RTSlotMap &&other) noexcept {
+            if (this != &other) {
+                this->releaseValues();
+                releaseStorage();
+                this->m_values = other.m_values;
+                this->m_owners = other.m_owners;
+                this->m_slots = other.m_slots;
+                this->m_capacity = other.m_capacity;
+                this->m_size = other.m_size;
+                this->m_freeHead = other.m_freeHead;
+                ESTL_METRIC(this->m_counters = other.m_counters);
+                m_resource = other.m_resource;
+                other.forgetStorage();
+            }
+            return *this;
+        }
+
+        MemoryResource *resource() const { return m_resource; }
+    };
+}// namespace ESTL
+
+#endif//ESTL_FIXEDSLOTMAP_HPP
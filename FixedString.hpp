@@ -6,21 +6,37 @@
 #define ESTL_FIXEDSTRING_HPP
 #pragma once
 
+#include "ESTLMemory.hpp"
+#include <algorithm>
 #include <array>
 #include <cstring>
 #include <iostream>
 #include <stdexcept>
 
 namespace ESTL {
+    class Serialization;
 
     // Base class containing common logic
     template<typename Derived>
     class FixedStringBase {
+        friend class Serialization;
+        template<typename>
+        friend class FixedStringBase;
+
     protected:
         char *m_data;          // Pointer to the character buffer
         std::size_t m_size;    // Current size of the string
         std::size_t m_capacity;// Fixed capacity (for both CT and RT)
 
+        // Takes other's buffer - for RT strings only. other is left without one: destroy or assign it.
+        FixedStringBase(FixedStringBase &&other) noexcept
+            : m_data(other.m_data)
+            , m_size(other.m_size)
+            , m_capacity(other.m_capacity) {
+            other.m_data = nullptr;
+            other.m_size = other.m_capacity = 0;
+        }
+
     public:
         // Constructor
         FixedStringBase(char *buffer, std::size_t capacity)
@@ -58,6 +74,27 @@ namespace ESTL {
             m_data[0] = '\0';
         }
 
+        // Character-wise swap through both buffers, O(size) - each string keeps its own buffer and capacity
+        template<typename OtherDerived>
+        void swap(FixedStringBase<OtherDerived> &other) {
+            if (static_cast<void *>(this) == static_cast<void *>(&other)) {
+                return;
+            }
+            if (m_size > other.m_capacity || other.m_size > m_capacity) {
+                throw std::out_of_range("Swap exceeds fixed capacity");
+            }
+            const std::size_t common = std::min(m_size, other.m_size);
+            std::swap_ranges(m_data, m_data + common, other.m_data);
+            if (m_size > common) {
+                std::memcpy(other.m_data + common, m_data + common, m_size - common);
+            } else {
+                std::memcpy(m_data + common, other.m_data + common, other.m_size - common);
+            }
+            std::swap(m_size, other.m_size);
+            m_data[m_size] = '\0';
+            other.m_data[other.m_size] = '\0';
+        }
+
         // Append
         void append(const char *str) {
             std::size_t len = std::strlen(str);
@@ -226,17 +263,34 @@ namespace ESTL {
             }
             std::strcpy(this->m_data, str);
         }
+
+        // Copies point at this string's own buffer, not the source's
+        CTString(const CTString &other)
+            : CTString() {
+            *this = other;
+        }
+
+        CTString &operator=(const CTString &other) {
+            if (this != &other) {
+                this->m_size = other.m_size;
+                std::memcpy(this->m_data, other.m_data, other.m_size + 1);
+            }
+            return *this;
+        }
     };
 
-    // Runtime FixedString
+    // Runtime FixedString - the buffer comes from a MemoryResource, the heap by default
     class RTString : public FixedStringBase<RTString> {
+        MemoryResource *m_resource;
+
     public:
         // Constructor
-        explicit RTString(std::size_t capacity)
-            : FixedStringBase<RTString>(new char[capacity + 1], capacity) {}
+        explicit RTString(std::size_t capacity, MemoryResource *resource = defaultResource())
+            : FixedStringBase<RTString>(memory::createArray<char>(resource, capacity + 1), capacity)
+            , m_resource(resource) {}
 
-        RTString(const char *str, std::size_t capacity)
-            : RTString(capacity) {
+        RTString(const char *str, std::size_t capacity, MemoryResource *resource = defaultResource())
+            : RTString(capacity, resource) {
             this->m_size = std::strlen(str);
             if (this->m_size > this->m_capacity) {
                 throw std::out_of_range("String exceeds fixed capacity");
@@ -244,27 +298,66 @@ namespace ESTL {
             std::strcpy(this->m_data, str);
         }
 
-        // Copy constructor
+        // Copy constructor - copies size() characters, not the capacity
         RTString(const RTString &other)
-            : FixedStringBase<RTString>(new char[other.m_capacity + 1], other.m_capacity) {
-            this->m_size = other.m_size;
-            std::strcpy(this->m_data, other.m_data);
+            : FixedStringBase<RTString>(memory::createArray<char>(other.m_resource, other.m_capacity + 1),
+                                        other.m_capacity)
+            , m_resource(other.m_resource) {
+            copyFrom(other);
         }
 
-        // Assignment operator
+        // Assignment operator - keeps the buffer when the capacities match
         RTString &operator=(const RTString &other) {
             if (this != &other) {
-                delete[] this->m_data;
-                this->m_capacity = other.m_capacity;
+                if (this->m_capacity != other.m_capacity) {
+                    char *data = memory::createArray<char>(m_resource, other.m_capacity + 1);
+                    memory::destroyArray(m_resource, this->m_data, this->m_capacity + 1);
+                    this->m_capacity = other.m_capacity;
+                    this->m_data = data;
+                }
+                copyFrom(other);
+            }
+            return *this;
+        }
+
+        // Moves take the buffer, O(1)
+        RTString(RTString &&other) noexcept
+            : FixedStringBase<RTString>(std::move(other))
+            , m_resource(other.m_resource) {}
+
+        RTString &operator=(RTString &&other) noexcept {
+            if (this != &other) {
+                memory::destroyArray(m_resource, this->m_data, this->m_capacity + 1);
+                this->m_data = other.m_data;
                 this->m_size = other.m_size;
-                this->m_data = new char[this->m_capacity + 1];
-                std::strcpy(this->m_data, other.m_data);
+                this->m_capacity = other.m_capacity;
+                m_resource = other.m_resource;
+                other.m_data = nullptr;
+                other.m_size = other.m_capacity = 0;
             }
             return *this;
         }
 
+        // RT strings exchange buffers, capacities included; the bounded swap stays for other string types
+        using FixedStringBase<RTString>::swap;
+        void swap(RTString &other) noexcept {
+            std::swap(this->m_data, other.m_data);
+            std::swap(this->m_size, other.m_size);
+            std::swap(this->m_capacity, other.m_capacity);
+            std::swap(m_resource, other.m_resource);
+        }
+
         // Destructor
-        ~RTString() { delete[] this->m_data; }
+        ~RTString() { memory::destroyArray(m_resource, this->m_data, this->m_capacity + 1); }
+
+        MemoryResource *resource() const { return m_resource; }
+
+    private:
+        void copyFrom(const RTString &other) {
+            this->m_size = other.m_size;
+            std::memcpy(this->m_data, other.m_data, other.m_size);
+            this->m_data[this->m_size] = '\0';
+        }
     };
 
 }// namespace ESTL
@@ -3,11 +3,19 @@
 //
 #pragma once
 
+#include "ESTLMemory.hpp"
+#include "ESTLMetrics.hpp"
+#include "ESTLTrace.hpp"
+#include "ESTLUtils.hpp"
+#include <algorithm>
 #include <array>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <new>
 #include <stdexcept>
+#include <utility>
 #include <vector>
 
 #ifndef ENABLE_THREAD_SAFETY
@@ -17,12 +25,22 @@
 namespace ESTL {
     enum class ProbingStrategy { CHAINING, LINEAR_PROBING, QUADRATIC_PROBING };
 
+    // Hash of integral and enum keys usable in constant expressions, where std::hash is not - the key itself, as
+    // std::hash of an integer is in libstdc++ and libc++
+    template<typename Key>
+    struct ConstexprHash {
+        constexpr std::size_t operator()(const Key &key) const noexcept { return static_cast<std::size_t>(key); }
+    };
+
     template<typename K, typename H>
     class FixedUnorderedSet;
     template<typename K, std::size_t M, std::size_t P, typename H>
     class CTUnorderedSet;
     template<typename K, typename H>
     class RTUnorderedSet;
+    template<typename K, typename V, typename H>
+    class UnorderedMapImage;
+    class Serialization;
 
     template<typename Key, typename Value, typename Hash = std::hash<Key>>
     class FixedUnorderedMap {
@@ -32,37 +50,153 @@ namespace ESTL {
         friend class CTUnorderedSet;
         template<typename K, typename H>
         friend class RTUnorderedSet;
+        template<typename K, typename V, typename H>
+        friend class UnorderedMapImage;
+        friend class Serialization;
 
     protected:
+        // Key and value are raw storage, constructed while occupied is set
         struct Bucket {
-            Key key;
-            Value value;
+            // The vacant members are active while the bucket is free - a constant may not hold a union without one
+            union {
+#if ESTL_CONSTEXPR_CONTAINERS
+                char vacantKey{};
+#endif
+                Key key;
+            };
+            union {
+#if ESTL_CONSTEXPR_CONTAINERS
+                char vacantValue{};
+#endif
+                Value value;
+            };
             bool occupied = false;
             Bucket *next = nullptr;// Chaining for collisions
+
+            ESTL_CONSTEXPR Bucket() {}
+            ESTL_CONSTEXPR ~Bucket() {}
+
+            template<typename K, typename V>
+            ESTL_CONSTEXPR void construct(K &&newKey, V &&newValue) {
+                detail::constructAt(&key, std::forward<K>(newKey));
+                try {
+                    detail::constructAt(&value, std::forward<V>(newValue));
+                } catch (...) {
+                    key.~Key();
+#if ESTL_CONSTEXPR_CONTAINERS
+                    vacantKey = 0;
+#endif
+                    throw;
+                }
+                occupied = true;
+            }
+
+            ESTL_CONSTEXPR void destroy() {
+                key.~Key();
+                value.~Value();
+#if ESTL_CONSTEXPR_CONTAINERS
+                vacantKey = vacantValue = 0;
+#endif
+                occupied = false;
+            }
         };
 
         // Gets the first available free bucket
-        Bucket *getFreeBucket() {
+        ESTL_CONSTEXPR Bucket *getFreeBucket() {
             if (! m_freeBuckets) {
                 throw std::out_of_range("No more free buckets available");
             }
             Bucket *bucket = m_freeBuckets;
             m_freeBuckets = m_freeBuckets->next;
             bucket->next = nullptr;
+            ESTL_METRIC(m_counters.acquire());
             return bucket;
         }
 
-        // Returns a bucket to the free pool
-        void returnBucket(Bucket *bucket) {
-            bucket->occupied = false;
+        // Returns a bucket to the free pool, destroying its entry
+        ESTL_CONSTEXPR void returnBucket(Bucket *bucket) {
+            if (bucket->occupied) {
+                bucket->destroy();
+            }
             bucket->next = m_freeBuckets;
             m_freeBuckets = bucket;
+            ESTL_METRIC(m_counters.release());
+        }
+
+        // Fills a bucket taken from the pool - it goes back if a copy throws
+        ESTL_CONSTEXPR void constructChained(Bucket *bucket, const Key &key, const Value &value) {
+            try {
+                bucket->construct(key, value);
+            } catch (...) {
+                returnBucket(bucket);
+                throw;
+            }
+        }
+
+        // Replaces a primary bucket's entry with its first chained one, which goes back to the pool
+        ESTL_CONSTEXPR void pullChained(Bucket *bucket) {
+            Bucket *nextBucket = bucket->next;
+            bucket->destroy();
+            bucket->construct(std::move(nextBucket->key), std::move(nextBucket->value));
+            bucket->next = nextBucket->next;
+            returnBucket(nextBucket);
         }
 
-        std::size_t getBucketIndex(const Key &key) const { return m_hasher(key) % m_mapCapacity; }
+        // Destroys every entry and returns the chained buckets to the pool
+        ESTL_CONSTEXPR void releaseEntries() {
+            for (std::size_t i = nextOccupied(0); i < m_mapCapacity; i = nextOccupied(i + 1)) {
+                Bucket *bucket = &m_buckets[i];
+                bucket->destroy();
+                Bucket *current = bucket->next;
+                while (current) {
+                    Bucket *next = current->next;
+                    returnBucket(current);
+                    current = next;
+                }
+                bucket->next = nullptr;
+            }
+            clearOccupancy();
+        }
+
+        ESTL_CONSTEXPR std::size_t getBucketIndex(const Key &key) const { return m_hasher(key) % m_mapCapacity; }
+
+        // Occupancy bitmap - bit i is set while primary bucket i holds an entry
+        static constexpr std::size_t occupancyWords(std::size_t mapCapacity) { return (mapCapacity + 63) / 64; }
+
+        ESTL_CONSTEXPR void markOccupied(std::size_t index) {
+            m_occupancy[index / 64] |= std::uint64_t(1) << (index % 64);
+        }
+        ESTL_CONSTEXPR void markFree(std::size_t index) {
+            m_occupancy[index / 64] &= ~(std::uint64_t(1) << (index % 64));
+        }
+
+        ESTL_CONSTEXPR void clearOccupancy() { std::fill(m_occupancy, m_occupancy + occupancyWords(m_mapCapacity), 0); }
+
+        // First occupied primary bucket at or after index, m_mapCapacity if none - skips 64 empty buckets per word
+        static ESTL_CONSTEXPR std::size_t nextOccupied(const std::uint64_t *occupancy, std::size_t mapCapacity,
+                                                      std::size_t index) {
+            if (index >= mapCapacity) {
+                return mapCapacity;
+            }
+            std::size_t word = index / 64;
+            std::uint64_t bits = occupancy[word] & (~std::uint64_t(0) << (index % 64));
+            const std::size_t words = occupancyWords(mapCapacity);
+            while (! bits) {
+                if (++word == words) {
+                    return mapCapacity;
+                }
+                bits = occupancy[word];
+            }
+            return word * 64 + static_cast<std::size_t>(__builtin_ctzll(bits));
+        }
+
+        ESTL_CONSTEXPR std::size_t nextOccupied(std::size_t index) const {
+            return nextOccupied(m_occupancy, m_mapCapacity, index);
+        }
 
         Bucket *m_buckets;
         Bucket *m_bucketPool;
+        std::uint64_t *m_occupancy;// occupancyWords(m_mapCapacity) words
         Bucket *m_freeBuckets;// Pool of available buckets
         Hash m_hasher;
         std::size_t m_size;
@@ -70,41 +204,76 @@ namespace ESTL {
         std::size_t m_bucketPoolCapacity;
         ProbingStrategy m_probingStrategy;
 #if (ENABLE_THREAD_SAFETY)
-        mutable std::mutex m_mutex;
+        mutable ContainerMutex m_mutex;
+#endif
+#if ESTL_ENABLE_METRICS
+        metrics::Counters m_counters;
 #endif
 
-    public:
-        FixedUnorderedMap(Bucket *bucketBuffer, Bucket *bucketPool, size_t mapCapacity, size_t poolCapacity)
+        // Takes other's buckets as they are - O(1), for RT maps whose arrays can change hands. other is left without
+        // storage: it can only be destroyed or assigned to.
+        FixedUnorderedMap(FixedUnorderedMap &&other) noexcept
+            : m_buckets(other.m_buckets)
+            , m_bucketPool(other.m_bucketPool)
+            , m_occupancy(other.m_occupancy)
+            , m_freeBuckets(other.m_freeBuckets)
+            , m_hasher(std::move(other.m_hasher))
+            , m_size(other.m_size)
+            , m_mapCapacity(other.m_mapCapacity)
+            , m_bucketPoolCapacity(other.m_bucketPoolCapacity)
+            , m_probingStrategy(other.m_probingStrategy) {
+            ESTL_METRIC(m_counters = other.m_counters);
+            other.forgetStorage();
+        }
+
+        void forgetStorage() {
+            m_buckets = m_bucketPool = m_freeBuckets = nullptr;
+            m_occupancy = nullptr;
+            m_size = m_mapCapacity = m_bucketPoolCapacity = 0;
+        }
+
+        // The derived class initializes the pool and the bitmap once its arrays exist
+        ESTL_CONSTEXPR FixedUnorderedMap(Bucket *bucketBuffer, Bucket *bucketPool, std::uint64_t *occupancy,
+                                         size_t mapCapacity, size_t poolCapacity, InlineStorage)
             : m_buckets(bucketBuffer)
             , m_bucketPool(bucketPool)
+            , m_occupancy(occupancy)
             , m_freeBuckets(nullptr)
             , m_size(0)
             , m_mapCapacity(mapCapacity)
             , m_bucketPoolCapacity(poolCapacity)
-            , m_probingStrategy(ProbingStrategy::CHAINING) {
+            , m_probingStrategy(ProbingStrategy::CHAINING) {}
+
+    public:
+        FixedUnorderedMap(Bucket *bucketBuffer, Bucket *bucketPool, std::uint64_t *occupancy, size_t mapCapacity,
+                          size_t poolCapacity)
+            : FixedUnorderedMap(bucketBuffer, bucketPool, occupancy, mapCapacity, poolCapacity, InlineStorage{}) {
             initFreeBucketPool();
+            clearOccupancy();
         }
 
         // Helper to initialize the free bucket pool
-        void initFreeBucketPool() {
+        ESTL_CONSTEXPR void initFreeBucketPool() {
             for (std::size_t i = 0; i < m_bucketPoolCapacity - 1; ++i) {
                 m_bucketPool[i].next = &m_bucketPool[i + 1];
             }
             m_bucketPool[m_bucketPoolCapacity - 1].next = nullptr;
             m_freeBuckets = &m_bucketPool[0];
+            ESTL_METRIC(m_counters.poolInUse = 0);
         }
 
-        bool insert(const Key &key, const Value &value) {
+        ESTL_CONSTEXPR bool insert(const Key &key, const Value &value) {
             std::size_t index = getBucketIndex(key);
             Bucket *bucket = &m_buckets[index];
             // If bucket is free, use it
 #if (ENABLE_THREAD_SAFETY)
-            std::lock_guard<std::mutex> lock(m_mutex);
+            std::lock_guard<ContainerMutex> lock(m_mutex);
 #endif
+            ESTL_TRACE(trace::Span span(TraceKind::UnorderedMap, TraceOp::Insert, this, m_size));
+            ESTL_TRACE(span.probes = 1);
             if (! bucket->occupied) {
-                bucket->key = key;
-                bucket->value = value;
-                bucket->occupied = true;
+                bucket->construct(key, value);
+                markOccupied(index);
                 ++m_size;
             } else if (bucket->key == key) {
                 return false;// Key already exists
@@ -113,15 +282,14 @@ namespace ESTL {
                 // Separate chaining
                 while (bucket->next) {
                     bucket = bucket->next;
+                    ESTL_TRACE(++span.probes);
                     if (bucket->key == key) {
                         return false;// Key already exists
                     }
                 }
                 // Allocate new bucket
                 Bucket *newBucket = getFreeBucket();
-                newBucket->key = key;
-                newBucket->value = value;
-                newBucket->occupied = true;
+                constructChained(newBucket, key, value);
                 bucket->next = newBucket;
                 ++m_size;
             }
@@ -129,16 +297,17 @@ namespace ESTL {
         }
 
         // Insert or assign method
-        bool insert_or_assign(const Key &key, const Value &value) {
+        ESTL_CONSTEXPR bool insert_or_assign(const Key &key, const Value &value) {
             std::size_t index = getBucketIndex(key);
             Bucket *bucket = &m_buckets[index];
 #if (ENABLE_THREAD_SAFETY)
-            std::lock_guard<std::mutex> lock(m_mutex);
+            std::lock_guard<ContainerMutex> lock(m_mutex);
 #endif
+            ESTL_TRACE(trace::Span span(TraceKind::UnorderedMap, TraceOp::InsertOrAssign, this, m_size));
+            ESTL_TRACE(span.probes = 1);
             if (! bucket->occupied) {
-                bucket->key = key;
-                bucket->value = value;
-                bucket->occupied = true;
+                bucket->construct(key, value);
+                markOccupied(index);
                 ++m_size;
                 return true;
             } else if (bucket->key == key) {
@@ -147,41 +316,40 @@ namespace ESTL {
             } else {
                 while (bucket->next) {
                     bucket = bucket->next;
+                    ESTL_TRACE(++span.probes);
                     if (bucket->key == key) {
                         bucket->value = value;
                         return false;
                     }
                 }
                 Bucket *newBucket = getFreeBucket();
-                newBucket->key = key;
-                newBucket->value = value;
-                newBucket->occupied = true;
+                constructChained(newBucket, key, value);
                 bucket->next = newBucket;
                 ++m_size;
                 return true;
             }
         }
 
-        bool erase(const Key &key) {
+        ESTL_CONSTEXPR bool erase(const Key &key) {
             std::size_t index = getBucketIndex(key);
             Bucket *bucket = &m_buckets[index];
             Bucket *prev = nullptr;
 #if (ENABLE_THREAD_SAFETY)
-            std::lock_guard<std::mutex> lock(m_mutex);
+            std::lock_guard<ContainerMutex> lock(m_mutex);
 #endif
+            ESTL_TRACE(trace::Span span(TraceKind::UnorderedMap, TraceOp::Erase, this, m_size));
             while (bucket) {
+                ESTL_TRACE(++span.probes);
                 if (bucket->occupied && bucket->key == key) {
                     if (prev) {
                         prev->next = bucket->next;
                         returnBucket(bucket);
                     } else {
                         if (bucket->next) {
-                            // Move next bucket data into current bucket
-                            Bucket *nextBucket = bucket->next;
-                            *bucket = *nextBucket;
-                            returnBucket(nextBucket);
+                            pullChained(bucket);
                         } else {
-                            bucket->occupied = false;
+                            bucket->destroy();
+                            markFree(index);
                         }
                     }
                     --m_size;
@@ -193,13 +361,15 @@ namespace ESTL {
             return false;
         }
 
-        Value *find(const Key &key) const {
+        ESTL_CONSTEXPR Value *find(const Key &key) const {
             std::size_t index = getBucketIndex(key);
 #if (ENABLE_THREAD_SAFETY)
-            std::lock_guard<std::mutex> lock(m_mutex);
+            std::lock_guard<ContainerMutex> lock(m_mutex);
 #endif
+            ESTL_TRACE(trace::Span span(TraceKind::UnorderedMap, TraceOp::Find, this, m_size));
             Bucket *bucket = &m_buckets[index];
             while (bucket) {
+                ESTL_TRACE(++span.probes);
                 if (bucket->occupied && bucket->key == key) {
                     return &bucket->value;
                 }
@@ -208,9 +378,9 @@ namespace ESTL {
             return nullptr;
         }
 
-        Value &operator[](const Key &key) {
+        ESTL_CONSTEXPR Value &operator[](const Key &key) {
 #if (ENABLE_THREAD_SAFETY)
-            std::lock_guard<std::mutex> lock(m_mutex);
+            std::lock_guard<ContainerMutex> lock(m_mutex);
 #endif
             Value *found = find(key);
             if (found)
@@ -221,32 +391,19 @@ namespace ESTL {
             return *find(key);
         }
 
-        void clear() {
+        ESTL_CONSTEXPR void clear() {
 #if (ENABLE_THREAD_SAFETY)
-            std::lock_guard<std::mutex> lock(m_mutex);
+            std::lock_guard<ContainerMutex> lock(m_mutex);
 #endif
-            for (std::size_t i = 0; i < m_mapCapacity; ++i) {
-                Bucket *bucket = &m_buckets[i];
-                if (bucket->occupied) {
-                    bucket->occupied = false;
-
-                    // Handle chained buckets
-                    Bucket *current = bucket->next;
-                    while (current) {
-                        Bucket *next = current->next;
-                        returnBucket(current);
-                        current = next;
-                    }
-                    bucket->next = nullptr;
-                }
-            }
+            ESTL_TRACE(trace::Span span(TraceKind::UnorderedMap, TraceOp::Clear, this, m_size));
+            releaseEntries();
             m_size = 0;
         }
 
         // Extract a key-value pair from the map
-        std::pair<Key, Value> extract(const Key &key) {
+        ESTL_CONSTEXPR std::pair<Key, Value> extract(const Key &key) {
 #if (ENABLE_THREAD_SAFETY)
-            std::lock_guard<std::mutex> lock(m_mutex);
+            std::lock_guard<ContainerMutex> lock(m_mutex);
 #endif
             std::size_t index = getBucketIndex(key);
             Bucket *bucket = &m_buckets[index];
@@ -254,17 +411,16 @@ namespace ESTL {
 
             while (bucket) {
                 if (bucket->occupied && bucket->key == key) {
-                    std::pair<Key, Value> kvPair = {bucket->key, bucket->value};
+                    std::pair<Key, Value> kvPair = {std::move(bucket->key), std::move(bucket->value)};
                     if (prev) {
                         prev->next = bucket->next;
                         returnBucket(bucket);
                     } else {
                         if (bucket->next) {
-                            Bucket *nextBucket = bucket->next;
-                            *bucket = *nextBucket;
-                            returnBucket(nextBucket);
+                            pullChained(bucket);
                         } else {
-                            bucket->occupied = false;
+                            bucket->destroy();
+                            markFree(index);
                         }
                     }
                     --m_size;
@@ -277,11 +433,11 @@ namespace ESTL {
         }
 
         // Merge another FixedUnorderedMap into this one
-        void merge(FixedUnorderedMap &other) {
+        ESTL_CONSTEXPR void merge(FixedUnorderedMap &other) {
 #if (ENABLE_THREAD_SAFETY)
-            std::lock_guard<std::mutex> otherLock(other.m_mutex);
+            std::lock_guard<ContainerMutex> otherLock(other.m_mutex);
 #endif
-            for (std::size_t i = 0; i < other.m_mapCapacity; ++i) {
+            for (std::size_t i = other.nextOccupied(0); i < other.m_mapCapacity; i = other.nextOccupied(i + 1)) {
                 Bucket *bucket = &other.m_buckets[i];
                 while (bucket && bucket->occupied) {
                     this->insert(bucket->key, bucket->value);
@@ -290,57 +446,149 @@ namespace ESTL {
             }
         }
 
-        std::size_t size() const {
+        ESTL_CONSTEXPR std::size_t size() const {
 #if (ENABLE_THREAD_SAFETY)
-            std::lock_guard<std::mutex> lock(m_mutex);
+            std::lock_guard<ContainerMutex> lock(m_mutex);
 #endif
             return m_size;
         }
 
-        bool empty() const {
+        ESTL_CONSTEXPR bool empty() const {
 #if (ENABLE_THREAD_SAFETY)
-            std::lock_guard<std::mutex> lock(m_mutex);
+            std::lock_guard<ContainerMutex> lock(m_mutex);
 #endif
             return m_size == 0;
         }
 
-        std::size_t capacity() const { return m_mapCapacity; }
+        ESTL_CONSTEXPR std::size_t capacity() const { return m_mapCapacity; }
+
+        // Occupancy snapshot - walks every chain, O(capacity / 64 + size). The pool is the chained bucket pool.
+        ContainerMetrics metrics() const {
+#if (ENABLE_THREAD_SAFETY)
+            std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
+            ContainerMetrics result;
+            result.size = m_size;
+            result.capacity = m_mapCapacity;
+            result.loadFactor = m_mapCapacity ? double(m_size) / m_mapCapacity : 0;
+            result.poolCapacity = m_bucketPoolCapacity;
+            std::size_t chains = 0;
+            std::size_t entries = 0;
+            for (std::size_t i = nextOccupied(0); i < m_mapCapacity; i = nextOccupied(i + 1)) {
+                std::size_t length = 1;
+                for (const Bucket *bucket = m_buckets[i].next; bucket; bucket = bucket->next) {
+                    ++length;
+                }
+                ++chains;
+                entries += length;
+                result.poolInUse += length - 1;
+                result.maxChainLength = length > result.maxChainLength ? length : result.maxChainLength;
+            }
+            result.averageChainLength = chains ? double(entries) / chains : 0;
+#if ESTL_ENABLE_METRICS
+            result.poolHighWater = m_counters.poolHighWater;
+#if (ENABLE_THREAD_SAFETY)
+            result.lockWait = m_mutex.histogram();
+#endif
+#endif
+            return result;
+        }
+
+        /**
+         * @brief Chain length histogram, hash quality and sizing advice - see HashDiagnostics.
+         *
+         * Replaying a production key set into a map sized generously and reading the recommended sizes is the way
+         * to pick N and BucketPoolSize of a CTMap. O(capacity + size).
+         * @param targetLoad Entries per primary bucket the recommended capacity is sized for.
+         */
+        HashDiagnostics diagnostics(double targetLoad = 0.75) const {
+            HashDiagnostics report;
+            {
+#if (ENABLE_THREAD_SAFETY)
+                std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
+                report.size = m_size;
+                report.capacity = m_mapCapacity;
+                report.poolCapacity = m_bucketPoolCapacity;
+                report.chainLengths.assign(1, 0);
+                for (std::size_t i = 0; i < m_mapCapacity; ++i) {
+                    std::size_t length = 0;
+                    if (m_buckets[i].occupied) {
+                        length = 1;
+                        for (const Bucket *bucket = m_buckets[i].next; bucket; bucket = bucket->next) {
+                            ++length;
+                        }
+                        ++report.primaryInUse;
+                        report.poolInUse += length - 1;
+                    }
+                    if (length >= report.chainLengths.size()) {
+                        report.chainLengths.resize(length + 1, 0);
+                    }
+                    ++report.chainLengths[length];
+                }
+            }
+            metrics::analyzeDistribution(report, targetLoad);
+            return report;
+        }
+
+        /**
+         * @brief Visits every entry as visit(const Key &, Value &), under the lock.
+         *
+         * Cheaper than the iterators for whole-map scans: one lock, no iterator state, and the occupancy bitmap
+         * skips empty primary buckets 64 at a time - O(capacity / 64 + size). visit must not modify the map.
+         */
+        template<typename Visitor>
+        ESTL_CONSTEXPR void forEach(Visitor visit) {
+#if (ENABLE_THREAD_SAFETY)
+            std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
+            const std::size_t words = occupancyWords(m_mapCapacity);
+            for (std::size_t word = 0; word < words; ++word) {
+                for (std::uint64_t bits = m_occupancy[word]; bits; bits &= bits - 1) {
+                    Bucket *bucket = &m_buckets[word * 64 + static_cast<std::size_t>(__builtin_ctzll(bits))];
+                    for (; bucket; bucket = bucket->next) {
+                        visit(static_cast<const Key &>(bucket->key), bucket->value);
+                    }
+                }
+            }
+        }
 
+        // Iteration follows the occupancy bitmap, so a sparse map costs O(capacity / 64 + size) to walk
         class Iterator {
         private:
             Bucket *m_current;         // Current primary bucket
             Bucket *m_chainCurrent;    // Current position in chain (could be primary bucket or a chained bucket)
             Bucket *m_buckets;         // Start of buckets array
+            const std::uint64_t *m_occupancy;
             std::size_t m_mapCapacity; // Total number of primary buckets
             std::size_t m_currentIndex;// Current index in primary buckets array
 
+            // Move to the next occupied primary bucket. The neighbour is checked first, it shares the cache line
+            // and keeps dense maps as fast as a plain scan; otherwise the bitmap skips empty buckets 64 at a time.
+            ESTL_CONSTEXPR void nextPrimary(std::size_t index) {
+                if (index >= m_mapCapacity || ! m_buckets[index].occupied) {
+                    index = FixedUnorderedMap::nextOccupied(m_occupancy, m_mapCapacity, index);
+                }
+                m_currentIndex = index;
+                if (index < m_mapCapacity) {
+                    m_current = &m_buckets[index];
+                    m_chainCurrent = m_current;
+                } else {
+                    m_current = nullptr;
+                    m_chainCurrent = nullptr;
+                }
+            }
+
             // Find the next valid bucket (occupied)
-            void findNextValid() {
+            ESTL_CONSTEXPR void findNextValid() {
                 // First check if we're in a chain and can move to next in chain
                 if (m_chainCurrent && m_chainCurrent->next) {
                     m_chainCurrent = m_chainCurrent->next;
                     return;
                 }
 
-                // Otherwise, move to the next primary bucket
-                m_chainCurrent = nullptr;
-                m_currentIndex++;
-
-                // Keep advancing until we find an occupied bucket or reach the end
-                while (m_currentIndex < m_mapCapacity) {
-                    m_current = &m_buckets[m_currentIndex];
-
-                    if (m_current->occupied) {
-                        m_chainCurrent = m_current;
-                        return;
-                    }
-
-                    m_currentIndex++;
-                }
-
-                // If we get here, we've reached the end
-                m_current = nullptr;
-                m_chainCurrent = nullptr;
+                // Otherwise, move to the next occupied primary bucket
+                nextPrimary(m_currentIndex + 1);
             }
 
         public:
@@ -352,33 +600,27 @@ namespace ESTL {
             using iterator_category = std::forward_iterator_tag;
 
             // Constructor
-            Iterator(Bucket *buckets, std::size_t mapCapacity, std::size_t startIndex = 0)
+            ESTL_CONSTEXPR Iterator(Bucket *buckets, const std::uint64_t *occupancy, std::size_t mapCapacity,
+                     std::size_t startIndex = 0)
                 : m_buckets(buckets)
+                , m_occupancy(occupancy)
                 , m_mapCapacity(mapCapacity)
                 , m_currentIndex(startIndex)
                 , m_current(nullptr)
                 , m_chainCurrent(nullptr) {
                 // Handle empty map
-                if (m_mapCapacity == 0 || ! m_buckets) {
+                if (m_mapCapacity == 0 || ! m_buckets || m_currentIndex >= m_mapCapacity) {
                     m_current = nullptr;
                     m_chainCurrent = nullptr;
                     return;
                 }
 
-                // Start at the first bucket
-                m_current = &m_buckets[m_currentIndex];
-
-                // If first bucket is not occupied, find the first valid one
-                if (! m_current->occupied) {
-                    m_currentIndex--;// Decrement so findNextValid will start at index 0
-                    findNextValid();
-                } else {
-                    m_chainCurrent = m_current;
-                }
+                // Start at the first occupied bucket from startIndex
+                nextPrimary(startIndex);
             }
 
             // Pre-increment operator
-            Iterator &operator++() {
+            ESTL_CONSTEXPR Iterator &operator++() {
                 if (m_chainCurrent) {
                     findNextValid();
                 }
@@ -386,14 +628,14 @@ namespace ESTL {
             }
 
             // Post-increment operator
-            Iterator operator++(int) {
+            ESTL_CONSTEXPR Iterator operator++(int) {
                 Iterator temp = *this;
                 ++(*this);
                 return temp;
             }
 
             // Dereference operator
-            std::pair<const Key &, Value &> operator*() const {
+            ESTL_CONSTEXPR std::pair<const Key &, Value &> operator*() const {
                 if (! m_chainCurrent) {
                     throw std::runtime_error("Dereferencing invalid iterator");
                 }
@@ -407,17 +649,19 @@ namespace ESTL {
             }
 
             // Equality operator
-            bool operator==(const Iterator &other) const { return m_chainCurrent == other.m_chainCurrent; }
+            ESTL_CONSTEXPR bool operator==(const Iterator &other) const {
+                return m_chainCurrent == other.m_chainCurrent;
+            }
 
             // Inequality operator
-            bool operator!=(const Iterator &other) const { return ! (*this == other); }
+            ESTL_CONSTEXPR bool operator!=(const Iterator &other) const { return ! (*this == other); }
         };
 
         // Begin iterator
-        Iterator begin() { return Iterator(m_buckets, m_mapCapacity, 0); }
+        ESTL_CONSTEXPR Iterator begin() { return Iterator(m_buckets, m_occupancy, m_mapCapacity, 0); }
 
         // End iterator
-        Iterator end() { return Iterator(m_buckets, m_mapCapacity, m_mapCapacity); }
+        ESTL_CONSTEXPR Iterator end() { return Iterator(m_buckets, m_occupancy, m_mapCapacity, m_mapCapacity); }
     };
 
     // Compile-time fixed unordered map
@@ -429,14 +673,19 @@ namespace ESTL {
 
         std::array<typename FixedUnorderedMap<Key, Value, Hash>::Bucket, N> m_buckets;
         std::array<typename FixedUnorderedMap<Key, Value, Hash>::Bucket, BucketPoolSize> m_bucketPool;
+        std::array<std::uint64_t, (N + 63) / 64> m_occupancy;
 
     public:
-        CTMap()
-            : FixedUnorderedMap<Key, Value, Hash>(m_buckets.data(), m_bucketPool.data(), N, BucketPoolSize) {
+        ESTL_CONSTEXPR CTMap()
+            : FixedUnorderedMap<Key, Value, Hash>(m_buckets.data(), m_bucketPool.data(), m_occupancy.data(), N,
+                                                  BucketPoolSize, InlineStorage{}) {
             this->initFreeBucketPool();
+            this->clearOccupancy();
         }
 
-        CTMap(std::initializer_list<std::pair<const Key, Value>> initList)
+        ESTL_CONSTEXPR ~CTMap() { this->releaseEntries(); }
+
+        ESTL_CONSTEXPR CTMap(std::initializer_list<std::pair<const Key, Value>> initList)
             : CTMap() {
             for (const auto &item: initList) {
                 this->insert(item.first, item.second);
@@ -444,29 +693,72 @@ namespace ESTL {
         }
     };
 
-    // Run-time fixed unordered map
+    // Run-time fixed unordered map - buckets come from a MemoryResource, the heap by default
     template<typename Key, typename Value, typename Hash = std::hash<Key>>
     class RTMap : public FixedUnorderedMap<Key, Value, Hash> {
+        using Base = FixedUnorderedMap<Key, Value, Hash>;
+        using Bucket = typename Base::Bucket;
+
+        MemoryResource *m_resource;
+
     public:
-        explicit RTMap(std::size_t capacity, std::size_t poolSize = 0)
-            : FixedUnorderedMap<Key, Value, Hash>(
-                      new typename FixedUnorderedMap<Key, Value, Hash>::Bucket[capacity],
-                      new typename FixedUnorderedMap<Key, Value, Hash>::Bucket[poolSize != 0 ? poolSize : capacity / 2],
-                      capacity, poolSize != 0 ? poolSize : capacity / 2) {
+        explicit RTMap(std::size_t capacity, std::size_t poolSize = 0, MemoryResource *resource = defaultResource())
+            : Base(memory::createArray<Bucket>(resource, capacity),
+                   memory::createArray<Bucket>(resource, poolSize != 0 ? poolSize : capacity / 2),
+                   memory::createArray<std::uint64_t>(resource, Base::occupancyWords(capacity)), capacity,
+                   poolSize != 0 ? poolSize : capacity / 2)
+            , m_resource(resource) {
             this->initFreeBucketPool();
         }
 
         RTMap(std::initializer_list<std::pair<const Key, Value>> initList, std::size_t capacity = 0,
-              std::size_t poolSize = 0)
-            : RTMap(capacity ? capacity : initList.size(), poolSize) {
+              std::size_t poolSize = 0, MemoryResource *resource = defaultResource())
+            : RTMap(capacity ? capacity : initList.size(), poolSize, resource) {
             for (const auto &item: initList) {
                 this->insert(item.first, item.second);
             }
         }
 
         ~RTMap() {
-            delete[] this->m_buckets;
-            delete[] this->m_bucketPool;
+            this->releaseEntries();
+            releaseStorage();
+        }
+
+        RTMap(const RTMap &) = delete;
+        RTMap &operator=(const RTMap &) = delete;
+
+        // The bucket arrays change hands, nothing is rehashed
+        RTMap(RTMap &&other) noexcept
+            : Base(std::move(other))
+            , m_resource(other.m_resource) {}
+
+        RTMap &operator=(RTMap &&other) noexcept {
+            if (this != &other) {
+                this->releaseEntries();
+                releaseStorage();
+                this->m_buckets = other.m_buckets;
+                this->m_bucketPool = other.m_bucketPool;
+                this->m_occupancy = other.m_occupancy;
+                this->m_freeBuckets = other.m_freeBuckets;
+                this->m_hasher = std::move(other.m_hasher);
+                this->m_size = other.m_size;
+                this->m_mapCapacity = other.m_mapCapacity;
+                this->m_bucketPoolCapacity = other.m_bucketPoolCapacity;
+                this->m_probingStrategy = other.m_probingStrategy;
+                ESTL_METRIC(this->m_counters = other.m_counters);
+                m_resource = other.m_resource;
+                other.forgetStorage();
+            }
+            return *this;
+        }
+
+        MemoryResource *resource() const { return m_resource; }
+
+    private:
+        void releaseStorage() {
+            memory::destroyArray(m_resource, this->m_buckets, this->m_mapCapacity);
+            memory::destroyArray(m_resource, this->m_bucketPool, this->m_bucketPoolCapacity);
+            memory::destroyArray(m_resource, this->m_occupancy, this->occupancyWords(this->m_mapCapacity));
         }
     };
 }// namespace ESTL
@@ -0,0 +1,247 @@
+//
+// Memory-mapped images of FixedUnorderedMap - write once, map read-only at startup.
+//
+#pragma once
+
+#include "ESTLImage.hpp"
+#include "FixedUnorderedMap.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace ESTL {
+    /**
+     * @brief Image layout of a FixedUnorderedMap.
+     *
+     * The primary buckets are written in place, so a key hashes to the same slot as in the live map, followed by the
+     * chained buckets renumbered in chain order. A chain link is the 1-based index of the next chained slot, 0 ends
+     * the chain.
+     */
+    template<typename Key, typename Value, typename Hash = std::hash<Key>>
+    class UnorderedMapImage {
+        static_assert(std::is_trivially_copyable<Key>::value && std::is_trivially_copyable<Value>::value,
+                      "Images need trivially copyable keys and values");
+
+    public:
+        struct Slot {
+            Key key;
+            Value value;
+            std::uint32_t next;
+            std::uint8_t occupied;
+        };
+
+        static std::uint64_t layoutHash() {
+            std::uint64_t hash = image::hashValue(image::fnv1a("unordered", 9), sizeof(Slot));
+            hash = image::hashValue(hash, offsetof(Slot, value));
+            hash = image::hashValue(hash, offsetof(Slot, next));
+            hash = image::hashType(hash, typeid(Key));
+            hash = image::hashType(hash, typeid(Value));
+            return image::hashType(hash, typeid(Hash));
+        }
+
+        /**
+         * @brief Writes the map's storage to an image file or shared memory writer.
+         *
+         * @throws std::runtime_error on I/O errors - an existing image is left untouched.
+         */
+        template<typename Writer>
+        static void write(const FixedUnorderedMap<Key, Value, Hash> &map, Writer &writer) {
+            using Bucket = typename FixedUnorderedMap<Key, Value, Hash>::Bucket;
+#if (ENABLE_THREAD_SAFETY)
+            std::lock_guard<ContainerMutex> lock(map.m_mutex);
+#endif
+            std::uint64_t chained = 0;
+            for (std::size_t i = 0; i < map.m_mapCapacity; ++i) {
+                for (const Bucket *bucket = map.m_buckets[i].next; bucket; bucket = bucket->next) {
+                    ++chained;
+                }
+            }
+            if (chained >= UINT32_MAX) {
+                throw std::out_of_range("Too many chained buckets for an image");
+            }
+
+            const std::size_t primaryBytes = map.m_mapCapacity * sizeof(Slot);
+            const std::size_t chainedBytes = chained * sizeof(Slot);
+            ImageHeader header{};
+            std::memcpy(header.magic, image::Magic, sizeof(header.magic));
+            header.version = ImageHeader::CurrentVersion;
+            header.kind = ImageKind::UnorderedMap;
+            header.layoutHash = layoutHash();
+            header.size = map.m_size;
+            header.capacity = map.m_mapCapacity;
+            header.overflowCount = chained;
+            header.payloadBytes = image::alignSection(primaryBytes) + image::alignSection(chainedBytes);
+
+            writer.write(&header, sizeof(header));
+
+            std::uint32_t nextIndex = 1;
+            for (std::size_t i = 0; i < map.m_mapCapacity; ++i) {
+                const Bucket &bucket = map.m_buckets[i];
+                writeSlot(writer, bucket, bucket.next ? nextIndex : 0);
+                for (const Bucket *link = bucket.next; link; link = link->next) {
+                    ++nextIndex;
+                }
+            }
+            writer.pad(primaryBytes);
+
+            nextIndex = 1;
+            for (std::size_t i = 0; i < map.m_mapCapacity; ++i) {
+                for (const Bucket *link = map.m_buckets[i].next; link; link = link->next) {
+                    ++nextIndex;
+                    writeSlot(writer, *link, link->next ? nextIndex : 0);
+                }
+            }
+            writer.pad(chainedBytes);
+            writer.commit();
+        }
+
+    private:
+        template<typename Writer, typename Bucket>
+        static void writeSlot(Writer &writer, const Bucket &bucket, std::uint32_t next) {
+            Slot slot;
+            std::memset(&slot, 0, sizeof(slot));// padding and empty slots are written as zeros
+            if (bucket.occupied) {
+                std::memcpy(&slot.key, &bucket.key, sizeof(Key));
+                std::memcpy(&slot.value, &bucket.value, sizeof(Value));
+                slot.occupied = 1;
+            }
+            slot.next = next;
+            writer.write(&slot, sizeof(slot));
+        }
+    };
+
+    /**
+     * @brief Read-only FixedUnorderedMap backed by a memory-mapped image.
+     *
+     * Opening costs one mmap and a header check, independent of the number of elements. Lookups use the same hash
+     * and bucket chains as the map the image was written from.
+     */
+    template<typename Key, typename Value, typename Hash = std::hash<Key>>
+    class MappedUnorderedMap {
+        using Image = UnorderedMapImage<Key, Value, Hash>;
+        using Slot = typename Image::Slot;
+
+        MappedImage m_image;
+        const Slot *m_primary;
+        const Slot *m_chained;
+        std::size_t m_capacity;
+        std::size_t m_chainedCount;
+        std::size_t m_size;
+        Hash m_hasher;
+
+    public:
+        explicit MappedUnorderedMap(const std::string &path, bool populate = false)
+            : m_image(path, ImageKind::UnorderedMap, Image::layoutHash(), populate) {
+            attach(path);
+        }
+
+        // Attaches to an image published with saveImage(map, SharedMemoryName{...})
+        explicit MappedUnorderedMap(const SharedMemoryName &segment, bool populate = false)
+            : m_image(segment, ImageKind::UnorderedMap, Image::layoutHash(), populate) {
+            attach(segment.name);
+        }
+
+    private:
+        void attach(const std::string &source) {
+            const ImageHeader &header = m_image.header();
+            m_capacity = header.capacity;
+            m_chainedCount = header.overflowCount;
+            m_size = header.size;
+            const std::size_t primaryBytes = image::alignSection(m_capacity * sizeof(Slot));
+            if (m_capacity == 0 ||
+                header.payloadBytes != primaryBytes + image::alignSection(m_chainedCount * sizeof(Slot))) {
+                throw std::runtime_error("Image '" + source + "' has inconsistent section sizes");
+            }
+            m_primary = m_image.section<Slot>(0);
+            m_chained = m_image.section<Slot>(primaryBytes);
+        }
+
+    public:
+
+        const Value *find(const Key &key) const {
+            const Slot *slot = &m_primary[m_hasher(key) % m_capacity];
+            while (true) {
+                if (slot->occupied && slot->key == key) {
+                    return &slot->value;
+                }
+                if (slot->next == 0 || slot->next > m_chainedCount) {
+                    return nullptr;
+                }
+                slot = &m_chained[slot->next - 1];
+            }
+        }
+
+        bool contains(const Key &key) const { return find(key) != nullptr; }
+
+        std::size_t size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+        std::size_t capacity() const { return m_capacity; }
+
+        // Visits primary slots, then chained slots - skipping empty ones
+        class Iterator {
+            const MappedUnorderedMap *m_map;
+            std::size_t m_index;// Primary slots first, then chained slots
+
+            const Slot *slot() const {
+                return m_index < m_map->m_capacity ? &m_map->m_primary[m_index]
+                                                   : &m_map->m_chained[m_index - m_map->m_capacity];
+            }
+
+            void skipEmpty() {
+                const std::size_t end = m_map->m_capacity + m_map->m_chainedCount;
+                while (m_index < end && ! slot()->occupied) {
+                    ++m_index;
+                }
+            }
+
+        public:
+            using value_type = std::pair<const Key &, const Value &>;
+            using difference_type = std::ptrdiff_t;
+            using iterator_category = std::forward_iterator_tag;
+
+            Iterator(const MappedUnorderedMap *map, std::size_t index)
+                : m_map(map)
+                , m_index(index) {
+                skipEmpty();
+            }
+
+            Iterator &operator++() {
+                ++m_index;
+                skipEmpty();
+                return *this;
+            }
+
+            Iterator operator++(int) {
+                Iterator temp = *this;
+                ++(*this);
+                return temp;
+            }
+
+            std::pair<const Key &, const Value &> operator*() const { return {slot()->key, slot()->value}; }
+
+            bool operator==(const Iterator &other) const { return m_index == other.m_index; }
+            bool operator!=(const Iterator &other) const { return ! (*this == other); }
+        };
+
+        Iterator begin() const { return Iterator(this, 0); }
+        Iterator end() const { return Iterator(this, m_capacity + m_chainedCount); }
+    };
+
+    // Writes map to path - see UnorderedMapImage
+    template<typename Key, typename Value, typename Hash>
+    void saveImage(const FixedUnorderedMap<Key, Value, Hash> &map, const std::string &path) {
+        image::ImageWriter writer(path);
+        UnorderedMapImage<Key, Value, Hash>::write(map, writer);
+    }
+
+    // Publishes map in shared memory for other processes to attach with MappedUnorderedMap
+    template<typename Key, typename Value, typename Hash>
+    void saveImage(const FixedUnorderedMap<Key, Value, Hash> &map, const SharedMemoryName &segment) {
+        image::SharedMemoryWriter writer(segment);
+        UnorderedMapImage<Key, Value, Hash>::write(map, writer);
+    }
+}// namespace ESTL
@@ -10,6 +10,8 @@
 namespace ESTL {
     template<typename Key, typename Hash = std::hash<Key>>
     class FixedUnorderedSet {
+        friend class Serialization;
+
         FixedUnorderedMap<Key, bool, Hash> *m_map;
 
     public:
@@ -79,17 +81,28 @@ namespace ESTL {
         RTMap<Key, bool, Hash> m_map;
 
     public:
-        explicit RTUnorderedSet(std::size_t capacity, std::size_t poolSize = 0)
-            : m_map(capacity, poolSize), FixedUnorderedSet<Key, Hash>(&m_map) {}
+        explicit RTUnorderedSet(std::size_t capacity, std::size_t poolSize = 0,
+                                MemoryResource *resource = defaultResource())
+            : m_map(capacity, poolSize, resource), FixedUnorderedSet<Key, Hash>(&m_map) {}
 
-        RTUnorderedSet(std::initializer_list<const Key> initList, std::size_t capacity = 0, std::size_t poolSize = 0)
-            : RTUnorderedSet(capacity ? capacity : initList.size(), poolSize) {
+        RTUnorderedSet(std::initializer_list<const Key> initList, std::size_t capacity = 0, std::size_t poolSize = 0,
+                       MemoryResource *resource = defaultResource())
+            : RTUnorderedSet(capacity ? capacity : initList.size(), poolSize, resource) {
             for (const auto &key: initList) {
                 this->insert(key);
             }
         }
 
         ~RTUnorderedSet() = default;
+
+        // The map's buckets change hands; the base keeps pointing at this set's own map
+        RTUnorderedSet(RTUnorderedSet &&other) noexcept
+            : FixedUnorderedSet<Key, Hash>(&m_map), m_map(std::move(other.m_map)) {}
+
+        RTUnorderedSet &operator=(RTUnorderedSet &&other) noexcept {
+            m_map = std::move(other.m_map);
+            return *this;
+        }
     };
 }// namespace ESTL
 
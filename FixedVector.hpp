@@ -3,12 +3,16 @@
 //
 #pragma once
 
+#include "ESTLMemory.hpp"
+#include "ESTLMetrics.hpp"
+#include "ESTLTrace.hpp"
 #include "ESTLUtils.hpp"
 #include <algorithm>
 #include <array>
 #include <initializer_list>
 #include <mutex>
 #include <stdexcept>
+#include <type_traits>
 #include <utility>
 
 #ifndef ENABLE_THREAD_SAFETY
@@ -16,98 +20,118 @@
 #endif
 
 namespace ESTL {
+template <typename U> class VectorImage;
+class Serialization;
+namespace parallel {
+struct VectorAccess;
+}
+
 // Base class for FixedVector
 template <typename T> class FixedVector {
+  template <typename U> friend class VectorImage;
+  friend class Serialization;
+  friend struct parallel::VectorAccess;
+
 protected:
   T *m_data;
   std::size_t m_capacity;
   std::size_t m_size;
 #if (ENABLE_THREAD_SAFETY)
-  mutable std::mutex m_mutex;
+  mutable ContainerMutex m_mutex;
+#endif
+#if ESTL_ENABLE_METRICS
+  metrics::Counters m_counters;
 #endif
 
 public:
   using iterator = T *;
   using const_iterator = const T *;
 
-  FixedVector(T *data, std::size_t capacity)
+  ESTL_CONSTEXPR FixedVector(T *data, std::size_t capacity)
       : m_data(data), m_capacity(capacity), m_size(0) {}
 
-  bool operator==(const FixedVector &other) const {
+  ESTL_CONSTEXPR bool operator==(const FixedVector &other) const {
     return m_data == other.m_data && m_capacity == other.m_capacity &&
            m_size == other.m_size;
     ;
   }
 
   // Push element to back - O(1)
-  void push_back(const T &value) {
+  ESTL_CONSTEXPR void push_back(const T &value) {
+#if (ENABLE_THREAD_SAFETY)
+    std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
     if (m_size >= m_capacity) {
       throw std::out_of_range("FixedVector overflow");
     }
-#if (ENABLE_THREAD_SAFETY)
-    std::lock_guard<std::mutex> lock(m_mutex);
-#endif
+    ESTL_TRACE(trace::Span span(TraceKind::Vector, TraceOp::PushBack, this, m_size));
     m_data[m_size++] = value;
+    ESTL_METRIC(m_counters.level(m_size));
   }
 
   // Emplace element at position - O(1)
-  template <typename... Args> iterator emplace(iterator pos, Args &&...args) {
+  template <typename... Args> ESTL_CONSTEXPR iterator emplace(iterator pos, Args &&...args) {
+#if (ENABLE_THREAD_SAFETY)
+    std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
     if (m_size >= m_capacity) {
       throw std::out_of_range("FixedVector overflow");
     }
-#if (ENABLE_THREAD_SAFETY)
-    std::lock_guard<std::mutex> lock(m_mutex);
-#endif
     std::move_backward(pos, end(), end() + 1);
     *pos = T(std::forward<Args>(args)...);
     ++m_size;
+    ESTL_METRIC(m_counters.level(m_size));
     return pos;
   }
 
   // Emplace element to back - O(1)
-  template <typename... Args> void emplace_back(Args &&...args) {
+  template <typename... Args> ESTL_CONSTEXPR void emplace_back(Args &&...args) {
+#if (ENABLE_THREAD_SAFETY)
+    std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
     if (m_size >= m_capacity) {
       throw std::out_of_range("FixedVector overflow");
     }
-#if (ENABLE_THREAD_SAFETY)
-    std::lock_guard<std::mutex> lock(m_mutex);
-#endif
+    ESTL_TRACE(trace::Span span(TraceKind::Vector, TraceOp::PushBack, this, m_size));
     m_data[m_size++] = T(std::forward<Args>(args)...);
+    ESTL_METRIC(m_counters.level(m_size));
   }
 
   // Append range of elements - O(N)
-  template <typename InputIt> void append_range(InputIt first, InputIt last) {
+  template <typename InputIt> ESTL_CONSTEXPR void append_range(InputIt first, InputIt last) {
     while (first != last) {
+#if (ENABLE_THREAD_SAFETY)
+      std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
       if (m_size >= m_capacity) {
         throw std::out_of_range("FixedVector overflow");
       }
-#if (ENABLE_THREAD_SAFETY)
-      std::lock_guard<std::mutex> lock(m_mutex);
-#endif
       m_data[m_size++] = *first++;
+      ESTL_METRIC(m_counters.level(m_size));
     }
   }
 
   // Remove last element - O(1)
-  void pop_back() {
+  ESTL_CONSTEXPR void pop_back() {
+#if (ENABLE_THREAD_SAFETY)
+    std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
     if (m_size == 0) {
       throw std::out_of_range("FixedVector underflow");
     }
-#if (ENABLE_THREAD_SAFETY)
-    std::lock_guard<std::mutex> lock(m_mutex);
-#endif
+    ESTL_TRACE(trace::Span span(TraceKind::Vector, TraceOp::PopBack, this, m_size));
     --m_size;
   }
 
   // Element access - O(1)
-  T &operator[](std::size_t index) {
+  ESTL_CONSTEXPR T &operator[](std::size_t index) {
     if (index >= m_size) {
       throw std::out_of_range("Index out of bounds");
     }
     return m_data[index];
   }
 
-  const T &operator[](std::size_t index) const {
+  ESTL_CONSTEXPR const T &operator[](std::size_t index) const {
     if (index >= m_size) {
       throw std::out_of_range("Index out of bounds");
     }
@@ -115,14 +139,14 @@ public:
   }
 
   // Bounds-checked access - O(1)
-  T &at(std::size_t index) {
+  ESTL_CONSTEXPR T &at(std::size_t index) {
     if (index >= m_size) {
       throw std::out_of_range("Index out of bounds");
     }
     return m_data[index];
   }
 
-  const T &at(std::size_t index) const {
+  ESTL_CONSTEXPR const T &at(std::size_t index) const {
     if (index >= m_size) {
       throw std::out_of_range("Index out of bounds");
     }
@@ -130,115 +154,150 @@ public:
   }
 
   // Access first and last element - O(1)
-  T &front() { return m_data[0]; }
-  T &back() { return m_data[m_size - 1]; }
+  ESTL_CONSTEXPR T &front() { return m_data[0]; }
+  ESTL_CONSTEXPR T &back() { return m_data[m_size - 1]; }
 
   // Capacity methods - O(1)
-  std::size_t size() const { return m_size; }
-  std::size_t capacity() const { return m_capacity; }
-  bool empty() const { return m_size == 0; }
-  void clear() { m_size = 0; }
-
-  // Swap two vectors - O(N)
-  void swap(FixedVector &other) noexcept {
-    std::swap(m_data, other.m_data);
+  ESTL_CONSTEXPR std::size_t size() const { return m_size; }
+  ESTL_CONSTEXPR std::size_t capacity() const { return m_capacity; }
+  ESTL_CONSTEXPR bool empty() const { return m_size == 0; }
+  ESTL_CONSTEXPR void clear() { m_size = 0; }
+
+  // Occupancy snapshot - the pool is the element array, see ContainerMetrics
+  ContainerMetrics metrics() const {
+#if (ENABLE_THREAD_SAFETY)
+    std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
+    ContainerMetrics result;
+    result.size = result.poolInUse = m_size;
+    result.capacity = result.poolCapacity = m_capacity;
+    result.loadFactor = m_capacity ? double(m_size) / m_capacity : 0;
+#if ESTL_ENABLE_METRICS
+    result.poolHighWater = m_counters.poolHighWater;
+#if (ENABLE_THREAD_SAFETY)
+    result.lockWait = m_mutex.histogram();
+#endif
+#endif
+    return result;
+  }
+
+  // Swap contents element-wise - O(size), each side must fit in the other's capacity. Storage stays where it is,
+  // so this works for CTVector's inline array; RTVector::swap exchanges buffers instead.
+  ESTL_CONSTEXPR void swap(FixedVector &other) {
+    if (this == &other) {
+      return;
+    }
+#if (ENABLE_THREAD_SAFETY)
+    std::lock(m_mutex, other.m_mutex);
+    std::lock_guard<ContainerMutex> lock(m_mutex, std::adopt_lock);
+    std::lock_guard<ContainerMutex> otherLock(other.m_mutex, std::adopt_lock);
+#endif
+    if (m_size > other.m_capacity || other.m_size > m_capacity) {
+      throw std::out_of_range("FixedVector swap exceeds capacity");
+    }
+    const std::size_t common = std::min(m_size, other.m_size);
+    std::swap_ranges(m_data, m_data + common, other.m_data);
+    if (m_size > common) {
+      std::move(m_data + common, m_data + m_size, other.m_data + common);
+    } else {
+      std::move(other.m_data + common, other.m_data + other.m_size, m_data + common);
+    }
     std::swap(m_size, other.m_size);
   }
 
   // Insert element at position - O(N)
-  iterator insert(iterator pos, const T &value) {
+  ESTL_CONSTEXPR iterator insert(iterator pos, const T &value) {
+#if (ENABLE_THREAD_SAFETY)
+    std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
     if (m_size >= m_capacity) {
       throw std::out_of_range("FixedVector overflow");
     }
-#if (ENABLE_THREAD_SAFETY)
-    std::lock_guard<std::mutex> lock(m_mutex);
-#endif
+    ESTL_TRACE(trace::Span span(TraceKind::Vector, TraceOp::Insert, this, m_size));
     std::move_backward(pos, end(), end() + 1);
     *pos = value;
     ++m_size;
+    ESTL_METRIC(m_counters.level(m_size));
     return pos;
   }
 
   // Erase element at position - O(N)
-  iterator erase(iterator pos) {
+  ESTL_CONSTEXPR iterator erase(iterator pos) {
+#if (ENABLE_THREAD_SAFETY)
+    std::lock_guard<ContainerMutex> lock(m_mutex);
+#endif
     if (pos >= end()) {
       throw std::out_of_range("Invalid erase position");
     }
-#if (ENABLE_THREAD_SAFETY)
-    std::lock_guard<std::mutex> lock(m_mutex);
-#endif
+    ESTL_TRACE(trace::Span span(TraceKind::Vector, TraceOp::Erase, this, m_size));
     std::move(pos + 1, end(), pos);
     --m_size;
     return pos;
   }
 
   // Iterators - O(1)
-  iterator begin() {
+  ESTL_CONSTEXPR iterator begin() {
     WARN_IF(m_size == 0,
             "Calling front on an empty container causes undefined behavior.");
     return m_data;
   }
 
-  const_iterator begin() const {
+  ESTL_CONSTEXPR const_iterator begin() const {
     WARN_IF(m_size == 0,
             "Calling front on an empty container causes undefined behavior.");
     return m_data;
   }
 
-  iterator end() { return m_data + m_size; }
-  const_iterator end() const { return m_data + m_size; }
+  ESTL_CONSTEXPR iterator end() { return m_data + m_size; }
+  ESTL_CONSTEXPR const_iterator end() const { return m_data + m_size; }
 };
 
 // Compile-time fixed vector
 template <typename T, std::size_t N> class CTVector : public FixedVector<T> {
 private:
+#if ESTL_CONSTEXPR_CONTAINERS
+  std::array<T, N> m_storage{}; // a constant may not hold indeterminate slots past size()
+#else
   std::array<T, N> m_storage;
+#endif
 
 public:
-  CTVector() : FixedVector<T>(m_storage.data(), N) {}
+  ESTL_CONSTEXPR CTVector() : FixedVector<T>(m_storage.data(), N) {}
 
   ~CTVector() = default;
 
-  CTVector(const CTVector &other) : FixedVector<T>(m_storage.data(), N) {
-    if (this != &other) {
-      std::copy(other.m_storage.begin(), other.m_storage.end(), m_storage);
-      this->m_capacity = other.m_capacity;
-      this->m_size = other.m_size;
-    }
+  // Copies and moves touch the first size() elements only - the inline array cannot change hands
+  ESTL_CONSTEXPR CTVector(const CTVector &other) : FixedVector<T>(m_storage.data(), N) {
+    std::copy(other.m_data, other.m_data + other.m_size, this->m_data);
+    this->m_size = other.m_size;
   }
 
-  CTVector &operator=(const CTVector &other) {
+  ESTL_CONSTEXPR CTVector &operator=(const CTVector &other) {
     if (this != &other) {
-      m_storage.swap(const_cast<std::array<T, N> &>(other.m_storage));
-      this->m_capacity = other.m_capacity;
+      std::copy(other.m_data, other.m_data + other.m_size, this->m_data);
       this->m_size = other.m_size;
     }
     return *this;
   }
 
-  CTVector(CTVector &&other) noexcept
-      : m_storage(std::move(other.m_storage)),
-        FixedVector<T>(m_storage.data(), N) {
-    this->m_capacity = other.m_capacity;
+  // other is left empty and usable
+  ESTL_CONSTEXPR CTVector(CTVector &&other) noexcept(std::is_nothrow_move_assignable<T>::value)
+      : FixedVector<T>(m_storage.data(), N) {
+    std::move(other.m_data, other.m_data + other.m_size, this->m_data);
     this->m_size = other.m_size;
-
-    other.m_data = nullptr;
-    other.m_size = other.m_capacity = 0;
+    other.m_size = 0;
   }
 
-  CTVector &operator=(CTVector &&other) noexcept {
+  ESTL_CONSTEXPR CTVector &operator=(CTVector &&other) noexcept(std::is_nothrow_move_assignable<T>::value) {
     if (this != &other) {
-      m_storage = std::move(other.m_storage);
-      this->m_capacity = other.m_capacity;
+      std::move(other.m_data, other.m_data + other.m_size, this->m_data);
       this->m_size = other.m_size;
-
-      other.m_data = nullptr;
-      other.m_size = other.m_capacity = 0;
+      other.m_size = 0;
     }
     return *this;
   }
 
-  CTVector(std::initializer_list<T> init)
+  ESTL_CONSTEXPR CTVector(std::initializer_list<T> init)
       : FixedVector<T>(m_storage.data(), N) {
     if (init.size() > N) {
       throw std::out_of_range("Initializer list too large");
@@ -248,26 +307,41 @@ public:
   }
 };
 
-// Run-time fixed vector
+// Run-time fixed vector - storage comes from a MemoryResource, the heap by
+// default
 template <typename T> class RTVector : public FixedVector<T> {
+  MemoryResource *m_resource;
+
 public:
-  explicit RTVector(std::size_t capacity)
-      : FixedVector<T>(new T[capacity], capacity) {}
+  explicit RTVector(std::size_t capacity,
+                    MemoryResource *resource = defaultResource())
+      : FixedVector<T>(memory::createArray<T>(resource, capacity), capacity),
+        m_resource(resource) {}
 
-  ~RTVector() { delete[] this->m_data; }
+  ~RTVector() {
+    memory::destroyArray(m_resource, this->m_data, this->m_capacity);
+  }
 
   RTVector(const RTVector &other)
-      : FixedVector<T>(new T[other.m_capacity], other.m_capacity) {
+      : FixedVector<T>(memory::createArray<T>(other.m_resource,
+                                              other.m_capacity),
+                       other.m_capacity),
+        m_resource(other.m_resource) {
     if (this != &other) {
       std::copy(other.m_data, other.m_data + other.m_size, this->m_data);
       this->m_size = other.m_size;
     }
   }
 
+  // Reuses the buffer when the capacities match
   RTVector &operator=(const RTVector &other) {
-    if (this != &other) {
-      delete[] this->m_data;
-      this->m_data = new T[other.m_capacity];
+    if (this != &other && this->m_capacity == other.m_capacity) {
+      std::copy(other.m_data, other.m_data + other.m_size, this->m_data);
+      this->m_size = other.m_size;
+    } else if (this != &other) {
+      T *data = memory::createArray<T>(m_resource, other.m_capacity);
+      memory::destroyArray(m_resource, this->m_data, this->m_capacity);
+      this->m_data = data;
       std::copy(other.m_data, other.m_data + other.m_size, this->m_data);
       this->m_capacity = other.m_capacity;
       this->m_size = other.m_size;
@@ -276,17 +350,20 @@ public:
   }
 
   RTVector(RTVector &&other) noexcept
-      : FixedVector<T>(other.m_data, other.m_capacity) {
+      : FixedVector<T>(other.m_data, other.m_capacity),
+        m_resource(other.m_resource) {
+    this->m_size = other.m_size;
     other.m_data = nullptr;
     other.m_capacity = other.m_size = 0;
   }
 
   RTVector &operator=(RTVector &&other) noexcept {
     if (this != &other) {
-      delete this->m_data;
+      memory::destroyArray(m_resource, this->m_data, this->m_capacity);
       this->m_data = other.m_data;
       this->m_capacity = other.m_capacity;
       this->m_size = other.m_size;
+      m_resource = other.m_resource;
 
       other.m_data = nullptr;
       other.m_capacity = other.m_size = 0;
@@ -294,12 +371,37 @@ public:
     return *this;
   }
 
-  RTVector(std::initializer_list<T> init, std::size_t capacity = 0) : RTVector(capacity ? capacity : init.size()) {
-    if (init.size() > capacity) {
+  // Exchanges buffers - O(1). Swapping with any other FixedVector goes element-wise.
+  using FixedVector<T>::swap;
+  void swap(RTVector &other) {
+    if (this == &other) {
+      return;
+    }
+#if (ENABLE_THREAD_SAFETY)
+    std::lock(this->m_mutex, other.m_mutex);
+    std::lock_guard<ContainerMutex> lock(this->m_mutex, std::adopt_lock);
+    std::lock_guard<ContainerMutex> otherLock(other.m_mutex, std::adopt_lock);
+#endif
+    std::swap(this->m_data, other.m_data);
+    std::swap(this->m_capacity, other.m_capacity);
+    std::swap(this->m_size, other.m_size);
+    std::swap(m_resource, other.m_resource);
+  }
+
+  MemoryResource *resource() const { return m_resource; }
+
+  RTVector(std::initializer_list<T> init, std::size_t capacity = 0,
+           MemoryResource *resource = defaultResource())
+      : RTVector(capacity ? capacity : init.size(), resource) {
+    if (init.size() > this->m_capacity) {
       throw std::out_of_range("Initializer list too large");
     }
     std::copy(init.begin(), init.end(), this->m_data);
     this->m_size = init.size();
   }
+
+  RTVector(std::size_t capacity, std::initializer_list<T> init,
+           MemoryResource *resource = defaultResource())
+      : RTVector(init, capacity, resource) {}
 };
 } // namespace ESTL
@@ -0,0 +1,126 @@
+//
+// Memory-mapped images of FixedVector - write once, map read-only in place.
+//
+#pragma once
+
+#include "ESTLImage.hpp"
+#include "FixedVector.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace ESTL {
+    /**
+     * @brief Image layout of a FixedVector.
+     *
+     * The elements are written as one contiguous array - the image is the vector's storage.
+     */
+    template<typename T>
+    class VectorImage {
+        static_assert(std::is_trivially_copyable<T>::value, "Images need trivially copyable elements");
+
+    public:
+        static std::uint64_t layoutHash() {
+            std::uint64_t hash = image::hashValue(image::fnv1a("vector", 6), sizeof(T));
+            hash = image::hashValue(hash, alignof(T));
+            return image::hashType(hash, typeid(T));
+        }
+
+        /**
+         * @brief Writes the vector's elements to an image file or shared memory writer.
+         *
+         * @throws std::runtime_error on I/O errors - an existing image is left untouched.
+         */
+        template<typename Writer>
+        static void write(const FixedVector<T> &vector, Writer &writer) {
+#if (ENABLE_THREAD_SAFETY)
+            std::lock_guard<ContainerMutex> lock(vector.m_mutex);
+#endif
+            const std::size_t bytes = vector.m_size * sizeof(T);
+            ImageHeader header{};
+            std::memcpy(header.magic, image::Magic, sizeof(header.magic));
+            header.version = ImageHeader::CurrentVersion;
+            header.kind = ImageKind::Vector;
+            header.layoutHash = layoutHash();
+            header.size = vector.m_size;
+            header.capacity = vector.m_size;
+            header.payloadBytes = image::alignSection(bytes);
+
+            writer.write(&header, sizeof(header));
+            writer.write(vector.m_data, bytes);
+            writer.pad(bytes);
+            writer.commit();
+        }
+    };
+
+    /**
+     * @brief Read-only FixedVector backed by a memory-mapped image.
+     *
+     * Attaching costs one mmap and a header check; the elements are used in place.
+     */
+    template<typename T>
+    class MappedVector {
+        using Image = VectorImage<T>;
+
+        MappedImage m_image;
+        const T *m_data;
+        std::size_t m_size;
+
+    public:
+        using const_iterator = const T *;
+
+        explicit MappedVector(const std::string &path, bool populate = false)
+            : m_image(path, ImageKind::Vector, Image::layoutHash(), populate) {
+            attach(path);
+        }
+
+        // Attaches to an image published with saveImage(vector, SharedMemoryName{...})
+        explicit MappedVector(const SharedMemoryName &segment, bool populate = false)
+            : m_image(segment, ImageKind::Vector, Image::layoutHash(), populate) {
+            attach(segment.name);
+        }
+
+        const T &operator[](std::size_t index) const {
+            if (index >= m_size) {
+                throw std::out_of_range("Index out of bounds");
+            }
+            return m_data[index];
+        }
+
+        const T &front() const { return (*this)[0]; }
+        const T &back() const { return (*this)[m_size - 1]; }
+
+        const T *data() const { return m_data; }
+        std::size_t size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+
+        const_iterator begin() const { return m_data; }
+        const_iterator end() const { return m_data + m_size; }
+
+    private:
+        void attach(const std::string &source) {
+            const ImageHeader &header = m_image.header();
+            m_size = header.size;
+            if (header.capacity != m_size || header.payloadBytes != image::alignSection(m_size * sizeof(T))) {
+                throw std::runtime_error("Image '" + source + "' has inconsistent section sizes");
+            }
+            m_data = m_image.section<T>(0);
+        }
+    };
+
+    // Writes vector to path - see VectorImage
+    template<typename T>
+    void saveImage(const FixedVector<T> &vector, const std::string &path) {
+        image::ImageWriter writer(path);
+        VectorImage<T>::write(vector, writer);
+    }
+
+    // Publishes vector in shared memory for other processes to attach with MappedVector
+    template<typename T>
+    void saveImage(const FixedVector<T> &vector, const SharedMemoryName &segment) {
+        image::SharedMemoryWriter writer(segment);
+        VectorImage<T>::write(vector, writer);
+    }
+}// namespace ESTL
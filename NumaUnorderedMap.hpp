@@ -0,0 +1,247 @@
+//
+// FixedUnorderedMap split into per-NUMA-node shards, or replicated on every node.
+//
+#pragma once
+
+#include "ESTLMemory.hpp"
+#include "ESTLThreadPool.hpp"
+#include "FixedUnorderedMap.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace ESTL {
+    /** NUMA placement
+    Partitioned: each node holds one shard in node-local memory and a key lives in exactly one shard, chosen by its
+        hash. Capacity is split across the nodes; a lookup from another node still crosses the interconnect, but the
+        table's memory bandwidth is spread over every node.
+    Replicated: each node holds a full copy - reads stay on the calling thread's node, writes are applied to every
+        copy. For read-mostly tables; costs nodes x the memory.
+    On a single-node machine both modes are one RTMap. The node count can be given explicitly, e.g. to test sharding
+    on a single-node box - nodes that do not exist fall back to default memory placement.
+     * */
+
+    template<typename Key, typename Value, typename Hash = std::hash<Key>>
+    class NumaUnorderedMap {
+        using Shard = RTMap<Key, Value, Hash>;
+
+        // Resources are declared first so they outlive the shards allocated from them
+        std::vector<std::unique_ptr<NumaResource>> m_resources;
+        std::vector<std::unique_ptr<Shard>> m_shards;
+        NumaPlacement m_placement;
+        Hash m_hasher;
+#if (ENABLE_THREAD_SAFETY)
+        mutable std::mutex m_writeMutex;// Keeps replicas applying writes in the same order
+#endif
+
+    public:
+        /**
+         * @param capacity Buckets of the whole map - split across the shards when partitioned, per copy when
+         * replicated.
+         * @param poolSize Chained buckets, split the same way (0: half of capacity).
+         * @param nodes Nodes to place shards on, the machine's node count by default.
+         */
+        NumaUnorderedMap(std::size_t capacity, std::size_t poolSize = 0,
+                         NumaPlacement placement = NumaPlacement::Partitioned, int nodes = numa::nodeCount())
+            : m_placement(placement) {
+            if (nodes < 1) {
+                throw std::invalid_argument("NumaUnorderedMap needs at least one node");
+            }
+            if (capacity == 0) {
+                throw std::invalid_argument("NumaUnorderedMap needs a capacity");
+            }
+            std::size_t pool = poolSize ? poolSize : capacity / 2;
+            std::size_t shardCapacity = capacity;
+            std::size_t shardPool = pool;
+            if (placement == NumaPlacement::Partitioned) {
+                shardCapacity = (capacity + nodes - 1) / nodes;
+                shardPool = (pool + nodes - 1) / nodes;
+            }
+            for (int node = 0; node < nodes; ++node) {
+                m_resources.emplace_back(new NumaResource(node));
+                m_shards.emplace_back(new Shard(shardCapacity, shardPool ? shardPool : 1, m_resources.back().get()));
+            }
+        }
+
+        bool insert(const Key &key, const Value &value) {
+            if (m_placement == NumaPlacement::Partitioned) {
+                return shardFor(key).insert(key, value);
+            }
+#if (ENABLE_THREAD_SAFETY)
+            std::lock_guard<std::mutex> lock(m_writeMutex);
+#endif
+            // The replicas hold the same keys, so the first one tells whether the key is new
+            if (! m_shards.front()->insert(key, value)) {
+                return false;
+            }
+            std::size_t written = 1;
+            try {
+                for (; written < m_shards.size(); ++written) {
+                    m_shards[written]->insert(key, value);
+                }
+            } catch (...) {
+                while (written) {// Undo the copies already written, so every node keeps answering the same
+                    m_shards[--written]->erase(key);
+                }
+                throw;
+            }
+            return true;
+        }
+
+        bool insert_or_assign(const Key &key, const Value &value) {
+            if (m_placement == NumaPlacement::Partitioned) {
+                return shardFor(key).insert_or_assign(key, value);
+            }
+#if (ENABLE_THREAD_SAFETY)
+            std::lock_guard<std::mutex> lock(m_writeMutex);
+#endif
+            const Value *current = m_shards.front()->find(key);
+            std::unique_ptr<Value> previous(current ? new Value(*current) : nullptr);
+            std::size_t written = 0;
+            try {
+                for (; written < m_shards.size(); ++written) {
+                    m_shards[written]->insert_or_assign(key, value);
+                }
+            } catch (...) {
+                while (written) {// Restore the copies already written, so every node keeps answering the same
+                    if (previous) {
+                        m_shards[--written]->insert_or_assign(key, *previous);
+                    } else {
+                        m_shards[--written]->erase(key);
+                    }
+                }
+                throw;
+            }
+            return ! previous;
+        }
+
+        /**
+         * Inserts the (key, value) pairs of [first, last) with the shards built in parallel on pool - each shard, or
+         * replica, is filled by one task, so the shards' locks are never contended. Keys already present, or repeated
+         * in the range, keep their first value as with insert(). Returns the number of keys inserted.
+         */
+        template<typename RandomIt>
+        std::size_t insertBulk(RandomIt first, RandomIt last, ThreadPool &pool = ThreadPool::shared()) {
+            const std::size_t count = static_cast<std::size_t>(std::distance(first, last));
+            std::atomic<std::size_t> inserted(0);
+            if (m_placement == NumaPlacement::Replicated) {
+#if (ENABLE_THREAD_SAFETY)
+                std::lock_guard<std::mutex> lock(m_writeMutex);
+#endif
+                pool.parallelFor(0, m_shards.size(), 1, [&](std::size_t begin, std::size_t end) {
+                    for (std::size_t replica = begin; replica < end; ++replica) {
+                        std::size_t added = 0;
+                        for (std::size_t i = 0; i < count; ++i) {
+                            added += m_shards[replica]->insert(first[i].first, first[i].second);
+                        }
+                        if (replica == 0) {
+                            inserted = added;
+                        }
+                    }
+                });
+                return inserted;
+            }
+            // Hash once, in parallel, then let each shard pick out its own entries
+            std::vector<std::uint32_t> owner(count);
+            pool.parallelFor(0, count, 0, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; ++i) {
+                    owner[i] = static_cast<std::uint32_t>(nodeOf(first[i].first));
+                }
+            });
+            pool.parallelFor(0, m_shards.size(), 1, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t shard = begin; shard < end; ++shard) {
+                    std::size_t added = 0;
+                    for (std::size_t i = 0; i < count; ++i) {
+                        if (owner[i] == shard) {
+                            added += m_shards[shard]->insert(first[i].first, first[i].second);
+                        }
+                    }
+                    inserted += added;
+                }
+            });
+            return inserted;
+        }
+
+        bool erase(const Key &key) {
+            if (m_placement == NumaPlacement::Partitioned) {
+                return shardFor(key).erase(key);
+            }
+#if (ENABLE_THREAD_SAFETY)
+            std::lock_guard<std::mutex> lock(m_writeMutex);
+#endif
+            bool erased = false;
+            for (auto &replica: m_shards) {
+                erased = replica->erase(key);
+            }
+            return erased;
+        }
+
+        // Partitioned: the key's shard. Replicated: the calling thread's node copy.
+        Value *find(const Key &key) const { return shardFor(key).find(key); }
+
+        bool contains(const Key &key) const { return find(key) != nullptr; }
+
+        void clear() {
+#if (ENABLE_THREAD_SAFETY)
+            std::lock_guard<std::mutex> lock(m_writeMutex);
+#endif
+            for (auto &shard: m_shards) {
+                shard->clear();
+            }
+        }
+
+        std::size_t size() const {
+            if (m_placement == NumaPlacement::Replicated) {
+                return m_shards.front()->size();
+            }
+            std::size_t total = 0;
+            for (const auto &shard: m_shards) {
+                total += shard->size();
+            }
+            return total;
+        }
+
+        bool empty() const { return size() == 0; }
+
+        NumaPlacement placement() const { return m_placement; }
+        int nodes() const { return static_cast<int>(m_shards.size()); }
+
+        // Node whose shard serves key
+        int nodeOf(const Key &key) const {
+            if (m_placement == NumaPlacement::Replicated) {
+                return localNode();
+            }
+            // Mixed so the shard choice does not correlate with the bucket index inside the shard
+            std::uint64_t hash = static_cast<std::uint64_t>(m_hasher(key));
+            hash ^= hash >> 33;
+            hash *= 0xff51afd7ed558ccdull;
+            hash ^= hash >> 33;
+            return static_cast<int>(hash % m_shards.size());
+        }
+
+        // The shard, or copy, placed on node
+        Shard &shard(int node) { return *m_shards.at(static_cast<std::size_t>(node)); }
+
+        // Visits every entry once
+        template<typename Visitor>
+        void forEach(Visitor visit) {
+            std::size_t shards = m_placement == NumaPlacement::Replicated ? 1 : m_shards.size();
+            for (std::size_t i = 0; i < shards; ++i) {
+                m_shards[i]->forEach(visit);
+            }
+        }
+
+    private:
+        int localNode() const {
+            int node = numa::currentNode();
+            return node < static_cast<int>(m_shards.size()) ? node : 0;
+        }
+
+        Shard &shardFor(const Key &key) const { return *m_shards[static_cast<std::size_t>(nodeOf(key))]; }
+    };
+}// namespace ESTL
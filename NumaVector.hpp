@@ -0,0 +1,125 @@
+//
+// FixedVector split into per-NUMA-node shards, or replicated on every node.
+//
+#pragma once
+
+#include "ESTLMemory.hpp"
+#include "FixedVector.hpp"
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace ESTL {
+    /**
+     * @brief Vector with one node-local RTVector per NUMA node.
+     *
+     * Partitioned: push_back appends to the calling thread's node shard, so producers on each node fill local memory;
+     * local() is the caller's shard and forEach() visits all shards. Replicated: push_back appends to every copy and
+     * reads through local() or operator[] stay on the caller's node. See NumaUnorderedMap for the placement modes.
+     */
+    template<typename T>
+    class NumaVector {
+        using Shard = RTVector<T>;
+
+        // Resources are declared first so they outlive the shards allocated from them
+        std::vector<std::unique_ptr<NumaResource>> m_resources;
+        std::vector<std::unique_ptr<Shard>> m_shards;
+        NumaPlacement m_placement;
+#if (ENABLE_THREAD_SAFETY)
+        mutable std::mutex m_writeMutex;// Keeps replicas applying writes in the same order
+#endif
+
+    public:
+        /**
+         * @param capacity Capacity of each shard, or of each copy when replicated.
+         * @param nodes Nodes to place shards on, the machine's node count by default.
+         */
+        NumaVector(std::size_t capacity, NumaPlacement placement = NumaPlacement::Partitioned,
+                   int nodes = numa::nodeCount())
+            : m_placement(placement) {
+            if (nodes < 1) {
+                throw std::invalid_argument("NumaVector needs at least one node");
+            }
+            for (int node = 0; node < nodes; ++node) {
+                m_resources.emplace_back(new NumaResource(node));
+                m_shards.emplace_back(new Shard(capacity, m_resources.back().get()));
+            }
+        }
+
+        // Partitioned: appends to the calling thread's node shard. Replicated: appends to every copy.
+        void push_back(const T &value) {
+            if (m_placement == NumaPlacement::Partitioned) {
+                local().push_back(value);
+                return;
+            }
+#if (ENABLE_THREAD_SAFETY)
+            std::lock_guard<std::mutex> lock(m_writeMutex);
+#endif
+            if (m_shards.front()->size() >= m_shards.front()->capacity()) {
+                throw std::out_of_range("FixedVector overflow");
+            }
+            for (auto &replica: m_shards) {
+                replica->push_back(value);
+            }
+        }
+
+        // Replicated only - element index of the caller's node copy
+        const T &operator[](std::size_t index) const {
+            if (m_placement != NumaPlacement::Replicated) {
+                throw std::logic_error("Indexing needs a replicated NumaVector - use shard() or forEach()");
+            }
+            return (*m_shards[localNode()])[index];
+        }
+
+        // The calling thread's node shard, or copy
+        Shard &local() { return *m_shards[localNode()]; }
+        const Shard &local() const { return *m_shards[localNode()]; }
+
+        // The shard, or copy, placed on node
+        Shard &shard(int node) { return *m_shards.at(static_cast<std::size_t>(node)); }
+
+        void clear() {
+#if (ENABLE_THREAD_SAFETY)
+            std::lock_guard<std::mutex> lock(m_writeMutex);
+#endif
+            for (auto &shard: m_shards) {
+                shard->clear();
+            }
+        }
+
+        std::size_t size() const {
+            if (m_placement == NumaPlacement::Replicated) {
+                return m_shards.front()->size();
+            }
+            std::size_t total = 0;
+            for (const auto &shard: m_shards) {
+                total += shard->size();
+            }
+            return total;
+        }
+
+        bool empty() const { return size() == 0; }
+
+        NumaPlacement placement() const { return m_placement; }
+        int nodes() const { return static_cast<int>(m_shards.size()); }
+
+        // Visits every element once, shard by shard
+        template<typename Visitor>
+        void forEach(Visitor visit) const {
+            std::size_t shards = m_placement == NumaPlacement::Replicated ? 1 : m_shards.size();
+            for (std::size_t i = 0; i < shards; ++i) {
+                for (const T &value: *m_shards[i]) {
+                    visit(value);
+                }
+            }
+        }
+
+    private:
+        std::size_t localNode() const {
+            int node = numa::currentNode();
+            return node < static_cast<int>(m_shards.size()) ? static_cast<std::size_t>(node) : 0;
+        }
+    };
+}// namespace ESTL
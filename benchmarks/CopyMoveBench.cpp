@@ -0,0 +1,111 @@
+//
+// Copy, move and swap cost against capacity - a 16-element container in large storage should copy like a 16-element
+// one, and RT moves and swaps should not depend on the size at all.
+//
+#include "../FixedList.hpp"
+#include "../FixedMap/FixedMap.hpp"
+#include "../FixedString.hpp"
+#include "../FixedVector.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <utility>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr std::size_t kCapacity = 1 << 20;
+    constexpr std::size_t kSmall = 16;
+
+    template<typename Op>
+    double nsPerOp(int rounds, Op op) {
+        auto start = Clock::now();
+        for (int i = 0; i < rounds; ++i) {
+            op();
+        }
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / rounds;
+    }
+
+    template<typename Vector>
+    void fill(Vector &vector, std::size_t count) {
+        vector.clear();
+        for (std::size_t i = 0; i < count; ++i) {
+            vector.push_back(static_cast<int>(i));
+        }
+    }
+
+    // Large CT containers live outside the stack
+    ESTL::CTVector<int, kCapacity> ctSource, ctTarget;
+}// namespace
+
+int main(int argc, char **argv) {
+    const int rounds = argc > 1 ? std::atoi(argv[1]) : 20000;
+    const int fullRounds = rounds / 100 > 0 ? rounds / 100 : 1;
+    std::uint64_t checksum = 0;
+
+    std::printf("capacity %zu, small size %zu, ns per operation\n", kCapacity, kSmall);
+
+    fill(ctSource, kSmall);
+    double ctCopySmall = nsPerOp(rounds, [&] {
+        ctTarget = ctSource;
+        checksum += ctTarget.size();
+    });
+    double ctSwapSmall = nsPerOp(rounds, [&] { ctTarget.swap(ctSource); });
+    fill(ctSource, kCapacity);
+    double ctCopyFull = nsPerOp(fullRounds, [&] {
+        ctTarget = ctSource;
+        checksum += ctTarget.size();
+    });
+    std::printf("CTVector copy       %12.1f small %12.1f full\n", ctCopySmall, ctCopyFull);
+    std::printf("CTVector swap       %12.1f small\n", ctSwapSmall);
+
+    ESTL::RTVector<int> rtVector(kCapacity), rtOther(kCapacity);
+    fill(rtVector, kSmall);
+    double rtCopySmall = nsPerOp(rounds, [&] {
+        rtOther = rtVector;
+        checksum += rtOther.size();
+    });
+    double rtMove = nsPerOp(rounds, [&] {
+        ESTL::RTVector<int> moved(std::move(rtVector));
+        rtVector = std::move(moved);
+    });
+    double rtSwap = nsPerOp(rounds, [&] { rtVector.swap(rtOther); });
+    std::printf("RTVector copy       %12.1f small\n", rtCopySmall);
+    std::printf("RTVector move       %12.1f (there and back)\n", rtMove);
+    std::printf("RTVector swap       %12.1f\n", rtSwap);
+
+    ESTL::RTString text("sixteen chars...", kCapacity), otherText(kCapacity);
+    double stringCopy = nsPerOp(rounds, [&] {
+        otherText = text;
+        checksum += otherText.size();
+    });
+    double stringMove = nsPerOp(rounds, [&] {
+        ESTL::RTString moved(std::move(text));
+        text = std::move(moved);
+    });
+    std::printf("RTString copy       %12.1f small\n", stringCopy);
+    std::printf("RTString move       %12.1f (there and back)\n", stringMove);
+
+    ESTL::RTList<int> list(kCapacity);
+    for (std::size_t i = 0; i < kSmall; ++i) {
+        list.push_back(static_cast<int>(i));
+    }
+    double listMove = nsPerOp(rounds, [&] {
+        ESTL::RTList<int> moved(std::move(list));
+        list = std::move(moved);
+    });
+    std::printf("RTList move         %12.1f (there and back)\n", listMove);
+
+    ESTL::RTMap<int, int> map(kCapacity);
+    for (std::size_t i = 0; i < kSmall; ++i) {
+        map.insert(static_cast<int>(i), static_cast<int>(i));
+    }
+    double mapMove = nsPerOp(rounds, [&] {
+        ESTL::RTMap<int, int> moved(std::move(map));
+        map = std::move(moved);
+    });
+    std::printf("RTMap (tree) move   %12.1f (there and back)   (checksum %llu)\n", mapMove,
+                static_cast<unsigned long long>(checksum + map.size() + list.size()));
+    return 0;
+}
@@ -0,0 +1,130 @@
+//
+// FIFO queue workloads on CTDeque against CTList - steady-state push_back / pop_front through a queue held at a
+// fixed depth, a full drain and refill, and bulk transfer through the deque's segments against element-wise list I/O.
+//
+#include "../FixedDeque.hpp"
+#include "../FixedList.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr std::size_t kCapacity = 4096;
+    constexpr std::size_t kDepth = 1000;
+    constexpr std::size_t kBurst = 512;
+
+    template<typename Op>
+    double nsPerOp(std::size_t operations, Op op) {
+        auto start = Clock::now();
+        op();
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / operations;
+    }
+
+    // Large CT containers live outside the stack
+    ESTL::CTDeque<std::uint64_t, kCapacity> deque;
+    ESTL::CTList<std::uint64_t, kCapacity> list;
+    std::uint64_t wire[kBurst];
+}// namespace
+
+int main(int argc, char **argv) {
+    const std::size_t operations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    const std::size_t bursts = operations / kBurst;
+    std::uint64_t checksum = 0;
+
+    std::printf("capacity %zu, queue depth %zu, burst %zu, ns per element\n", kCapacity, kDepth, kBurst);
+
+    for (std::size_t i = 0; i < kDepth; ++i) {
+        deque.push_back(i);
+        list.push_back(i);
+    }
+    double dequeSteady = nsPerOp(operations, [&] {
+        for (std::size_t i = 0; i < operations; ++i) {
+            checksum += deque.front();
+            deque.pop_front();
+            deque.push_back(i);
+        }
+    });
+    double listSteady = nsPerOp(operations, [&] {
+        for (std::size_t i = 0; i < operations; ++i) {
+            checksum += list.front();
+            list.pop_front();
+            list.push_back(i);
+        }
+    });
+    std::printf("steady push/pop     %10.2f CTDeque %10.2f CTList\n", dequeSteady, listSteady);
+
+    const std::size_t rounds = operations / kCapacity ? operations / kCapacity : 1;
+    double dequeRefill = nsPerOp(rounds * kCapacity, [&] {
+        for (std::size_t round = 0; round < rounds; ++round) {
+            while (! deque.empty()) {
+                checksum += deque.front();
+                deque.pop_front();
+            }
+            while (! deque.full()) {
+                deque.push_back(round);
+            }
+        }
+    });
+    double listRefill = nsPerOp(rounds * kCapacity, [&] {
+        for (std::size_t round = 0; round < rounds; ++round) {
+            while (! list.empty()) {
+                checksum += list.front();
+                list.pop_front();
+            }
+            while (list.size() < kCapacity) {
+                list.push_back(round);
+            }
+        }
+    });
+    std::printf("drain and refill    %10.2f CTDeque %10.2f CTList\n", dequeRefill, listRefill);
+
+    // Bulk I/O: a burst is read into the free space and an equal burst written out of the front, as a readv() and
+    // writev() pair would - the deque copies whole segments, the list goes one node at a time
+    deque.clear();
+    list.clear();
+    for (std::size_t i = 0; i < kDepth; ++i) {
+        deque.push_back(i);
+        list.push_back(i);
+    }
+    for (std::size_t i = 0; i < kBurst; ++i) {
+        wire[i] = i;
+    }
+    double dequeBulk = nsPerOp(bursts * kBurst, [&] {
+        for (std::size_t burst = 0; burst < bursts; ++burst) {
+            std::size_t copied = 0;
+            for (const auto &segment : deque.freeSegments()) {
+                const std::size_t count = segment.size < kBurst - copied ? segment.size : kBurst - copied;
+                std::memcpy(segment.data, wire + copied, count * sizeof(std::uint64_t));
+                copied += count;
+            }
+            deque.commitBack(copied);
+            std::size_t sent = 0;
+            for (const auto &segment : deque.segments()) {
+                const std::size_t count = segment.size < kBurst - sent ? segment.size : kBurst - sent;
+                std::memcpy(wire + sent, segment.data, count * sizeof(std::uint64_t));
+                sent += count;
+            }
+            deque.consumeFront(sent);
+            checksum += wire[burst % kBurst];
+        }
+    });
+    double listBulk = nsPerOp(bursts * kBurst, [&] {
+        for (std::size_t burst = 0; burst < bursts; ++burst) {
+            for (std::size_t i = 0; i < kBurst; ++i) {
+                list.push_back(wire[i]);
+            }
+            for (std::size_t i = 0; i < kBurst; ++i) {
+                wire[i] = list.front();
+                list.pop_front();
+            }
+            checksum += wire[burst % kBurst];
+        }
+    });
+    std::printf("bulk burst I/O      %10.2f CTDeque %10.2f CTList   (checksum %llu)\n", dequeBulk, listBulk,
+                static_cast<unsigned long long>(checksum));
+    return 0;
+}
@@ -0,0 +1,97 @@
+//
+// FixedMap engine comparison - point lookups and range scans at 1M keys.
+//
+#include "../FixedMap/FixedMap.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double elapsedNs(Clock::time_point start) {
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    }
+
+    const char *treeName(TreeType type) {
+        switch (type) {
+            case TreeType::RedBlack:
+                return "RedBlack";
+            case TreeType::AVL:
+                return "AVL";
+            case TreeType::BPlus:
+                return "BPlus";
+            case TreeType::Persistent:
+                return "Persistent";
+        }
+        return "?";
+    }
+
+    void benchTree(TreeType type, const std::vector<std::uint64_t> &keys, const std::vector<std::uint64_t> &probes) {
+        // A persistent write copies its path before the old nodes are retired - room for a few paths on top
+        const std::size_t spare = type == TreeType::Persistent ? 256 : 0;
+        ESTL::RTMap<std::uint64_t, std::uint64_t> map(keys.size() + spare, type);
+
+        auto start = Clock::now();
+        for (std::uint64_t key: keys) {
+            map.insert(key, key);
+        }
+        double insertNs = elapsedNs(start) / keys.size();
+
+        std::uint64_t checksum = 0;
+        start = Clock::now();
+        for (std::uint64_t key: probes) {
+            checksum += *map.find(key);
+        }
+        double findNs = elapsedNs(start) / probes.size();
+
+        start = Clock::now();
+        for (auto it = map.begin(); it != map.end(); ++it) {
+            checksum += (*it).second;
+        }
+        double scanNs = elapsedNs(start) / keys.size();
+
+        // Short range scans - 100 consecutive keys from a random starting point
+        const std::size_t ranges = probes.size() / 100;
+        start = Clock::now();
+        for (std::size_t i = 0; i < ranges; ++i) {
+            auto it = map.lower_bound(probes[i]);
+            for (int step = 0; step < 100 && it != map.end(); ++step, ++it) {
+                checksum += (*it).second;
+            }
+        }
+        double rangeNs = elapsedNs(start) / (ranges * 100);
+
+        start = Clock::now();
+        for (std::uint64_t key: probes) {
+            map.erase(key);
+        }
+        double eraseNs = elapsedNs(start) / probes.size();
+
+        std::printf("%-10s %12.1f %12.1f %12.1f %12.1f %12.1f   (checksum %llu)\n", treeName(type), insertNs, findNs,
+                    scanNs, rangeNs, eraseNs, static_cast<unsigned long long>(checksum));
+    }
+}// namespace
+
+int main(int argc, char **argv) {
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    std::mt19937_64 rng(2025);
+    std::vector<std::uint64_t> keys(count);
+    std::iota(keys.begin(), keys.end(), 0);
+    std::shuffle(keys.begin(), keys.end(), rng);
+    std::vector<std::uint64_t> probes(keys);
+    std::shuffle(probes.begin(), probes.end(), rng);
+
+    std::printf("%zu keys, ns/op\n", count);
+    std::printf("%-10s %12s %12s %12s %12s %12s\n", "engine", "insert", "find", "full scan", "range scan", "erase");
+    for (TreeType type: {TreeType::RedBlack, TreeType::AVL, TreeType::BPlus, TreeType::Persistent}) {
+        benchTree(type, keys, probes);
+    }
+    return 0;
+}
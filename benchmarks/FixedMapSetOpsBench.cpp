@@ -0,0 +1,73 @@
+//
+// FixedMap bulk set operations - element-wise merge against join-based set_union over a shared pool.
+//
+#include "../FixedMap/FixedMap.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+    using Map = ESTL::FixedMap<std::uint64_t, std::uint64_t>;
+
+    double elapsedMs(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    void fill(Map &map, const std::vector<std::uint64_t> &keys) {
+        for (std::uint64_t key: keys) {
+            map.insert(key, key);
+        }
+    }
+
+    void benchUnion(TreeType type, const char *name, const std::vector<std::uint64_t> &large,
+                    const std::vector<std::uint64_t> &small) {
+        const std::size_t capacity = large.size() + small.size();
+        double mergeMs;
+        {
+            // merge copies, so the pool has to hold the small map twice
+            ESTL::RTNodePool<std::uint64_t, std::uint64_t> pool(capacity + small.size());
+            Map map(pool, type);
+            Map other(pool, type);
+            fill(map, large);
+            fill(other, small);
+            auto start = Clock::now();
+            map.merge(other);
+            mergeMs = elapsedMs(start);
+        }
+
+        ESTL::RTNodePool<std::uint64_t, std::uint64_t> pool(capacity);
+        Map map(pool, type);
+        Map other(pool, type);
+        fill(map, large);
+        fill(other, small);
+        auto start = Clock::now();
+        map.set_union(other);
+        double unionMs = elapsedMs(start);
+        std::printf("%-10s %14.2f %14.2f   (%zu elements)\n", name, mergeMs, unionMs, map.size());
+    }
+}// namespace
+
+int main(int argc, char **argv) {
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const std::size_t smallCount = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : count / 10;
+
+    std::mt19937_64 rng(2025);
+    std::vector<std::uint64_t> large(count);
+    std::vector<std::uint64_t> small(smallCount);
+    for (auto &key: large) {
+        key = rng();
+    }
+    for (auto &key: small) {
+        key = rng();
+    }
+
+    std::printf("union of %zu and %zu keys, ms\n", count, smallCount);
+    std::printf("%-10s %14s %14s\n", "engine", "merge", "set_union");
+    benchUnion(TreeType::RedBlack, "RedBlack", large, small);
+    benchUnion(TreeType::AVL, "AVL", large, small);
+    return 0;
+}
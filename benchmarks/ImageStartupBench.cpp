@@ -0,0 +1,60 @@
+//
+// Startup cost of a FixedUnorderedMap - rebuilding by insertion against mapping a saved image.
+//
+#include "../FixedUnorderedMapImage.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double elapsedMs(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    std::uint64_t mix(std::uint64_t x) {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdull;
+        return x ^ (x >> 33);
+    }
+}// namespace
+
+int main(int argc, char **argv) {
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 5000000;
+    const std::string path = argc > 2 ? argv[2] : "/tmp/estl_startup_bench.img";
+
+    auto start = Clock::now();
+    ESTL::RTMap<std::uint64_t, std::uint64_t> map(count, count);
+    for (std::size_t i = 0; i < count; ++i) {
+        map.insert(mix(i), i);
+    }
+    double rebuildMs = elapsedMs(start);
+
+    start = Clock::now();
+    ESTL::saveImage(map, path);
+    double saveMs = elapsedMs(start);
+
+    start = Clock::now();
+    ESTL::MappedUnorderedMap<std::uint64_t, std::uint64_t> mapped(path);
+    double openMs = elapsedMs(start);
+
+    // First lookups fault in their pages
+    std::uint64_t checksum = 0;
+    start = Clock::now();
+    for (std::size_t i = 0; i < 1000; ++i) {
+        checksum += *mapped.find(mix(i * (count / 1000)));
+    }
+    double firstLookupsMs = elapsedMs(start);
+
+    std::printf("%zu entries\n", count);
+    std::printf("rebuild by insert   %10.2f ms\n", rebuildMs);
+    std::printf("save image          %10.2f ms\n", saveMs);
+    std::printf("map + validate      %10.3f ms\n", openMs);
+    std::printf("first 1000 lookups  %10.3f ms   (checksum %llu)\n", firstLookupsMs,
+                static_cast<unsigned long long>(checksum));
+    std::remove(path.c_str());
+    return 0;
+}
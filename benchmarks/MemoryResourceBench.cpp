@@ -0,0 +1,78 @@
+//
+// RT container storage - random lookups on heap against hugepage storage, and per-request containers on the heap
+// against an arena released with one reset.
+//
+#include "../ESTLMemory.hpp"
+#include "../FixedUnorderedMap.hpp"
+#include "../FixedVector.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double elapsedMs(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    std::uint64_t mix(std::uint64_t x) {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdull;
+        return x ^ (x >> 33);
+    }
+
+    double lookupMs(ESTL::MemoryResource *resource, std::size_t count, std::uint64_t &checksum) {
+        ESTL::RTMap<std::uint64_t, std::uint64_t> map(count, count, resource);
+        for (std::size_t i = 0; i < count; ++i) {
+            map.insert(mix(i), i);
+        }
+        auto start = Clock::now();
+        for (std::size_t i = 0; i < count; ++i) {
+            checksum += *map.find(mix(mix(i) % count));
+        }
+        return elapsedMs(start);
+    }
+
+    double requestsMs(ESTL::MemoryResource *resource, ESTL::ArenaResource *arena, int requests) {
+        auto start = Clock::now();
+        for (int request = 0; request < requests; ++request) {
+            {
+                ESTL::RTVector<int> ids(64, resource);
+                ESTL::RTMap<int, int> index(32, 32, resource);
+                for (int i = 0; i < 32; ++i) {
+                    ids.push_back(i);
+                    index.insert(i, request);
+                }
+            }
+            if (arena) {
+                arena->reset();
+            }
+        }
+        return elapsedMs(start);
+    }
+}// namespace
+
+int main(int argc, char **argv) {
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 8000000;
+    const int requests = 200000;
+    std::uint64_t checksum = 0;
+
+    ESTL::HugePageResource hugePages;
+    double heapLookups = lookupMs(ESTL::defaultResource(), count, checksum);
+    double hugeLookups = lookupMs(&hugePages, count, checksum);
+
+    ESTL::ArenaResource arena(1 << 20);
+    double heapRequests = requestsMs(ESTL::defaultResource(), nullptr, requests);
+    double arenaRequests = requestsMs(&arena, &arena, requests);
+
+    std::printf("%zu entries, random lookups\n", count);
+    std::printf("heap storage        %10.2f ms\n", heapLookups);
+    std::printf("hugepage storage    %10.2f ms\n", hugeLookups);
+    std::printf("%d requests, a vector and a map each\n", requests);
+    std::printf("heap new/delete     %10.2f ms\n", heapRequests);
+    std::printf("arena + reset       %10.2f ms   (checksum %llu)\n", arenaRequests,
+                static_cast<unsigned long long>(checksum));
+    return 0;
+}
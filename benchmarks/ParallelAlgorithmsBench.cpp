@@ -0,0 +1,93 @@
+//
+// Parallel algorithms on a large RTVector against thread count - 1 thread is the serial baseline, each row doubles the
+// pool up to the hardware threads. Defaults to 100M elements; pass a smaller count on small machines.
+//
+#include "../ESTLParallel.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+    using Vector = ESTL::RTVector<std::uint32_t>;
+
+    template<typename Op>
+    double milliseconds(Op op) {
+        auto start = Clock::now();
+        op();
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    std::uint32_t mix(std::uint32_t value) {
+        value ^= value >> 16;
+        value *= 0x7feb352du;
+        value ^= value >> 15;
+        value *= 0x846ca68bu;
+        return value ^ (value >> 16);
+    }
+
+    struct Row {
+        unsigned threads;
+        double sort, forEach, transform, reduce, scan, partition;
+    };
+}// namespace
+
+int main(int argc, char **argv) {
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000000;
+    const unsigned hardware = std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1;
+    const unsigned maxThreads = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : hardware;
+
+    Vector source(count), work(count), out(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        source.push_back(mix(static_cast<std::uint32_t>(i)));
+    }
+    std::uint64_t checksum = 0;
+    std::vector<Row> rows;
+
+    std::printf("%zu elements, %u hardware threads, ms (speedup against 1 thread)\n", count, hardware);
+    for (unsigned threads = 1;; threads = threads * 2 > maxThreads && threads < maxThreads ? maxThreads : threads * 2) {
+        ESTL::ThreadPool pool(threads - 1);
+        auto identity = [](std::uint32_t value) { return value; };
+        Row row{threads, 0, 0, 0, 0, 0, 0};
+
+        ESTL::parallel::transform(source, work, identity, pool);
+        row.sort = milliseconds([&] { ESTL::parallel::sort(work, std::less<std::uint32_t>(), pool); });
+        checksum += work[count / 2];
+
+        row.forEach = milliseconds([&] {
+            ESTL::parallel::for_each(work, [](std::uint32_t &value) { value = mix(value); }, pool);
+        });
+        row.transform = milliseconds([&] {
+            ESTL::parallel::transform(work, out, [](std::uint32_t value) { return value * 3 + 1; }, pool);
+        });
+        row.reduce = milliseconds([&] {
+            checksum += ESTL::parallel::reduce(out, std::uint32_t(0), std::plus<std::uint32_t>(), pool);
+        });
+        row.scan = milliseconds([&] {
+            ESTL::parallel::inclusive_scan(work, out, std::plus<std::uint32_t>(), pool);
+        });
+        checksum += out[count - 1];
+        row.partition = milliseconds([&] {
+            checksum += ESTL::parallel::partition(work, [](std::uint32_t value) { return value & 1; }, pool) -
+                        work.begin();
+        });
+        rows.push_back(row);
+
+        const Row &base = rows.front();
+        std::printf("%3u threads  sort %9.1f (%4.1fx)  for_each %8.1f (%4.1fx)  transform %8.1f (%4.1fx)\n", threads,
+                    row.sort, base.sort / row.sort, row.forEach, base.forEach / row.forEach, row.transform,
+                    base.transform / row.transform);
+        std::printf("             reduce %7.1f (%4.1fx)  scan %12.1f (%4.1fx)  partition %8.1f (%4.1fx)\n", row.reduce,
+                    base.reduce / row.reduce, row.scan, base.scan / row.scan, row.partition,
+                    base.partition / row.partition);
+        if (threads >= maxThreads) {
+            break;
+        }
+    }
+    std::printf("(checksum %llu)\n", static_cast<unsigned long long>(checksum));
+    return 0;
+}
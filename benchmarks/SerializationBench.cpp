@@ -0,0 +1,71 @@
+//
+// Checkpoint throughput - bulk serialization of a FixedVector against writing its elements one by one.
+//
+#include "../ESTLSerialization.hpp"
+#include "../FixedVector.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double elapsedMs(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    double mbPerSecond(std::size_t bytes, double ms) { return bytes / (1024.0 * 1024.0) / (ms / 1000.0); }
+}// namespace
+
+int main(int argc, char **argv) {
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 16u << 20;
+    const std::string path = argc > 2 ? argv[2] : "/tmp/estl_serialization_bench.bin";
+    const std::size_t bytes = count * sizeof(std::uint64_t);
+    std::vector<char> buffer(1 << 20);
+
+    ESTL::RTVector<std::uint64_t> vector(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        vector.push_back(i * 0x9e3779b97f4a7c15ull);
+    }
+
+    auto start = Clock::now();
+    {
+        std::ofstream out(path, std::ios::binary);
+        ESTL::BinaryWriter writer(out, buffer.data(), buffer.size());
+        for (std::uint64_t value: vector) {
+            writer.writeValue(value);
+        }
+        writer.flush();
+    }
+    double elementMs = elapsedMs(start);
+
+    start = Clock::now();
+    {
+        std::ofstream out(path, std::ios::binary);
+        ESTL::BinaryWriter writer(out, buffer.data(), buffer.size());
+        ESTL::serialize(writer, vector);
+        writer.flush();
+    }
+    double bulkMs = elapsedMs(start);
+
+    ESTL::RTVector<std::uint64_t> loaded(count);
+    start = Clock::now();
+    {
+        std::ifstream in(path, std::ios::binary);
+        ESTL::BinaryReader reader(in, buffer.data(), buffer.size());
+        ESTL::deserialize(reader, loaded);
+    }
+    double loadMs = elapsedMs(start);
+
+    std::printf("%zu elements, %.1f MiB\n", count, bytes / (1024.0 * 1024.0));
+    std::printf("element-wise write  %10.2f ms  %8.1f MiB/s\n", elementMs, mbPerSecond(bytes, elementMs));
+    std::printf("bulk serialize      %10.2f ms  %8.1f MiB/s\n", bulkMs, mbPerSecond(bytes, bulkMs));
+    std::printf("bulk deserialize    %10.2f ms  %8.1f MiB/s  (%s)\n", loadMs, mbPerSecond(bytes, loadMs),
+                loaded.size() == count && loaded[count - 1] == vector[count - 1] ? "ok" : "MISMATCH");
+    std::remove(path.c_str());
+    return 0;
+}
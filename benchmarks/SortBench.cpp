@@ -0,0 +1,123 @@
+//
+// Radix sort against std::sort on large RTVectors of 32- and 64-bit keys and of records, and sorting networks against
+// std::sort on small CTVectors - ns per element.
+//
+#include "../ESTLSort.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    struct Record {
+        std::uint64_t key;
+        std::uint64_t payload;
+    };
+
+    template<typename Vector, typename Source, typename Sort>
+    double nsPerElement(Vector &vector, const Source &source, int rounds, Sort sort) {
+        double total = 0;
+        for (int round = 0; round < rounds; ++round) {
+            vector = source;
+            auto start = Clock::now();
+            sort(vector);
+            total += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        }
+        return total / rounds / (vector.size() ? vector.size() : 1);
+    }
+
+    constexpr std::size_t kInputs = 1024;// Distinct small inputs, so std::sort cannot learn the branches of one
+
+    // Small sorts are timed in one batch - a clock read per sort would cost more than the sort. Both columns include
+    // the copy that resets the input.
+    template<std::size_t N, typename Sort>
+    double smallNsPerElement(const std::vector<ESTL::CTVector<std::uint32_t, N>> &inputs, int rounds,
+                             std::uint64_t &checksum, Sort sort) {
+        ESTL::CTVector<std::uint32_t, N> work;
+        auto start = Clock::now();
+        for (int round = 0; round < rounds; ++round) {
+            work = inputs[static_cast<std::size_t>(round) % kInputs];
+            sort(work);
+            checksum += work[static_cast<std::size_t>(round) % N];
+        }
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / rounds / N;
+    }
+
+    template<std::size_t N>
+    void smallRow(std::mt19937_64 &rng, int rounds, std::uint64_t &checksum) {
+        std::vector<ESTL::CTVector<std::uint32_t, N>> inputs(kInputs);
+        for (auto &input: inputs) {
+            for (std::size_t i = 0; i < N; ++i) {
+                input.push_back(static_cast<std::uint32_t>(rng()));
+            }
+        }
+        double network = smallNsPerElement(inputs, rounds, checksum, [](ESTL::FixedVector<std::uint32_t> &v) {
+            ESTL::sorting::network_sort(v);
+        });
+        double standard = smallNsPerElement(inputs, rounds, checksum, [](ESTL::FixedVector<std::uint32_t> &v) {
+            std::sort(v.begin(), v.end());
+        });
+        std::printf("CTVector<uint32, %2zu>   network %8.2f   std::sort %8.2f\n", N, network, standard);
+    }
+}// namespace
+
+int main(int argc, char **argv) {
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    const int rounds = argc > 2 ? std::atoi(argv[2]) : 3;
+    std::mt19937_64 rng(12345);
+    std::uint64_t checksum = 0;
+
+    std::printf("%zu elements, ns per element\n", count);
+
+    ESTL::RTVector<std::uint32_t> keys32(count), work32(count), scratch32(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        keys32.push_back(static_cast<std::uint32_t>(rng()));
+    }
+    double radix32 = nsPerElement(work32, keys32, rounds, [&](ESTL::FixedVector<std::uint32_t> &v) {
+        ESTL::sorting::radix_sort(v, scratch32);
+    });
+    double std32 = nsPerElement(work32, keys32, rounds, [](ESTL::FixedVector<std::uint32_t> &v) {
+        std::sort(v.begin(), v.end());
+    });
+    checksum += work32[count / 2];
+    std::printf("RTVector<uint32>       radix %10.2f   std::sort %8.2f\n", radix32, std32);
+
+    ESTL::RTVector<std::uint64_t> keys64(count), work64(count), scratch64(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        keys64.push_back(rng());
+    }
+    double radix64 = nsPerElement(work64, keys64, rounds, [&](ESTL::FixedVector<std::uint64_t> &v) {
+        ESTL::sorting::radix_sort(v, scratch64);
+    });
+    double std64 = nsPerElement(work64, keys64, rounds, [](ESTL::FixedVector<std::uint64_t> &v) {
+        std::sort(v.begin(), v.end());
+    });
+    checksum += work64[count / 2];
+    std::printf("RTVector<uint64>       radix %10.2f   std::sort %8.2f\n", radix64, std64);
+
+    ESTL::RTVector<Record> records(count), workRecords(count), scratchRecords(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        records.push_back(Record{rng() >> 24, i});// 40-bit keys: three digits skipped
+    }
+    double radixRecords = nsPerElement(workRecords, records, rounds, [&](ESTL::FixedVector<Record> &v) {
+        ESTL::sorting::radix_sort(v, scratchRecords, [](const Record &record) { return record.key; });
+    });
+    double stdRecords = nsPerElement(workRecords, records, rounds, [](ESTL::FixedVector<Record> &v) {
+        std::stable_sort(v.begin(), v.end(), [](const Record &a, const Record &b) { return a.key < b.key; });
+    });
+    checksum += workRecords[count / 2].payload;
+    std::printf("RTVector<Record>       radix %10.2f   std::stable_sort %8.2f\n", radixRecords, stdRecords);
+
+    const int smallRounds = 200000;
+    smallRow<8>(rng, smallRounds, checksum);
+    smallRow<16>(rng, smallRounds, checksum);
+    smallRow<32>(rng, smallRounds, checksum);
+    smallRow<64>(rng, smallRounds, checksum);
+    std::printf("(checksum %llu)\n", static_cast<unsigned long long>(checksum));
+    return 0;
+}
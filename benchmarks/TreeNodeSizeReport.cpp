@@ -0,0 +1,22 @@
+//
+// Tree node footprint - bytes per node of the current TreeNode layout.
+// Build with -DESTL_COMPACT_TREE_NODE=1 (CMake option ESTL_COMPACT_TREE_NODE) to see the packed layout.
+//
+#include "../FixedMap/FixedMap.hpp"
+#include <cstdint>
+#include <cstdio>
+
+namespace {
+    template<typename Key, typename Value>
+    void report(const char *name) {
+        std::printf("%-28s %6zu bytes/node   (key + value %zu)\n", name, sizeof(TreeNode<Key, Value>),
+                    sizeof(Key) + sizeof(Value));
+    }
+}// namespace
+
+int main() {
+    std::printf("TreeNode layout: %s\n", ESTL_COMPACT_TREE_NODE ? "compact (metadata in parent link)" : "default");
+    report<int, int>("TreeNode<int, int>");
+    report<std::uint64_t, std::uint64_t>("TreeNode<uint64_t, uint64_t>");
+    return 0;
+}
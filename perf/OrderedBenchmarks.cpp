@@ -0,0 +1,55 @@
+//
+// perf-check benchmarks - FixedMap with the red-black and AVL engines.
+//
+#include "../FixedMap/FixedMap.hpp"
+#include "Perf.hpp"
+#include <memory>
+
+namespace perf {
+    namespace {
+        void addTree(std::vector<Benchmark> &benchmarks, const std::string &prefix, TreeType type) {
+            auto keys = std::make_shared<std::vector<std::uint64_t>>(shuffledKeys());
+            auto map = std::make_shared<ESTL::RTMap<std::uint64_t, std::uint64_t>>(Elements, type);
+            auto fill = [map, keys] {
+                map->clear();
+                for (std::uint64_t key: *keys) {
+                    map->insert(key, key);
+                }
+            };
+            // Reads only need the map full - refilled only after a benchmark emptied it
+            auto filled = [map, fill] {
+                if (map->size() != Elements) {
+                    fill();
+                }
+            };
+
+            benchmarks.push_back({prefix + ".insert", Elements, [map, keys] {
+                                      for (std::uint64_t key: *keys) {
+                                          map->insert(key, key);
+                                      }
+                                  }, [map] { map->clear(); }});
+            benchmarks.push_back({prefix + ".find", Elements, [map, keys] {
+                                      for (std::uint64_t key: *keys) {
+                                          keep(map->find(key));
+                                      }
+                                  }, filled});
+            benchmarks.push_back({prefix + ".erase", Elements, [map, keys] {
+                                      for (std::uint64_t key: *keys) {
+                                          map->erase(key);
+                                      }
+                                  }, fill});
+            benchmarks.push_back({prefix + ".iterate", Elements, [map] {
+                                      std::uint64_t sum = 0;
+                                      for (auto it = map->begin(); it != map->end(); ++it) {
+                                          sum += (*it).second;
+                                      }
+                                      keep(sum);
+                                  }, filled});
+        }
+    }// namespace
+
+    void addOrderedBenchmarks(std::vector<Benchmark> &benchmarks) {
+        addTree(benchmarks, "FixedMap-RB", TreeType::RedBlack);
+        addTree(benchmarks, "FixedMap-AVL", TreeType::AVL);
+    }
+}// namespace perf
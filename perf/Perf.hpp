@@ -0,0 +1,61 @@
+//
+// perf-check suite - the fixed benchmark set whose throughput is compared with perf/baseline.json.
+//
+// As in estl_loadgen, the unordered maps and FixedMap share the ESTL::CTMap / ESTL::RTMap names, so each container
+// family registers its benchmarks from its own translation unit.
+//
+
+#ifndef ESTL_PERF_HPP
+#define ESTL_PERF_HPP
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace perf {
+    // Elements per container - small enough to stay in cache, so the numbers measure the code, not the memory
+    constexpr std::size_t Elements = 4096;
+
+    /**
+     * @brief One timed operation - "Container.operation".
+     *
+     * body performs operations calls of the operation and is the only part timed. setup, when set, runs untimed
+     * before every call of body and puts the container back in the state body expects (e.g. empty before a fill).
+     */
+    struct Benchmark {
+        std::string name;
+        std::size_t operations;
+        std::function<void()> body;
+        std::function<void()> setup;
+    };
+
+    void addSequenceBenchmarks(std::vector<Benchmark> &benchmarks);
+    void addUnorderedBenchmarks(std::vector<Benchmark> &benchmarks);
+    void addOrderedBenchmarks(std::vector<Benchmark> &benchmarks);
+
+    // Keeps a result alive without storing it anywhere
+    template<typename T>
+    inline void keep(const T &value) {
+        asm volatile("" : : "g"(value) : "memory");
+    }
+
+    // The same pseudo-random permutation of 0 .. Elements - 1 on every run
+    inline std::vector<std::uint64_t> shuffledKeys() {
+        std::vector<std::uint64_t> keys(Elements);
+        for (std::size_t i = 0; i < Elements; ++i) {
+            keys[i] = i;
+        }
+        std::uint64_t state = 2025;
+        for (std::size_t i = Elements - 1; i > 0; --i) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            std::size_t j = static_cast<std::size_t>((state >> 33) % (i + 1));
+            std::swap(keys[i], keys[j]);
+        }
+        return keys;
+    }
+}// namespace perf
+
+#endif//ESTL_PERF_HPP
@@ -0,0 +1,81 @@
+//
+// perf-check benchmarks - FixedVector, FixedList and FixedString.
+//
+#include "../FixedList.hpp"
+#include "../FixedString.hpp"
+#include "../FixedVector.hpp"
+#include "Perf.hpp"
+#include <memory>
+
+namespace perf {
+    void addSequenceBenchmarks(std::vector<Benchmark> &benchmarks) {
+        auto vector = std::make_shared<ESTL::RTVector<std::uint64_t>>(Elements);
+        auto fillVector = [vector] {
+            vector->clear();
+            for (std::uint64_t i = 0; i < Elements; ++i) {
+                vector->push_back(i);
+            }
+        };
+        benchmarks.push_back({"FixedVector.push_back", Elements, fillVector, [vector] { vector->clear(); }});
+        benchmarks.push_back({"FixedVector.operator[]", Elements, [vector] {
+                                  std::uint64_t sum = 0;
+                                  for (std::size_t i = 0; i < Elements; ++i) {
+                                      sum += (*vector)[i];
+                                  }
+                                  keep(sum);
+                              }, fillVector});
+        benchmarks.push_back({"FixedVector.pop_back", Elements, [vector] {
+                                  for (std::size_t i = 0; i < Elements; ++i) {
+                                      vector->pop_back();
+                                  }
+                              }, fillVector});
+
+        auto list = std::make_shared<ESTL::RTList<std::uint64_t>>(Elements);
+        auto fillList = [list] {
+            list->clear();
+            for (std::uint64_t i = 0; i < Elements; ++i) {
+                list->push_back(i);
+            }
+        };
+        benchmarks.push_back({"FixedList.push_back", Elements, [list] {
+                                  for (std::uint64_t i = 0; i < Elements; ++i) {
+                                      list->push_back(i);
+                                  }
+                              }, [list] { list->clear(); }});
+        benchmarks.push_back({"FixedList.iterate", Elements, [list] {
+                                  std::uint64_t sum = 0;
+                                  for (std::uint64_t value: *list) {
+                                      sum += value;
+                                  }
+                                  keep(sum);
+                              }, fillList});
+        benchmarks.push_back({"FixedList.pop_front", Elements, [list] {
+                                  for (std::size_t i = 0; i < Elements; ++i) {
+                                      list->pop_front();
+                                  }
+                              }, fillList});
+
+        auto string = std::make_shared<ESTL::RTString>(Elements);
+        benchmarks.push_back({"FixedString.push_back", Elements, [string] {
+                                  for (std::size_t i = 0; i < Elements; ++i) {
+                                      string->push_back(static_cast<char>('a' + i % 26));
+                                  }
+                              }, [string] { string->clear(); }});
+        // 16-character pieces, one operation each
+        benchmarks.push_back({"FixedString.append", Elements / 16, [string] {
+                                  for (std::size_t i = 0; i < Elements / 16; ++i) {
+                                      string->append("abcdefghijklmnop");
+                                  }
+                              }, [string] { string->clear(); }});
+        auto text = std::make_shared<ESTL::RTString>(Elements);
+        for (std::size_t i = 0; i + 1 < Elements / 16; ++i) {
+            text->append("abcdefghijklmnop");
+        }
+        text->append("needle!");
+        benchmarks.push_back({"FixedString.find", 16, [text] {
+                                  for (int i = 0; i < 16; ++i) {
+                                      keep(text->find("needle"));
+                                  }
+                              }, nullptr});
+    }
+}// namespace perf
@@ -0,0 +1,54 @@
+//
+// perf-check benchmarks - FixedUnorderedMap.
+//
+#include "../FixedUnorderedMap.hpp"
+#include "Perf.hpp"
+#include <memory>
+
+namespace perf {
+    void addUnorderedBenchmarks(std::vector<Benchmark> &benchmarks) {
+        auto keys = std::make_shared<std::vector<std::uint64_t>>(shuffledKeys());
+        auto map = std::make_shared<ESTL::RTMap<std::uint64_t, std::uint64_t>>(Elements, Elements / 2);
+        auto fill = [map, keys] {
+            map->clear();
+            for (std::uint64_t key: *keys) {
+                map->insert(key, key);
+            }
+        };
+        auto find = [map, keys] {
+            for (std::uint64_t key: *keys) {
+                keep(map->find(key));
+            }
+        };
+        // Reads only need the map full - refilled only after a benchmark emptied it
+        auto filled = [map, fill] {
+            if (map->size() != Elements) {
+                fill();
+            }
+        };
+
+        benchmarks.push_back({"FixedUnorderedMap.insert", Elements, [map, keys] {
+                                  for (std::uint64_t key: *keys) {
+                                      map->insert(key, key);
+                                  }
+                              }, [map] { map->clear(); }});
+        benchmarks.push_back({"FixedUnorderedMap.find", Elements, find, filled});
+        benchmarks.push_back({"FixedUnorderedMap.insert_or_assign", Elements, [map, keys] {
+                                  for (std::uint64_t key: *keys) {
+                                      map->insert_or_assign(key, key + 1);
+                                  }
+                              }, filled});
+        benchmarks.push_back({"FixedUnorderedMap.erase", Elements, [map, keys] {
+                                  for (std::uint64_t key: *keys) {
+                                      map->erase(key);
+                                  }
+                              }, fill});
+        benchmarks.push_back({"FixedUnorderedMap.iterate", Elements, [map] {
+                                  std::uint64_t sum = 0;
+                                  for (auto it = map->begin(); it != map->end(); ++it) {
+                                      sum += (*it).second;
+                                  }
+                                  keep(sum);
+                              }, filled});
+    }
+}// namespace perf
@@ -0,0 +1,206 @@
+//
+// estl_perfsuite - runs the perf-check benchmarks and compares their throughput with a stored baseline.
+//
+// Usage: estl_perfsuite [--baseline FILE] [--threshold T] [--write-baseline FILE] [--filter TEXT]
+//                       [--repetitions N] [--min-time-ms MS]
+//   Each benchmark is timed --repetitions times for at least --min-time-ms each and keeps its best run, which is
+//   the least disturbed by the rest of the machine. With --baseline the exit status is 1 when any benchmark runs
+//   slower than (1 - T) times its baseline throughput on three measurements in a row. --write-baseline stores the
+//   results as a new baseline.
+//
+#include "Perf.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+namespace {
+    using namespace perf;
+
+    struct Options {
+        const char *baseline = nullptr;
+        const char *writeBaseline = nullptr;
+        const char *filter = nullptr;
+        double threshold = 0.2;
+        unsigned repetitions = 5;
+        double minTimeMs = 20;
+    };
+
+    int usage() {
+        std::fprintf(stderr, "usage: estl_perfsuite [--baseline FILE] [--threshold T] [--write-baseline FILE]\n"
+                             "                      [--filter TEXT] [--repetitions N] [--min-time-ms MS]\n");
+        return 2;
+    }
+
+    // Best throughput, in operations per second, of options.repetitions runs
+    double measure(const Benchmark &benchmark, const Options &options) {
+        using Clock = std::chrono::steady_clock;
+        double best = 0;
+        for (unsigned repetition = 0; repetition <= options.repetitions; ++repetition) {
+            double elapsedNs = 0;
+            std::size_t operations = 0;
+            do {
+                if (benchmark.setup) {
+                    benchmark.setup();
+                }
+                auto start = Clock::now();
+                benchmark.body();
+                elapsedNs += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+                operations += benchmark.operations;
+            } while (elapsedNs < options.minTimeMs * 1e6);
+            // The first run only warms caches and branch predictors
+            if (repetition > 0) {
+                best = std::max(best, operations / elapsedNs * 1e9);
+            }
+        }
+        return best;
+    }
+
+    /**
+     * Reads the "name": number pairs of a baseline file.
+     * Only the flat layout written by writeBaseline() is understood - keys whose value is not a number are skipped.
+     */
+    bool readBaseline(const char *path, std::map<std::string, double> &baseline) {
+        std::ifstream in(path);
+        if (! in) {
+            return false;
+        }
+        std::stringstream buffer;
+        buffer << in.rdbuf();
+        const std::string text = buffer.str();
+        std::size_t pos = 0;
+        while ((pos = text.find('"', pos)) != std::string::npos) {
+            std::size_t end = text.find('"', pos + 1);
+            if (end == std::string::npos) {
+                return false;
+            }
+            std::string key = text.substr(pos + 1, end - pos - 1);
+            pos = text.find_first_not_of(" \t\r\n", end + 1);
+            if (pos == std::string::npos) {
+                break;
+            }
+            if (text[pos] != ':') {
+                continue;
+            }
+            const std::size_t start = text.find_first_not_of(" \t\r\n", pos + 1);
+            if (start == std::string::npos) {
+                break;
+            }
+            const char *value = text.c_str() + start;
+            char *parsed = nullptr;
+            double number = std::strtod(value, &parsed);
+            if (parsed != value) {
+                baseline[key] = number;
+            }
+            pos = static_cast<std::size_t>(parsed != value ? parsed - text.c_str() : pos + 1);
+        }
+        return true;
+    }
+
+    bool writeBaseline(const char *path, const std::vector<std::pair<std::string, double>> &results) {
+        std::ofstream out(path);
+        if (! out) {
+            return false;
+        }
+        out << "{\n  \"unit\": \"operations per second\",\n  \"benchmarks\": {\n";
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            char number[32];
+            std::snprintf(number, sizeof(number), "%.0f", results[i].second);
+            out << "    \"" << results[i].first << "\": " << number << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+        out << "  }\n}\n";
+        return static_cast<bool>(out);
+    }
+}// namespace
+
+int main(int argc, char **argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        if (i + 1 >= argc) {
+            return usage();
+        }
+        const char *flag = argv[i];
+        const char *value = argv[++i];
+        if (! std::strcmp(flag, "--baseline")) {
+            options.baseline = value;
+        } else if (! std::strcmp(flag, "--write-baseline")) {
+            options.writeBaseline = value;
+        } else if (! std::strcmp(flag, "--filter")) {
+            options.filter = value;
+        } else if (! std::strcmp(flag, "--threshold")) {
+            options.threshold = std::strtod(value, nullptr);
+        } else if (! std::strcmp(flag, "--repetitions")) {
+            options.repetitions = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+        } else if (! std::strcmp(flag, "--min-time-ms")) {
+            options.minTimeMs = std::strtod(value, nullptr);
+        } else {
+            return usage();
+        }
+    }
+    if (! (options.threshold >= 0 && options.threshold < 1) || ! options.repetitions) {
+        return usage();
+    }
+
+    std::map<std::string, double> baseline;
+    if (options.baseline && ! readBaseline(options.baseline, baseline)) {
+        std::fprintf(stderr, "estl_perfsuite: cannot read baseline %s\n", options.baseline);
+        return 2;
+    }
+
+    std::vector<Benchmark> benchmarks;
+    addSequenceBenchmarks(benchmarks);
+    addUnorderedBenchmarks(benchmarks);
+    addOrderedBenchmarks(benchmarks);
+
+    std::printf("%-36s %16s %16s %9s  %s\n", "benchmark", "baseline ops/s", "current ops/s", "change", "status");
+    std::vector<std::pair<std::string, double>> results;
+    std::size_t regressions = 0;
+    for (const Benchmark &benchmark: benchmarks) {
+        if (options.filter && benchmark.name.find(options.filter) == std::string::npos) {
+            continue;
+        }
+        double current = measure(benchmark, options);
+        auto found = baseline.find(benchmark.name);
+        // A miss is measured again before it counts - one stall of the machine is not a regression
+        for (int retry = 0; retry < 2 && found != baseline.end() && current < found->second * (1 - options.threshold);
+             ++retry) {
+            current = std::max(current, measure(benchmark, options));
+        }
+        results.emplace_back(benchmark.name, current);
+        if (found == baseline.end() || ! (found->second > 0)) {
+            std::printf("%-36s %16s %16.0f %9s  %s\n", benchmark.name.c_str(), "-", current, "-",
+                        options.baseline ? "new" : "");
+        } else {
+            const double change = current / found->second - 1;
+            const bool regressed = current < found->second * (1 - options.threshold);
+            regressions += regressed ? 1 : 0;
+            std::printf("%-36s %16.0f %16.0f %+8.1f%%  %s\n", benchmark.name.c_str(), found->second, current,
+                        change * 100, regressed ? "REGRESSED" : "ok");
+            baseline.erase(found);
+        }
+        std::fflush(stdout);
+    }
+    // Baseline entries no longer in the suite, unless filtered out on purpose
+    if (! options.filter) {
+        for (const auto &missing: baseline) {
+            std::printf("%-36s %16.0f %16s %9s  %s\n", missing.first.c_str(), missing.second, "-", "-", "missing");
+        }
+    }
+
+    if (options.writeBaseline) {
+        if (! writeBaseline(options.writeBaseline, results)) {
+            std::fprintf(stderr, "estl_perfsuite: cannot write %s\n", options.writeBaseline);
+            return 2;
+        }
+        std::printf("baseline written to %s\n", options.writeBaseline);
+    }
+    if (regressions) {
+        std::printf("%zu benchmark(s) regressed by more than %.0f%%\n", regressions, options.threshold * 100);
+        return 1;
+    }
+    return 0;
+}
@@ -2,7 +2,10 @@
 // Created by SnirN on 3/26/2025.
 //
 #include "../FixedMap/BalancedTreeFactory.hpp"
+#include "../FixedMap/FixedMap.hpp"
 #include <gtest/gtest.h>
+#include <map>
+#include <random>
 #include <thread>
 #include <vector>
 #include <string>
@@ -22,6 +25,7 @@ namespace ESTL {
         }
 
         void TearDown() override {
+          tree.reset();// the tree destroys its entries, so it goes before the buffer
           delete [] buffer;
         }
     };
@@ -167,8 +171,89 @@ namespace ESTL {
         EXPECT_EQ(tree->size(), 0);
     }
 
+    TEST_P(BalancedTreeTest, LowerBound) {
+        for (int i = 0; i < 100; i += 10) {
+            EXPECT_TRUE(tree->insert(i, "value" + std::to_string(i)));
+        }
+        EXPECT_EQ(tree->lowerBound(-5)->key, 0);
+        EXPECT_EQ(tree->lowerBound(30)->key, 30);
+        EXPECT_EQ(tree->lowerBound(31)->key, 40);
+        EXPECT_EQ(tree->lowerBound(91), nullptr);
+    }
+
+    TEST_P(BalancedTreeTest, RandomInsertEraseMatchesStdMap) {
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<int> keyDist(0, 2000);
+        std::map<int, std::string> reference;
+
+        for (int i = 0; i < 20000; ++i) {
+            int key = keyDist(rng);
+            if (rng() % 3 == 0) {
+                EXPECT_EQ(tree->erase(key), reference.erase(key) == 1);
+            } else {
+                EXPECT_EQ(tree->insert(key, std::to_string(key)), reference.emplace(key, std::to_string(key)).second);
+            }
+        }
+        ASSERT_EQ(tree->size(), reference.size());
+
+        // Forward and backward walks visit the same keys as the reference
+        auto expected = reference.begin();
+        for (auto node = tree->minimum(); node != nullptr; node = tree->next(node), ++expected) {
+            ASSERT_NE(expected, reference.end());
+            EXPECT_EQ(node->key, expected->first);
+            EXPECT_EQ(node->value, expected->second);
+        }
+        EXPECT_EQ(expected, reference.end());
+
+        auto reverse = reference.rbegin();
+        for (auto node = tree->prev(nullptr); node != nullptr; node = tree->prev(node), ++reverse) {
+            ASSERT_NE(reverse, reference.rend());
+            EXPECT_EQ(node->key, reverse->first);
+        }
+        EXPECT_EQ(reverse, reference.rend());
+
+        for (int key = 0; key <= 2000; ++key) {
+            EXPECT_EQ(tree->find(key) != nullptr, reference.count(key) == 1);
+        }
+    }
+
+    TEST_P(BalancedTreeTest, EmptyTracksContents) {
+        EXPECT_TRUE(tree->insert(1, "one"));
+        EXPECT_EQ(tree->size(), 1);
+        EXPECT_FALSE(tree->empty());
+        EXPECT_TRUE(tree->erase(1));
+        EXPECT_TRUE(tree->empty());
+        for (int key = 0; key < 500; ++key) {
+            tree->insert(key, std::to_string(key));
+        }
+        EXPECT_FALSE(tree->empty());
+        tree->clear();
+        EXPECT_TRUE(tree->empty());
+    }
+
+    // The split target check reads empty() - a B+ tree holding one key must be rejected
+    TEST(BPlusTreeSplitTest, RejectsNonEmptyTarget) {
+        RTMap<int, int> map(64, TreeType::BPlus);
+        RTMap<int, int> right(64, TreeType::BPlus);
+        for (int key = 0; key < 20; ++key) {
+            map.insert(key, key);
+        }
+        right.insert(100, 100);
+        EXPECT_FALSE(right.empty());
+        EXPECT_THROW(map.split(10, right), std::invalid_argument);
+        EXPECT_EQ(map.size(), 20);
+
+        right.erase(100);
+        EXPECT_TRUE(right.empty());
+        map.split(10, right);
+        EXPECT_EQ(map.size(), 10);
+        EXPECT_EQ(right.size(), 10);
+        EXPECT_NE(right.find(15), nullptr);
+        EXPECT_EQ(map.find(15), nullptr);
+    }
+
     INSTANTIATE_TEST_SUITE_P(TreeTypes, BalancedTreeTest, ::testing::Values
-                             (TreeType::RedBlack, TreeType::AVL));
+                             (TreeType::RedBlack, TreeType::AVL, TreeType::BPlus));
 
 
 }// namespace ESTL
\ No newline at end of file
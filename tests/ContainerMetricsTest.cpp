@@ -0,0 +1,183 @@
+#include "../FixedList.hpp"
+#include "../FixedUnorderedMap.hpp"
+#include "../FixedVector.hpp"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+namespace ESTL {
+    // Sends every key to bucket key % 8, so the test controls the chains
+    struct ModuloHash {
+        std::size_t operator()(int key) const { return static_cast<std::size_t>(key) % 8; }
+    };
+
+    TEST(ContainerMetricsTest, UnorderedMapChains) {
+        RTMap<int, int, ModuloHash> map(8, 4);
+        for (int key: {0, 8, 16, 1}) {
+            ASSERT_TRUE(map.insert(key, key));
+        }
+
+        ContainerMetrics metrics = map.metrics();
+        EXPECT_EQ(metrics.size, 4u);
+        EXPECT_EQ(metrics.capacity, 8u);
+        EXPECT_DOUBLE_EQ(metrics.loadFactor, 0.5);
+        EXPECT_EQ(metrics.maxChainLength, 3u);
+        EXPECT_DOUBLE_EQ(metrics.averageChainLength, 2.0);
+        EXPECT_EQ(metrics.poolCapacity, 4u);
+        EXPECT_EQ(metrics.poolInUse, 2u);
+
+        ASSERT_TRUE(map.erase(16));
+        ASSERT_TRUE(map.erase(8));
+        metrics = map.metrics();
+        EXPECT_EQ(metrics.maxChainLength, 1u);
+        EXPECT_EQ(metrics.poolInUse, 0u);
+        EXPECT_EQ(metrics.countersEnabled, bool(ESTL_ENABLE_METRICS));
+        if (metrics.countersEnabled) {
+            EXPECT_EQ(metrics.poolHighWater, 2u);
+            EXPECT_GT(metrics.lockWait.acquisitions, 0u);
+        } else {
+            EXPECT_EQ(metrics.poolHighWater, 0u);
+            EXPECT_EQ(metrics.lockWait.acquisitions, 0u);
+        }
+    }
+
+    TEST(ContainerMetricsTest, EmptyUnorderedMap) {
+        CTMap<int, int, 16> map;
+        ContainerMetrics metrics = map.metrics();
+        EXPECT_EQ(metrics.size, 0u);
+        EXPECT_EQ(metrics.maxChainLength, 0u);
+        EXPECT_DOUBLE_EQ(metrics.averageChainLength, 0.0);
+        EXPECT_EQ(metrics.poolCapacity, 8u);
+    }
+
+    TEST(ContainerMetricsTest, VectorHighWater) {
+        RTVector<int> vector(10);
+        for (int i = 0; i < 6; ++i) {
+            vector.push_back(i);
+        }
+        vector.pop_back();
+        vector.pop_back();
+
+        ContainerMetrics metrics = vector.metrics();
+        EXPECT_EQ(metrics.size, 4u);
+        EXPECT_EQ(metrics.poolInUse, 4u);
+        EXPECT_EQ(metrics.poolCapacity, 10u);
+        EXPECT_DOUBLE_EQ(metrics.loadFactor, 0.4);
+        EXPECT_EQ(metrics.poolHighWater, metrics.countersEnabled ? 6u : 0u);
+    }
+
+    TEST(ContainerMetricsTest, ListHighWater) {
+        RTList<int> list(8);
+        for (int i = 0; i < 5; ++i) {
+            list.push_back(i);
+        }
+        list.pop_front();
+        list.clear();
+        list.push_front(1);
+
+        ContainerMetrics metrics = list.metrics();
+        EXPECT_EQ(metrics.size, 1u);
+        EXPECT_EQ(metrics.poolInUse, 1u);
+        EXPECT_EQ(metrics.poolCapacity, 8u);
+        EXPECT_EQ(metrics.poolHighWater, metrics.countersEnabled ? 5u : 0u);
+    }
+
+    TEST(ContainerMetricsTest, LockWaitHistogramBuckets) {
+        LockWaitHistogram histogram;
+        histogram.record(100);    // below 512 ns
+        histogram.record(511);
+        histogram.record(512);    // [512, 1024)
+        histogram.record(5000000);// [4.19 ms, 8.39 ms)
+        histogram.record(UINT64_MAX / 2);
+
+        EXPECT_EQ(histogram.contended, 5u);
+        EXPECT_EQ(histogram.maxWaitNs, UINT64_MAX / 2);
+        EXPECT_EQ(histogram.buckets[0], 2u);
+        EXPECT_EQ(histogram.buckets[1], 1u);
+        EXPECT_EQ(histogram.buckets[14], 1u);
+        EXPECT_EQ(histogram.buckets[LockWaitHistogram::Buckets - 1], 1u);
+        EXPECT_EQ(LockWaitHistogram::upperBoundNs(0), 512u);
+        EXPECT_EQ(LockWaitHistogram::upperBoundNs(LockWaitHistogram::Buckets - 1), UINT64_MAX);
+    }
+
+#if ENABLE_THREAD_SAFETY
+    TEST(ContainerMetricsTest, LockWaitsUnderContention) {
+        RTVector<int> vector(40000);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&vector] {
+                for (int i = 0; i < 10000; ++i) {
+                    vector.push_back(i);
+                }
+            });
+        }
+        for (auto &thread: threads) {
+            thread.join();
+        }
+
+        ContainerMetrics metrics = vector.metrics();
+        EXPECT_EQ(metrics.size, 40000u);
+        if (metrics.countersEnabled) {
+            // push_back locks once per element, metrics() once more
+            EXPECT_EQ(metrics.lockWait.acquisitions, 40001u);
+            EXPECT_LE(metrics.lockWait.contended, metrics.lockWait.acquisitions);
+            std::uint64_t bucketed = 0;
+            for (std::uint64_t count: metrics.lockWait.buckets) {
+                bucketed += count;
+            }
+            EXPECT_EQ(bucketed, metrics.lockWait.contended);
+        }
+    }
+#endif
+    TEST(HashDiagnosticsTest, ChainHistogram) {
+        RTMap<int, int, ModuloHash> map(8, 4);
+        for (int key: {0, 8, 16, 1, 9, 2}) {
+            ASSERT_TRUE(map.insert(key, key));
+        }
+
+        HashDiagnostics report = map.diagnostics();
+        EXPECT_EQ(report.size, 6u);
+        EXPECT_EQ(report.capacity, 8u);
+        EXPECT_EQ(report.primaryInUse, 3u);
+        EXPECT_EQ(report.poolInUse, 3u);
+        ASSERT_EQ(report.chainLengths.size(), 4u);
+        EXPECT_EQ(report.chainLengths[0], 5u);
+        EXPECT_EQ(report.chainLengths[1], 1u);
+        EXPECT_EQ(report.chainLengths[2], 1u);
+        EXPECT_EQ(report.chainLengths[3], 1u);
+        // expected 0.75 per bucket: (5 * 0.5625 + 0.0625 + 1.5625 + 5.0625) / 0.75
+        EXPECT_NEAR(report.chiSquared, 12.667, 1e-3);
+        EXPECT_EQ(report.degreesOfFreedom, 7u);
+        EXPECT_EQ(report.recommendedCapacity, 8u);
+        EXPECT_LE(report.recommendedPoolSize, 6u);
+    }
+
+    TEST(HashDiagnosticsTest, UniformHashScoresNearOne) {
+        RTMap<int, int> map(4096, 4096);
+        std::uint64_t state = 12345;
+        for (int i = 0; i < 3000; ++i) {
+            state = state * 6364136223846793005ull + 1442695040888963407ull;
+            map.insert(static_cast<int>(state >> 33), i);
+        }
+        HashDiagnostics report = map.diagnostics(0.5);
+        EXPECT_NEAR(report.chiSquaredRatio, 1.0, 0.15);
+        EXPECT_EQ(report.recommendedCapacity, (report.size * 2));
+        // ~ n - m(1 - e^(-n/m)) = 3000 - 6000 * 0.2212 = 673 expected overflow, plus margin
+        EXPECT_GT(report.recommendedPoolSize, 673u);
+        EXPECT_LT(report.recommendedPoolSize, 800u);
+    }
+
+    TEST(HashDiagnosticsTest, ClusteredHashIsFlagged) {
+        RTMap<int, int, ModuloHash> map(64, 256);
+        for (int i = 0; i < 200; ++i) {
+            map.insert(i * 8, i);// every key in bucket 0
+        }
+        HashDiagnostics report = map.diagnostics();
+        EXPECT_EQ(report.primaryInUse, 1u);
+        EXPECT_EQ(report.chainLengths.back(), 1u);
+        EXPECT_EQ(report.chainLengths.size(), 201u);
+        EXPECT_GT(report.chiSquaredRatio, 50.0);
+        EXPECT_EQ(report.recommendedPoolSize, 200u);// capped at the key count
+        EXPECT_THROW(map.diagnostics(0.0), std::invalid_argument);
+    }
+}// namespace ESTL
@@ -261,4 +261,151 @@ TYPED_TEST(FixedMapTest, MultiThreads) {
 }
 #endif
 
+TEST(FixedMapResourceTest, NodesFromArena) {
+  ArenaResource arena(1 << 20);
+  {
+    RTMap<int, int> map(1000, TreeType::AVL, &arena);
+    RTNodePool<int, int> pool(1000, &arena);
+    FixedMap<int, int> shared(pool, TreeType::RedBlack);
+    for (int i = 0; i < 1000; ++i) {
+      ASSERT_TRUE(map.insert(i, i));
+      ASSERT_TRUE(shared.insert(i, -i));
+    }
+    EXPECT_EQ(map.resource(), &arena);
+    EXPECT_GE(arena.used(), 2000 * sizeof(TreeNode<int, int>));
+
+    const std::size_t used = arena.used();
+    RTMap<int, int> listed({{1, 10}, {2, 20}}, 8, TreeType::RedBlack, &arena);
+    EXPECT_EQ(listed.resource(), &arena);
+    EXPECT_GE(arena.used(), used + 8 * sizeof(TreeNode<int, int>));
+    EXPECT_EQ(*listed.find(2), 20);
+  }
+  arena.reset();
+  EXPECT_EQ(arena.used(), 0u);
+}
+
+TEST(FixedMapMoveTest, MoveTakesTheTree) {
+  RTMap<int, int> map(64, TreeType::AVL);
+  for (int i = 0; i < 40; ++i) {
+    map.insert(i, i * 2);
+  }
+  const int *value = map.find(7);
+  RTMap<int, int> moved(std::move(map));
+  EXPECT_EQ(moved.find(7), value);
+  EXPECT_EQ(moved.size(), 40u);
+
+  RTMap<int, int> target(4);
+  target.insert(100, 1);
+  target = std::move(moved);
+  EXPECT_EQ(target.size(), 40u);
+  EXPECT_EQ(target.find(100), nullptr);
+  EXPECT_EQ(*target.find(39), 78);
+  target.insert(41, 1);
+  EXPECT_EQ(target.capacity(), 64u);
+}
+
+class FixedMapMetricsTest : public ::testing::TestWithParam<TreeType> {};
+
+TEST_P(FixedMapMetricsTest, ShapeAndCounters) {
+  // Spare capacity for the persistent engine's path copies
+  RTMap<int, int> map(1000, GetParam());
+  for (int i = 0; i < 600; ++i) {
+    ASSERT_TRUE(map.insert(i, i));// ascending keys keep the engines rebalancing
+  }
+  for (int i = 0; i < 300; ++i) {
+    ASSERT_TRUE(map.erase(i));
+  }
+
+  ContainerMetrics metrics = map.metrics();
+  EXPECT_EQ(metrics.size, 300u);
+  EXPECT_EQ(metrics.capacity, 1000u);
+  EXPECT_DOUBLE_EQ(metrics.loadFactor, 0.3);
+  EXPECT_EQ(metrics.poolCapacity, 1000u);
+  EXPECT_GE(metrics.poolInUse, 300u);// the persistent engine may hold retired nodes
+  EXPECT_GE(metrics.treeHeight, 2u);
+  EXPECT_LE(metrics.treeHeight, GetParam() == TreeType::BPlus ? 4u : 20u);
+  if (metrics.countersEnabled) {
+    if (GetParam() == TreeType::Persistent) {
+      EXPECT_GE(metrics.poolHighWater, 600u);
+    } else {
+      EXPECT_EQ(metrics.poolHighWater, 600u);
+      EXPECT_EQ(metrics.poolInUse, 300u);
+    }
+    EXPECT_GT(metrics.rebalances, 0u);
+    if (GetParam() != TreeType::BPlus) {
+      EXPECT_GT(metrics.rotations, 0u);
+    }
+    EXPECT_GT(metrics.lockWait.acquisitions, 900u);
+  } else {
+    EXPECT_EQ(metrics.poolHighWater, 0u);
+    EXPECT_EQ(metrics.rotations, 0u);
+    EXPECT_EQ(metrics.rebalances, 0u);
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(Engines, FixedMapMetricsTest,
+                         ::testing::Values(TreeType::RedBlack, TreeType::AVL, TreeType::BPlus, TreeType::Persistent));
+
+namespace {
+// Value without a default constructor that counts its live instances
+struct Tracked {
+  static int live;
+  int value;
+
+  explicit Tracked(int v) : value(v) { ++live; }
+  Tracked(const Tracked &other) : value(other.value) { ++live; }
+  ~Tracked() { --live; }
+};
+int Tracked::live = 0;
+} // namespace
+
+class FixedMapStorageTest : public ::testing::TestWithParam<TreeType> {};
+
+TEST_P(FixedMapStorageTest, EntriesLiveOnlyWhileInTree) {
+  {
+    RTMap<int, Tracked> map(64, GetParam());
+    EXPECT_EQ(Tracked::live, 0); // free nodes hold no entries
+    for (int key = 0; key < 20; ++key) {
+      ASSERT_TRUE(map.insert(key, Tracked(key)));
+    }
+    EXPECT_FALSE(map.insert(3, Tracked(-3)));
+    for (int key = 0; key < 20; key += 4) {
+      ASSERT_TRUE(map.erase(key));
+    }
+    ASSERT_NE(map.find(7), nullptr);
+    EXPECT_EQ(map.find(7)->value, 7);
+    if (GetParam() != TreeType::Persistent) { // retired versions keep their copies a while longer
+      EXPECT_EQ(Tracked::live, 15);
+    }
+    map.clear();
+    if (GetParam() != TreeType::Persistent) {
+      EXPECT_EQ(Tracked::live, 0);
+    }
+    map.insert(1, Tracked(1));
+  }
+  EXPECT_EQ(Tracked::live, 0);
+
+  {
+    CTMap<int, Tracked, 32> map(GetParam());
+    for (int key = 0; key < 10; ++key) {
+      map.insert(key, Tracked(key));
+    }
+  }
+  EXPECT_EQ(Tracked::live, 0);
+
+  if (GetParam() == TreeType::RedBlack || GetParam() == TreeType::AVL) {
+    RTNodePool<int, Tracked> pool(32);
+    {
+      FixedMap<int, Tracked> shared(pool, GetParam());
+      shared.insert(1, Tracked(1));
+      shared.insert(2, Tracked(2));
+    }
+    EXPECT_EQ(Tracked::live, 2); // nodes of a shared pool stay with the pool
+  }
+  EXPECT_EQ(Tracked::live, 0);
+}
+
+INSTANTIATE_TEST_SUITE_P(Engines, FixedMapStorageTest,
+                         ::testing::Values(TreeType::RedBlack, TreeType::AVL, TreeType::BPlus, TreeType::Persistent));
+
 } // namespace ESTL
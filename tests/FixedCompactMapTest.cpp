@@ -0,0 +1,263 @@
+#include "../FixedCompactMap.hpp"
+#include "../FixedUnorderedMap.hpp"
+#include <gtest/gtest.h>
+#include <map>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace ESTL {
+    namespace {
+        template<typename Map>
+        std::vector<std::pair<int, int>> ordered(Map &map) {
+            std::vector<std::pair<int, int>> seen;
+            for (auto it = map.begin(); it != map.end(); ++it) {
+                seen.emplace_back((*it).first, (*it).second);
+            }
+            return seen;
+        }
+
+        // Every key lands on the same home slot - exercises long probe runs and backward-shift deletion
+        struct ConstantHash {
+            std::size_t operator()(int) const { return 0; }
+        };
+
+        // Value without a default constructor that counts its live instances
+        struct Tracked {
+            static int live;
+            int value;
+
+            explicit Tracked(int v)
+                : value(v) {
+                ++live;
+            }
+            Tracked(const Tracked &other)
+                : value(other.value) {
+                ++live;
+            }
+            Tracked(Tracked &&other) noexcept
+                : value(other.value) {
+                ++live;
+            }
+            Tracked &operator=(const Tracked &) = default;
+            ~Tracked() { --live; }
+        };
+        int Tracked::live = 0;
+
+        // Heap resource that fails its failAt-th allocation and records what is still outstanding
+        class FailingResource : public MemoryResource {
+        public:
+            std::map<void *, std::size_t> live;
+            int allocations = 0;
+            int failAt;
+
+            explicit FailingResource(int failAt)
+                : failAt(failAt) {}
+
+            void *allocate(std::size_t bytes, std::size_t alignment) override {
+                if (++allocations == failAt) {
+                    throw std::bad_alloc();
+                }
+                void *pointer = defaultResource()->allocate(bytes, alignment);
+                live[pointer] = bytes;
+                return pointer;
+            }
+
+            void deallocate(void *pointer, std::size_t bytes, std::size_t alignment) override {
+                live.erase(pointer);
+                defaultResource()->deallocate(pointer, bytes, alignment);
+            }
+        };
+    }// namespace
+
+    template<typename T>
+    class FixedCompactMapTest : public ::testing::Test {
+    public:
+        T map;
+    };
+
+    class CTCompactMap16 : public CTCompactMap<int, int, 16> {};
+
+    class RTCompactMap16 : public RTCompactMap<int, int> {
+    public:
+        RTCompactMap16()
+            : RTCompactMap<int, int>(16) {}
+    };
+
+    using MapTypes = ::testing::Types<CTCompactMap16, RTCompactMap16>;
+    TYPED_TEST_SUITE(FixedCompactMapTest, MapTypes);
+
+    TYPED_TEST(FixedCompactMapTest, InsertFindAndIterateInInsertionOrder) {
+        EXPECT_TRUE(this->map.empty());
+        EXPECT_TRUE(this->map.insert(30, 3));
+        EXPECT_TRUE(this->map.insert(10, 1));
+        EXPECT_TRUE(this->map.insert(20, 2));
+        EXPECT_FALSE(this->map.insert(10, 100));
+        EXPECT_EQ(this->map.size(), 3u);
+        ASSERT_NE(this->map.find(10), nullptr);
+        EXPECT_EQ(*this->map.find(10), 1);
+        EXPECT_EQ(this->map.find(40), nullptr);
+        EXPECT_EQ(ordered(this->map), (std::vector<std::pair<int, int>>{{30, 3}, {10, 1}, {20, 2}}));
+    }
+
+    TYPED_TEST(FixedCompactMapTest, AssignKeepsPositionAndEraseKeepsOrder) {
+        for (int key = 0; key < 6; ++key) {
+            this->map.insert(key, key);
+        }
+        EXPECT_FALSE(this->map.insert_or_assign(2, 20));
+        this->map[4] = 40;
+        EXPECT_TRUE(this->map.erase(1));
+        EXPECT_TRUE(this->map.erase(5));
+        EXPECT_FALSE(this->map.erase(5));
+        EXPECT_FALSE(this->map.contains(1));
+        EXPECT_EQ(ordered(this->map), (std::vector<std::pair<int, int>>{{0, 0}, {2, 20}, {3, 3}, {4, 40}}));
+        // A re-inserted key goes to the end
+        this->map.insert(1, 10);
+        EXPECT_EQ(ordered(this->map), (std::vector<std::pair<int, int>>{{0, 0}, {2, 20}, {3, 3}, {4, 40}, {1, 10}}));
+    }
+
+    TYPED_TEST(FixedCompactMapTest, InsertCompactsTombstonesWhenEntriesRunOut) {
+        for (int key = 0; key < 16; ++key) {
+            this->map.insert(key, key);
+        }
+        EXPECT_THROW(this->map.insert(16, 16), std::out_of_range);
+        // Erased in the middle only - trailing tombstones would be given back without compaction
+        for (int key = 0; key < 15; key += 3) {
+            this->map.erase(key);
+        }
+        EXPECT_EQ(this->map.metrics().poolInUse, 16u);
+        EXPECT_TRUE(this->map.insert(100, 100));
+        EXPECT_EQ(this->map.metrics().poolInUse, this->map.size());
+
+        std::vector<std::pair<int, int>> expected;
+        for (int key = 0; key < 16; ++key) {
+            if (key % 3 || key == 15) {
+                expected.emplace_back(key, key);
+            }
+        }
+        expected.emplace_back(100, 100);
+        EXPECT_EQ(ordered(this->map), expected);
+        for (const auto &entry: expected) {
+            ASSERT_NE(this->map.find(entry.first), nullptr);
+            EXPECT_EQ(*this->map.find(entry.first), entry.second);
+        }
+    }
+
+    TYPED_TEST(FixedCompactMapTest, ChurnAtCapacity) {
+        for (int key = 0; key < 16; ++key) {
+            this->map.insert(key, key);
+        }
+        for (int key = 16; key < 1000; ++key) {
+            ASSERT_TRUE(this->map.erase(key - 16));
+            ASSERT_TRUE(this->map.insert(key, key));
+        }
+        EXPECT_EQ(this->map.size(), 16u);
+        std::vector<std::pair<int, int>> expected;
+        for (int key = 984; key < 1000; ++key) {
+            expected.emplace_back(key, key);
+        }
+        EXPECT_EQ(ordered(this->map), expected);
+    }
+
+    TYPED_TEST(FixedCompactMapTest, ClearAndShrinkToFit) {
+        for (int key = 0; key < 8; ++key) {
+            this->map.insert(key, key);
+        }
+        this->map.erase(7);// trailing tombstones are given back at once
+        EXPECT_EQ(this->map.metrics().poolInUse, 7u);
+        this->map.erase(2);
+        this->map.shrink_to_fit();
+        EXPECT_EQ(this->map.metrics().poolInUse, 6u);
+        EXPECT_EQ(ordered(this->map),
+                  (std::vector<std::pair<int, int>>{{0, 0}, {1, 1}, {3, 3}, {4, 4}, {5, 5}, {6, 6}}));
+        this->map.clear();
+        EXPECT_TRUE(this->map.empty());
+        EXPECT_TRUE(this->map.begin() == this->map.end());
+        this->map.insert(9, 9);
+        EXPECT_EQ(ordered(this->map), (std::vector<std::pair<int, int>>{{9, 9}}));
+    }
+
+    TEST(FixedCompactMapProbeTest, EraseInsideCollisionRun) {
+        CTCompactMap<int, int, 32, ConstantHash> map;
+        for (int key = 0; key < 10; ++key) {
+            map.insert(key, key);
+        }
+        for (int key = 0; key < 10; key += 2) {
+            ASSERT_TRUE(map.erase(key));
+        }
+        for (int key = 0; key < 10; ++key) {
+            EXPECT_EQ(map.contains(key), key % 2 == 1) << key;
+        }
+        map.insert(4, 44);
+        ASSERT_NE(map.find(4), nullptr);
+        EXPECT_EQ(*map.find(4), 44);
+    }
+
+    TEST(FixedCompactMapProbeTest, StringKeysAndForEach) {
+        RTCompactMap<std::string, int> map(64);
+        const char *words[] = {"delta", "alpha", "charlie", "bravo"};
+        for (int i = 0; i < 4; ++i) {
+            map.insert(words[i], i);
+        }
+        std::vector<std::string> visited;
+        map.forEach([&visited](const std::string &key, int &value) {
+            visited.push_back(key);
+            value *= 10;
+        });
+        EXPECT_EQ(visited, (std::vector<std::string>{"delta", "alpha", "charlie", "bravo"}));
+        EXPECT_EQ(*map.find("charlie"), 20);
+    }
+
+    TEST(FixedCompactMapProbeTest, SmallerThanBucketLayout) {
+        static_assert(std::is_same<CompactMapIndex<1024>, std::uint16_t>::value, "small maps use 16-bit slots");
+        static_assert(std::is_same<CompactMapIndex<70000>, std::uint32_t>::value, "large maps use 32-bit slots");
+        EXPECT_LT(sizeof(CTCompactMap<int, int, 1024>), sizeof(CTMap<int, int, 1024, 512>) / 2);
+    }
+
+    TEST(FixedCompactMapStorageTest, EntriesLiveOnlyWhileInserted) {
+        {
+            CTCompactMap<int, Tracked, 8> map;
+            EXPECT_EQ(Tracked::live, 0);// unused entries hold no values
+            for (int key = 0; key < 8; ++key) {
+                ASSERT_TRUE(map.insert(key, Tracked(key)));
+            }
+            EXPECT_EQ(Tracked::live, 8);
+            ASSERT_TRUE(map.erase(2));
+            ASSERT_TRUE(map.erase(5));
+            EXPECT_EQ(Tracked::live, 6);// tombstones are destroyed at once
+            ASSERT_TRUE(map.insert(20, Tracked(20)));// compacts the tombstones away
+            EXPECT_EQ(Tracked::live, 7);
+            EXPECT_FALSE(map.insert_or_assign(3, Tracked(-3)));
+            EXPECT_EQ(map.find(3)->value, -3);
+            EXPECT_EQ(Tracked::live, 7);
+            map.clear();
+            EXPECT_EQ(Tracked::live, 0);
+            map.insert(1, Tracked(1));
+            map.insert(2, Tracked(2));
+        }
+        EXPECT_EQ(Tracked::live, 0);// the owner releases what is left
+
+        {
+            RTCompactMap<std::string, Tracked> map(4);
+            map.insert("a", Tracked(1));
+            map.insert("b", Tracked(2));
+            map.erase("a");
+            EXPECT_EQ(Tracked::live, 1);
+        }
+        EXPECT_EQ(Tracked::live, 0);
+    }
+
+    TEST(FixedCompactMapStorageTest, FailedAllocationReleasesEarlierArrays) {
+        for (int failAt = 1; failAt <= 3; ++failAt) {
+            FailingResource resource(failAt);
+            EXPECT_THROW((RTCompactMap<int, int>(64, &resource)), std::bad_alloc);
+            EXPECT_TRUE(resource.live.empty());
+        }
+        FailingResource resource(4);
+        {
+            RTCompactMap<int, int> map(64, &resource);
+            EXPECT_EQ(resource.live.size(), 3u);
+        }
+        EXPECT_TRUE(resource.live.empty());
+    }
+}// namespace ESTL
@@ -0,0 +1,223 @@
+#include "../FixedDeque.hpp"
+#include <algorithm>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ESTL {
+namespace {
+template <typename Deque> std::vector<int> contents(const Deque &deque) {
+  return std::vector<int>(deque.begin(), deque.end());
+}
+
+// Concatenation of segments() - what a writev() of them would send
+template <typename Deque> std::vector<int> gathered(Deque &deque) {
+  std::vector<int> out;
+  for (const auto &segment : deque.segments()) {
+    out.insert(out.end(), segment.data, segment.data + segment.size);
+  }
+  return out;
+}
+} // namespace
+
+template <typename T> class FixedDequeTest : public ::testing::Test {
+public:
+  T deque;
+};
+
+class CTDeque8 : public CTDeque<int, 8> {};
+
+class RTDeque8 : public RTDeque<int> {
+public:
+  RTDeque8() : RTDeque<int>(8) {}
+};
+
+using DequeTypes = ::testing::Types<CTDeque8, RTDeque8>;
+TYPED_TEST_SUITE(FixedDequeTest, DequeTypes);
+
+TYPED_TEST(FixedDequeTest, PushAndPopAtBothEnds) {
+  this->deque.push_back(2);
+  this->deque.push_back(3);
+  this->deque.push_front(1);
+  this->deque.emplace_front(0);
+  this->deque.emplace_back(4);
+  EXPECT_EQ(contents(this->deque), (std::vector<int>{0, 1, 2, 3, 4}));
+  EXPECT_EQ(this->deque.front(), 0);
+  EXPECT_EQ(this->deque.back(), 4);
+
+  this->deque.pop_front();
+  this->deque.pop_back();
+  EXPECT_EQ(contents(this->deque), (std::vector<int>{1, 2, 3}));
+  EXPECT_EQ(this->deque.size(), 3u);
+}
+
+TYPED_TEST(FixedDequeTest, OverflowAndUnderflowThrow) {
+  EXPECT_THROW(this->deque.pop_front(), std::out_of_range);
+  EXPECT_THROW(this->deque.pop_back(), std::out_of_range);
+  EXPECT_THROW(this->deque.front(), std::out_of_range);
+  for (int i = 0; i < 8; ++i) {
+    this->deque.push_back(i);
+  }
+  EXPECT_TRUE(this->deque.full());
+  EXPECT_THROW(this->deque.push_back(8), std::out_of_range);
+  EXPECT_THROW(this->deque.push_front(8), std::out_of_range);
+  EXPECT_THROW(this->deque.at(8), std::out_of_range);
+  EXPECT_EQ(this->deque.size(), 8u);
+}
+
+TYPED_TEST(FixedDequeTest, FifoWrapsAroundTheArray) {
+  int next = 0;
+  int expected = 0;
+  for (int round = 0; round < 50; ++round) {
+    while (!this->deque.full()) {
+      this->deque.push_back(next++);
+    }
+    for (int i = 0; i < 3; ++i) {
+      EXPECT_EQ(this->deque.front(), expected++);
+      this->deque.pop_front();
+    }
+  }
+  std::vector<int> want(this->deque.size());
+  std::iota(want.begin(), want.end(), expected);
+  EXPECT_EQ(contents(this->deque), want);
+  for (std::size_t i = 0; i < this->deque.size(); ++i) {
+    EXPECT_EQ(this->deque[i], expected + static_cast<int>(i));
+  }
+}
+
+TYPED_TEST(FixedDequeTest, IteratorsAreRandomAccess) {
+  for (int value : {5, 3, 7, 1}) {
+    this->deque.push_back(value);
+  }
+  this->deque.push_front(9);
+  this->deque.push_front(2);// Wraps to the end of the array
+  std::sort(this->deque.begin(), this->deque.end());
+  EXPECT_EQ(contents(this->deque), (std::vector<int>{1, 2, 3, 5, 7, 9}));
+  auto it = this->deque.begin() + 4;
+  EXPECT_EQ(*it, 7);
+  EXPECT_EQ(it[-1], 5);
+  EXPECT_EQ(this->deque.end() - it, 2);
+  typename TypeParam::const_iterator constIt = it;
+  EXPECT_EQ(*constIt, 7);
+}
+
+TYPED_TEST(FixedDequeTest, SegmentsCoverTheContentsInOrder) {
+  auto empty = this->deque.segments();
+  EXPECT_EQ(empty[0].size + empty[1].size, 0u);
+
+  for (int i = 0; i < 6; ++i) {
+    this->deque.push_back(i);
+  }
+  this->deque.consumeFront(4);
+  for (int i = 6; i < 11; ++i) {
+    this->deque.push_back(i);
+  }
+  auto runs = this->deque.segments();
+  EXPECT_EQ(runs[0].size, 4u);
+  EXPECT_EQ(runs[1].size, 3u);
+  EXPECT_EQ(gathered(this->deque), (std::vector<int>{4, 5, 6, 7, 8, 9, 10}));
+
+  auto free = this->deque.freeSegments();
+  EXPECT_EQ(free[0].size + free[1].size, 1u);
+  EXPECT_THROW(this->deque.consumeFront(8), std::out_of_range);
+  this->deque.consumeFront(7);
+  EXPECT_TRUE(this->deque.empty());
+}
+
+TYPED_TEST(FixedDequeTest, FreeSegmentsFillLikeReadv) {
+  for (int i = 0; i < 5; ++i) {
+    this->deque.push_back(i);
+  }
+  this->deque.consumeFront(3);// Head at 3, tail at 5: the free space wraps
+
+  const int incoming[] = {10, 11, 12, 13, 14, 15};
+  std::size_t copied = 0;
+  for (const auto &segment : this->deque.freeSegments()) {
+    std::memcpy(segment.data, incoming + copied, segment.size * sizeof(int));
+    copied += segment.size;
+  }
+  EXPECT_EQ(copied, 6u);
+  this->deque.commitBack(copied);
+  EXPECT_EQ(contents(this->deque), (std::vector<int>{3, 4, 10, 11, 12, 13, 14, 15}));
+  EXPECT_THROW(this->deque.commitBack(1), std::out_of_range);
+  auto none = this->deque.freeSegments();
+  EXPECT_EQ(none[0].size + none[1].size, 0u);
+}
+
+TYPED_TEST(FixedDequeTest, AppendRangeIsAllOrNothing) {
+  std::vector<int> values{1, 2, 3, 4, 5, 6};
+  this->deque.push_back(0);
+  this->deque.append_range(values.begin(), values.end());
+  EXPECT_EQ(this->deque.size(), 7u);
+  EXPECT_THROW(this->deque.append_range(values.begin(), values.begin() + 2), std::out_of_range);
+  EXPECT_EQ(this->deque.size(), 7u);
+}
+
+TEST(FixedDequeCopyMoveTest, CopiesUnwrapTheContents) {
+  CTDeque<std::string, 4> source;
+  source.push_back("b");
+  source.push_back("c");
+  source.push_front("a");// Wrapped
+
+  CTDeque<std::string, 4> copy(source);
+  EXPECT_EQ(copy.segments()[1].size, 0u);
+  EXPECT_EQ(copy.front(), "a");
+  EXPECT_EQ(copy.back(), "c");
+
+  CTDeque<std::string, 4> moved(std::move(source));
+  EXPECT_TRUE(source.empty());
+  EXPECT_EQ(moved[1], "b");
+  source.push_back("reused");
+  EXPECT_EQ(source.front(), "reused");
+
+  RTDeque<int> rt(4);
+  rt.push_back(1);
+  rt.push_front(0);
+  RTDeque<int> rtCopy(rt);
+  EXPECT_EQ(contents(rtCopy), (std::vector<int>{0, 1}));
+  RTDeque<int> rtMoved(std::move(rt));
+  EXPECT_EQ(contents(rtMoved), (std::vector<int>{0, 1}));
+  RTDeque<int> other(2);
+  other.push_back(7);
+  rtMoved.swap(other);
+  EXPECT_EQ(rtMoved.capacity(), 2u);
+  EXPECT_EQ(contents(other), (std::vector<int>{0, 1}));
+  other = rtCopy;
+  EXPECT_EQ(contents(other), (std::vector<int>{0, 1}));
+}
+
+#if (ENABLE_THREAD_SAFETY)
+// Buffer swaps lock both deques - every push lands in one of the two buffers, never in one being handed over
+TEST(FixedDequeCopyMoveTest, RTSwapIsAtomicAgainstPushes) {
+  RTDeque<int> first(20000);
+  RTDeque<int> second(20000);
+  std::thread pushFirst([&first]() {
+    for (int i = 0; i < 5000; ++i) {
+      first.push_back(i);
+    }
+  });
+  std::thread pushSecond([&second]() {
+    for (int i = 5000; i < 10000; ++i) {
+      second.push_front(i);
+    }
+  });
+  for (int i = 0; i < 2000; ++i) {
+    first.swap(second);
+  }
+  pushFirst.join();
+  pushSecond.join();
+
+  std::vector<int> all = contents(first);
+  const std::vector<int> rest = contents(second);
+  all.insert(all.end(), rest.begin(), rest.end());
+  std::sort(all.begin(), all.end());
+  ASSERT_EQ(all.size(), 10000u);
+  for (int i = 0; i < 10000; ++i) {
+    ASSERT_EQ(all[i], i);
+  }
+}
+#endif
+} // namespace ESTL
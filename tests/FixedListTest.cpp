@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include "../FixedList.hpp"
 #include <thread>
+#include <vector>
 
 namespace ESTL {
 // Define a test fixture template
@@ -234,4 +235,64 @@ TYPED_TEST(FixedListTest, ThreadSafety) {
   EXPECT_LE(this->list.size(), this->list.capacity());
 }
 #endif
+
+namespace {
+// Element without a default constructor that counts its live instances
+struct Tracked {
+  static int live;
+  int value;
+
+  explicit Tracked(int v) : value(v) { ++live; }
+  Tracked(const Tracked &other) : value(other.value) { ++live; }
+  ~Tracked() { --live; }
+};
+int Tracked::live = 0;
+} // namespace
+
+TEST(FixedListStorageTest, ElementsLiveOnlyWhileLinked) {
+  {
+    CTList<Tracked, 8> list;
+    EXPECT_EQ(Tracked::live, 0); // free nodes hold no elements
+    list.push_back(Tracked(1));
+    list.emplace_back(2);
+    list.emplace_front(0);
+    list.insert(std::next(list.begin()), Tracked(5));
+    EXPECT_EQ(Tracked::live, 4);
+    list.pop_front();
+    list.erase(list.begin());
+    EXPECT_EQ(Tracked::live, 2);
+    EXPECT_EQ(list.front().value, 1);
+    list.clear();
+    EXPECT_EQ(Tracked::live, 0);
+    list.emplace_back(3);
+  }
+  EXPECT_EQ(Tracked::live, 0);
+
+  {
+    RTList<Tracked> list(4);
+    list.emplace_back(1);
+    list.emplace_back(2);
+    RTList<Tracked> other(2);
+    other.emplace_back(3);
+    other = std::move(list);
+    EXPECT_EQ(Tracked::live, 2);
+    EXPECT_EQ(other.back().value, 2);
+  }
+  EXPECT_EQ(Tracked::live, 0);
+}
+
+TEST(FixedListMoveTest, MoveTakesNodesWithoutRelinking) {
+  RTList<int> list(16, {1, 2, 3});
+  const int *first = &list.front();
+  RTList<int> moved(std::move(list));
+  EXPECT_EQ(&moved.front(), first);
+  EXPECT_EQ(std::vector<int>(moved.begin(), moved.end()), (std::vector<int>{1, 2, 3}));
+  EXPECT_EQ(list.capacity(), 0u);
+  moved.push_back(4);
+  EXPECT_EQ(moved.size(), 4u);
+
+  list = std::move(moved);
+  EXPECT_EQ(list.back(), 4);
+  EXPECT_EQ(list.capacity(), 16u);
+}
 } // namespace ESTL
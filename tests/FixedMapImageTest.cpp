@@ -0,0 +1,127 @@
+//
+// Memory-mapped FixedMap images
+//
+#include "../FixedMap/FixedMapImage.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <iterator>
+#include <functional>
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <string>
+#include <unistd.h>
+
+namespace ESTL {
+
+    class FixedMapImageTest : public ::testing::TestWithParam<TreeType> {
+    protected:
+        std::string path = ::testing::TempDir() + "estl_fixed_map.img";
+
+        void TearDown() override { std::remove(path.c_str()); }
+    };
+
+    TEST_P(FixedMapImageTest, RoundTripInKeyOrder) {
+        RTMap<std::int64_t, float> map(4096, GetParam());
+        std::map<std::int64_t, float> reference;
+        std::mt19937 rng(21);
+        for (int i = 0; i < 3000; ++i) {
+            std::int64_t key = static_cast<std::int64_t>(rng() % 20000) - 10000;
+            if (map.insert(key, i * 0.25f)) {
+                reference[key] = i * 0.25f;
+            }
+        }
+        saveImage(map, path);
+
+        MappedMap<std::int64_t, float> mapped(path);
+        ASSERT_EQ(mapped.size(), reference.size());
+        auto expected = reference.begin();
+        for (auto it = mapped.begin(); it != mapped.end(); ++it, ++expected) {
+            EXPECT_EQ((*it).first, expected->first);
+            EXPECT_EQ((*it).second, expected->second);
+        }
+        for (std::int64_t key = -10010; key < 10010; key += 7) {
+            const float *value = mapped.find(key);
+            EXPECT_EQ(value != nullptr, reference.count(key) == 1);
+            auto bound = mapped.lower_bound(key);
+            auto referenceBound = reference.lower_bound(key);
+            if (referenceBound == reference.end()) {
+                EXPECT_EQ(bound, mapped.end());
+            } else {
+                EXPECT_EQ((*bound).first, referenceBound->first);
+            }
+        }
+    }
+
+    INSTANTIATE_TEST_SUITE_P(TreeTypes, FixedMapImageTest,
+                             ::testing::Values(TreeType::RedBlack, TreeType::AVL, TreeType::BPlus,
+                                               TreeType::Persistent));
+
+    // Iterators work with the standard algorithms that pick their code path from the category
+    TEST(FixedMapImageIteratorTest, RandomAccess) {
+        std::string path = ::testing::TempDir() + "estl_fixed_map_iterator.img";
+        RTMap<int, int> map(64);
+        for (int key = 0; key < 50; ++key) {
+            map.insert(key * 3, key);
+        }
+        saveImage(map, path);
+
+        MappedMap<int, int> mapped(path);
+        auto first = mapped.begin();
+        auto last = mapped.end();
+        EXPECT_EQ(std::distance(first, last), 50);
+        EXPECT_EQ(last - first, 50);
+        auto it = first;
+        std::advance(it, 20);
+        EXPECT_EQ((*it).first, 60);
+        EXPECT_EQ(first[49].second, 49);
+        EXPECT_EQ((*(last - 1)).first, 147);
+        EXPECT_EQ((*(5 + first)).first, 15);
+        EXPECT_TRUE(first < it && it <= last && last > it && it >= first);
+        it -= 10;
+        EXPECT_EQ(it - first, 10);
+        auto found = std::partition_point(first, last, [](std::pair<const int &, const int &> entry) {
+            return entry.first < 100;
+        });
+        EXPECT_EQ((*found).first, 102);
+        EXPECT_EQ(std::count_if(first, last, [](std::pair<const int &, const int &> entry) {
+                      return entry.second % 2 == 0;
+                  }), 25);
+        std::remove(path.c_str());
+    }
+
+    TEST(FixedMapImageValidationTest, RejectsOtherTypesOrdersAndMissingFiles) {
+        std::string path = ::testing::TempDir() + "estl_fixed_map_types.img";
+        RTMap<int, int> map(16);
+        map.insert(1, 1);
+        saveImage(map, path);
+
+        EXPECT_NO_THROW((MappedMap<int, int>(path)));
+        EXPECT_THROW((MappedMap<int, int, std::greater<int>>(path)), std::runtime_error);
+        EXPECT_THROW((MappedMap<long, int>(path)), std::runtime_error);
+
+        std::remove(path.c_str());
+        EXPECT_THROW((MappedMap<int, int>(path)), std::runtime_error);
+    }
+
+    TEST(FixedMapImageSharedMemoryTest, PublishAndAttach) {
+        SharedMemoryName segment{"/estl-test-map-" + std::to_string(getpid())};
+        RTMap<int, double> map(256, TreeType::AVL);
+        for (int key = 200; key > 0; key -= 2) {
+            map.insert(key, key / 2.0);
+        }
+        saveImage(map, segment);
+
+        MappedMap<int, double> mapped(segment);
+        ASSERT_EQ(mapped.size(), 100u);
+        EXPECT_EQ((*mapped.begin()).first, 2);
+        EXPECT_EQ(*mapped.find(100), 50.0);
+        EXPECT_FALSE(mapped.contains(101));
+        EXPECT_THROW((MappedMap<int, float>(segment)), std::runtime_error);
+
+        removeSharedImage(segment);
+        EXPECT_THROW((MappedMap<int, double>(segment)), std::runtime_error);
+        EXPECT_EQ(*mapped.find(200), 100.0);
+    }
+
+}// namespace ESTL
@@ -0,0 +1,48 @@
+//
+// Binary serialization of FixedMap
+//
+#include "../ESTLSerialization.hpp"
+#include "../FixedMap/FixedMap.hpp"
+#include "../FixedString.hpp"
+#include <gtest/gtest.h>
+#include <sstream>
+
+namespace ESTL {
+
+    class FixedMapSerializationTest : public ::testing::TestWithParam<TreeType> {};
+
+    TEST_P(FixedMapSerializationTest, RoundTripInKeyOrder) {
+        RTMap<int, CTString<8>> map(512, GetParam());
+        for (int key = 300; key > 0; key -= 3) {
+            map.insert(key, CTString<8>(std::to_string(key).c_str()));
+        }
+
+        std::stringstream stream;
+        char buffer[96];
+        BinaryWriter writer(stream, buffer, sizeof(buffer));
+        serialize(writer, map);
+        writer.flush();
+
+        RTMap<int, CTString<8>> loaded(512, GetParam());
+        loaded.insert(1, CTString<8>("stale"));
+        BinaryReader reader(stream, buffer, sizeof(buffer));
+        deserialize(reader, loaded);
+        ASSERT_EQ(loaded.size(), 100u);
+        EXPECT_EQ(loaded.find(1), nullptr);
+        int expected = 3;
+        for (auto it = loaded.begin(); it != loaded.end(); ++it, expected += 3) {
+            EXPECT_EQ((*it).first, expected);
+            EXPECT_STREQ((*it).second.c_str(), std::to_string(expected).c_str());
+        }
+
+        RTMap<int, CTString<8>> small(50, GetParam());
+        std::stringstream replay(stream.str());
+        BinaryReader again(replay, buffer, sizeof(buffer));
+        EXPECT_THROW(deserialize(again, small), std::out_of_range);
+    }
+
+    INSTANTIATE_TEST_SUITE_P(TreeTypes, FixedMapSerializationTest,
+                             ::testing::Values(TreeType::RedBlack, TreeType::AVL, TreeType::BPlus,
+                                               TreeType::Persistent));
+
+}// namespace ESTL
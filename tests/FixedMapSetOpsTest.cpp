@@ -0,0 +1,183 @@
+//
+// Bulk set operation tests - join-based over a shared pool and the element-wise fallback
+//
+#include "../FixedMap/FixedMap.hpp"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <map>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace ESTL {
+
+    struct SetOpsCase {
+        TreeType type;
+        SetOperation operation;
+    };
+
+    class SetOpsTest : public ::testing::TestWithParam<SetOpsCase> {
+    protected:
+        static const std::size_t POOL_CAPACITY = 8192;
+        std::mt19937 rng{17};
+
+        std::map<int, int> randomEntries(std::size_t count, int maxKey, int tag) {
+            std::map<int, int> entries;
+            while (entries.size() < count) {
+                int key = static_cast<int>(rng() % maxKey);
+                entries.emplace(key, key * 10 + tag);
+            }
+            return entries;
+        }
+
+        // Expected keys and values - keys present in both keep the first map's value
+        static std::map<int, int> expected(const std::map<int, int> &a, const std::map<int, int> &b,
+                                           SetOperation operation) {
+            std::map<int, int> result;
+            for (const auto &entry: a) {
+                bool inB = b.count(entry.first) != 0;
+                if (operation == SetOperation::Union || (operation == SetOperation::Intersection) == inB) {
+                    result.insert(entry);
+                }
+            }
+            if (operation == SetOperation::Union) {
+                result.insert(b.begin(), b.end());
+            }
+            return result;
+        }
+
+        template<typename Map>
+        static void fill(Map &map, const std::map<int, int> &entries) {
+            for (const auto &entry: entries) {
+                ASSERT_TRUE(map.insert(entry.first, entry.second));
+            }
+        }
+
+        template<typename Map>
+        static void apply(Map &map, Map &other, SetOperation operation) {
+            switch (operation) {
+                case SetOperation::Union:
+                    map.set_union(other);
+                    break;
+                case SetOperation::Intersection:
+                    map.set_intersection(other);
+                    break;
+                case SetOperation::Difference:
+                    map.set_difference(other);
+                    break;
+            }
+        }
+
+        template<typename Map>
+        static void expectContents(Map &map, const std::map<int, int> &reference) {
+            ASSERT_EQ(map.size(), reference.size());
+            auto expectedEntry = reference.begin();
+            for (auto it = map.begin(); it != map.end(); ++it, ++expectedEntry) {
+                ASSERT_NE(expectedEntry, reference.end());
+                EXPECT_EQ((*it).first, expectedEntry->first);
+                EXPECT_EQ((*it).second, expectedEntry->second);
+            }
+            EXPECT_EQ(expectedEntry, reference.end());
+        }
+    };
+
+    const std::size_t SetOpsTest::POOL_CAPACITY;
+
+    TEST_P(SetOpsTest, SharedPoolMatchesReference) {
+        const SetOpsCase param = GetParam();
+        if (param.type != TreeType::RedBlack && param.type != TreeType::AVL) {
+            GTEST_SKIP() << "Shared pools need a join-capable engine";
+        }
+        // Uneven sizes exercise the O(m log(n/m + 1)) path in both directions
+        for (auto sizes: {std::make_pair(3000, 200), std::make_pair(200, 3000), std::make_pair(2500, 2500),
+                          std::make_pair(0, 100), std::make_pair(100, 0)}) {
+            RTNodePool<int, int> pool(POOL_CAPACITY);
+            FixedMap<int, int> map(pool, param.type);
+            FixedMap<int, int> other(pool, param.type);
+            auto a = randomEntries(sizes.first, 6000, 1);
+            auto b = randomEntries(sizes.second, 6000, 2);
+            fill(map, a);
+            fill(other, b);
+
+            apply(map, other, param.operation);
+            auto reference = expected(a, b, param.operation);
+            expectContents(map, reference);
+            EXPECT_TRUE(other.empty());
+            EXPECT_EQ(pool.available(), POOL_CAPACITY - reference.size());
+
+            // The result is a regular tree again
+            EXPECT_TRUE(map.insert(-1, -1));
+            EXPECT_TRUE(map.erase(-1));
+        }
+    }
+
+    TEST_P(SetOpsTest, ForkedTasksMatchReference) {
+        const SetOpsCase param = GetParam();
+        if (param.type != TreeType::RedBlack && param.type != TreeType::AVL) {
+            GTEST_SKIP() << "Shared pools need a join-capable engine";
+        }
+        RTNodePool<int, int> pool(POOL_CAPACITY);
+        auto tree = BalancedTreeFactory<int, int>::createTree(param.type, &pool);
+        auto other = BalancedTreeFactory<int, int>::createTree(param.type, &pool);
+        auto a = randomEntries(3000, 8000, 1);
+        auto b = randomEntries(3000, 8000, 2);
+        for (const auto &entry: a) {
+            tree->insert(entry.first, entry.second);
+        }
+        for (const auto &entry: b) {
+            other->insert(entry.first, entry.second);
+        }
+
+        tree->combineWith(*other, param.operation, 4);
+        auto reference = expected(a, b, param.operation);
+        ASSERT_EQ(tree->size(), reference.size());
+        auto expectedEntry = reference.begin();
+        for (auto node = tree->minimum(); node; node = tree->next(node), ++expectedEntry) {
+            EXPECT_EQ(node->key, expectedEntry->first);
+            EXPECT_EQ(node->value, expectedEntry->second);
+        }
+        EXPECT_EQ(pool.available(), POOL_CAPACITY - reference.size());
+    }
+
+    TEST_P(SetOpsTest, SeparateBuffersMatchReference) {
+        const SetOpsCase param = GetParam();
+        RTMap<int, int> map(POOL_CAPACITY, param.type);
+        RTMap<int, int> other(POOL_CAPACITY, param.type);
+        auto a = randomEntries(1500, 4000, 1);
+        auto b = randomEntries(1200, 4000, 2);
+        fill(map, a);
+        fill(other, b);
+
+        apply(map, other, param.operation);
+        expectContents(map, expected(a, b, param.operation));
+        EXPECT_TRUE(other.empty());
+        EXPECT_THROW(apply(map, map, param.operation), std::invalid_argument);
+    }
+
+    TEST(SetOpsOverflowTest, UnionThatDoesNotFitLeavesMapsUntouched) {
+        RTMap<int, int> map(10);
+        RTMap<int, int> other(10);
+        for (int key = 0; key < 8; ++key) {
+            map.insert(key, key);
+            other.insert(key + 4, key);
+        }
+        EXPECT_THROW(map.set_union(other), std::out_of_range);
+        EXPECT_EQ(map.size(), 8u);
+        EXPECT_EQ(other.size(), 8u);
+    }
+
+    std::vector<SetOpsCase> allCases() {
+        std::vector<SetOpsCase> cases;
+        for (TreeType type: {TreeType::RedBlack, TreeType::AVL, TreeType::BPlus, TreeType::Persistent}) {
+            for (SetOperation operation:
+                 {SetOperation::Union, SetOperation::Intersection, SetOperation::Difference}) {
+                cases.push_back({type, operation});
+            }
+        }
+        return cases;
+    }
+
+    INSTANTIATE_TEST_SUITE_P(TreesAndOperations, SetOpsTest, ::testing::ValuesIn(allCases()));
+
+}// namespace ESTL
@@ -0,0 +1,172 @@
+//
+// Snapshot isolation tests for FixedMap with TreeType::Persistent
+//
+#include "../FixedMap/FixedMap.hpp"
+#include <atomic>
+#include <functional>
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace ESTL {
+
+    class FixedMapSnapshotTest : public ::testing::Test {
+    protected:
+        static const std::size_t POOL_CAPACITY = 4096;
+        RTMap<int, int> map;
+
+        FixedMapSnapshotTest()
+            : map(POOL_CAPACITY, TreeType::Persistent) {}
+    };
+
+    TEST_F(FixedMapSnapshotTest, MatchesStdMap) {
+        std::mt19937 rng(7);
+        std::map<int, int> reference;
+        for (int i = 0; i < 20000; ++i) {
+            int key = static_cast<int>(rng() % 1000);
+            switch (rng() % 3) {
+                case 0:
+                    EXPECT_EQ(map.erase(key), reference.erase(key) == 1);
+                    break;
+                case 1:
+                    EXPECT_EQ(map.insert(key, i), reference.emplace(key, i).second);
+                    break;
+                default:
+                    EXPECT_EQ(map.insert_or_assign(key, i), reference.count(key) == 0);
+                    reference[key] = i;
+            }
+        }
+        ASSERT_EQ(map.size(), reference.size());
+
+        auto expected = reference.begin();
+        for (auto it = map.begin(); it != map.end(); ++it, ++expected) {
+            ASSERT_NE(expected, reference.end());
+            EXPECT_EQ((*it).first, expected->first);
+            EXPECT_EQ((*it).second, expected->second);
+        }
+        EXPECT_EQ(expected, reference.end());
+
+        auto snapshot = map.snapshot();
+        expected = reference.begin();
+        for (auto it = snapshot.begin(); it != snapshot.end(); ++it, ++expected) {
+            EXPECT_EQ((*it).first, expected->first);
+            EXPECT_EQ((*it).second, expected->second);
+        }
+        EXPECT_EQ(expected, reference.end());
+    }
+
+    TEST_F(FixedMapSnapshotTest, SnapshotIgnoresLaterWrites) {
+        for (int i = 0; i < 100; ++i) {
+            map.insert(i, i);
+        }
+        auto snapshot = map.snapshot();
+
+        map.erase(10);
+        map.insert(1000, 1000);
+        map.insert_or_assign(20, -20);
+        map.clear();
+        EXPECT_TRUE(map.empty());
+
+        EXPECT_FALSE(snapshot.empty());
+        ASSERT_NE(snapshot.find(10), nullptr);
+        EXPECT_EQ(*snapshot.find(20), 20);
+        EXPECT_EQ(snapshot.find(1000), nullptr);
+
+        int expected = 0;
+        for (auto it = snapshot.begin(); it != snapshot.end(); ++it) {
+            EXPECT_EQ((*it).first, expected++);
+        }
+        EXPECT_EQ(expected, 100);
+    }
+
+    TEST_F(FixedMapSnapshotTest, ReleasedSnapshotsReturnNodes) {
+        RTMap<int, int> small(64, TreeType::Persistent);
+        for (int i = 0; i < 16; ++i) {
+            small.insert(i, i);
+        }
+
+        {
+            auto snapshot = small.snapshot();
+            // The snapshot keeps every replaced node alive until the pool runs out
+            EXPECT_THROW(
+                    {
+                        for (int round = 0; round < 64; ++round) {
+                            small.insert_or_assign(round % 16, round);
+                        }
+                    },
+                    std::out_of_range);
+            EXPECT_EQ(*snapshot.find(3), 3);
+            // Erasing a missing key copies nothing, so it fails cleanly with the pool exhausted
+            EXPECT_FALSE(small.erase(100));
+            EXPECT_FALSE(small.erase(-1));
+        }
+
+        // Released - the next writes reclaim the old versions
+        for (int round = 0; round < 1000; ++round) {
+            EXPECT_FALSE(small.insert_or_assign(round % 16, round));
+        }
+        EXPECT_EQ(small.size(), 16);
+    }
+
+    TEST_F(FixedMapSnapshotTest, SnapshotRequiresPersistentTree) {
+        RTMap<int, int> redBlack(16);
+        EXPECT_THROW(redBlack.snapshot(), std::logic_error);
+    }
+
+    // Readers iterate lock-free while a writer keeps a sliding window of 100 consecutive keys
+    TEST_F(FixedMapSnapshotTest, ConcurrentReadersSeeConsistentVersions) {
+        const int window = 100;
+        for (int i = 0; i < window; ++i) {
+            map.insert(i, i);
+        }
+
+        std::atomic<bool> done(false);
+        std::atomic<int> failures(0);
+        auto reader = [&]() {
+            while (! done.load()) {
+                auto snapshot = map.snapshot();
+                int count = 0;
+                int previous = 0;
+                for (auto it = snapshot.begin(); it != snapshot.end(); ++it) {
+                    const auto entry = *it;
+                    if ((count > 0 && entry.first != previous + 1) || entry.second != entry.first) {
+                        ++failures;
+                    }
+                    previous = entry.first;
+                    ++count;
+                }
+                if (count != window && count != window + 1) {
+                    ++failures;
+                }
+            }
+        };
+
+        std::vector<std::thread> readers;
+        for (int i = 0; i < 3; ++i) {
+            readers.emplace_back(reader);
+        }
+        // A reader holding an old version may exhaust the spare nodes - the writer backs off until it is released
+        auto write = [](const std::function<void()> &operation) {
+            while (true) {
+                try {
+                    operation();
+                    return;
+                } catch (const std::out_of_range &) {
+                    std::this_thread::yield();
+                }
+            }
+        };
+        for (int next = window; next < 20000; ++next) {
+            write([&]() { map.insert(next, next); });
+            write([&]() { map.erase(next - window); });
+        }
+        done = true;
+        for (auto &thread: readers) {
+            thread.join();
+        }
+        EXPECT_EQ(failures.load(), 0);
+    }
+
+}// namespace ESTL
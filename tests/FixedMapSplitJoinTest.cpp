@@ -0,0 +1,303 @@
+//
+// Split / join tests - O(log n) node moves over a shared pool and the copying fallback
+//
+#include "../FixedMap/FixedMap.hpp"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace ESTL {
+
+    using Node = TreeNode<int, int>;
+
+    // Returns the height of a subtree after checking order, parent links and the engine's balance invariant - count
+    // gets its node count
+    int checkSubtree(const Node *node, const Node *parent, TreeType type, int &blackHeight, std::size_t &count) {
+        if (! node || ! node->inUse()) {
+            blackHeight = 0;
+            count = 0;
+            return 0;
+        }
+        EXPECT_EQ(node->parent, parent);
+        if (node->left && node->left->inUse()) {
+            EXPECT_LT(node->left->key, node->key);
+        }
+        if (node->right && node->right->inUse()) {
+            EXPECT_GT(node->right->key, node->key);
+        }
+        int leftBlack = 0;
+        int rightBlack = 0;
+        std::size_t leftCount = 0;
+        std::size_t rightCount = 0;
+        int leftHeight = checkSubtree(node->left, node, type, leftBlack, leftCount);
+        int rightHeight = checkSubtree(node->right, node, type, rightBlack, rightCount);
+        int height = std::max(leftHeight, rightHeight) + 1;
+        count = 1 + leftCount + rightCount;
+        if (type == TreeType::AVL) {
+            EXPECT_LE(std::abs(leftHeight - rightHeight), 1);
+            EXPECT_EQ(node->height(), height);
+            return height;
+        } else {
+            EXPECT_EQ(leftBlack, rightBlack);
+            if (node->isRed()) {
+                EXPECT_FALSE(node->left && node->left->inUse() && node->left->isRed());
+                EXPECT_FALSE(node->right && node->right->inUse() && node->right->isRed());
+            }
+        }
+        blackHeight = leftBlack + (node->isRed() ? 0 : 1);
+        return height;
+    }
+
+    // Checks the shape of the whole tree - returns its node count
+    std::size_t checkShape(BalancedTree<int, int> &tree, TreeType type) {
+        const Node *root = tree.minimum();
+        while (root && root->parent) {
+            root = root->parent;
+        }
+        int blackHeight = 0;
+        std::size_t count = 0;
+        checkSubtree(root, nullptr, type, blackHeight, count);
+        if (type == TreeType::RedBlack && root) {
+            EXPECT_FALSE(root->isRed());
+        }
+        return count;
+    }
+
+    void checkTree(BalancedTree<int, int> &tree, TreeType type, int first, int last) {
+        EXPECT_EQ(checkShape(tree, type), tree.size());
+        ASSERT_EQ(tree.size(), static_cast<std::size_t>(last - first));
+        int expected = first;
+        for (auto node = tree.minimum(); node; node = tree.next(node), ++expected) {
+            EXPECT_EQ(node->key, expected);
+        }
+        EXPECT_EQ(expected, last);
+    }
+
+    class SplitJoinTreeTest : public ::testing::TestWithParam<TreeType> {
+    protected:
+        static const std::size_t POOL_CAPACITY = 4096;
+        RTNodePool<int, int> pool{POOL_CAPACITY};
+    };
+
+    const std::size_t SplitJoinTreeTest::POOL_CAPACITY;
+
+    TEST_P(SplitJoinTreeTest, SplitKeepsBalance) {
+        std::mt19937 rng(11);
+        for (int splitKey: {0, 1, 500, 1023, 1024, 5000}) {
+            auto left = BalancedTreeFactory<int, int>::createTree(GetParam(), &pool);
+            auto right = BalancedTreeFactory<int, int>::createTree(GetParam(), &pool);
+            std::vector<int> keys(1024);
+            for (int i = 0; i < 1024; ++i) {
+                keys[i] = i;
+            }
+            std::shuffle(keys.begin(), keys.end(), rng);
+            for (int key: keys) {
+                ASSERT_TRUE(left->insert(key, key * 2));
+            }
+
+            left->splitInto(splitKey, *right);
+            int boundary = std::min(std::max(splitKey, 0), 1024);
+            checkTree(*left, GetParam(), 0, boundary);
+            checkTree(*right, GetParam(), boundary, 1024);
+
+            left->clear();
+            right->clear();
+            EXPECT_EQ(pool.available(), POOL_CAPACITY);
+        }
+    }
+
+    TEST_P(SplitJoinTreeTest, JoinUnevenTreesKeepsBalance) {
+        for (int sizes: {0, 1, 7, 300}) {
+            auto left = BalancedTreeFactory<int, int>::createTree(GetParam(), &pool);
+            auto right = BalancedTreeFactory<int, int>::createTree(GetParam(), &pool);
+            for (int key = 0; key < sizes; ++key) {
+                ASSERT_TRUE(left->insert(key, key));
+            }
+            for (int key = sizes; key < 2000; ++key) {
+                ASSERT_TRUE(right->insert(key, key));
+            }
+
+            left->joinFrom(*right);
+            checkTree(*left, GetParam(), 0, 2000);
+            EXPECT_TRUE(right->empty());
+            EXPECT_EQ(right->size(), 0u);
+
+            // Joining a large tree onto a small one, and inserting afterwards
+            right->joinFrom(*left);
+            checkTree(*right, GetParam(), 0, 2000);
+            EXPECT_TRUE(right->insert(-1, -1));
+            EXPECT_TRUE(right->erase(1000));
+            EXPECT_EQ(right->size(), 2000u);
+            right->clear();
+        }
+        EXPECT_EQ(pool.available(), POOL_CAPACITY);
+    }
+
+    TEST_P(SplitJoinTreeTest, RepeatedSplitJoinRoundTrip) {
+        std::mt19937 rng(3);
+        auto tree = BalancedTreeFactory<int, int>::createTree(GetParam(), &pool);
+        auto rest = BalancedTreeFactory<int, int>::createTree(GetParam(), &pool);
+        for (int key = 0; key < 3000; ++key) {
+            ASSERT_TRUE(tree->insert(key, key));
+        }
+        for (int round = 0; round < 200; ++round) {
+            int key = static_cast<int>(rng() % 3000);
+            tree->splitInto(key, *rest);
+            tree->joinFrom(*rest);
+        }
+        checkTree(*tree, GetParam(), 0, 3000);
+    }
+
+    // Insert checks the pool, not the tree's own size - two trees sharing a full pool both refuse new keys
+    TEST_P(SplitJoinTreeTest, InsertIntoExhaustedSharedPoolFails) {
+        RTNodePool<int, int> small(64);
+        auto left = BalancedTreeFactory<int, int>::createTree(GetParam(), &small);
+        auto right = BalancedTreeFactory<int, int>::createTree(GetParam(), &small);
+        for (int key = 0; key < 64; ++key) {
+            ASSERT_TRUE(left->insert(key, key));
+        }
+        left->splitInto(32, *right);
+        EXPECT_FALSE(left->insert(-1, -1));
+        EXPECT_FALSE(right->insert(100, 100));
+        EXPECT_EQ(left->size(), 32u);
+        EXPECT_EQ(right->size(), 32u);
+
+        ASSERT_TRUE(right->erase(40));
+        EXPECT_TRUE(left->insert(-1, -1));
+        EXPECT_EQ(checkShape(*right, GetParam()), 31u);
+        left->clear();
+        right->clear();
+        EXPECT_EQ(small.available(), 64u);
+    }
+
+    // Splits, edits both halves and joins them again - sizes match the reference after every step
+    TEST_P(SplitJoinTreeTest, AlternatingSplitInsertJoinKeepsSizesExact) {
+        RTNodePool<int, int> large(40000);
+        auto tree = BalancedTreeFactory<int, int>::createTree(GetParam(), &large);
+        auto rest = BalancedTreeFactory<int, int>::createTree(GetParam(), &large);
+        std::map<int, int> reference;
+        for (int key = 0; key < 60000; key += 2) {
+            ASSERT_TRUE(tree->insert(key, key));
+            reference[key] = key;
+        }
+
+        std::mt19937 rng(21);
+        for (int round = 0; round < 500; ++round) {
+            const int key = static_cast<int>(rng() % 60000);
+            tree->splitInto(key, *rest);
+            const auto boundary = reference.lower_bound(key);
+            ASSERT_EQ(tree->size(), static_cast<std::size_t>(std::distance(reference.begin(), boundary)));
+            ASSERT_EQ(rest->size(), reference.size() - tree->size());
+
+            // Odd keys go in, the first key of the right part goes out
+            const int low = static_cast<int>(rng() % 60000) | 1;
+            if (low < key && tree->insert(low, low)) {
+                reference[low] = low;
+            } else if (low > key && rest->insert(low, low)) {
+                reference[low] = low;
+            }
+            if (! rest->empty()) {
+                const int first = rest->minimum()->key;
+                ASSERT_TRUE(rest->erase(first));
+                reference.erase(first);
+            }
+
+            tree->joinFrom(*rest);
+            ASSERT_EQ(tree->size(), reference.size());
+            ASSERT_EQ(rest->size(), 0u);
+        }
+
+        EXPECT_EQ(checkShape(*tree, GetParam()), reference.size());
+        auto expected = reference.begin();
+        for (auto node = tree->minimum(); node; node = tree->next(node), ++expected) {
+            ASSERT_NE(expected, reference.end());
+            EXPECT_EQ(node->key, expected->first);
+        }
+        EXPECT_EQ(expected, reference.end());
+        tree->clear();
+        EXPECT_EQ(large.available(), 40000u);
+    }
+
+    INSTANTIATE_TEST_SUITE_P(JoinableTrees, SplitJoinTreeTest,
+                             ::testing::Values(TreeType::RedBlack, TreeType::AVL));
+
+    class FixedMapSplitJoinTest : public ::testing::TestWithParam<TreeType> {};
+
+    TEST_P(FixedMapSplitJoinTest, SharedPoolSplitAndJoin) {
+        if (GetParam() != TreeType::RedBlack && GetParam() != TreeType::AVL) {
+            RTNodePool<int, int> pool(16);
+            EXPECT_THROW((FixedMap<int, int>(pool, GetParam())), std::invalid_argument);
+            return;
+        }
+        CTNodePool<int, int, 1024> pool;
+        FixedMap<int, int> low(pool, GetParam());
+        FixedMap<int, int> high(pool, GetParam());
+        for (int key = 0; key < 1000; ++key) {
+            ASSERT_TRUE(low.insert(key, -key));
+        }
+
+        low.split(600, high);
+        EXPECT_EQ(low.size(), 600u);
+        EXPECT_EQ(high.size(), 400u);
+        EXPECT_EQ(low.find(600), nullptr);
+        EXPECT_EQ(*high.find(600), -600);
+        EXPECT_EQ((*high.begin()).first, 600);
+
+        EXPECT_THROW(low.split(10, high), std::invalid_argument);
+        EXPECT_THROW(high.join(low), std::invalid_argument);
+        EXPECT_THROW(low.join(low), std::invalid_argument);
+
+        low.join(high);
+        EXPECT_EQ(low.size(), 1000u);
+        EXPECT_TRUE(high.empty());
+        int expected = 0;
+        for (auto it = low.begin(); it != low.end(); ++it, ++expected) {
+            EXPECT_EQ((*it).first, expected);
+        }
+        EXPECT_EQ(expected, 1000);
+
+        // Both maps keep drawing from the shared pool
+        EXPECT_TRUE(high.insert(5000, 1));
+        EXPECT_EQ(pool.available(), 1024u - 1001u);
+    }
+
+    TEST_P(FixedMapSplitJoinTest, SeparateBuffersFallBackToCopying) {
+        std::mt19937 rng(5);
+        std::map<int, int> reference;
+        RTMap<int, int> map(2048, GetParam());
+        RTMap<int, int> upper(2048, GetParam());
+        for (int i = 0; i < 1500; ++i) {
+            int key = static_cast<int>(rng() % 4000);
+            map.insert(key, i);
+            reference.emplace(key, i);
+        }
+
+        map.split(2000, upper);
+        EXPECT_EQ(map.size() + upper.size(), reference.size());
+        for (const auto &entry: reference) {
+            auto *value = entry.first < 2000 ? map.find(entry.first) : upper.find(entry.first);
+            ASSERT_NE(value, nullptr);
+            EXPECT_EQ(*value, entry.second);
+        }
+
+        map.join(upper);
+        EXPECT_TRUE(upper.empty());
+        auto expected = reference.begin();
+        for (auto it = map.begin(); it != map.end(); ++it, ++expected) {
+            ASSERT_NE(expected, reference.end());
+            EXPECT_EQ((*it).first, expected->first);
+        }
+        EXPECT_EQ(expected, reference.end());
+
+        RTMap<int, int> tooSmall(10, GetParam());
+        EXPECT_THROW(map.split(0, tooSmall), std::out_of_range);
+        EXPECT_EQ(map.size(), reference.size());
+    }
+
+    INSTANTIATE_TEST_SUITE_P(TreeTypes, FixedMapSplitJoinTest,
+                             ::testing::Values(TreeType::RedBlack, TreeType::AVL, TreeType::BPlus,
+                                               TreeType::Persistent));
+
+}// namespace ESTL
@@ -0,0 +1,207 @@
+#include "../FixedSlotMap.hpp"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ESTL {
+    namespace {
+        // Counts live instances, to check that erase, clear and destruction end every lifetime
+        struct Tracked {
+            static int live;
+            int value;
+
+            explicit Tracked(int v)
+                : value(v) { ++live; }
+            Tracked(const Tracked &other)
+                : value(other.value) { ++live; }
+            Tracked(Tracked &&other) noexcept
+                : value(other.value) { ++live; }
+            ~Tracked() { --live; }
+        };
+
+        int Tracked::live = 0;
+
+        template<typename Map>
+        std::vector<int> sortedValues(Map &map) {
+            std::vector<int> seen(map.begin(), map.end());
+            std::sort(seen.begin(), seen.end());
+            return seen;
+        }
+    }// namespace
+
+    template<typename T>
+    class FixedSlotMapTest : public ::testing::Test {
+    public:
+        T map;
+    };
+
+    class CTSlotMap8 : public CTSlotMap<int, 8> {};
+
+    class RTSlotMap8 : public RTSlotMap<int> {
+    public:
+        RTSlotMap8()
+            : RTSlotMap<int>(8) {}
+    };
+
+    using SlotMapTypes = ::testing::Types<CTSlotMap8, RTSlotMap8>;
+    TYPED_TEST_SUITE(FixedSlotMapTest, SlotMapTypes);
+
+    TYPED_TEST(FixedSlotMapTest, InsertFindErase) {
+        SlotHandle a = this->map.insert(10);
+        SlotHandle b = this->map.emplace(20);
+        EXPECT_EQ(this->map.size(), 2u);
+        EXPECT_EQ(this->map.at(a), 10);
+        EXPECT_EQ(*this->map.find(b), 20);
+        this->map[b] = 21;
+        EXPECT_EQ(this->map.at(b), 21);
+
+        EXPECT_TRUE(this->map.erase(a));
+        EXPECT_FALSE(this->map.contains(a));
+        EXPECT_EQ(this->map.find(a), nullptr);
+        EXPECT_THROW(this->map.at(a), std::out_of_range);
+        EXPECT_FALSE(this->map.erase(a));
+        EXPECT_EQ(this->map.at(b), 21);
+        EXPECT_EQ(this->map.size(), 1u);
+    }
+
+    TYPED_TEST(FixedSlotMapTest, NullAndForeignHandlesAreRejected) {
+        this->map.insert(1);
+        EXPECT_FALSE(this->map.contains(SlotHandle{}));
+        EXPECT_FALSE(this->map.contains(SlotHandle{100, 1}));
+        EXPECT_FALSE(this->map.contains(SlotHandle{3, 1}));// Free slot at its current generation
+        EXPECT_FALSE(this->map.erase(SlotHandle{}));
+    }
+
+    TYPED_TEST(FixedSlotMapTest, ReusedSlotKeepsOldHandleStale) {
+        SlotHandle old = this->map.insert(1);
+        this->map.erase(old);
+        SlotHandle fresh = this->map.insert(2);
+        EXPECT_EQ(fresh.index, old.index);
+        EXPECT_NE(fresh.generation, old.generation);
+        EXPECT_FALSE(this->map.contains(old));
+        EXPECT_FALSE(this->map.erase(old));
+        EXPECT_EQ(this->map.at(fresh), 2);
+    }
+
+    TYPED_TEST(FixedSlotMapTest, FreeSlotsAreReusedLastInFirstOut) {
+        std::vector<SlotHandle> handles;
+        for (int i = 0; i < 6; ++i) {
+            handles.push_back(this->map.insert(i));
+        }
+        this->map.erase(handles[1]);
+        this->map.erase(handles[4]);
+        EXPECT_EQ(this->map.insert(40).index, handles[4].index);
+        EXPECT_EQ(this->map.insert(10).index, handles[1].index);
+        EXPECT_EQ(this->map.insert(60).index, 6u);
+    }
+
+    TYPED_TEST(FixedSlotMapTest, ValuesStayDenseAfterErase) {
+        std::vector<SlotHandle> handles;
+        for (int i = 0; i < 8; ++i) {
+            handles.push_back(this->map.insert(i));
+        }
+        EXPECT_TRUE(this->map.full());
+        this->map.erase(handles[0]);
+        this->map.erase(handles[5]);
+        this->map.erase(handles[3]);
+        EXPECT_EQ(this->map.end() - this->map.begin(), 5);
+        EXPECT_EQ(sortedValues(this->map), (std::vector<int>{1, 2, 4, 6, 7}));
+        for (int i : {1, 2, 4, 6, 7}) {
+            EXPECT_EQ(this->map.at(handles[i]), i);
+        }
+
+        // handleAt and forEach name each value's current handle
+        for (std::size_t position = 0; position < this->map.size(); ++position) {
+            EXPECT_EQ(this->map.at(this->map.handleAt(position)), this->map.begin()[position]);
+        }
+        EXPECT_THROW(this->map.handleAt(5), std::out_of_range);
+        int visited = 0;
+        this->map.forEach([&](SlotHandle handle, int &value) {
+            EXPECT_EQ(handles[value], handle);
+            ++visited;
+        });
+        EXPECT_EQ(visited, 5);
+    }
+
+    TYPED_TEST(FixedSlotMapTest, InsertIntoFullMapThrows) {
+        for (int i = 0; i < 8; ++i) {
+            this->map.insert(i);
+        }
+        EXPECT_THROW(this->map.insert(8), std::out_of_range);
+        EXPECT_EQ(this->map.size(), 8u);
+    }
+
+    TYPED_TEST(FixedSlotMapTest, ClearInvalidatesEveryHandle) {
+        std::vector<SlotHandle> handles;
+        for (int i = 0; i < 8; ++i) {
+            handles.push_back(this->map.insert(i));
+        }
+        this->map.clear();
+        EXPECT_TRUE(this->map.empty());
+        for (const SlotHandle &handle : handles) {
+            EXPECT_FALSE(this->map.contains(handle));
+        }
+        for (int i = 0; i < 8; ++i) {
+            EXPECT_FALSE(this->map.contains(handles[i]));
+            EXPECT_EQ(this->map.at(this->map.insert(i)), i);
+        }
+        EXPECT_TRUE(this->map.full());
+    }
+
+    TYPED_TEST(FixedSlotMapTest, MetricsReportThePool) {
+        this->map.insert(1);
+        SlotHandle b = this->map.insert(2);
+        this->map.erase(b);
+        ContainerMetrics m = this->map.metrics();
+        EXPECT_EQ(m.size, 1u);
+        EXPECT_EQ(m.poolInUse, 1u);
+        EXPECT_EQ(m.poolCapacity, 8u);
+        EXPECT_DOUBLE_EQ(m.loadFactor, 1.0 / 8);
+    }
+
+    TEST(FixedSlotMapLifetimeTest, EraseClearAndDestructionEndLifetimes) {
+        Tracked::live = 0;
+        {
+            CTSlotMap<Tracked, 4> ct;
+            RTSlotMap<Tracked> rt(4);
+            SlotHandle first = ct.emplace(1);
+            ct.emplace(2);
+            ct.emplace(3);
+            rt.emplace(4);
+            rt.emplace(5);
+            EXPECT_EQ(Tracked::live, 5);
+            ct.erase(first);// Moves the last value into the hole
+            EXPECT_EQ(Tracked::live, 4);
+            rt.clear();
+            EXPECT_EQ(Tracked::live, 2);
+            rt.emplace(6);
+        }
+        EXPECT_EQ(Tracked::live, 0);
+    }
+
+    TEST(FixedSlotMapLifetimeTest, NonDefaultConstructibleValues) {
+        CTSlotMap<std::string, 2> names;
+        SlotHandle h = names.emplace(3, 'x');
+        EXPECT_EQ(names.at(h), "xxx");
+    }
+
+    TEST(FixedSlotMapMoveTest, MovedMapKeepsHandles) {
+        RTSlotMap<int> source(4);
+        SlotHandle a = source.insert(1);
+        SlotHandle b = source.insert(2);
+        source.erase(a);
+
+        RTSlotMap<int> moved(std::move(source));
+        EXPECT_EQ(moved.at(b), 2);
+        EXPECT_FALSE(moved.contains(a));
+
+        RTSlotMap<int> assigned(2);
+        assigned.insert(7);
+        assigned = std::move(moved);
+        EXPECT_EQ(assigned.capacity(), 4u);
+        EXPECT_EQ(assigned.at(b), 2);
+        EXPECT_EQ(assigned.insert(3).index, a.index);
+    }
+}// namespace ESTL
@@ -117,4 +117,41 @@ namespace ESTL {
         }
         EXPECT_EQ(result, "Hello");
     }
+
+    TEST(FixedStringCopyMoveTest, CTSwapIsCharacterwiseAndBounded) {
+        CTString<16> text("swap me");
+        CTString<8> shorter("abc");
+        const char *data = text.c_str();
+        text.swap(shorter);
+        EXPECT_EQ(text.c_str(), data);
+        EXPECT_STREQ(text.c_str(), "abc");
+        EXPECT_STREQ(shorter.c_str(), "swap me");
+        EXPECT_EQ(shorter.size(), 7u);
+
+        CTString<16> longer("more than eight");
+        EXPECT_THROW(shorter.swap(longer), std::out_of_range);
+        EXPECT_STREQ(shorter.c_str(), "swap me");
+    }
+
+    TEST(FixedStringCopyMoveTest, RTMoveAndSwapExchangeBuffers) {
+        RTString text("hello", 1000);
+        RTString other("hi", 4);
+        const char *data = text.c_str();
+        text.swap(other);
+        EXPECT_EQ(other.c_str(), data);
+        EXPECT_EQ(other.capacity(), 1000u);
+        EXPECT_STREQ(text.c_str(), "hi");
+
+        RTString moved(std::move(other));
+        EXPECT_EQ(moved.c_str(), data);
+        EXPECT_STREQ(moved.c_str(), "hello");
+        other = moved;
+        EXPECT_STREQ(other.c_str(), "hello");
+        EXPECT_NE(other.c_str(), moved.c_str());
+
+        CTString<8> inline_("ct");
+        moved.swap(inline_);// a CT string on either side goes character-wise
+        EXPECT_STREQ(moved.c_str(), "ct");
+        EXPECT_STREQ(inline_.c_str(), "hello");
+    }
 }
\ No newline at end of file
@@ -0,0 +1,115 @@
+//
+// Memory-mapped FixedUnorderedMap images
+//
+#include "../FixedUnorderedMapImage.hpp"
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <string>
+
+namespace ESTL {
+
+    class UnorderedMapImageTest : public ::testing::Test {
+    protected:
+        std::string path = ::testing::TempDir() + "estl_unordered_map.img";
+
+        void TearDown() override { std::remove(path.c_str()); }
+    };
+
+    TEST_F(UnorderedMapImageTest, RoundTripWithChains) {
+        // Few primary buckets force long chains
+        RTMap<std::uint64_t, double> map(64, 2048);
+        std::map<std::uint64_t, double> reference;
+        std::mt19937_64 rng(9);
+        for (int i = 0; i < 1500; ++i) {
+            std::uint64_t key = rng() % 100000;
+            if (map.insert(key, i * 0.5)) {
+                reference[key] = i * 0.5;
+            }
+        }
+        for (int i = 0; i < 300; ++i) {// erased slots and moved chain heads must survive the round trip
+            auto it = reference.begin();
+            std::advance(it, rng() % reference.size());
+            EXPECT_TRUE(map.erase(it->first));
+            reference.erase(it);
+        }
+        saveImage(map, path);
+
+        MappedUnorderedMap<std::uint64_t, double> mapped(path);
+        EXPECT_EQ(mapped.size(), reference.size());
+        EXPECT_EQ(mapped.capacity(), 64u);
+        for (const auto &entry: reference) {
+            const double *value = mapped.find(entry.first);
+            ASSERT_NE(value, nullptr);
+            EXPECT_EQ(*value, entry.second);
+        }
+        for (std::uint64_t key = 100000; key < 100100; ++key) {
+            EXPECT_FALSE(mapped.contains(key));
+        }
+
+        std::size_t visited = 0;
+        for (auto it = mapped.begin(); it != mapped.end(); ++it, ++visited) {
+            EXPECT_EQ(reference.at((*it).first), (*it).second);
+        }
+        EXPECT_EQ(visited, reference.size());
+    }
+
+    TEST_F(UnorderedMapImageTest, EmptyMap) {
+        RTMap<int, int> map(16);
+        saveImage(map, path);
+        MappedUnorderedMap<int, int> mapped(path, true);
+        EXPECT_TRUE(mapped.empty());
+        EXPECT_EQ(mapped.find(3), nullptr);
+        EXPECT_EQ(mapped.begin(), mapped.end());
+    }
+
+    TEST_F(UnorderedMapImageTest, RejectsMismatchedImages) {
+        RTMap<int, int> map(16);
+        map.insert(1, 2);
+        saveImage(map, path);
+
+        EXPECT_THROW((MappedUnorderedMap<int, long>(path)), std::runtime_error);
+        EXPECT_THROW((MappedUnorderedMap<unsigned, int>(path)), std::runtime_error);
+        EXPECT_THROW((MappedUnorderedMap<int, int>(path + ".missing")), std::runtime_error);
+
+        // Truncated file
+        std::string contents;
+        {
+            std::ifstream in(path, std::ios::binary);
+            contents.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+        {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            out.write(contents.data(), static_cast<std::streamsize>(contents.size() - 8));
+        }
+        EXPECT_THROW((MappedUnorderedMap<int, int>(path)), std::runtime_error);
+
+        // Not an image
+        {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            out << std::string(256, 'x');
+        }
+        EXPECT_THROW((MappedUnorderedMap<int, int>(path)), std::runtime_error);
+    }
+
+    TEST_F(UnorderedMapImageTest, RewriteReplacesImage) {
+        RTMap<int, int> map(16);
+        map.insert(1, 10);
+        saveImage(map, path);
+        MappedUnorderedMap<int, int> before(path);
+
+        map.insert_or_assign(1, 20);
+        map.insert(2, 30);
+        saveImage(map, path);
+        MappedUnorderedMap<int, int> after(path);
+
+        // An existing mapping keeps the old image
+        EXPECT_EQ(*before.find(1), 10);
+        EXPECT_EQ(before.find(2), nullptr);
+        EXPECT_EQ(*after.find(1), 20);
+        EXPECT_EQ(*after.find(2), 30);
+    }
+
+}// namespace ESTL
@@ -0,0 +1,165 @@
+#include "../FixedUnorderedMap.hpp"
+#include <gtest/gtest.h>
+#include <map>
+
+namespace ESTL {
+    namespace {
+        // Key k goes to primary bucket k % capacity
+        struct IdentityHash {
+            std::size_t operator()(int key) const { return static_cast<std::size_t>(key); }
+        };
+
+        template<typename Map>
+        std::map<int, int> iterated(Map &map) {
+            std::map<int, int> seen;
+            for (auto it = map.begin(); it != map.end(); ++it) {
+                EXPECT_TRUE(seen.emplace((*it).first, (*it).second).second) << "visited twice: " << (*it).first;
+            }
+            return seen;
+        }
+
+        // Value without a default constructor that counts its live instances
+        struct Tracked {
+            static int live;
+            int value;
+
+            explicit Tracked(int v)
+                : value(v) {
+                ++live;
+            }
+            Tracked(const Tracked &other)
+                : value(other.value) {
+                ++live;
+            }
+            Tracked(Tracked &&other) noexcept
+                : value(other.value) {
+                ++live;
+            }
+            Tracked &operator=(const Tracked &) = default;
+            ~Tracked() { --live; }
+        };
+        int Tracked::live = 0;
+    }// namespace
+
+    TEST(FixedUnorderedMapIterationTest, SparseMapAcrossBitmapWords) {
+        RTMap<int, int, IdentityHash> map(1000, 8);
+        // First and last bucket of several 64-bucket words, the last bucket, and a chain at 5
+        const std::map<int, int> expected = {{0, 0}, {5, 1}, {1005, 2}, {63, 3}, {64, 4}, {127, 5}, {999, 6}};
+        for (const auto &entry: expected) {
+            ASSERT_TRUE(map.insert(entry.first, entry.second));
+        }
+        EXPECT_EQ(iterated(map), expected);
+    }
+
+    TEST(FixedUnorderedMapIterationTest, EraseAndClearUpdateOccupancy) {
+        RTMap<int, int, IdentityHash> map(256, 8);
+        map.insert(3, 3);
+        map.insert(259, 259);// chained behind 3
+        map.insert(200, 200);
+        ASSERT_TRUE(map.erase(3));// the chained entry moves into the primary bucket
+        EXPECT_EQ(iterated(map), (std::map<int, int>{{259, 259}, {200, 200}}));
+        ASSERT_TRUE(map.erase(259));
+        ASSERT_TRUE(map.erase(200));
+        EXPECT_TRUE(iterated(map).empty());
+        EXPECT_TRUE(map.begin() == map.end());
+
+        map.insert(255, 1);
+        map.insert(511, 2);
+        map.clear();
+        EXPECT_TRUE(map.begin() == map.end());
+        map.insert(7, 7);
+        EXPECT_EQ(iterated(map), (std::map<int, int>{{7, 7}}));
+    }
+
+    TEST(FixedUnorderedMapIterationTest, CapacityNotMultipleOfWord) {
+        CTMap<int, int, 70, 4, IdentityHash> map;
+        map.insert(69, 1);
+        map.insert(139, 2);// chained behind 69
+        map.insert(64, 3);
+        EXPECT_EQ(iterated(map), (std::map<int, int>{{64, 3}, {69, 1}, {139, 2}}));
+        map.extract(69);
+        EXPECT_EQ(iterated(map), (std::map<int, int>{{64, 3}, {139, 2}}));
+    }
+
+    TEST(FixedUnorderedMapIterationTest, ForEachVisitsEveryEntry) {
+        RTMap<int, int, IdentityHash> map(128, 16);
+        for (int key = 0; key < 300; key += 7) {
+            map.insert(key, key);
+        }
+        std::size_t visited = 0;
+        map.forEach([&visited](const int &key, int &value) {
+            EXPECT_EQ(key, value);
+            value = -key;
+            ++visited;
+        });
+        EXPECT_EQ(visited, map.size());
+        for (int key = 0; key < 300; key += 7) {
+            ASSERT_NE(map.find(key), nullptr);
+            EXPECT_EQ(*map.find(key), -key);
+        }
+    }
+
+    TEST(FixedUnorderedMapIterationTest, MergeSkipsEmptyBuckets) {
+        RTMap<int, int, IdentityHash> source(4096, 4);
+        source.insert(10, 1);
+        source.insert(4000, 2);
+        RTMap<int, int, IdentityHash> target(64, 16);
+        target.merge(source);
+        EXPECT_EQ(iterated(target), (std::map<int, int>{{10, 1}, {4000, 2}}));
+    }
+
+    TEST(FixedUnorderedMapStorageTest, EntriesLiveOnlyWhileOccupied) {
+        {
+            CTMap<int, Tracked, 16, 8, IdentityHash> map;
+            EXPECT_EQ(Tracked::live, 0);// empty buckets hold no entries
+            map.insert(1, Tracked(1));
+            map.insert(17, Tracked(17));// chained behind 1
+            map.insert_or_assign(33, Tracked(33));
+            map.insert(5, Tracked(5));
+            EXPECT_EQ(Tracked::live, 4);
+            ASSERT_TRUE(map.erase(1));// 17 moves into the primary bucket
+            EXPECT_EQ(Tracked::live, 3);
+            ASSERT_NE(map.find(17), nullptr);
+            EXPECT_EQ(map.find(17)->value, 17);
+            EXPECT_EQ(map.find(33)->value, 33);
+            EXPECT_EQ(map.extract(5).second.value, 5);
+            EXPECT_EQ(Tracked::live, 2);
+            map.clear();
+            EXPECT_EQ(Tracked::live, 0);
+            map.insert(2, Tracked(2));
+            map.insert(18, Tracked(18));
+        }
+        EXPECT_EQ(Tracked::live, 0);
+
+        {
+            RTMap<int, Tracked, IdentityHash> map(8, 4);
+            for (int key = 0; key < 12; ++key) {
+                map.insert(key, Tracked(key));
+            }
+            EXPECT_EQ(Tracked::live, 12);
+        }
+        EXPECT_EQ(Tracked::live, 0);
+    }
+
+    TEST(FixedUnorderedMapMoveTest, MoveTakesBucketsWithoutRehashing) {
+        RTMap<int, Tracked, IdentityHash> map(64, 8);
+        for (int key = 0; key < 100; key += 3) {
+            map.insert(key, Tracked(key));
+        }
+        const int live = Tracked::live;
+        const Tracked *entry = map.find(66);
+        RTMap<int, Tracked, IdentityHash> moved(std::move(map));
+        EXPECT_EQ(Tracked::live, live);
+        EXPECT_EQ(moved.find(66), entry);
+        EXPECT_EQ(moved.size(), 34u);
+        EXPECT_EQ(map.capacity(), 0u);
+
+        RTMap<int, Tracked, IdentityHash> target(4);
+        target.insert(1, Tracked(1));
+        target = std::move(moved);
+        EXPECT_EQ(Tracked::live, live);
+        EXPECT_EQ(target.find(1), nullptr);
+        ASSERT_NE(target.find(99), nullptr);
+        EXPECT_EQ(target.find(99)->value, 99);
+    }
+}// namespace ESTL
@@ -106,4 +106,21 @@ namespace ESTL {
         }
         EXPECT_EQ(this->set.size(), 10);
     }
+
+    TEST(FixedUnorderedSetMoveTest, MovedSetUsesItsOwnMap) {
+        RTUnorderedSet<int> set(32);
+        set.insert(1);
+        set.insert(2);
+        RTUnorderedSet<int> moved(std::move(set));
+        EXPECT_TRUE(moved.contains(2));
+        EXPECT_EQ(moved.size(), 2u);
+        moved.insert(3);
+
+        RTUnorderedSet<int> target(4);
+        target.insert(9);
+        target = std::move(moved);
+        EXPECT_EQ(target.size(), 3u);
+        EXPECT_FALSE(target.contains(9));
+        EXPECT_EQ(target.capacity(), 32u);
+    }
 }// namespace ESTL
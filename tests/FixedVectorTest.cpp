@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "../FixedVector.hpp"
+#include <algorithm>
 #include <vector>
 #include <thread>
 
@@ -306,6 +307,58 @@ TYPED_TEST(FixedVectorTest, Iterators) {
 //     EXPECT_EQ(vec2[2], 3);
 // }
 
+TEST(FixedVectorCopyMoveTest, CTCopyAndMoveKeepInlineStorage) {
+  CTVector<int, 64> source{1, 2, 3};
+  CTVector<int, 64> copy(source);
+  EXPECT_NE(&copy[0], &source[0]);
+  EXPECT_EQ(std::vector<int>(copy.begin(), copy.end()), (std::vector<int>{1, 2, 3}));
+
+  CTVector<int, 64> moved(std::move(copy));
+  EXPECT_EQ(moved.size(), 3u);
+  EXPECT_EQ(moved[2], 3);
+  EXPECT_TRUE(copy.empty()); // moved-from CT vectors stay usable
+  copy.push_back(7);
+  EXPECT_EQ(copy[0], 7);
+
+  source = moved;
+  source.push_back(4);
+  EXPECT_EQ(moved.size(), 3u);
+  EXPECT_EQ(source.size(), 4u);
+}
+
+TEST(FixedVectorCopyMoveTest, CTSwapIsElementwiseAndBounded) {
+  CTVector<int, 8> small{1, 2};
+  CTVector<int, 4> other{5, 6, 7};
+  const int *smallData = &small[0];
+  small.swap(other);
+  EXPECT_EQ(&small[0], smallData);
+  EXPECT_EQ(std::vector<int>(small.begin(), small.end()), (std::vector<int>{5, 6, 7}));
+  EXPECT_EQ(std::vector<int>(other.begin(), other.end()), (std::vector<int>{1, 2}));
+
+  CTVector<int, 8> big{1, 2, 3, 4, 5};
+  EXPECT_THROW(other.swap(big), std::out_of_range);
+  EXPECT_EQ(other.size(), 2u);
+  EXPECT_EQ(big.size(), 5u);
+}
+
+TEST(FixedVectorCopyMoveTest, RTSwapAndMoveExchangeBuffers) {
+  RTVector<int> first(100, {1, 2, 3});
+  RTVector<int> second(4, {9});
+  const int *firstData = &first[0];
+  first.swap(second);
+  EXPECT_EQ(&second[0], firstData);
+  EXPECT_EQ(second.capacity(), 100u);
+  EXPECT_EQ(first.capacity(), 4u);
+  EXPECT_EQ(first[0], 9);
+
+  RTVector<int> moved(std::move(second));
+  EXPECT_EQ(&moved[0], firstData);
+  EXPECT_EQ(moved.size(), 3u);
+  second = moved; // a moved-from vector can be assigned to
+  EXPECT_EQ(second[2], 3);
+  EXPECT_NE(&second[0], &moved[0]);
+}
+
 #if (ENABLE_THREAD_SAFETY)
 TYPED_TEST(FixedVectorTest, ThreadSafety) {
   this->vec.clear();
@@ -325,5 +378,34 @@ TYPED_TEST(FixedVectorTest, ThreadSafety) {
 
   EXPECT_EQ(this->vec.size(), 10);
 }
+
+// Buffer swaps lock both vectors - every push lands in one of the two buffers, never in one being handed over
+TEST(FixedVectorCopyMoveTest, RTSwapIsAtomicAgainstPushes) {
+  RTVector<int> first(20000);
+  RTVector<int> second(20000);
+  std::thread pushFirst([&first]() {
+    for (int i = 0; i < 5000; ++i) {
+      first.push_back(i);
+    }
+  });
+  std::thread pushSecond([&second]() {
+    for (int i = 5000; i < 10000; ++i) {
+      second.push_back(i);
+    }
+  });
+  for (int i = 0; i < 2000; ++i) {
+    first.swap(second);
+  }
+  pushFirst.join();
+  pushSecond.join();
+
+  std::vector<int> all(first.begin(), first.end());
+  all.insert(all.end(), second.begin(), second.end());
+  std::sort(all.begin(), all.end());
+  ASSERT_EQ(all.size(), 10000u);
+  for (int i = 0; i < 10000; ++i) {
+    ASSERT_EQ(all[i], i);
+  }
+}
 #endif
 }
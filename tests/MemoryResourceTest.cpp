@@ -0,0 +1,160 @@
+//
+// Memory resources and RT containers allocating from them
+//
+#include "../ESTLMemory.hpp"
+#include "../FixedList.hpp"
+#include "../FixedString.hpp"
+#include "../FixedUnorderedSet.hpp"
+#include "../FixedVector.hpp"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <map>
+#include <utility>
+
+namespace ESTL {
+
+    // Heap resource that records the bytes it has outstanding
+    class CountingResource : public MemoryResource {
+    public:
+        std::map<void *, std::size_t> live;
+
+        void *allocate(std::size_t bytes, std::size_t alignment) override {
+            void *pointer = defaultResource()->allocate(bytes, alignment);
+            live[pointer] = bytes;
+            return pointer;
+        }
+
+        void deallocate(void *pointer, std::size_t bytes, std::size_t alignment) override {
+            auto it = live.find(pointer);
+            ASSERT_NE(it, live.end());
+            EXPECT_EQ(it->second, bytes);
+            live.erase(it);
+            defaultResource()->deallocate(pointer, bytes, alignment);
+        }
+    };
+
+    TEST(MemoryResourceTest, ArenaAlignsAndResets) {
+        ArenaResource arena(4096);
+        void *first = arena.allocate(3, 1);
+        void *aligned = arena.allocate(64, 64);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(aligned) % 64, 0u);
+        EXPECT_GT(aligned, first);
+        EXPECT_THROW(arena.allocate(8192, 8), std::bad_alloc);
+
+        arena.reset();
+        EXPECT_EQ(arena.used(), 0u);
+        EXPECT_EQ(arena.allocate(3, 1), first);
+
+        alignas(16) unsigned char buffer[256];
+        ArenaResource local(buffer, sizeof(buffer));
+        EXPECT_EQ(local.allocate(200, 16), buffer);
+        EXPECT_THROW(local.allocate(100, 1), std::bad_alloc);
+    }
+
+    TEST(MemoryResourceTest, ContainersReturnTheirStorage) {
+        CountingResource counting;
+        {
+            RTVector<std::uint64_t> vector(100, &counting);
+            RTList<int> list(10, &counting);
+            RTMap<int, int> map(16, 8, &counting);
+            RTUnorderedSet<int> set(8, 4, &counting);
+            RTString string("resource", 12, &counting);
+            // Unordered maps and sets take buckets, chained buckets and the occupancy bitmap
+            EXPECT_EQ(counting.live.size(), 9u);
+            EXPECT_EQ(counting.live.at(vector.begin()), 100 * sizeof(std::uint64_t));
+
+            vector.push_back(7);
+            RTVector<std::uint64_t> copy(vector);
+            EXPECT_EQ(copy.resource(), &counting);
+            RTVector<std::uint64_t> moved(std::move(copy));
+            EXPECT_EQ(moved.size(), 1u);
+            EXPECT_EQ(moved[0], 7u);
+            EXPECT_EQ(counting.live.size(), 10u);
+
+            RTString other(4, &counting);
+            other = string;
+            EXPECT_STREQ(other.c_str(), "resource");
+            EXPECT_EQ(counting.live.size(), 11u);
+        }
+        EXPECT_TRUE(counting.live.empty());
+    }
+
+    TEST(MemoryResourceTest, ArenaBackedContainersReleasedByReset) {
+        ArenaResource arena(1 << 20);
+        for (int request = 0; request < 100; ++request) {
+            {
+                RTVector<int> ids(1000, &arena);
+                RTMap<int, int> index(256, 1000, &arena);
+                for (int i = 0; i < 1000; ++i) {
+                    ids.push_back(i);
+                    index.insert(i, request);
+                }
+                EXPECT_EQ(*index.find(999), request);
+                EXPECT_GT(arena.used(), 1000 * sizeof(int));
+            }
+            arena.reset();
+        }
+        EXPECT_EQ(arena.used(), 0u);
+    }
+
+    // Containers built from an initializer list take their storage from the resource as well
+    TEST(MemoryResourceTest, InitializerListConstructorsUseResource) {
+        ArenaResource arena(1 << 20);
+        std::size_t used = arena.used();
+        {
+            RTVector<int> listed({1, 2, 3}, 64, &arena);
+            EXPECT_GE(arena.used(), used + 64 * sizeof(int));
+            EXPECT_EQ(listed.resource(), &arena);
+            EXPECT_EQ(listed[2], 3);
+            used = arena.used();
+
+            RTVector<int> sized(32, {4, 5}, &arena);
+            EXPECT_GE(arena.used(), used + 32 * sizeof(int));
+            EXPECT_EQ(sized.resource(), &arena);
+            EXPECT_EQ(sized[1], 5);
+            used = arena.used();
+
+            RTList<int> list(16, {7, 8, 9}, &arena);
+            EXPECT_GT(arena.used(), used);
+            EXPECT_EQ(list.size(), 3u);
+            used = arena.used();
+
+            RTMap<int, int> map({{1, 10}, {2, 20}}, 16, 8, &arena);
+            EXPECT_GT(arena.used(), used);
+            EXPECT_EQ(map.resource(), &arena);
+            EXPECT_EQ(*map.find(2), 20);
+            used = arena.used();
+
+            RTUnorderedSet<int> set({3, 4, 5}, 16, 8, &arena);
+            EXPECT_GT(arena.used(), used);
+            EXPECT_TRUE(set.contains(4));
+        }
+        arena.reset();
+        EXPECT_EQ(arena.used(), 0u);
+    }
+
+    TEST(MemoryResourceTest, HugePageAndNumaResources) {
+        HugePageResource hugePages;
+        {
+            RTVector<std::uint32_t> table(1 << 20, &hugePages);
+            EXPECT_EQ(reinterpret_cast<std::uintptr_t>(table.begin()) % memory::HugePageSize, 0u);
+            for (std::uint32_t i = 0; i < (1u << 20); ++i) {
+                table.push_back(i);
+            }
+            EXPECT_EQ(table[123456], 123456u);
+        }
+
+        // Node 0 always exists; a missing node falls back to the default policy
+        for (int node: {0, 1000}) {
+            NumaResource numa(node);
+            RTMap<int, int> map(1024, 2000, &numa);
+            for (int i = 0; i < 2000; ++i) {
+                map.insert(i, -i);
+            }
+            EXPECT_EQ(*map.find(1999), -1999);
+            EXPECT_EQ(reinterpret_cast<std::uintptr_t>(map.resource()), reinterpret_cast<std::uintptr_t>(&numa));
+        }
+        EXPECT_THROW(NumaResource(-1), std::invalid_argument);
+    }
+
+}// namespace ESTL
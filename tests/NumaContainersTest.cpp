@@ -0,0 +1,200 @@
+//
+// NUMA partitioned and replicated wrappers - run with simulated node counts on single-node machines
+//
+#include "../NumaUnorderedMap.hpp"
+#include "../NumaVector.hpp"
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace ESTL {
+
+    TEST(NumaTopologyTest, NodeCountAndCurrentNode) {
+        EXPECT_GE(numa::nodeCount(), 1);
+        EXPECT_GE(numa::currentNode(), 0);
+        EXPECT_LT(numa::currentNode(), numa::nodeCount());
+    }
+
+    namespace {
+        // Value whose copy number failAt throws - copies are counted across all instances
+        struct FragileValue {
+            static int copies;
+            static int failAt;
+            int value;
+
+            explicit FragileValue(int v)
+                : value(v) {}
+            FragileValue(const FragileValue &other)
+                : value(other.value) {
+                countCopy();
+            }
+            FragileValue &operator=(const FragileValue &other) {
+                countCopy();
+                value = other.value;
+                return *this;
+            }
+
+            static void countCopy() {
+                if (++copies == failAt) {
+                    throw std::runtime_error("copy failed");
+                }
+            }
+        };
+        int FragileValue::copies = 0;
+        int FragileValue::failAt = 0;
+    }// namespace
+
+    class NumaContainersTest : public ::testing::TestWithParam<int> {};
+
+    TEST_P(NumaContainersTest, PartitionedMapRoutesByHash) {
+        NumaUnorderedMap<int, int> map(4096, 4096, NumaPlacement::Partitioned, GetParam());
+        ASSERT_EQ(map.nodes(), GetParam());
+        std::map<int, int> reference;
+        std::mt19937 rng(29);
+        for (int i = 0; i < 3000; ++i) {
+            int key = static_cast<int>(rng() % 10000);
+            if (map.insert(key, i)) {
+                reference[key] = i;
+            }
+        }
+        EXPECT_TRUE(map.erase(reference.begin()->first));
+        reference.erase(reference.begin());
+        map.insert_or_assign(-5, 5);
+        reference[-5] = 5;
+
+        EXPECT_EQ(map.size(), reference.size());
+        std::size_t shardTotal = 0;
+        for (int node = 0; node < map.nodes(); ++node) {
+            shardTotal += map.shard(node).size();
+            if (GetParam() > 1) {
+                EXPECT_GT(map.shard(node).size(), reference.size() / (2 * GetParam()));// keys spread over shards
+            }
+        }
+        EXPECT_EQ(shardTotal, reference.size());
+        for (const auto &entry: reference) {
+            ASSERT_NE(map.find(entry.first), nullptr);
+            EXPECT_EQ(*map.find(entry.first), entry.second);
+            EXPECT_NE(map.shard(map.nodeOf(entry.first)).find(entry.first), nullptr);
+        }
+        std::size_t visited = 0;
+        map.forEach([&](const int &key, int &value) {
+            EXPECT_EQ(reference.at(key), value);
+            ++visited;
+        });
+        EXPECT_EQ(visited, reference.size());
+    }
+
+    TEST_P(NumaContainersTest, ReplicatedMapKeepsCopiesInSync) {
+        NumaUnorderedMap<int, int> map(256, 256, NumaPlacement::Replicated, GetParam());
+        std::vector<std::thread> writers;
+        for (int t = 0; t < 4; ++t) {
+            writers.emplace_back([&map, t] {
+                for (int key = t * 100; key < t * 100 + 100; ++key) {
+                    map.insert(key, key * 2);
+                }
+            });
+        }
+        for (auto &writer: writers) {
+            writer.join();
+        }
+        EXPECT_TRUE(map.erase(7));
+        EXPECT_EQ(map.size(), 399u);
+        for (int node = 0; node < map.nodes(); ++node) {
+            EXPECT_EQ(map.shard(node).size(), 399u);
+            EXPECT_EQ(map.shard(node).find(7), nullptr);
+            EXPECT_EQ(*map.shard(node).find(399), 798);
+        }
+        EXPECT_EQ(*map.find(123), 246);
+    }
+
+    // A write that fails on a later replica is undone on the earlier ones
+    TEST(NumaReplicatedMapTest, FailedWriteLeavesReplicasIdentical) {
+        NumaUnorderedMap<int, FragileValue> map(64, 64, NumaPlacement::Replicated, 3);
+        map.insert(1, FragileValue(10));
+
+        FragileValue::copies = 0;
+        FragileValue::failAt = 2;// the second replica's copy
+        EXPECT_THROW(map.insert(2, FragileValue(20)), std::runtime_error);
+        FragileValue::copies = 0;
+        FragileValue::failAt = 3;// the saved old value, the first replica, then the second replica
+        EXPECT_THROW(map.insert_or_assign(1, FragileValue(11)), std::runtime_error);
+        FragileValue::copies = 0;
+        FragileValue::failAt = 3;// a new key - the first two replicas, then the third
+        EXPECT_THROW(map.insert_or_assign(3, FragileValue(30)), std::runtime_error);
+        FragileValue::failAt = 0;
+
+        for (int node = 0; node < map.nodes(); ++node) {
+            EXPECT_EQ(map.shard(node).size(), 1u);
+            EXPECT_EQ(map.shard(node).find(2), nullptr);
+            EXPECT_EQ(map.shard(node).find(3), nullptr);
+            ASSERT_NE(map.shard(node).find(1), nullptr);
+            EXPECT_EQ(map.shard(node).find(1)->value, 10);
+        }
+        EXPECT_TRUE(map.insert(2, FragileValue(20)));
+        EXPECT_FALSE(map.insert_or_assign(1, FragileValue(12)));
+        for (int node = 0; node < map.nodes(); ++node) {
+            EXPECT_EQ(map.shard(node).find(1)->value, 12);
+            EXPECT_EQ(map.shard(node).find(2)->value, 20);
+        }
+    }
+
+    TEST_P(NumaContainersTest, VectorShardsAndReplicas) {
+        NumaVector<int> partitioned(100, NumaPlacement::Partitioned, GetParam());
+        for (int i = 0; i < 100; ++i) {
+            partitioned.push_back(i);
+        }
+        EXPECT_EQ(partitioned.size(), 100u);
+        EXPECT_EQ(partitioned.local().size(), 100u);// this thread's node takes every append
+        EXPECT_THROW(partitioned.push_back(100), std::out_of_range);
+        EXPECT_THROW(partitioned[0], std::logic_error);
+        int sum = 0;
+        partitioned.forEach([&sum](int value) { sum += value; });
+        EXPECT_EQ(sum, 4950);
+
+        NumaVector<int> replicated(10, NumaPlacement::Replicated, GetParam());
+        for (int i = 0; i < 10; ++i) {
+            replicated.push_back(i * i);
+        }
+        EXPECT_THROW(replicated.push_back(0), std::out_of_range);
+        EXPECT_EQ(replicated.size(), 10u);
+        EXPECT_EQ(replicated[9], 81);
+        for (int node = 0; node < replicated.nodes(); ++node) {
+            EXPECT_EQ(replicated.shard(node).size(), 10u);
+            EXPECT_EQ(replicated.shard(node)[3], 9);
+        }
+        replicated.clear();
+        EXPECT_TRUE(replicated.empty());
+    }
+
+    TEST_P(NumaContainersTest, BulkInsertMatchesSerialInserts) {
+        ThreadPool pool(3);
+        std::vector<std::pair<int, int>> entries;
+        std::mt19937 rng(41);
+        for (int i = 0; i < 5000; ++i) {
+            entries.emplace_back(static_cast<int>(rng() % 4000), i);
+        }
+        for (NumaPlacement placement: {NumaPlacement::Partitioned, NumaPlacement::Replicated}) {
+            NumaUnorderedMap<int, int> bulk(8192, 8192, placement, GetParam());
+            NumaUnorderedMap<int, int> serial(8192, 8192, placement, GetParam());
+            bulk.insert(7, -1);
+            serial.insert(7, -1);
+            std::size_t inserted = 0;
+            for (const auto &entry: entries) {
+                inserted += serial.insert(entry.first, entry.second);
+            }
+            EXPECT_EQ(bulk.insertBulk(entries.begin(), entries.end(), pool), inserted);
+            ASSERT_EQ(bulk.size(), serial.size());
+            serial.forEach([&](const int &key, int &value) { EXPECT_EQ(*bulk.find(key), value); });
+            if (placement == NumaPlacement::Replicated) {
+                for (int node = 0; node < bulk.nodes(); ++node) {
+                    EXPECT_EQ(bulk.shard(node).size(), serial.size());
+                }
+            }
+        }
+    }
+
+    INSTANTIATE_TEST_SUITE_P(SimulatedNodes, NumaContainersTest, ::testing::Values(1, 2, 3));
+
+}// namespace ESTL
@@ -0,0 +1,145 @@
+//
+// Parallel algorithms against their std:: counterparts, on pools with and without workers
+//
+#include "../ESTLParallel.hpp"
+#include <algorithm>
+#include <functional>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace ESTL {
+    namespace {
+        template<typename T>
+        std::vector<T> contents(const FixedVector<T> &vector) {
+            return std::vector<T>(vector.begin(), vector.end());
+        }
+
+        void fillRandom(FixedVector<int> &vector, std::size_t count, int range, unsigned seed) {
+            std::mt19937 rng(seed);
+            vector.clear();
+            for (std::size_t i = 0; i < count; ++i) {
+                vector.push_back(static_cast<int>(rng() % static_cast<unsigned>(range)));
+            }
+        }
+    }// namespace
+
+    // Worker count as parameter - 0 runs everything on the caller
+    class ParallelAlgorithmsTest : public ::testing::TestWithParam<unsigned> {
+    protected:
+        ThreadPool pool;
+        RTVector<int> vector;
+
+        ParallelAlgorithmsTest()
+            : pool(GetParam())
+            , vector(300000) {}
+    };
+
+    TEST_P(ParallelAlgorithmsTest, SortMatchesStdSort) {
+        for (std::size_t count: {0u, 1u, 1000u, 70000u, 300000u}) {
+            fillRandom(vector, count, 1 << 30, 7);
+            std::vector<int> expected = contents(vector);
+            std::sort(expected.begin(), expected.end());
+            parallel::sort(vector, std::less<int>(), pool);
+            EXPECT_EQ(contents(vector), expected) << count << " elements";
+        }
+        // Heavy duplicates and a custom order
+        fillRandom(vector, 200000, 3, 9);
+        parallel::sort(vector, std::greater<int>(), pool);
+        EXPECT_TRUE(std::is_sorted(vector.begin(), vector.end(), std::greater<int>()));
+        EXPECT_EQ(std::count(vector.begin(), vector.end(), 1) + std::count(vector.begin(), vector.end(), 0) +
+                          std::count(vector.begin(), vector.end(), 2),
+                  200000);
+        // Already sorted input
+        parallel::sort(vector, std::less<int>(), pool);
+        EXPECT_TRUE(std::is_sorted(vector.begin(), vector.end()));
+    }
+
+    TEST_P(ParallelAlgorithmsTest, TransformAndReduce) {
+        fillRandom(vector, 100000, 1000, 3);
+        RTVector<long long> squares(100000);
+        parallel::transform(vector, squares, [](int value) { return 1LL * value * value; }, pool);
+        ASSERT_EQ(squares.size(), vector.size());
+        for (std::size_t i = 0; i < vector.size(); ++i) {
+            ASSERT_EQ(squares[i], 1LL * vector[i] * vector[i]);
+        }
+        const long long expected = std::accumulate(squares.begin(), squares.end(), 5LL);
+        EXPECT_EQ(parallel::reduce(squares, 5LL, std::plus<long long>(), pool), expected);
+
+        // In place, and into an output too small
+        parallel::transform(vector, vector, [](int value) { return -value; }, pool);
+        EXPECT_LE(*std::max_element(vector.begin(), vector.end()), 0);
+        RTVector<long long> small(10);
+        EXPECT_THROW(parallel::transform(vector, small, [](int value) { return 1LL * value; }, pool),
+                     std::out_of_range);
+        EXPECT_EQ(small.size(), 0u);
+
+        RTVector<int> empty(4);
+        EXPECT_EQ(parallel::reduce(empty, 42, std::plus<int>(), pool), 42);
+    }
+
+    TEST_P(ParallelAlgorithmsTest, ScansMatchSerialScans) {
+        fillRandom(vector, 123457, 100, 5);
+        std::vector<int> source = contents(vector);
+        std::vector<int> inclusive(source.size());
+        std::partial_sum(source.begin(), source.end(), inclusive.begin());
+
+        RTVector<int> out(300000);
+        parallel::inclusive_scan(vector, out, std::plus<int>(), pool, 1000);
+        EXPECT_EQ(contents(out), inclusive);
+
+        parallel::exclusive_scan(vector, out, 10, std::plus<int>(), pool, 1000);
+        ASSERT_EQ(out.size(), source.size());
+        EXPECT_EQ(out[0], 10);
+        for (std::size_t i = 1; i < source.size(); ++i) {
+            ASSERT_EQ(out[i], 10 + inclusive[i - 1]);
+        }
+
+        // In place
+        parallel::inclusive_scan(vector, vector, std::plus<int>(), pool, 1000);
+        EXPECT_EQ(contents(vector), inclusive);
+    }
+
+    TEST_P(ParallelAlgorithmsTest, OrderedCombineForNonCommutativeOps) {
+        RTVector<std::string> words(3000);
+        for (int i = 0; i < 3000; ++i) {
+            words.push_back(std::string(1, static_cast<char>('a' + i % 26)));
+        }
+        std::string expected = ">";
+        for (const std::string &word: words) {
+            expected += word;
+        }
+        EXPECT_EQ(parallel::reduce(words, std::string(">"), std::plus<std::string>(), pool, 64), expected);
+
+        parallel::inclusive_scan(words, words, std::plus<std::string>(), pool, 64);
+        EXPECT_EQ(">" + words[2999], expected);
+        EXPECT_EQ(words[2], "abc");
+    }
+
+    TEST_P(ParallelAlgorithmsTest, PartitionIsStable) {
+        fillRandom(vector, 250000, 1000000, 11);
+        std::vector<int> expected = contents(vector);
+        auto isEven = [](int value) { return value % 2 == 0; };
+        auto split = std::stable_partition(expected.begin(), expected.end(), isEven);
+
+        int *middle = parallel::partition(vector, isEven, pool);
+        EXPECT_EQ(middle - vector.begin(), split - expected.begin());
+        EXPECT_EQ(contents(vector), expected);
+
+        RTVector<int> none(8);
+        none.push_back(1);
+        EXPECT_EQ(parallel::partition(none, isEven, pool), none.begin());
+    }
+
+    TEST_P(ParallelAlgorithmsTest, GrainHeuristic) {
+        EXPECT_EQ(parallel::grainFor(100, pool), parallel::kMinGrain);
+        EXPECT_EQ(parallel::grainFor(100, pool, 7), 7u);
+        const std::size_t big = std::size_t(1) << 26;
+        EXPECT_EQ(parallel::grainFor(big, pool),
+                  std::max(parallel::kMinGrain, big / (parallel::kPiecesPerThread * pool.concurrency())));
+    }
+
+    INSTANTIATE_TEST_SUITE_P(Workers, ParallelAlgorithmsTest, ::testing::Values(0u, 3u));
+}// namespace ESTL
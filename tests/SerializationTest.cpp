@@ -0,0 +1,196 @@
+//
+// Binary serialization of vectors, lists, strings and unordered containers
+//
+#include "../ESTLSerialization.hpp"
+#include "../FixedList.hpp"
+#include "../FixedString.hpp"
+#include "../FixedUnorderedSet.hpp"
+#include "../FixedVector.hpp"
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <sstream>
+#include <vector>
+
+namespace ESTL {
+
+    TEST(SerializationTest, VectorStreamsThroughSmallBuffer) {
+        RTVector<std::uint64_t> vector(10000);
+        for (std::uint64_t i = 0; i < 10000; ++i) {
+            vector.push_back(i * i);
+        }
+        CTList<short, 8> list{1, 2, 3};
+
+        std::stringstream stream;
+        char buffer[64];
+        {
+            BinaryWriter writer(stream, buffer, sizeof(buffer));
+            serialize(writer, list);
+            serialize(writer, vector);// larger than the buffer - written directly
+            serialize(writer, list);
+            writer.flush();
+            EXPECT_EQ(writer.bytesWritten(), 3 * sizeof(RecordHeader) + 10000 * 8 + 6 * sizeof(short));
+        }
+
+        RTVector<std::uint64_t> loaded(10000);
+        loaded.push_back(42);
+        CTList<short, 8> first;
+        CTList<short, 8> last;
+        BinaryReader reader(stream, buffer, sizeof(buffer));
+        deserialize(reader, first);
+        deserialize(reader, loaded);
+        deserialize(reader, last);
+        ASSERT_EQ(loaded.size(), 10000u);
+        for (std::uint64_t i = 0; i < 10000; ++i) {
+            EXPECT_EQ(loaded[i], i * i);
+        }
+        EXPECT_EQ(std::vector<short>(first.begin(), first.end()), (std::vector<short>{1, 2, 3}));
+        EXPECT_EQ(std::vector<short>(last.begin(), last.end()), (std::vector<short>{1, 2, 3}));
+        EXPECT_THROW(deserialize(reader, last), std::runtime_error);
+    }
+
+    TEST(SerializationTest, StringsAndNestedElements) {
+        CTVector<CTString<12>, 4> words;
+        words.push_back(CTString<12>("fixed"));
+        words.push_back(CTString<12>(""));
+        words.push_back(CTString<12>("twelve chars"));
+        RTString note("checkpoint", 16);
+
+        char buffer[256];
+        BinaryWriter writer(buffer, sizeof(buffer));
+        serialize(writer, words);
+        serialize(writer, note);
+
+        CTVector<CTString<12>, 4> loadedWords;
+        RTString loadedNote(16);
+        BinaryReader reader(writer.data(), writer.size());
+        deserialize(reader, loadedWords);
+        deserialize(reader, loadedNote);
+        ASSERT_EQ(loadedWords.size(), 3u);
+        EXPECT_STREQ(loadedWords[0].c_str(), "fixed");
+        EXPECT_TRUE(loadedWords[1].empty());
+        EXPECT_STREQ(loadedWords[2].c_str(), "twelve chars");
+        EXPECT_EQ(loadedNote.size(), 10u);
+        EXPECT_STREQ(loadedNote.c_str(), "checkpoint");
+
+        BinaryReader again(writer.data(), writer.size());
+        CTVector<CTString<12>, 2> tooFew;
+        EXPECT_THROW(deserialize(again, tooFew), std::out_of_range);
+        EXPECT_TRUE(tooFew.empty());
+
+        char small[8];
+        BinaryWriter full(small, sizeof(small));
+        EXPECT_THROW(serialize(full, note), std::out_of_range);
+    }
+
+    TEST(SerializationTest, UnorderedMapAndSet) {
+        RTMap<int, double> map(32, 512);
+        std::map<int, double> reference;
+        std::mt19937 rng(17);
+        for (int i = 0; i < 400; ++i) {
+            int key = static_cast<int>(rng() % 1000);
+            if (map.insert(key, i / 4.0)) {
+                reference[key] = i / 4.0;
+            }
+        }
+        RTUnorderedSet<long> set({5, 7, 11}, 8);
+
+        std::stringstream stream;
+        char buffer[128];
+        BinaryWriter writer(stream, buffer, sizeof(buffer));
+        serialize(writer, map);
+        serialize(writer, set);
+        writer.flush();
+
+        RTMap<int, double> loaded(64, 512);
+        loaded.insert(-1, -1.0);
+        RTUnorderedSet<long> loadedSet(4);
+        BinaryReader reader(stream, buffer, sizeof(buffer));
+        deserialize(reader, loaded);
+        deserialize(reader, loadedSet);
+        EXPECT_EQ(loaded.size(), reference.size());
+        EXPECT_EQ(loaded.find(-1), nullptr);
+        for (const auto &entry: reference) {
+            ASSERT_NE(loaded.find(entry.first), nullptr);
+            EXPECT_EQ(*loaded.find(entry.first), entry.second);
+        }
+        EXPECT_EQ(loadedSet.size(), 3u);
+        EXPECT_TRUE(loadedSet.contains(11));
+    }
+
+    TEST(SerializationTest, MapKeysChainingPastThePoolThrowOutOfRange) {
+        // Multiples of 4 all land in bucket 0 of a 4 slot map: 10 keys need 9 pool buckets
+        RTMap<int, double> map(64, 16);
+        for (int i = 0; i < 10; ++i) {
+            map.insert(4 * i, i);
+        }
+        char buffer[512];
+        BinaryWriter writer(buffer, sizeof(buffer));
+        serialize(writer, map);
+
+        RTMap<int, double> small(4, 8);
+        small.insert(1, 1.0);
+        BinaryReader reader(writer.data(), writer.size());
+        EXPECT_THROW(deserialize(reader, small), std::out_of_range);
+        EXPECT_EQ(small.find(1), nullptr);// Cleared, then filled up to the pool
+        EXPECT_EQ(small.size(), 9u);
+
+        RTMap<int, double> large(4, 9);
+        BinaryReader again(writer.data(), writer.size());
+        deserialize(again, large);
+        EXPECT_EQ(large.size(), 10u);
+    }
+
+    namespace {
+        // Trivially copyable, not default-constructible
+        struct Reading {
+            explicit Reading(int value)
+                : value(value) {}
+            int value;
+        };
+    }// namespace
+
+    TEST(SerializationTest, RawElementsNeedNoDefaultConstructor) {
+        CTList<Reading, 4> list;
+        list.push_back(Reading(3));
+        list.push_back(Reading(4));
+        RTMap<int, Reading> map(8);
+        map.insert(7, Reading(70));
+
+        char buffer[256];
+        BinaryWriter writer(buffer, sizeof(buffer));
+        serialize(writer, list);
+        serialize(writer, map);
+
+        CTList<Reading, 4> loadedList;
+        RTMap<int, Reading> loadedMap(8);
+        BinaryReader reader(writer.data(), writer.size());
+        deserialize(reader, loadedList);
+        deserialize(reader, loadedMap);
+        ASSERT_EQ(loadedList.size(), 2u);
+        EXPECT_EQ(loadedList.front().value, 3);
+        EXPECT_EQ(loadedList.back().value, 4);
+        ASSERT_NE(loadedMap.find(7), nullptr);
+        EXPECT_EQ(loadedMap.find(7)->value, 70);
+    }
+
+    TEST(SerializationTest, RejectsMismatchedRecords) {
+        CTVector<int, 4> vector{1, 2, 3};
+        char buffer[128];
+        BinaryWriter writer(buffer, sizeof(buffer));
+        serialize(writer, vector);
+
+        CTVector<long, 4> wider;
+        BinaryReader asWider(writer.data(), writer.size());
+        EXPECT_THROW(deserialize(asWider, wider), std::runtime_error);
+
+        CTList<int, 4> list;
+        BinaryReader asList(writer.data(), writer.size());
+        EXPECT_THROW(deserialize(asList, list), std::runtime_error);
+
+        CTVector<int, 4> truncated;
+        BinaryReader shortInput(writer.data(), writer.size() - 1);
+        EXPECT_THROW(deserialize(shortInput, truncated), std::runtime_error);
+    }
+
+}// namespace ESTL
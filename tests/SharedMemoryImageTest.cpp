@@ -0,0 +1,116 @@
+//
+// Container images published in POSIX shared memory and attached from other processes
+//
+#include "../FixedListImage.hpp"
+#include "../FixedUnorderedMapImage.hpp"
+#include "../FixedVectorImage.hpp"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace ESTL {
+
+    class SharedMemoryImageTest : public ::testing::Test {
+    protected:
+        SharedMemoryName segment{"/estl-test-" + std::to_string(getpid())};
+
+        void TearDown() override { removeSharedImage(segment); }
+    };
+
+    TEST_F(SharedMemoryImageTest, VectorRoundTrip) {
+        RTVector<std::uint32_t> vector(1000);
+        for (std::uint32_t i = 0; i < 1000; ++i) {
+            vector.push_back(i * 3);
+        }
+        saveImage(vector, segment);
+
+        MappedVector<std::uint32_t> mapped(segment);
+        ASSERT_EQ(mapped.size(), 1000u);
+        EXPECT_EQ(mapped.front(), 0u);
+        EXPECT_EQ(mapped.back(), 2997u);
+        std::uint32_t expected = 0;
+        for (std::uint32_t value: mapped) {
+            EXPECT_EQ(value, expected);
+            expected += 3;
+        }
+        EXPECT_THROW(mapped[1000], std::out_of_range);
+        EXPECT_THROW((MappedList<std::uint32_t>(segment)), std::runtime_error);
+    }
+
+    TEST_F(SharedMemoryImageTest, ListKeepsSequenceOrder) {
+        RTList<int> list(16);
+        list.push_back(2);
+        list.push_back(3);
+        list.push_front(1);
+        list.push_back(4);
+        list.pop_front();
+        saveImage(list, segment);
+
+        MappedList<int> mapped(segment);
+        ASSERT_EQ(mapped.size(), 3u);
+        EXPECT_EQ(mapped.front(), 2);
+        EXPECT_EQ(mapped.back(), 4);
+        int expected = 2;
+        for (int value: mapped) {
+            EXPECT_EQ(value, expected++);
+        }
+
+        RTList<int> empty(4);
+        saveImage(empty, segment);
+        MappedList<int> attached(segment);
+        EXPECT_TRUE(attached.empty());
+        EXPECT_THROW(attached.front(), std::out_of_range);
+    }
+
+    TEST_F(SharedMemoryImageTest, RepublishKeepsAttachedImage) {
+        RTMap<int, int> map(64);
+        map.insert(1, 10);
+        saveImage(map, segment);
+        MappedUnorderedMap<int, int> before(segment);
+
+        map.insert(2, 20);
+        saveImage(map, segment);
+        MappedUnorderedMap<int, int> after(segment);
+        EXPECT_EQ(before.size(), 1u);
+        EXPECT_FALSE(before.contains(2));
+        EXPECT_EQ(*after.find(2), 20);
+
+        removeSharedImage(segment);
+        EXPECT_THROW((MappedUnorderedMap<int, int>(segment)), std::runtime_error);
+        EXPECT_EQ(*before.find(1), 10);
+    }
+
+    TEST_F(SharedMemoryImageTest, ChildProcessAttaches) {
+        RTMap<std::uint64_t, std::uint64_t> map(512, 4096);
+        for (std::uint64_t key = 0; key < 3000; ++key) {
+            map.insert(key * 7, key);
+        }
+        saveImage(map, segment);
+
+        pid_t child = fork();
+        ASSERT_NE(child, -1);
+        if (child == 0) {
+            // Plain exit codes - gtest assertions do not cross the fork
+            int status = 0;
+            try {
+                MappedUnorderedMap<std::uint64_t, std::uint64_t> mapped(segment);
+                status |= mapped.size() == 3000 ? 0 : 1;
+                for (std::uint64_t key = 0; key < 3000; ++key) {
+                    const std::uint64_t *value = mapped.find(key * 7);
+                    status |= value && *value == key ? 0 : 2;
+                    status |= mapped.contains(key * 7 + 1) ? 4 : 0;
+                }
+            } catch (...) {
+                status = 8;
+            }
+            _exit(status);
+        }
+        int status = 0;
+        ASSERT_EQ(waitpid(child, &status, 0), child);
+        ASSERT_TRUE(WIFEXITED(status));
+        EXPECT_EQ(WEXITSTATUS(status), 0);
+    }
+
+}// namespace ESTL
@@ -0,0 +1,185 @@
+//
+// Radix sort, sorting networks and the size / type dispatch against std::sort
+//
+#include "../ESTLSort.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace ESTL {
+    namespace {
+        template<typename T>
+        std::vector<T> contents(const FixedVector<T> &vector) {
+            return std::vector<T>(vector.begin(), vector.end());
+        }
+
+        template<typename T>
+        void fillRandom(FixedVector<T> &vector, std::size_t count, unsigned seed) {
+            std::mt19937_64 rng(seed);
+            vector.clear();
+            for (std::size_t i = 0; i < count; ++i) {
+                vector.push_back(static_cast<T>(rng()));
+            }
+        }
+
+        template<typename T>
+        void expectSortedLikeStd(FixedVector<T> &vector, void (*sorter)(FixedVector<T> &)) {
+            std::vector<T> expected = contents(vector);
+            std::sort(expected.begin(), expected.end());
+            sorter(vector);
+            EXPECT_EQ(contents(vector), expected);
+        }
+
+        struct Record {
+            std::int32_t key = 0;
+            std::string name;
+        };
+    }// namespace
+
+    TEST(RadixSortTest, UnsignedSignedAndFloatingKeys) {
+        RTVector<std::uint32_t> u32(20000);
+        fillRandom(u32, 20000, 1);
+        expectSortedLikeStd<std::uint32_t>(u32, [](FixedVector<std::uint32_t> &v) { sorting::radix_sort(v); });
+
+        RTVector<std::uint64_t> u64(20000);
+        fillRandom(u64, 20000, 2);
+        expectSortedLikeStd<std::uint64_t>(u64, [](FixedVector<std::uint64_t> &v) { sorting::radix_sort(v); });
+
+        RTVector<std::int64_t> i64(20001);
+        fillRandom(i64, 20000, 3);
+        i64.push_back(std::numeric_limits<std::int64_t>::min());
+        expectSortedLikeStd<std::int64_t>(i64, [](FixedVector<std::int64_t> &v) { sorting::radix_sort(v); });
+
+        RTVector<double> doubles(5000);
+        std::mt19937 rng(4);
+        std::uniform_real_distribution<double> spread(-1e6, 1e6);
+        for (int i = 0; i < 4990; ++i) {
+            doubles.push_back(spread(rng));
+        }
+        for (double special: {0.0, -0.5, 1e300, -1e300, std::numeric_limits<double>::infinity(),
+                              -std::numeric_limits<double>::infinity(), 3.0, 3.0, -1e-300, 1e-300}) {
+            doubles.push_back(special);
+        }
+        expectSortedLikeStd<double>(doubles, [](FixedVector<double> &v) { sorting::radix_sort(v); });
+
+        RTVector<float> floats(4);
+        for (float value: {2.5f, -2.5f, 0.0f, -7.0f}) {
+            floats.push_back(value);
+        }
+        sorting::radix_sort(floats);
+        EXPECT_EQ(contents(floats), (std::vector<float>{-7.0f, -2.5f, 0.0f, 2.5f}));
+    }
+
+    TEST(RadixSortTest, RecordsByKeyAreSortedStably) {
+        RTVector<Record> records(3000);
+        std::mt19937 rng(5);
+        for (int i = 0; i < 3000; ++i) {
+            records.push_back(Record{static_cast<std::int32_t>(rng() % 50) - 25, std::to_string(i)});
+        }
+        std::vector<Record> expected = contents(records);
+        auto byKey = [](const Record &a, const Record &b) { return a.key < b.key; };
+        std::stable_sort(expected.begin(), expected.end(), byKey);
+
+        RTVector<Record> scratch(4000);
+        sorting::radix_sort(records, scratch, [](const Record &record) { return record.key; });
+        ASSERT_EQ(records.size(), expected.size());
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            EXPECT_EQ(records[i].key, expected[i].key);
+            EXPECT_EQ(records[i].name, expected[i].name);
+        }
+    }
+
+    TEST(RadixSortTest, CallerScratchIsChecked) {
+        RTVector<std::uint16_t> values(100), small(10);
+        for (int i = 0; i < 100; ++i) {
+            values.push_back(static_cast<std::uint16_t>(100 - i));
+        }
+        EXPECT_THROW(sorting::radix_sort(values, small), std::out_of_range);
+        EXPECT_THROW(sorting::radix_sort(values, values), std::invalid_argument);
+        RTVector<std::uint16_t> scratch(100);
+        sorting::radix_sort(values, scratch);
+        EXPECT_TRUE(std::is_sorted(values.begin(), values.end()));
+        EXPECT_EQ(values.size(), 100u);
+    }
+
+    TEST(NetworkSortTest, EverySizeUpTo64) {
+        std::mt19937 rng(6);
+        CTVector<int, 64> small;
+        for (std::size_t count = 0; count <= 64; ++count) {
+            small.clear();
+            for (std::size_t i = 0; i < count; ++i) {
+                small.push_back(static_cast<int>(rng() % 41) - 20);
+            }
+            expectSortedLikeStd<int>(small, [](FixedVector<int> &v) { sorting::network_sort(v); });
+        }
+        // Values equal to the padding
+        small.clear();
+        for (int value: {std::numeric_limits<int>::max(), 1, std::numeric_limits<int>::min()}) {
+            small.push_back(value);
+        }
+        sorting::network_sort(small);
+        EXPECT_EQ(contents(small),
+                  (std::vector<int>{std::numeric_limits<int>::min(), 1, std::numeric_limits<int>::max()}));
+
+        CTVector<double, 20> doubles;
+        for (double value: {0.5, -3.0, 2.0, 2.0, -0.25, 9.0, 1e9}) {
+            doubles.push_back(value);
+        }
+        expectSortedLikeStd<double>(doubles, [](FixedVector<double> &v) { sorting::network_sort(v); });
+
+        RTVector<int> large(65);
+        fillRandom(large, 65, 7);
+        EXPECT_THROW(sorting::network_sort(large), std::out_of_range);
+    }
+
+    TEST(NetworkSortTest, InfinitiesSortAfterThePadding) {
+        const float inf = std::numeric_limits<float>::infinity();
+        CTVector<float, 64> floats;
+        for (std::size_t count: {3u, 5u, 7u, 13u, 33u}) {
+            fillRandom(floats, count - 2, static_cast<unsigned>(count));
+            floats.push_back(inf);
+            floats.push_back(-inf);
+            expectSortedLikeStd<float>(floats, [](FixedVector<float> &v) { sorting::network_sort(v); });
+            EXPECT_EQ(floats[count - 1], inf) << count << " elements";
+        }
+
+        // Through sort(), which takes the network for small vectors
+        CTVector<float, 8> small;
+        for (float value: {inf, 1.0f, -2.0f}) {
+            small.push_back(value);
+        }
+        sorting::sort(small);
+        EXPECT_EQ(contents(small), (std::vector<float>{-2.0f, 1.0f, inf}));
+
+        const double dinf = std::numeric_limits<double>::infinity();
+        CTVector<double, 8> doubles;
+        for (double value: {dinf, 0.5, dinf, -dinf, 2.0, -1.0}) {
+            doubles.push_back(value);
+        }
+        sorting::sort(doubles);
+        EXPECT_EQ(contents(doubles), (std::vector<double>{-dinf, -1.0, 0.5, 2.0, dinf, dinf}));
+    }
+
+    TEST(SortDispatchTest, EverySizeAndTypeSorts) {
+        RTVector<std::uint32_t> values(10000), scratch(10000);
+        for (std::size_t count: {0u, 1u, 8u, 9u, 64u, 65u, 2047u, 2048u, 10000u}) {
+            fillRandom(values, count, static_cast<unsigned>(count));
+            expectSortedLikeStd<std::uint32_t>(values, [](FixedVector<std::uint32_t> &v) { sorting::sort(v); });
+            fillRandom(values, count, static_cast<unsigned>(count) + 1);
+            std::vector<std::uint32_t> expected = contents(values);
+            std::sort(expected.begin(), expected.end());
+            sorting::sort(values, scratch);
+            EXPECT_EQ(contents(values), expected);
+        }
+
+        RTVector<std::string> words(4000);
+        for (int i = 0; i < 4000; ++i) {
+            words.push_back(std::to_string((i * 7919) % 4000));
+        }
+        expectSortedLikeStd<std::string>(words, [](FixedVector<std::string> &v) { sorting::sort(v); });
+    }
+}// namespace ESTL
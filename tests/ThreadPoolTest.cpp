@@ -0,0 +1,163 @@
+//
+// Work-stealing deque and thread pool - run with more workers than cores, so steals and sleeps both happen
+//
+#include "../ESTLParallel.hpp"
+#include <atomic>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace ESTL {
+
+    TEST(WorkStealingDequeTest, OwnerIsLifoThievesAreFifo) {
+        WorkStealingDeque<int, 4> deque;
+        int item = 0;
+        EXPECT_FALSE(deque.pop(item));
+        EXPECT_FALSE(deque.steal(item));
+        for (int i = 1; i <= 4; ++i) {
+            EXPECT_TRUE(deque.push(i));
+        }
+        EXPECT_FALSE(deque.push(5));
+        EXPECT_EQ(deque.size(), 4u);
+
+        ASSERT_TRUE(deque.pop(item));
+        EXPECT_EQ(item, 4);
+        ASSERT_TRUE(deque.steal(item));
+        EXPECT_EQ(item, 1);
+        EXPECT_TRUE(deque.push(6));
+        EXPECT_TRUE(deque.push(7));
+        EXPECT_FALSE(deque.push(8));
+
+        std::vector<int> rest;
+        while (deque.pop(item)) {
+            rest.push_back(item);
+        }
+        EXPECT_EQ(rest, (std::vector<int>{7, 6, 3, 2}));
+        EXPECT_TRUE(deque.empty());
+    }
+
+    TEST(WorkStealingDequeTest, EveryItemIsTakenExactlyOnce) {
+        constexpr int kItems = 200000;
+        WorkStealingDeque<int, 256> deque;
+        std::vector<std::atomic<int>> taken(kItems);
+        for (auto &count: taken) {
+            count.store(0);
+        }
+        std::atomic<bool> done(false);
+        auto take = [&](int item) { taken[static_cast<std::size_t>(item)].fetch_add(1); };
+
+        std::vector<std::thread> thieves;
+        for (int t = 0; t < 3; ++t) {
+            thieves.emplace_back([&] {
+                int item;
+                while (! done.load()) {
+                    if (deque.steal(item)) {
+                        take(item);
+                    }
+                }
+                while (deque.steal(item)) {
+                    take(item);
+                }
+            });
+        }
+        int item;
+        for (int next = 0; next < kItems;) {
+            if (deque.push(next)) {
+                ++next;
+            } else if (deque.pop(item)) {
+                take(item);
+            }
+            if (next % 3 == 0 && deque.pop(item)) {
+                take(item);
+            }
+        }
+        while (deque.pop(item)) {
+            take(item);
+        }
+        done.store(true);
+        for (auto &thief: thieves) {
+            thief.join();
+        }
+        for (int i = 0; i < kItems; ++i) {
+            ASSERT_EQ(taken[static_cast<std::size_t>(i)].load(), 1) << "item " << i;
+        }
+    }
+
+    TEST(ThreadPoolTest, ParallelForCoversEveryIndexOnce) {
+        ThreadPool pool(3);
+        EXPECT_EQ(pool.concurrency(), 4u);
+        for (std::size_t grain: {0u, 1u, 7u, 100000u}) {
+            std::vector<std::atomic<int>> hits(10000);
+            for (auto &hit: hits) {
+                hit.store(0);
+            }
+            pool.parallelFor(0, hits.size(), grain, [&](std::size_t begin, std::size_t end) {
+                ASSERT_LT(begin, end);
+                for (std::size_t i = begin; i < end; ++i) {
+                    hits[i].fetch_add(1);
+                }
+            });
+            for (auto &hit: hits) {
+                ASSERT_EQ(hit.load(), 1);
+            }
+        }
+        bool called = false;
+        pool.parallelFor(5, 5, 1, [&](std::size_t, std::size_t) { called = true; });
+        EXPECT_FALSE(called);
+    }
+
+    TEST(ThreadPoolTest, NestedJobsAndPoolWithoutWorkers) {
+        ThreadPool pool(2);
+        std::atomic<long> total(0);
+        pool.parallelFor(0, 16, 1, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t outer = begin; outer < end; ++outer) {
+                pool.parallelFor(0, 1000, 10, [&](std::size_t b, std::size_t e) {
+                    total.fetch_add(static_cast<long>(e - b));
+                });
+            }
+        });
+        EXPECT_EQ(total.load(), 16000);
+
+        ThreadPool inline0(0);
+        long sum = 0;
+        inline0.parallelFor(0, 100, 1, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                sum += static_cast<long>(i);
+            }
+        });
+        EXPECT_EQ(sum, 4950);
+    }
+
+    TEST(ThreadPoolTest, FirstExceptionReachesTheCaller) {
+        ThreadPool pool(3);
+        EXPECT_THROW(pool.parallelFor(0, 1000, 1,
+                                      [](std::size_t begin, std::size_t) {
+                                          if (begin == 500) {
+                                              throw std::runtime_error("piece failed");
+                                          }
+                                      }),
+                     std::runtime_error);
+        // The pool stays usable
+        std::atomic<int> pieces(0);
+        pool.parallelFor(0, 64, 1, [&](std::size_t, std::size_t) { pieces.fetch_add(1); });
+        EXPECT_EQ(pieces.load(), 64);
+    }
+
+    TEST(ThreadPoolTest, ParallelForEachOverFixedVector) {
+        ThreadPool pool(3);
+        RTVector<int> vector(50000);
+        for (int i = 0; i < 50000; ++i) {
+            vector.push_back(i);
+        }
+        parallel::for_each(vector, [](int &value) { value *= 2; }, pool);
+        long long sum = std::accumulate(vector.begin(), vector.end(), 0LL);
+        EXPECT_EQ(sum, 2LL * 49999 * 50000 / 2);
+
+        CTVector<int, 64> small;
+        small.push_back(1);
+        parallel::for_each(small, [](int &value) { value = 9; }, pool);
+        EXPECT_EQ(small[0], 9);
+    }
+}// namespace ESTL
@@ -0,0 +1,187 @@
+// Traced instantiations use types private to this file, so they do not clash with the untraced ones of other tests
+#ifndef ESTL_ENABLE_TRACING
+#define ESTL_ENABLE_TRACING true
+#endif
+
+#include "../FixedList.hpp"
+#include "../FixedUnorderedMap.hpp"
+#include "../FixedVector.hpp"
+#include <atomic>
+#include <gtest/gtest.h>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace ESTL {
+    namespace {
+        struct TracedKey {
+            int value = 0;
+            bool operator==(const TracedKey &other) const { return value == other.value; }
+        };
+
+        // Every key to bucket value % 8
+        struct TracedHash {
+            std::size_t operator()(const TracedKey &key) const { return static_cast<std::size_t>(key.value) % 8; }
+        };
+
+        struct TracedValue {
+            int value = 0;
+        };
+
+        std::vector<TraceEvent> eventsOf(const void *container) {
+            std::vector<TraceEvent> events;
+            for (const TraceEvent &event: trace::collect()) {
+                if (event.container == container) {
+                    events.push_back(event);
+                }
+            }
+            return events;
+        }
+    }// namespace
+
+    TEST(TraceTest, UnorderedMapProbes) {
+        trace::clear();// an earlier container may have had the same address
+        RTMap<TracedKey, int, TracedHash> map(8, 8);
+        map.insert({0}, 0);
+        map.insert({8}, 1);
+        map.insert({16}, 2);
+        ASSERT_NE(map.find({16}), nullptr);
+        ASSERT_TRUE(map.erase({8}));
+
+        std::vector<TraceEvent> events = eventsOf(&map);
+        ASSERT_EQ(events.size(), 5u);
+        const TraceOp ops[] = {TraceOp::Insert, TraceOp::Insert, TraceOp::Insert, TraceOp::Find, TraceOp::Erase};
+        const std::uint32_t probes[] = {1, 1, 2, 3, 2};// buckets compared against the key
+        const std::uint64_t sizes[] = {0, 1, 2, 3, 3};
+        for (std::size_t i = 0; i < events.size(); ++i) {
+            EXPECT_EQ(events[i].kind, TraceKind::UnorderedMap);
+            EXPECT_EQ(events[i].op, ops[i]) << i;
+            EXPECT_EQ(events[i].probes, probes[i]) << i;
+            EXPECT_EQ(events[i].size, sizes[i]) << i;
+            EXPECT_NE(events[i].thread, 0u);
+        }
+        for (std::size_t i = 1; i < events.size(); ++i) {
+            EXPECT_GE(events[i].startCycles, events[i - 1].startCycles + events[i - 1].durationCycles);
+        }
+    }
+
+    TEST(TraceTest, VectorAndListOperations) {
+        trace::clear();// an earlier container may have had the same address
+        RTVector<TracedValue> vector(4);
+        vector.push_back({1});
+        vector.emplace_back();
+        vector.pop_back();
+        RTList<TracedValue> list(4);
+        list.push_back({1});
+        list.push_front({2});
+        list.pop_back();
+        list.clear();
+
+        std::vector<TraceEvent> vectorEvents = eventsOf(&vector);
+        ASSERT_EQ(vectorEvents.size(), 3u);
+        EXPECT_EQ(vectorEvents[0].op, TraceOp::PushBack);
+        EXPECT_EQ(vectorEvents[1].op, TraceOp::PushBack);
+        EXPECT_EQ(vectorEvents[2].op, TraceOp::PopBack);
+        EXPECT_EQ(vectorEvents[2].size, 2u);
+
+        // FixedList is a base of RTList - both addresses are the same object
+        std::vector<TraceEvent> listEvents = eventsOf(static_cast<FixedList<TracedValue> *>(&list));
+        ASSERT_EQ(listEvents.size(), 4u);
+        EXPECT_EQ(listEvents[0].op, TraceOp::PushBack);
+        EXPECT_EQ(listEvents[1].op, TraceOp::PushFront);
+        EXPECT_EQ(listEvents[2].op, TraceOp::PopBack);
+        EXPECT_EQ(listEvents[3].op, TraceOp::Clear);
+        EXPECT_EQ(listEvents[3].kind, TraceKind::List);
+    }
+
+    TEST(TraceTest, PerThreadRings) {
+        trace::clear();// an earlier container may have had the same address
+        RTVector<TracedValue> first(100);
+        RTVector<TracedValue> second(100);
+        // Both threads alive at once, so the kernel cannot hand the second one the first one's id
+        std::atomic<int> started{0};
+        auto fill = [&started](RTVector<TracedValue> &vector) {
+            ++started;
+            while (started.load() < 2) {
+                std::this_thread::yield();
+            }
+            for (int i = 0; i < 100; ++i) {
+                vector.push_back({i});
+            }
+        };
+        std::thread a(fill, std::ref(first));
+        std::thread b(fill, std::ref(second));
+        a.join();
+        b.join();
+
+        std::vector<TraceEvent> firstEvents = eventsOf(&first);
+        std::vector<TraceEvent> secondEvents = eventsOf(&second);
+        ASSERT_EQ(firstEvents.size(), 100u);
+        ASSERT_EQ(secondEvents.size(), 100u);
+        std::set<std::uint32_t> threads;
+        for (const TraceEvent &event: firstEvents) {
+            threads.insert(event.thread);
+        }
+        for (const TraceEvent &event: secondEvents) {
+            threads.insert(event.thread);
+        }
+        EXPECT_EQ(threads.size(), 2u);
+    }
+
+    TEST(TraceTest, RingsOfExitedThreadsAreBounded) {
+        trace::clear();
+        const std::size_t live = trace::Registry::instance().rings();
+        const std::size_t threads = 2 * ESTL_TRACE_RETIRED_RINGS + 10;
+        RTVector<TracedValue> vector(threads);
+        for (std::size_t i = 0; i < threads; ++i) {
+            std::thread([&vector, i]() { vector.push_back({static_cast<int>(i)}); }).join();
+        }
+        EXPECT_LE(trace::Registry::instance().rings(), live + ESTL_TRACE_RETIRED_RINGS);
+
+        // The newest exited threads are still dumped
+        std::vector<TraceEvent> events = eventsOf(&vector);
+        EXPECT_GE(events.size(), static_cast<std::size_t>(ESTL_TRACE_RETIRED_RINGS));
+        EXPECT_LE(events.size(), static_cast<std::size_t>(ESTL_TRACE_RETIRED_RINGS) + 1);
+
+        trace::clear();
+        EXPECT_EQ(trace::Registry::instance().rings(), live);
+        EXPECT_TRUE(eventsOf(&vector).empty());
+    }
+
+    TEST(TraceTest, RingKeepsNewestEvents) {
+        trace::clear();
+        RTVector<TracedValue> vector(1);
+        const std::size_t capacity = trace::ThreadRing::Capacity;
+        const std::size_t operations = capacity + 100;
+        for (std::size_t i = 0; i < operations / 2; ++i) {
+            vector.push_back({1});
+            vector.pop_back();
+        }
+        std::vector<TraceEvent> events = eventsOf(&vector);
+        ASSERT_EQ(events.size(), capacity);
+        EXPECT_EQ(events.back().op, TraceOp::PopBack);
+    }
+
+    TEST(TraceTest, Dumpers) {
+        trace::clear();
+        RTMap<TracedKey, int, TracedHash> map(8, 8);
+        map.insert({1}, 1);
+        map.clear();
+
+        std::ostringstream chrome;
+        trace::writeChromeTrace(chrome);
+        EXPECT_EQ(chrome.str().find("{\"traceEvents\":["), 0u);
+        EXPECT_NE(chrome.str().find("\"name\":\"insert\",\"cat\":\"FixedUnorderedMap\",\"ph\":\"X\""),
+                  std::string::npos);
+        EXPECT_NE(chrome.str().find("\"name\":\"clear\""), std::string::npos);
+
+        std::ostringstream perf;
+        trace::writePerfScript(perf);
+        EXPECT_NE(perf.str().find(": estl:insert: FixedUnorderedMap container="), std::string::npos);
+        EXPECT_NE(perf.str().find(" probes=1 "), std::string::npos);
+
+        trace::clear();
+        EXPECT_TRUE(trace::collect().empty());
+    }
+}// namespace ESTL
@@ -0,0 +1,71 @@
+//
+// Containers built in constant expressions - compiled as C++20 with ESTL_CONSTEXPR_CONTAINERS, see CMakeLists.txt.
+// The static_asserts are the tests; the runtime checks read the tables emitted into the binary.
+//
+#include "../../FixedList.hpp"
+#include "../../FixedUnorderedMap.hpp"
+#include "../../FixedVector.hpp"
+#include <gtest/gtest.h>
+
+namespace ESTL {
+    namespace {
+        constexpr CTVector<int, 16> squares() {
+            CTVector<int, 16> result;
+            for (int i = 0; i < 10; ++i) {
+                result.push_back(i * i);
+            }
+            result.erase(result.begin());
+            result.insert(result.begin(), -1);
+            return result;
+        }
+
+        constexpr int sumList() {
+            CTList<int, 8> list{3, 4, 5};
+            list.push_front(2);
+            list.pop_back();
+            list.emplace_back(10);
+            int sum = 0;
+            for (int value: list) {
+                sum += value;
+            }
+            return sum;
+        }
+
+        // Key k lands in bucket k % 8 - 1, 9 and 17 share a chain
+        constexpr int chainedLookups() {
+            CTMap<int, int, 8, 4, ConstexprHash<int>> map{{1, 10}, {9, 90}, {17, 170}, {2, 20}};
+            map.erase(9);
+            map.insert_or_assign(2, 22);
+            map[25] = 250;
+            return *map.find(17) + *map.find(2) + *map.find(25) + (map.find(9) == nullptr ? 1 : 0);
+        }
+
+        enum class Opcode { Load, Store, Add, Jump };
+
+        static constexpr CTVector<int, 16> kSquares = squares();
+        static constexpr CTList<int, 4> kPrimes{2, 3, 5, 7};
+        static constexpr CTMap<Opcode, const char *, 8, 4, ConstexprHash<Opcode>> kMnemonics{
+                {Opcode::Load, "ld"}, {Opcode::Store, "st"}, {Opcode::Add, "add"}, {Opcode::Jump, "jmp"}};
+    }// namespace
+
+    static_assert(squares().size() == 10 && squares()[0] == -1 && squares()[9] == 81, "vector operations");
+    static_assert(kPrimes.back() == 7 && kPrimes.size() == 4, "list built at compile time");
+    static_assert(sumList() == 19, "list operations in a constant expression");
+    static_assert(chainedLookups() == 170 + 22 + 250 + 1, "map operations in a constant expression");
+    static_assert(kMnemonics.size() == 4 && kMnemonics.find(Opcode::Add) != nullptr, "map built at compile time");
+
+    // kSquares is constant-initialized all the same - GCC 12 only refuses to read a constexpr variable initialized
+    // through a function call back in later constant expressions when it points into itself
+    TEST(ConstexprContainersTest, TablesAreReadableAtRunTime) {
+        EXPECT_EQ(kSquares.size(), 10u);
+        EXPECT_EQ(kSquares[3], 9);
+        int product = 1;
+        for (int prime: kPrimes) {
+            product *= prime;
+        }
+        EXPECT_EQ(product, 210);
+        ASSERT_NE(kMnemonics.find(Opcode::Jump), nullptr);
+        EXPECT_STREQ(*kMnemonics.find(Opcode::Jump), "jmp");
+        EXPECT_EQ(kMnemonics.find(static_cast<Opcode>(6)), nullptr);
+    }
+}// namespace ESTL
@@ -0,0 +1,111 @@
+//
+// Capacity-planning report - replays a key file into an RTMap and prints its HashDiagnostics.
+//
+// Usage: estl_hashreport <key file> [--capacity N] [--load L] [--integers]
+//   One key per line. --capacity replays into N primary buckets (the N of the CTMap being sized), by default the
+//   capacity recommended for the target load. --integers hashes the keys as 64-bit integers instead of strings.
+//
+#include "../FixedUnorderedMap.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace {
+    struct Options {
+        const char *path = nullptr;
+        std::size_t capacity = 0;
+        double load = 0.75;
+        bool integers = false;
+    };
+
+    int usage() {
+        std::fprintf(stderr, "usage: estl_hashreport <key file> [--capacity N] [--load L] [--integers]\n");
+        return 2;
+    }
+
+    template<typename Key>
+    void report(const std::vector<Key> &keys, const Options &options) {
+        std::size_t capacity = options.capacity;
+        if (! capacity) {
+            capacity = static_cast<std::size_t>(keys.size() / options.load) + 1;
+        }
+        // A pool as large as the key set - the replay never runs out, the report says what is really needed
+        ESTL::RTMap<Key, char> map(capacity, keys.size() ? keys.size() : 1);
+        std::size_t duplicates = 0;
+        for (const Key &key: keys) {
+            duplicates += map.insert(key, 0) ? 0 : 1;
+        }
+
+        ESTL::HashDiagnostics diagnostics = map.diagnostics(options.load);
+        std::printf("keys            %zu (%zu duplicates skipped)\n", diagnostics.size, duplicates);
+        std::printf("capacity        %zu primary buckets, load %.3f\n", diagnostics.capacity,
+                    double(diagnostics.size) / diagnostics.capacity);
+        std::printf("primary in use  %zu\n", diagnostics.primaryInUse);
+        std::printf("pool in use     %zu\n", diagnostics.poolInUse);
+        std::printf("chain lengths   (entries, primary buckets)\n");
+        std::size_t widest = 1;
+        for (std::size_t count: diagnostics.chainLengths) {
+            widest = count > widest ? count : widest;
+        }
+        for (std::size_t length = 0; length < diagnostics.chainLengths.size(); ++length) {
+            std::size_t count = diagnostics.chainLengths[length];
+            if (! count) {
+                continue;
+            }
+            std::string bar((count * 50 + widest - 1) / widest, '#');
+            std::printf("  %4zu %10zu %s\n", length, count, bar.c_str());
+        }
+        std::printf("chi-squared     %.1f over %zu degrees of freedom, ratio %.3f (uniform ~1)\n",
+                    diagnostics.chiSquared, diagnostics.degreesOfFreedom, diagnostics.chiSquaredRatio);
+        std::printf("recommended     N = %zu, BucketPoolSize = %zu for load %.2f\n", diagnostics.recommendedCapacity,
+                    diagnostics.recommendedPoolSize, diagnostics.targetLoad);
+    }
+}// namespace
+
+int main(int argc, char **argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        if (! std::strcmp(argv[i], "--capacity") && i + 1 < argc) {
+            options.capacity = std::strtoull(argv[++i], nullptr, 10);
+        } else if (! std::strcmp(argv[i], "--load") && i + 1 < argc) {
+            options.load = std::strtod(argv[++i], nullptr);
+        } else if (! std::strcmp(argv[i], "--integers")) {
+            options.integers = true;
+        } else if (argv[i][0] != '-' && ! options.path) {
+            options.path = argv[i];
+        } else {
+            return usage();
+        }
+    }
+    if (! options.path || ! (options.load > 0)) {
+        return usage();
+    }
+
+    std::ifstream in(options.path);
+    if (! in) {
+        std::fprintf(stderr, "estl_hashreport: cannot open %s\n", options.path);
+        return 1;
+    }
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(in, line);) {
+        if (! line.empty()) {
+            lines.push_back(line);
+        }
+    }
+
+    if (options.integers) {
+        std::vector<long long> keys;
+        keys.reserve(lines.size());
+        for (const std::string &line: lines) {
+            keys.push_back(std::strtoll(line.c_str(), nullptr, 10));
+        }
+        report(keys, options);
+    } else {
+        report(lines, options);
+    }
+    return 0;
+}
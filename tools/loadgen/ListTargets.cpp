@@ -0,0 +1,38 @@
+//
+// estl_loadgen targets - FixedList as a queue: writes push at the back, erases pop the front, reads peek the front.
+//
+#include "../../FixedList.hpp"
+#include "LoadGen.hpp"
+
+namespace loadgen {
+    namespace {
+        // Keys only fill the queue - a full or empty list throws, which the driver counts as rejected
+        template<typename List>
+        struct ListSubject {
+            List list;
+
+            template<typename... Args>
+            explicit ListSubject(Args &&...args) : list(std::forward<Args>(args)...) {}
+
+            void read(std::uint64_t) { keep(list.front()); }
+            void write(std::uint64_t key) { list.push_back(key); }
+            void erase(std::uint64_t) { list.pop_front(); }
+        };
+
+        using CTListSubject = ListSubject<ESTL::CTList<std::uint64_t, CTKeys>>;
+        using RTListSubject = ListSubject<ESTL::RTList<std::uint64_t>>;
+    }// namespace
+
+    // push_back / pop_front test for full / empty before taking the lock, and front() hands out a reference, so
+    // threads share a list only under an external lock
+    void addListTargets(std::vector<Target> &targets) {
+        targets.push_back(target<CTListSubject>("CTList", CTKeys, [](std::size_t) {
+            return std::unique_ptr<CTListSubject>(new CTListSubject());
+        }));
+        targets.back().concurrent = false;
+        targets.push_back(target<RTListSubject>("RTList", 0, [](std::size_t keys) {
+            return std::unique_ptr<RTListSubject>(new RTListSubject(keys));
+        }));
+        targets.back().concurrent = false;
+    }
+}// namespace loadgen
@@ -0,0 +1,311 @@
+//
+// estl_loadgen driver - workloads, key streams, latency histograms and the threaded run loop shared by the targets.
+//
+// The unordered maps and FixedMap both name their containers ESTL::CTMap / ESTL::RTMap, so each container family
+// is driven from its own translation unit and registers its targets with main.cpp through the add*Targets functions.
+//
+
+#ifndef ESTL_LOADGEN_HPP
+#define ESTL_LOADGEN_HPP
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef ENABLE_THREAD_SAFETY
+#define ENABLE_THREAD_SAFETY true
+#endif
+
+namespace loadgen {
+    enum class Distribution { Uniform, Zipf, Sequential };
+
+    // Lock taken by the driver around every operation, on top of the container's own mutex (if compiled in)
+    enum class ExternalLock { None, Mutex, ReadWrite };
+
+    // Capacity of the compile-time containers - CT targets skip workloads with a larger key space
+    constexpr std::size_t CTKeys = std::size_t(1) << 16;
+
+    struct Workload {
+        unsigned readPercent = 90;
+        unsigned writePercent = 5;
+        unsigned erasePercent = 5;
+        Distribution distribution = Distribution::Uniform;
+        ExternalLock lock = ExternalLock::None;
+        unsigned threads = 1;
+        std::size_t keys = CTKeys;           // Key space - keys are 0 .. keys - 1
+        std::size_t operations = 200000;     // Per thread
+        double zipfTheta = 0.99;
+        std::uint64_t seed = 2025;
+    };
+
+    struct Result {
+        double seconds = 0;
+        std::uint64_t operations = 0;
+        std::uint64_t rejected = 0;// Operations that threw - pool or list full, list empty
+        std::uint64_t p50Ns = 0;
+        std::uint64_t p99Ns = 0;
+        std::uint64_t p999Ns = 0;
+    };
+
+    struct Target {
+        std::string name;
+        std::size_t maxKeys;// Largest key space the target holds, 0: unbounded
+        std::function<Result(const Workload &)> run;
+        // False: the container's own lock does not make its operations safe to share - needs an external lock
+        bool concurrent = true;
+    };
+
+    void addUnorderedTargets(std::vector<Target> &targets);
+    void addOrderedTargets(std::vector<Target> &targets);
+    void addListTargets(std::vector<Target> &targets);
+
+    // Keeps the result of a lookup alive without storing it anywhere shared
+    template<typename T>
+    inline void keep(const T &value) {
+        asm volatile("" : : "g"(value) : "memory");
+    }
+
+    inline const char *name(Distribution distribution) {
+        static const char *const names[] = {"uniform", "zipf", "sequential"};
+        return names[static_cast<std::size_t>(distribution)];
+    }
+
+    inline const char *name(ExternalLock lock) {
+        static const char *const names[] = {"none", "mutex", "rwlock"};
+        return names[static_cast<std::size_t>(lock)];
+    }
+
+    /**
+     * @brief Log-linear latency histogram.
+     *
+     * Each power of two is split into 16 linear sub-buckets, so a recorded value is reported within 1/16 of itself -
+     * fixed memory, no allocation while recording, and per-thread histograms merge by adding counts.
+     */
+    class LatencyHistogram {
+        static constexpr unsigned SubBits = 4;
+        static constexpr std::size_t SubBuckets = std::size_t(1) << SubBits;
+
+        std::array<std::uint64_t, 64 * SubBuckets> m_counts{};
+        std::uint64_t m_total = 0;
+
+        static std::size_t index(std::uint64_t ns) {
+            if (ns < SubBuckets) {
+                return static_cast<std::size_t>(ns);
+            }
+            const unsigned magnitude = 63 - static_cast<unsigned>(__builtin_clzll(ns));
+            return ((magnitude - SubBits + 1) << SubBits) + ((ns >> (magnitude - SubBits)) & (SubBuckets - 1));
+        }
+
+        // Smallest value filed into bucket i
+        static std::uint64_t lowerBound(std::size_t i) {
+            const std::size_t slot = i >> SubBits;
+            if (slot == 0) {
+                return i;
+            }
+            return (SubBuckets + (i & (SubBuckets - 1))) << (slot - 1);
+        }
+
+    public:
+        void record(std::uint64_t ns) {
+            ++m_counts[index(ns)];
+            ++m_total;
+        }
+
+        void merge(const LatencyHistogram &other) {
+            for (std::size_t i = 0; i < m_counts.size(); ++i) {
+                m_counts[i] += other.m_counts[i];
+            }
+            m_total += other.m_total;
+        }
+
+        // Value at quantile q (0 < q <= 1) - the lower bound of the bucket holding it
+        std::uint64_t percentile(double q) const {
+            if (! m_total) {
+                return 0;
+            }
+            const std::uint64_t rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(q * m_total)));
+            std::uint64_t seen = 0;
+            for (std::size_t i = 0; i < m_counts.size(); ++i) {
+                seen += m_counts[i];
+                if (seen >= rank) {
+                    return lowerBound(i);
+                }
+            }
+            return lowerBound(m_counts.size() - 1);
+        }
+    };
+
+    // splitmix64 - cheap, and good enough to pick keys and operations
+    class Random {
+        std::uint64_t m_state;
+
+    public:
+        explicit Random(std::uint64_t seed) : m_state(seed) {}
+
+        std::uint64_t next() {
+            std::uint64_t z = (m_state += 0x9e3779b97f4a7c15ULL);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            return z ^ (z >> 31);
+        }
+
+        // Uniform in [0, 1)
+        double unit() { return double(next() >> 11) * (1.0 / 9007199254740992.0); }
+    };
+
+    // Cumulative Zipf(theta) probabilities of ranks 0 .. keys - 1 - key 0 is the hottest, shared by all threads
+    inline std::vector<double> zipfTable(std::size_t keys, double theta) {
+        std::vector<double> cdf(keys);
+        double sum = 0;
+        for (std::size_t rank = 0; rank < keys; ++rank) {
+            sum += 1.0 / std::pow(double(rank + 1), theta);
+            cdf[rank] = sum;
+        }
+        for (double &p: cdf) {
+            p /= sum;
+        }
+        return cdf;
+    }
+
+    // Keys of one thread
+    class KeyStream {
+        const Workload &m_workload;
+        const std::vector<double> &m_zipf;
+        Random m_random;
+        std::uint64_t m_next;
+
+    public:
+        KeyStream(const Workload &workload, const std::vector<double> &zipf, unsigned thread)
+            : m_workload(workload)
+            , m_zipf(zipf)
+            , m_random(workload.seed * 7919 + thread)
+            , m_next(workload.keys / workload.threads * thread) {}
+
+        std::uint64_t next() {
+            switch (m_workload.distribution) {
+                case Distribution::Uniform:
+                    return m_random.next() % m_workload.keys;
+                case Distribution::Zipf:
+                    return static_cast<std::uint64_t>(
+                            std::lower_bound(m_zipf.begin(), m_zipf.end() - 1, m_random.unit()) - m_zipf.begin());
+                case Distribution::Sequential:
+                    break;
+            }
+            // Each thread walks the key space from its own offset
+            const std::uint64_t key = m_next;
+            m_next = m_next + 1 == m_workload.keys ? 0 : m_next + 1;
+            return key;
+        }
+    };
+
+    /**
+     * Runs workload against subject on workload.threads threads and returns the combined throughput and latencies.
+     *
+     * Subject has read(key), write(key) and erase(key) members; an operation that throws counts as rejected. Latency
+     * is measured per operation and includes the wait for the external lock. The threads start together and the
+     * elapsed time runs from their start to the last one finishing.
+     */
+    template<typename Subject>
+    Result run(const Workload &workload, Subject &subject) {
+        const std::vector<double> zipf = workload.distribution == Distribution::Zipf
+                                                 ? zipfTable(workload.keys, workload.zipfTheta)
+                                                 : std::vector<double>();
+        std::mutex mutex;
+        std::shared_timed_mutex rwMutex;
+        std::vector<LatencyHistogram> histograms(workload.threads);
+        std::vector<std::uint64_t> rejected(workload.threads);
+        std::atomic<unsigned> ready{0};
+        std::atomic<bool> go{false};
+
+        auto worker = [&](unsigned thread) {
+            KeyStream keys(workload, zipf, thread);
+            Random operations(workload.seed ^ (0x5851f42d4c957f2dULL * (thread + 1)));
+            LatencyHistogram &histogram = histograms[thread];
+            ++ready;
+            while (! go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            for (std::size_t i = 0; i < workload.operations; ++i) {
+                const std::uint64_t key = keys.next();
+                const unsigned pick = static_cast<unsigned>(operations.next() % 100);
+                const bool read = pick < workload.readPercent;
+                const bool write = ! read && pick < workload.readPercent + workload.writePercent;
+                const auto start = std::chrono::steady_clock::now();
+                try {
+                    std::unique_lock<std::mutex> exclusive(mutex, std::defer_lock);
+                    std::unique_lock<std::shared_timed_mutex> writer(rwMutex, std::defer_lock);
+                    std::shared_lock<std::shared_timed_mutex> reader(rwMutex, std::defer_lock);
+                    if (workload.lock == ExternalLock::Mutex) {
+                        exclusive.lock();
+                    } else if (workload.lock == ExternalLock::ReadWrite) {
+                        read ? reader.lock() : writer.lock();
+                    }
+                    if (read) {
+                        subject.read(key);
+                    } else if (write) {
+                        subject.write(key);
+                    } else {
+                        subject.erase(key);
+                    }
+                } catch (const std::exception &) {
+                    ++rejected[thread];
+                }
+                histogram.record(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - start).count()));
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (unsigned thread = 0; thread < workload.threads; ++thread) {
+            threads.emplace_back(worker, thread);
+        }
+        while (ready.load() < workload.threads) {
+            std::this_thread::yield();
+        }
+        const auto start = std::chrono::steady_clock::now();
+        go.store(true, std::memory_order_release);
+        for (std::thread &thread: threads) {
+            thread.join();
+        }
+
+        Result result;
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        LatencyHistogram combined;
+        for (unsigned thread = 0; thread < workload.threads; ++thread) {
+            combined.merge(histograms[thread]);
+            result.rejected += rejected[thread];
+        }
+        result.operations = std::uint64_t(workload.operations) * workload.threads;
+        result.p50Ns = combined.percentile(0.50);
+        result.p99Ns = combined.percentile(0.99);
+        result.p999Ns = combined.percentile(0.999);
+        return result;
+    }
+
+    // Builds a fresh subject per workload, half of the key space preloaded so reads hit about half the time
+    template<typename Subject, typename Make>
+    Target target(const std::string &name, std::size_t maxKeys, Make make) {
+        return {name, maxKeys, [make](const Workload &workload) -> Result {
+                    std::unique_ptr<Subject> subject = make(workload.keys);
+                    for (std::uint64_t key = 0; key < workload.keys; key += 2) {
+                        subject->write(key);
+                    }
+                    return run(workload, *subject);
+                }};
+    }
+}// namespace loadgen
+
+#endif//ESTL_LOADGEN_HPP
@@ -0,0 +1,42 @@
+//
+// estl_loadgen targets - FixedMap with each tree engine.
+//
+#include "../../FixedMap/FixedMap.hpp"
+#include "LoadGen.hpp"
+
+namespace loadgen {
+    namespace {
+        template<typename Map>
+        struct MapSubject {
+            Map map;
+
+            template<typename... Args>
+            explicit MapSubject(Args &&...args) : map(std::forward<Args>(args)...) {}
+
+            void read(std::uint64_t key) { keep(map.find(key)); }
+            void write(std::uint64_t key) { keep(map.insert_or_assign(key, key)); }
+            void erase(std::uint64_t key) { keep(map.erase(key)); }
+        };
+
+        using RTMapSubject = MapSubject<ESTL::RTMap<std::uint64_t, std::uint64_t>>;
+        using CTMapSubject = MapSubject<ESTL::CTMap<std::uint64_t, std::uint64_t, CTKeys>>;
+
+        Target treeTarget(const char *name, TreeType type) {
+            return target<RTMapSubject>(name, 0, [type](std::size_t keys) {
+                // Path copying retires about 3 * height nodes per write before they are reclaimed
+                std::size_t spare = type == TreeType::Persistent ? 256 : 0;
+                return std::unique_ptr<RTMapSubject>(new RTMapSubject(keys + spare, type));
+            });
+        }
+    }// namespace
+
+    void addOrderedTargets(std::vector<Target> &targets) {
+        targets.push_back(treeTarget("FixedMap-RB", TreeType::RedBlack));
+        targets.push_back(treeTarget("FixedMap-AVL", TreeType::AVL));
+        targets.push_back(treeTarget("FixedMap-BPlus", TreeType::BPlus));
+        targets.push_back(treeTarget("FixedMap-Persistent", TreeType::Persistent));
+        targets.push_back(target<CTMapSubject>("FixedMap-CT-RB", CTKeys, [](std::size_t) {
+            return std::unique_ptr<CTMapSubject>(new CTMapSubject(TreeType::RedBlack));
+        }));
+    }
+}// namespace loadgen
@@ -0,0 +1,55 @@
+//
+// estl_loadgen targets - FixedUnorderedMap and FixedUnorderedSet, compile-time and run-time.
+//
+#include "../../FixedUnorderedMap.hpp"
+#include "../../FixedUnorderedSet.hpp"
+#include "LoadGen.hpp"
+
+namespace loadgen {
+    namespace {
+        template<typename Map>
+        struct MapSubject {
+            Map map;
+
+            template<typename... Args>
+            explicit MapSubject(Args &&...args) : map(std::forward<Args>(args)...) {}
+
+            void read(std::uint64_t key) { keep(map.find(key)); }
+            void write(std::uint64_t key) { keep(map.insert_or_assign(key, key)); }
+            void erase(std::uint64_t key) { keep(map.erase(key)); }
+        };
+
+        template<typename Set>
+        struct SetSubject {
+            Set set;
+
+            template<typename... Args>
+            explicit SetSubject(Args &&...args) : set(std::forward<Args>(args)...) {}
+
+            void read(std::uint64_t key) { keep(set.contains(key)); }
+            void write(std::uint64_t key) { keep(set.insert(key)); }
+            void erase(std::uint64_t key) { keep(set.erase(key)); }
+        };
+
+        // One primary bucket per key and half as many chained ones, as in the containers' own defaults
+        using CTMapSubject = MapSubject<ESTL::CTMap<std::uint64_t, std::uint64_t, CTKeys, CTKeys / 2>>;
+        using RTMapSubject = MapSubject<ESTL::RTMap<std::uint64_t, std::uint64_t>>;
+        using CTSetSubject = SetSubject<ESTL::CTUnorderedSet<std::uint64_t, CTKeys, CTKeys / 2>>;
+        using RTSetSubject = SetSubject<ESTL::RTUnorderedSet<std::uint64_t>>;
+    }// namespace
+
+    void addUnorderedTargets(std::vector<Target> &targets) {
+        targets.push_back(target<CTMapSubject>("CTMap", CTKeys, [](std::size_t) {
+            return std::unique_ptr<CTMapSubject>(new CTMapSubject());
+        }));
+        targets.push_back(target<RTMapSubject>("RTMap", 0, [](std::size_t keys) {
+            return std::unique_ptr<RTMapSubject>(new RTMapSubject(keys, keys / 2 + 1));
+        }));
+        targets.push_back(target<CTSetSubject>("CTUnorderedSet", CTKeys, [](std::size_t) {
+            return std::unique_ptr<CTSetSubject>(new CTSetSubject());
+        }));
+        targets.push_back(target<RTSetSubject>("RTUnorderedSet", 0, [](std::size_t keys) {
+            return std::unique_ptr<RTSetSubject>(new RTSetSubject(keys, keys / 2 + 1));
+        }));
+    }
+}// namespace loadgen
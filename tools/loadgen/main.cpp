@@ -0,0 +1,220 @@
+//
+// Load generator - read/write/erase mixes over the maps, sets and lists, one CSV row per run.
+//
+// Usage: estl_loadgen [--targets A,B] [--threads 1,4] [--mix 90/5/5,50/25/25] [--dist uniform,zipf,sequential]
+//                     [--lock none,mutex,rwlock] [--keys N] [--ops N] [--theta T] [--seed S] [--list]
+//   Every combination of the comma-separated lists is run; --ops is per thread. The keys are 0 .. N - 1, half of
+//   them preloaded. --lock adds a driver-side lock around every operation; container_lock in the output says whether
+//   the containers were built with their own mutex (estl_loadgen) or without it (estl_loadgen_unlocked).
+//
+#include "LoadGen.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+namespace {
+    using namespace loadgen;
+
+    struct Options {
+        std::vector<std::string> targets;
+        std::vector<unsigned> threads;
+        std::vector<Workload> mixes;// Percentages only
+        std::vector<Distribution> distributions = {Distribution::Uniform, Distribution::Zipf,
+                                                   Distribution::Sequential};
+        std::vector<ExternalLock> locks = {ExternalLock::None, ExternalLock::Mutex, ExternalLock::ReadWrite};
+        std::size_t keys = CTKeys;
+        std::size_t operations = 200000;
+        double theta = 0.99;
+        std::uint64_t seed = 2025;
+        bool list = false;
+    };
+
+    int usage() {
+        std::fprintf(stderr, "usage: estl_loadgen [--targets A,B] [--threads 1,4] [--mix 90/5/5,50/25/25]\n"
+                             "                    [--dist uniform,zipf,sequential] [--lock none,mutex,rwlock]\n"
+                             "                    [--keys N] [--ops N] [--theta T] [--seed S] [--list]\n");
+        return 2;
+    }
+
+    std::vector<std::string> split(const char *text, char separator) {
+        std::vector<std::string> parts;
+        std::stringstream stream(text);
+        for (std::string part; std::getline(stream, part, separator);) {
+            if (! part.empty()) {
+                parts.push_back(part);
+            }
+        }
+        return parts;
+    }
+
+    bool parse(int argc, char **argv, Options &options) {
+        for (int i = 1; i < argc; ++i) {
+            const char *flag = argv[i];
+            if (! std::strcmp(flag, "--list")) {
+                options.list = true;
+                continue;
+            }
+            if (i + 1 >= argc) {
+                return false;
+            }
+            const char *value = argv[++i];
+            if (! std::strcmp(flag, "--targets")) {
+                options.targets = split(value, ',');
+            } else if (! std::strcmp(flag, "--threads")) {
+                options.threads.clear();
+                for (const std::string &count: split(value, ',')) {
+                    options.threads.push_back(static_cast<unsigned>(std::strtoul(count.c_str(), nullptr, 10)));
+                    if (! options.threads.back()) {
+                        return false;
+                    }
+                }
+            } else if (! std::strcmp(flag, "--mix")) {
+                options.mixes.clear();
+                for (const std::string &mix: split(value, ',')) {
+                    std::vector<std::string> percents = split(mix.c_str(), '/');
+                    if (percents.size() != 3) {
+                        return false;
+                    }
+                    Workload workload;
+                    workload.readPercent = static_cast<unsigned>(std::strtoul(percents[0].c_str(), nullptr, 10));
+                    workload.writePercent = static_cast<unsigned>(std::strtoul(percents[1].c_str(), nullptr, 10));
+                    workload.erasePercent = static_cast<unsigned>(std::strtoul(percents[2].c_str(), nullptr, 10));
+                    if (workload.readPercent + workload.writePercent + workload.erasePercent != 100) {
+                        return false;
+                    }
+                    options.mixes.push_back(workload);
+                }
+            } else if (! std::strcmp(flag, "--dist")) {
+                options.distributions.clear();
+                for (const std::string &name: split(value, ',')) {
+                    if (name == "uniform") {
+                        options.distributions.push_back(Distribution::Uniform);
+                    } else if (name == "zipf") {
+                        options.distributions.push_back(Distribution::Zipf);
+                    } else if (name == "sequential") {
+                        options.distributions.push_back(Distribution::Sequential);
+                    } else {
+                        return false;
+                    }
+                }
+            } else if (! std::strcmp(flag, "--lock")) {
+                options.locks.clear();
+                for (const std::string &name: split(value, ',')) {
+                    if (name == "none") {
+                        options.locks.push_back(ExternalLock::None);
+                    } else if (name == "mutex") {
+                        options.locks.push_back(ExternalLock::Mutex);
+                    } else if (name == "rwlock") {
+                        options.locks.push_back(ExternalLock::ReadWrite);
+                    } else {
+                        return false;
+                    }
+                }
+            } else if (! std::strcmp(flag, "--keys")) {
+                options.keys = std::strtoull(value, nullptr, 10);
+            } else if (! std::strcmp(flag, "--ops")) {
+                options.operations = std::strtoull(value, nullptr, 10);
+            } else if (! std::strcmp(flag, "--theta")) {
+                options.theta = std::strtod(value, nullptr);
+            } else if (! std::strcmp(flag, "--seed")) {
+                options.seed = std::strtoull(value, nullptr, 10);
+            } else {
+                return false;
+            }
+        }
+        return options.keys >= 2 && options.operations > 0 && options.theta > 0;
+    }
+
+    bool selected(const Options &options, const Target &target) {
+        if (options.targets.empty()) {
+            return true;
+        }
+        for (const std::string &name: options.targets) {
+            if (name == target.name) {
+                return true;
+            }
+        }
+        return false;
+    }
+}// namespace
+
+int main(int argc, char **argv) {
+    Options options;
+    if (! parse(argc, argv, options)) {
+        return usage();
+    }
+    if (options.threads.empty()) {
+        const unsigned cores = std::thread::hardware_concurrency();
+        options.threads.push_back(1);
+        if (cores > 1) {
+            options.threads.push_back(cores);
+        }
+    }
+    if (options.mixes.empty()) {
+        Workload readMostly;
+        Workload balanced;
+        balanced.readPercent = 50;
+        balanced.writePercent = 25;
+        balanced.erasePercent = 25;
+        options.mixes = {readMostly, balanced};
+    }
+
+    std::vector<Target> targets;
+    addUnorderedTargets(targets);
+    addOrderedTargets(targets);
+    addListTargets(targets);
+    if (options.list) {
+        for (const Target &target: targets) {
+            std::printf("%s\n", target.name.c_str());
+        }
+        return 0;
+    }
+
+    std::printf("target,container_lock,external_lock,threads,distribution,read_pct,write_pct,erase_pct,keys,ops,"
+                "rejected,seconds,ops_per_sec,p50_ns,p99_ns,p999_ns\n");
+    for (const Target &target: targets) {
+        if (! selected(options, target)) {
+            continue;
+        }
+        if (target.maxKeys && options.keys > target.maxKeys) {
+            std::fprintf(stderr, "skipping %s: holds at most %zu keys\n", target.name.c_str(), target.maxKeys);
+            continue;
+        }
+        for (const Workload &mix: options.mixes) {
+            for (Distribution distribution: options.distributions) {
+                for (ExternalLock lock: options.locks) {
+                    for (unsigned threads: options.threads) {
+                        const bool shareable = ENABLE_THREAD_SAFETY && target.concurrent;
+                        if (threads > 1 && lock == ExternalLock::None && ! shareable) {
+                            std::fprintf(stderr, "skipping %s on %u threads without a lock\n", target.name.c_str(),
+                                         threads);
+                            continue;
+                        }
+                        Workload workload = mix;
+                        workload.distribution = distribution;
+                        workload.lock = lock;
+                        workload.threads = threads;
+                        workload.keys = options.keys;
+                        workload.operations = options.operations;
+                        workload.zipfTheta = options.theta;
+                        workload.seed = options.seed;
+                        Result result = target.run(workload);
+                        std::printf("%s,%s,%s,%u,%s,%u,%u,%u,%zu,%llu,%llu,%.6f,%.0f,%llu,%llu,%llu\n",
+                                    target.name.c_str(), ENABLE_THREAD_SAFETY ? "on" : "off", name(lock), threads,
+                                    name(distribution), workload.readPercent, workload.writePercent,
+                                    workload.erasePercent, workload.keys,
+                                    static_cast<unsigned long long>(result.operations),
+                                    static_cast<unsigned long long>(result.rejected), result.seconds,
+                                    result.seconds > 0 ? result.operations / result.seconds : 0,
+                                    static_cast<unsigned long long>(result.p50Ns),
+                                    static_cast<unsigned long long>(result.p99Ns),
+                                    static_cast<unsigned long long>(result.p999Ns));
+                        std::fflush(stdout);
+                    }
+                }
+            }
+        }
+    }
+    return 0;
+}